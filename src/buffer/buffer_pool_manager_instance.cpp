@@ -172,7 +172,9 @@ bool BufferPoolManagerInstance::UnpinPgImp(page_id_t page_id, bool is_dirty) {
   }
 
   target->pin_count_ -= 1;
-  replacer_->Unpin(pair->second);
+  if (target->pin_count_ == 0) {
+    replacer_->Unpin(pair->second);
+  }
   return true;
 }
 
@@ -1,11 +1,41 @@
 #include "catalog/table_generator.h"
 
 #include <algorithm>
+#include <cmath>
 #include <random>
 #include <vector>
 
 namespace bustub {
 
+namespace {
+
+/** @return the skew of a Zipf distribution, 0 for the others */
+double ZipfTheta(TableGenerator::Dist dist) {
+  switch (dist) {
+    case TableGenerator::Dist::Zipf_50:
+      return 0.50;
+    case TableGenerator::Dist::Zipf_75:
+      return 0.75;
+    case TableGenerator::Dist::Zipf_95:
+      return 0.95;
+    case TableGenerator::Dist::Zipf_99:
+      return 0.99;
+    default:
+      return 0;
+  }
+}
+
+/** @return the sum of 1 / i^theta over i in [1, n] */
+double Zeta(uint64_t n, double theta) {
+  double sum = 0;
+  for (uint64_t i = 1; i <= n; i++) {
+    sum += 1.0 / std::pow(static_cast<double>(i), theta);
+  }
+  return sum;
+}
+
+}  // namespace
+
 template <typename CppType>
 std::vector<Value> TableGenerator::GenNumericValues(ColumnInsertMeta *col_meta, uint32_t count) {
   std::vector<Value> values{};
@@ -32,6 +62,36 @@ std::vector<Value> TableGenerator::GenNumericValues(ColumnInsertMeta *col_meta,
     return values;
   }
 
+  // Handle Zipf columns, where min_ is the most frequent value, min_ + 1 the next one, and so on, following Gray et
+  // al., "Quickly Generating Billion-Record Synthetic Databases"
+  if (double theta = ZipfTheta(col_meta->dist_); theta > 0) {
+    auto n = col_meta->max_ - col_meta->min_ + 1;
+    if (col_meta->zipf_zeta_ == 0) {
+      col_meta->zipf_zeta_ = Zeta(n, theta);
+    }
+    double zeta_n = col_meta->zipf_zeta_;
+    double alpha = 1.0 / (1.0 - theta);
+    double eta = (1.0 - std::pow(2.0 / static_cast<double>(n), 1.0 - theta)) / (1.0 - Zeta(2, theta) / zeta_n);
+    // every batch of values draws from a generator of its own
+    std::default_random_engine generator(col_meta->serial_counter_);
+    col_meta->serial_counter_ += count;
+    std::uniform_real_distribution<double> uniform(0.0, 1.0);
+    for (uint32_t i = 0; i < count; i++) {
+      double u = uniform(generator);
+      double uz = u * zeta_n;
+      uint64_t rank;
+      if (uz < 1.0) {
+        rank = 0;
+      } else if (uz < 1.0 + std::pow(0.5, theta)) {
+        rank = 1;
+      } else {
+        rank = std::min(n - 1, static_cast<uint64_t>(static_cast<double>(n) * std::pow(eta * u - eta + 1.0, alpha)));
+      }
+      values.emplace_back(Value(col_meta->type_, static_cast<CppType>(col_meta->min_ + rank)));
+    }
+    return values;
+  }
+
   std::default_random_engine generator;
   // TODO(Amadou): Break up in two branches if this is too weird.
   std::conditional_t<std::is_integral_v<CppType>, std::uniform_int_distribution<CppType>,
@@ -163,19 +223,24 @@ void TableGenerator::GenerateTestTables() {
   };
 
   for (auto &table_meta : insert_meta) {
-    // Create Schema
-    std::vector<Column> cols{};
-    cols.reserve(table_meta.col_meta_.size());
-    for (const auto &col_meta : table_meta.col_meta_) {
-      if (col_meta.type_ != TypeId::VARCHAR) {
-        cols.emplace_back(col_meta.name_, col_meta.type_);
-      } else {
-        cols.emplace_back(col_meta.name_, col_meta.type_, TEST_VARLEN_SIZE);
-      }
+    GenerateTable(&table_meta);
+  }
+}
+
+TableInfo *TableGenerator::GenerateTable(TableInsertMeta *table_meta) {
+  // Create Schema
+  std::vector<Column> cols{};
+  cols.reserve(table_meta->col_meta_.size());
+  for (const auto &col_meta : table_meta->col_meta_) {
+    if (col_meta.type_ != TypeId::VARCHAR) {
+      cols.emplace_back(col_meta.name_, col_meta.type_);
+    } else {
+      cols.emplace_back(col_meta.name_, col_meta.type_, TEST_VARLEN_SIZE);
     }
-    Schema schema(cols);
-    auto info = exec_ctx_->GetCatalog()->CreateTable(exec_ctx_->GetTransaction(), table_meta.name_, schema);
-    FillTable(info, &table_meta);
   }
+  Schema schema(cols);
+  auto info = exec_ctx_->GetCatalog()->CreateTable(exec_ctx_->GetTransaction(), table_meta->name_, schema);
+  FillTable(info, table_meta);
+  return info;
 }
 }  // namespace bustub
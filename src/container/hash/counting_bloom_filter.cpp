@@ -0,0 +1,94 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// counting_bloom_filter.cpp
+//
+// Identification: src/container/hash/counting_bloom_filter.cpp
+//
+// Copyright (c) 2015-2021, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "container/hash/counting_bloom_filter.h"
+
+#include "wyhash/wyhash.h"
+
+namespace bustub {
+
+CountingBloomFilter::CountingBloomFilter(size_t capacity) { Reset(capacity); }
+
+void CountingBloomFilter::Reset(size_t capacity) {
+  constexpr size_t counters_per_block = WORDS_PER_BLOCK * COUNTERS_PER_WORD;
+  capacity_ = capacity == 0 ? 1 : capacity;
+  num_blocks_ = (capacity_ * COUNTERS_PER_ENTRY + counters_per_block - 1) / counters_per_block;
+  blocks_ = std::make_unique<Block[]>(num_blocks_);
+  for (size_t i = 0; i < num_blocks_; i++) {
+    for (auto &word : blocks_[i].words_) {
+      word.store(0, std::memory_order_relaxed);
+    }
+  }
+  size_.store(0, std::memory_order_relaxed);
+}
+
+CountingBloomFilter::Block *CountingBloomFilter::BlockFor(uint64_t hash) const {
+  // Multiply-shift range reduction on the high half; the low half is what the hash table's directory consumes.
+  return &blocks_[((hash >> 32) * num_blocks_) >> 32];
+}
+
+uint64_t CountingBloomFilter::ProbeHash(uint64_t hash) {
+  // Remix so the counter positions are independent of the bits used to pick the block.
+  return wyhash::Hash64(hash);
+}
+
+uint32_t CountingBloomFilter::CounterIndex(uint64_t probe_hash, uint32_t probe) {
+  return static_cast<uint32_t>((probe_hash >> (probe * 7)) & (WORDS_PER_BLOCK * COUNTERS_PER_WORD - 1));
+}
+
+void CountingBloomFilter::Insert(uint64_t hash) {
+  Block *block = BlockFor(hash);
+  uint64_t probe_hash = ProbeHash(hash);
+  for (uint32_t probe = 0; probe < NUM_PROBES; probe++) {
+    uint32_t idx = CounterIndex(probe_hash, probe);
+    std::atomic<uint64_t> &word = block->words_[idx / COUNTERS_PER_WORD];
+    uint32_t shift = (idx % COUNTERS_PER_WORD) * 4;
+    uint64_t old_word = word.load(std::memory_order_relaxed);
+    while (((old_word >> shift) & COUNTER_MASK) != COUNTER_MASK &&
+           !word.compare_exchange_weak(old_word, old_word + (1ULL << shift), std::memory_order_release,
+                                       std::memory_order_relaxed)) {
+    }
+  }
+  size_.fetch_add(1, std::memory_order_relaxed);
+}
+
+void CountingBloomFilter::Remove(uint64_t hash) {
+  Block *block = BlockFor(hash);
+  uint64_t probe_hash = ProbeHash(hash);
+  for (uint32_t probe = 0; probe < NUM_PROBES; probe++) {
+    uint32_t idx = CounterIndex(probe_hash, probe);
+    std::atomic<uint64_t> &word = block->words_[idx / COUNTERS_PER_WORD];
+    uint32_t shift = (idx % COUNTERS_PER_WORD) * 4;
+    uint64_t old_word = word.load(std::memory_order_relaxed);
+    // A saturated counter has lost its exact count and must stay set; zero means the hash was never inserted.
+    while (((old_word >> shift) & COUNTER_MASK) != COUNTER_MASK && ((old_word >> shift) & COUNTER_MASK) != 0 &&
+           !word.compare_exchange_weak(old_word, old_word - (1ULL << shift), std::memory_order_release,
+                                       std::memory_order_relaxed)) {
+    }
+  }
+  size_.fetch_sub(1, std::memory_order_relaxed);
+}
+
+bool CountingBloomFilter::MayContain(uint64_t hash) const {
+  const Block *block = BlockFor(hash);
+  uint64_t probe_hash = ProbeHash(hash);
+  for (uint32_t probe = 0; probe < NUM_PROBES; probe++) {
+    uint32_t idx = CounterIndex(probe_hash, probe);
+    uint64_t word = block->words_[idx / COUNTERS_PER_WORD].load(std::memory_order_acquire);
+    if (((word >> ((idx % COUNTERS_PER_WORD) * 4)) & COUNTER_MASK) == 0) {
+      return false;
+    }
+  }
+  return true;
+}
+
+}  // namespace bustub
@@ -10,8 +10,10 @@
 //
 //===----------------------------------------------------------------------===//
 
+#include <algorithm>
 #include <iostream>
 #include <string>
+#include <unordered_set>
 #include <utility>
 #include <vector>
 
@@ -24,9 +26,30 @@ namespace bustub {
 
 template <typename KeyType, typename ValueType, typename KeyComparator>
 HASH_TABLE_TYPE::ExtendibleHashTable(const std::string &name, BufferPoolManager *buffer_pool_manager,
-                                     const KeyComparator &comparator, HashFunction<KeyType> hash_fn)
+                                     const KeyComparator &comparator, HashFunction<KeyType> hash_fn,
+                                     bool use_membership_filter)
     : buffer_pool_manager_(buffer_pool_manager), comparator_(comparator), hash_fn_(std::move(hash_fn)) {
-  //  implement me!
+  Page *dir_raw = buffer_pool_manager_->NewPage(&directory_page_id_);
+  if (dir_raw == nullptr) {
+    throw Exception(ExceptionType::OUT_OF_MEMORY, "Cannot allocate hash table directory page");
+  }
+  auto *dir_page = reinterpret_cast<HashTableDirectoryPage *>(dir_raw->GetData());
+  dir_page->SetPageId(directory_page_id_);
+
+  page_id_t bucket_page_id;
+  if (buffer_pool_manager_->NewPage(&bucket_page_id) == nullptr) {
+    buffer_pool_manager_->UnpinPage(directory_page_id_, true);
+    throw Exception(ExceptionType::OUT_OF_MEMORY, "Cannot allocate hash table bucket page");
+  }
+  dir_page->SetBucketPageId(0, bucket_page_id);
+  dir_page->SetLocalDepth(0, 0);
+
+  buffer_pool_manager_->UnpinPage(bucket_page_id, true);
+  buffer_pool_manager_->UnpinPage(directory_page_id_, true);
+
+  if (use_membership_filter) {
+    filter_ = std::make_unique<CountingBloomFilter>(BUCKET_ARRAY_SIZE);
+  }
 }
 
 /*****************************************************************************
@@ -46,22 +69,31 @@ uint32_t HASH_TABLE_TYPE::Hash(KeyType key) {
 
 template <typename KeyType, typename ValueType, typename KeyComparator>
 inline uint32_t HASH_TABLE_TYPE::KeyToDirectoryIndex(KeyType key, HashTableDirectoryPage *dir_page) {
-  return 0;
+  return Hash(key) & dir_page->GetGlobalDepthMask();
 }
 
 template <typename KeyType, typename ValueType, typename KeyComparator>
 inline uint32_t HASH_TABLE_TYPE::KeyToPageId(KeyType key, HashTableDirectoryPage *dir_page) {
-  return 0;
+  return dir_page->GetBucketPageId(KeyToDirectoryIndex(key, dir_page));
+}
+
+template <typename KeyType, typename ValueType, typename KeyComparator>
+Page *HASH_TABLE_TYPE::FetchPage(page_id_t page_id) {
+  Page *page = buffer_pool_manager_->FetchPage(page_id);
+  if (page == nullptr) {
+    throw Exception(ExceptionType::OUT_OF_MEMORY, "Cannot fetch hash table page");
+  }
+  return page;
 }
 
 template <typename KeyType, typename ValueType, typename KeyComparator>
 HashTableDirectoryPage *HASH_TABLE_TYPE::FetchDirectoryPage() {
-  return nullptr;
+  return reinterpret_cast<HashTableDirectoryPage *>(FetchPage(directory_page_id_)->GetData());
 }
 
 template <typename KeyType, typename ValueType, typename KeyComparator>
 HASH_TABLE_BUCKET_TYPE *HASH_TABLE_TYPE::FetchBucketPage(page_id_t bucket_page_id) {
-  return nullptr;
+  return reinterpret_cast<HASH_TABLE_BUCKET_TYPE *>(FetchPage(bucket_page_id)->GetData());
 }
 
 /*****************************************************************************
@@ -69,7 +101,26 @@ HASH_TABLE_BUCKET_TYPE *HASH_TABLE_TYPE::FetchBucketPage(page_id_t bucket_page_i
  *****************************************************************************/
 template <typename KeyType, typename ValueType, typename KeyComparator>
 bool HASH_TABLE_TYPE::GetValue(Transaction *transaction, const KeyType &key, std::vector<ValueType> *result) {
-  return false;
+  table_latch_.RLock();
+  // A negative answer from the filter is exact, so absent keys never reach the buffer pool.
+  if (filter_ != nullptr && !filter_->MayContain(hash_fn_.GetHash(key))) {
+    table_latch_.RUnlock();
+    return false;
+  }
+
+  HashTableDirectoryPage *dir_page = FetchDirectoryPage();
+  page_id_t bucket_page_id = KeyToPageId(key, dir_page);
+  Page *bucket_raw = FetchPage(bucket_page_id);
+  auto *bucket = reinterpret_cast<HASH_TABLE_BUCKET_TYPE *>(bucket_raw->GetData());
+
+  bucket_raw->RLatch();
+  bool found = bucket->GetValue(key, comparator_, result);
+  bucket_raw->RUnlatch();
+
+  buffer_pool_manager_->UnpinPage(bucket_page_id, false);
+  buffer_pool_manager_->UnpinPage(directory_page_id_, false);
+  table_latch_.RUnlock();
+  return found;
 }
 
 /*****************************************************************************
@@ -77,12 +128,122 @@ bool HASH_TABLE_TYPE::GetValue(Transaction *transaction, const KeyType &key, std
  *****************************************************************************/
 template <typename KeyType, typename ValueType, typename KeyComparator>
 bool HASH_TABLE_TYPE::Insert(Transaction *transaction, const KeyType &key, const ValueType &value) {
-  return false;
+  table_latch_.RLock();
+  HashTableDirectoryPage *dir_page = FetchDirectoryPage();
+  page_id_t bucket_page_id = KeyToPageId(key, dir_page);
+  Page *bucket_raw = FetchPage(bucket_page_id);
+  auto *bucket = reinterpret_cast<HASH_TABLE_BUCKET_TYPE *>(bucket_raw->GetData());
+
+  bucket_raw->WLatch();
+  if (bucket->IsFull()) {
+    bucket_raw->WUnlatch();
+    buffer_pool_manager_->UnpinPage(bucket_page_id, false);
+    buffer_pool_manager_->UnpinPage(directory_page_id_, false);
+    table_latch_.RUnlock();
+    return SplitInsert(transaction, key, value);
+  }
+  bool inserted = bucket->Insert(key, value, comparator_);
+  bucket_raw->WUnlatch();
+
+  buffer_pool_manager_->UnpinPage(bucket_page_id, inserted);
+  buffer_pool_manager_->UnpinPage(directory_page_id_, false);
+
+  bool filter_full = false;
+  if (inserted && filter_ != nullptr) {
+    filter_->Insert(hash_fn_.GetHash(key));
+    filter_full = filter_->GetSize() > filter_->GetCapacity();
+  }
+  table_latch_.RUnlock();
+
+  if (filter_full) {
+    RebuildFilter();
+  }
+  return inserted;
 }
 
 template <typename KeyType, typename ValueType, typename KeyComparator>
 bool HASH_TABLE_TYPE::SplitInsert(Transaction *transaction, const KeyType &key, const ValueType &value) {
-  return false;
+  table_latch_.WLock();
+  HashTableDirectoryPage *dir_page = FetchDirectoryPage();
+  bool dir_dirty = false;
+  bool inserted = false;
+
+  while (true) {
+    uint32_t bucket_idx = KeyToDirectoryIndex(key, dir_page);
+    page_id_t bucket_page_id = dir_page->GetBucketPageId(bucket_idx);
+    HASH_TABLE_BUCKET_TYPE *bucket = FetchBucketPage(bucket_page_id);
+
+    if (!bucket->IsFull()) {
+      inserted = bucket->Insert(key, value, comparator_);
+      buffer_pool_manager_->UnpinPage(bucket_page_id, inserted);
+      break;
+    }
+
+    // A full bucket has no free slot, so Insert cannot be used to detect a duplicate.
+    bool duplicate = false;
+    for (uint32_t i = 0; i < BUCKET_ARRAY_SIZE && !duplicate; i++) {
+      duplicate = comparator_(key, bucket->KeyAt(i)) == 0 && value == bucket->ValueAt(i);
+    }
+    if (duplicate) {
+      buffer_pool_manager_->UnpinPage(bucket_page_id, false);
+      break;
+    }
+
+    if (dir_page->GetLocalDepth(bucket_idx) == dir_page->GetGlobalDepth()) {
+      if (dir_page->Size() * 2 > DIRECTORY_ARRAY_SIZE) {
+        // The directory cannot grow any further.
+        buffer_pool_manager_->UnpinPage(bucket_page_id, false);
+        break;
+      }
+      dir_page->IncrGlobalDepth();
+    }
+
+    page_id_t image_page_id;
+    Page *image_raw = buffer_pool_manager_->NewPage(&image_page_id);
+    if (image_raw == nullptr) {
+      buffer_pool_manager_->UnpinPage(bucket_page_id, false);
+      break;
+    }
+    auto *image = reinterpret_cast<HASH_TABLE_BUCKET_TYPE *>(image_raw->GetData());
+
+    // Every directory slot that pointed at the full bucket goes one level deeper; those with the new high bit set
+    // now point at the split image.
+    uint32_t new_high_bit = 1U << dir_page->GetLocalDepth(bucket_idx);
+    for (uint32_t i = 0; i < dir_page->Size(); i++) {
+      if (dir_page->GetBucketPageId(i) == bucket_page_id) {
+        dir_page->IncrLocalDepth(i);
+        if ((i & new_high_bit) != (bucket_idx & new_high_bit)) {
+          dir_page->SetBucketPageId(i, image_page_id);
+        }
+      }
+    }
+    dir_dirty = true;
+
+    for (uint32_t i = 0; i < BUCKET_ARRAY_SIZE; i++) {
+      KeyType moved_key = bucket->KeyAt(i);
+      if (dir_page->GetBucketPageId(KeyToDirectoryIndex(moved_key, dir_page)) == image_page_id) {
+        image->Insert(moved_key, bucket->ValueAt(i), comparator_);
+        bucket->RemoveAt(i);
+      }
+    }
+
+    buffer_pool_manager_->UnpinPage(image_page_id, true);
+    buffer_pool_manager_->UnpinPage(bucket_page_id, true);
+  }
+
+  buffer_pool_manager_->UnpinPage(directory_page_id_, dir_dirty);
+
+  bool filter_full = false;
+  if (inserted && filter_ != nullptr) {
+    filter_->Insert(hash_fn_.GetHash(key));
+    filter_full = filter_->GetSize() > filter_->GetCapacity();
+  }
+  table_latch_.WUnlock();
+
+  if (filter_full) {
+    RebuildFilter();
+  }
+  return inserted;
 }
 
 /*****************************************************************************
@@ -90,14 +251,117 @@ bool HASH_TABLE_TYPE::SplitInsert(Transaction *transaction, const KeyType &key,
  *****************************************************************************/
 template <typename KeyType, typename ValueType, typename KeyComparator>
 bool HASH_TABLE_TYPE::Remove(Transaction *transaction, const KeyType &key, const ValueType &value) {
-  return false;
+  table_latch_.RLock();
+  HashTableDirectoryPage *dir_page = FetchDirectoryPage();
+  page_id_t bucket_page_id = KeyToPageId(key, dir_page);
+  Page *bucket_raw = FetchPage(bucket_page_id);
+  auto *bucket = reinterpret_cast<HASH_TABLE_BUCKET_TYPE *>(bucket_raw->GetData());
+
+  bucket_raw->WLatch();
+  bool removed = bucket->Remove(key, value, comparator_);
+  bool empty = bucket->IsEmpty();
+  bucket_raw->WUnlatch();
+
+  buffer_pool_manager_->UnpinPage(bucket_page_id, removed);
+  buffer_pool_manager_->UnpinPage(directory_page_id_, false);
+  if (removed && filter_ != nullptr) {
+    filter_->Remove(hash_fn_.GetHash(key));
+  }
+  table_latch_.RUnlock();
+
+  if (removed && empty) {
+    Merge(transaction, key, value);
+  }
+  return removed;
 }
 
 /*****************************************************************************
  * MERGE
  *****************************************************************************/
 template <typename KeyType, typename ValueType, typename KeyComparator>
-void HASH_TABLE_TYPE::Merge(Transaction *transaction, const KeyType &key, const ValueType &value) {}
+void HASH_TABLE_TYPE::Merge(Transaction *transaction, const KeyType &key, const ValueType &value) {
+  table_latch_.WLock();
+  HashTableDirectoryPage *dir_page = FetchDirectoryPage();
+  uint32_t bucket_idx = KeyToDirectoryIndex(key, dir_page);
+  bool dir_dirty = false;
+
+  // Keep folding the bucket into its split image for as long as one of the pair is empty, so an empty sibling
+  // left behind by an earlier remove is reclaimed too.
+  while (true) {
+    uint32_t local_depth = dir_page->GetLocalDepth(bucket_idx);
+    uint32_t image_idx = dir_page->GetSplitImageIndex(bucket_idx);
+    if (local_depth == 0 || dir_page->GetLocalDepth(image_idx) != local_depth) {
+      break;
+    }
+
+    page_id_t bucket_page_id = dir_page->GetBucketPageId(bucket_idx);
+    page_id_t image_page_id = dir_page->GetBucketPageId(image_idx);
+    HASH_TABLE_BUCKET_TYPE *bucket = FetchBucketPage(bucket_page_id);
+    HASH_TABLE_BUCKET_TYPE *image = FetchBucketPage(image_page_id);
+    bool bucket_empty = bucket->IsEmpty();
+    bool image_empty = image->IsEmpty();
+    buffer_pool_manager_->UnpinPage(bucket_page_id, false);
+    buffer_pool_manager_->UnpinPage(image_page_id, false);
+    if (!bucket_empty && !image_empty) {
+      break;
+    }
+
+    page_id_t empty_page_id = bucket_empty ? bucket_page_id : image_page_id;
+    page_id_t kept_page_id = bucket_empty ? image_page_id : bucket_page_id;
+    for (uint32_t i = 0; i < dir_page->Size(); i++) {
+      page_id_t page_id = dir_page->GetBucketPageId(i);
+      if (page_id == empty_page_id || page_id == kept_page_id) {
+        dir_page->SetBucketPageId(i, kept_page_id);
+        dir_page->DecrLocalDepth(i);
+      }
+    }
+    buffer_pool_manager_->DeletePage(empty_page_id);
+    dir_dirty = true;
+
+    while (dir_page->CanShrink()) {
+      dir_page->DecrGlobalDepth();
+    }
+    bucket_idx &= dir_page->GetGlobalDepthMask();
+  }
+
+  buffer_pool_manager_->UnpinPage(directory_page_id_, dir_dirty);
+  table_latch_.WUnlock();
+}
+
+/*****************************************************************************
+ * MEMBERSHIP FILTER
+ *****************************************************************************/
+template <typename KeyType, typename ValueType, typename KeyComparator>
+void HASH_TABLE_TYPE::RebuildFilter() {
+  if (filter_ == nullptr) {
+    return;
+  }
+
+  table_latch_.WLock();
+  HashTableDirectoryPage *dir_page = FetchDirectoryPage();
+  std::vector<uint64_t> hashes;
+  std::unordered_set<page_id_t> visited;
+  for (uint32_t i = 0; i < dir_page->Size(); i++) {
+    page_id_t bucket_page_id = dir_page->GetBucketPageId(i);
+    if (!visited.insert(bucket_page_id).second) {
+      continue;
+    }
+    HASH_TABLE_BUCKET_TYPE *bucket = FetchBucketPage(bucket_page_id);
+    for (uint32_t slot = 0; slot < BUCKET_ARRAY_SIZE && bucket->IsOccupied(slot); slot++) {
+      if (bucket->IsReadable(slot)) {
+        hashes.push_back(hash_fn_.GetHash(bucket->KeyAt(slot)));
+      }
+    }
+    buffer_pool_manager_->UnpinPage(bucket_page_id, false);
+  }
+  buffer_pool_manager_->UnpinPage(directory_page_id_, false);
+
+  filter_->Reset(std::max<size_t>(hashes.size() * 2, BUCKET_ARRAY_SIZE));
+  for (auto hash : hashes) {
+    filter_->Insert(hash);
+  }
+  table_latch_.WUnlock();
+}
 
 /*****************************************************************************
  * GETGLOBALDEPTH - DO NOT TOUCH
@@ -10,6 +10,7 @@
 //
 //===----------------------------------------------------------------------===//
 
+#include <algorithm>
 #include <iostream>
 #include <string>
 #include <utility>
@@ -22,47 +23,227 @@
 
 namespace bustub {
 
+namespace {
+
+// the number of block page ids that fit in a header page
+constexpr size_t MAX_NUM_BLOCKS = (PAGE_SIZE - sizeof(HashTableHeaderPage)) / sizeof(page_id_t);
+
+}  // namespace
+
 template <typename KeyType, typename ValueType, typename KeyComparator>
-HASH_TABLE_TYPE::LinearProbeHashTable(const std::string &name, BufferPoolManager *buffer_pool_manager,
-                                      const KeyComparator &comparator, size_t num_buckets,
-                                      HashFunction<KeyType> hash_fn)
-    : buffer_pool_manager_(buffer_pool_manager), comparator_(comparator), hash_fn_(std::move(hash_fn)) {}
+LINEAR_PROBE_HASH_TABLE_TYPE::LinearProbeHashTable(const std::string &name, BufferPoolManager *buffer_pool_manager,
+                                                   const KeyComparator &comparator, size_t num_buckets,
+                                                   HashFunction<KeyType> hash_fn)
+    : buffer_pool_manager_(buffer_pool_manager), comparator_(comparator), hash_fn_(std::move(hash_fn)) {
+  header_page_id_ = NewTable(num_buckets);
+}
 
 /*****************************************************************************
  * SEARCH
  *****************************************************************************/
 template <typename KeyType, typename ValueType, typename KeyComparator>
-bool HASH_TABLE_TYPE::GetValue(Transaction *transaction, const KeyType &key, std::vector<ValueType> *result) {
-  return false;
+bool LINEAR_PROBE_HASH_TABLE_TYPE::GetValue(Transaction *transaction, const KeyType &key,
+                                            std::vector<ValueType> *result) {
+  table_latch_.RLock();
+  size_t size = result->size();
+  // a bucket that was never occupied ends the probe sequence of every key that hashes before it
+  Probe(header_page_id_, key, false, [&](HASH_TABLE_BLOCK_TYPE *block, slot_offset_t bucket_ind) {
+    if (!block->IsOccupied(bucket_ind)) {
+      return true;
+    }
+    if (block->IsReadable(bucket_ind) && comparator_(block->KeyAt(bucket_ind), key) == 0) {
+      result->push_back(block->ValueAt(bucket_ind));
+    }
+    return false;
+  });
+  table_latch_.RUnlock();
+  return result->size() > size;
 }
 /*****************************************************************************
  * INSERTION
  *****************************************************************************/
 template <typename KeyType, typename ValueType, typename KeyComparator>
-bool HASH_TABLE_TYPE::Insert(Transaction *transaction, const KeyType &key, const ValueType &value) {
-  return false;
+bool LINEAR_PROBE_HASH_TABLE_TYPE::Insert(Transaction *transaction, const KeyType &key, const ValueType &value) {
+  table_latch_.RLock();
+  bool inserted;
+  while (!InsertInto(header_page_id_, key, value, &inserted)) {
+    page_id_t header_page_id = header_page_id_;
+    table_latch_.RUnlock();
+    table_latch_.WLock();
+    // another insert may have rebuilt the table in the meantime
+    if (header_page_id_ == header_page_id) {
+      Grow(NumBuckets());
+    }
+    table_latch_.WUnlock();
+    table_latch_.RLock();
+  }
+  table_latch_.RUnlock();
+  return inserted;
+}
+
+template <typename KeyType, typename ValueType, typename KeyComparator>
+bool LINEAR_PROBE_HASH_TABLE_TYPE::InsertInto(page_id_t header_page_id, const KeyType &key, const ValueType &value,
+                                              bool *inserted) {
+  *inserted = false;
+  return Probe(header_page_id, key, true, [&](HASH_TABLE_BLOCK_TYPE *block, slot_offset_t bucket_ind) {
+    if (block->IsReadable(bucket_ind)) {
+      return comparator_(block->KeyAt(bucket_ind), key) == 0 && block->ValueAt(bucket_ind) == value;
+    }
+    // tombstones are skipped, and a concurrent insert may claim the bucket first
+    *inserted = !block->IsOccupied(bucket_ind) && block->Insert(bucket_ind, key, value);
+    return *inserted;
+  });
 }
 
 /*****************************************************************************
  * REMOVE
  *****************************************************************************/
 template <typename KeyType, typename ValueType, typename KeyComparator>
-bool HASH_TABLE_TYPE::Remove(Transaction *transaction, const KeyType &key, const ValueType &value) {
-  return false;
+bool LINEAR_PROBE_HASH_TABLE_TYPE::Remove(Transaction *transaction, const KeyType &key, const ValueType &value) {
+  table_latch_.RLock();
+  bool removed = false;
+  Probe(header_page_id_, key, true, [&](HASH_TABLE_BLOCK_TYPE *block, slot_offset_t bucket_ind) {
+    if (!block->IsOccupied(bucket_ind)) {
+      return true;
+    }
+    if (block->IsReadable(bucket_ind) && comparator_(block->KeyAt(bucket_ind), key) == 0 &&
+        block->ValueAt(bucket_ind) == value) {
+      block->Remove(bucket_ind);
+      removed = true;
+    }
+    return removed;
+  });
+  table_latch_.RUnlock();
+  return removed;
 }
 
 /*****************************************************************************
  * RESIZE
  *****************************************************************************/
 template <typename KeyType, typename ValueType, typename KeyComparator>
-void HASH_TABLE_TYPE::Resize(size_t initial_size) {}
+void LINEAR_PROBE_HASH_TABLE_TYPE::Resize(size_t initial_size) {
+  table_latch_.WLock();
+  Grow(2 * initial_size);
+  table_latch_.WUnlock();
+}
+
+template <typename KeyType, typename ValueType, typename KeyComparator>
+void LINEAR_PROBE_HASH_TABLE_TYPE::Grow(size_t num_buckets) {
+  auto *header = reinterpret_cast<HashTableHeaderPage *>(FetchPage(header_page_id_)->GetData());
+  // a table filled up by tombstones is rebuilt at the same size; one filled up by entries doubles
+  size_t num_entries = 0;
+  for (size_t i = 0; i < header->NumBlocks(); i++) {
+    page_id_t block_page_id = header->GetBlockPageId(i);
+    auto *block = reinterpret_cast<HASH_TABLE_BLOCK_TYPE *>(FetchPage(block_page_id)->GetData());
+    for (slot_offset_t bucket_ind = 0; bucket_ind < BLOCK_ARRAY_SIZE; bucket_ind++) {
+      num_entries += block->IsReadable(bucket_ind) ? 1 : 0;
+    }
+    buffer_pool_manager_->UnpinPage(block_page_id, false);
+  }
+
+  page_id_t new_header_page_id = NewTable(std::max(num_buckets, 2 * num_entries));
+  bool inserted;
+  for (size_t i = 0; i < header->NumBlocks(); i++) {
+    page_id_t block_page_id = header->GetBlockPageId(i);
+    auto *block = reinterpret_cast<HASH_TABLE_BLOCK_TYPE *>(FetchPage(block_page_id)->GetData());
+    for (slot_offset_t bucket_ind = 0; bucket_ind < BLOCK_ARRAY_SIZE; bucket_ind++) {
+      if (block->IsReadable(bucket_ind)) {
+        InsertInto(new_header_page_id, block->KeyAt(bucket_ind), block->ValueAt(bucket_ind), &inserted);
+      }
+    }
+    buffer_pool_manager_->UnpinPage(block_page_id, false);
+    buffer_pool_manager_->DeletePage(block_page_id);
+  }
+  buffer_pool_manager_->UnpinPage(header_page_id_, false);
+  buffer_pool_manager_->DeletePage(header_page_id_);
+  header_page_id_ = new_header_page_id;
+}
+
+template <typename KeyType, typename ValueType, typename KeyComparator>
+page_id_t LINEAR_PROBE_HASH_TABLE_TYPE::NewTable(size_t num_buckets) {
+  size_t num_blocks = std::max<size_t>(1, (num_buckets + BLOCK_ARRAY_SIZE - 1) / BLOCK_ARRAY_SIZE);
+  if (num_blocks > MAX_NUM_BLOCKS) {
+    throw Exception(ExceptionType::OUT_OF_MEMORY, "Linear probe hash table cannot grow any further");
+  }
+  page_id_t header_page_id;
+  Page *page = buffer_pool_manager_->NewPage(&header_page_id);
+  if (page == nullptr) {
+    throw Exception(ExceptionType::OUT_OF_MEMORY, "Cannot allocate hash table header page");
+  }
+  // new pages are zeroed, so every block starts out with no occupied buckets
+  auto *header = reinterpret_cast<HashTableHeaderPage *>(page->GetData());
+  header->SetPageId(header_page_id);
+  header->SetSize(num_blocks * BLOCK_ARRAY_SIZE);
+  for (size_t i = 0; i < num_blocks; i++) {
+    page_id_t block_page_id;
+    if (buffer_pool_manager_->NewPage(&block_page_id) == nullptr) {
+      throw Exception(ExceptionType::OUT_OF_MEMORY, "Cannot allocate hash table block page");
+    }
+    header->AddBlockPageId(block_page_id);
+    buffer_pool_manager_->UnpinPage(block_page_id, true);
+  }
+  buffer_pool_manager_->UnpinPage(header_page_id, true);
+  return header_page_id;
+}
+
+template <typename KeyType, typename ValueType, typename KeyComparator>
+template <typename Visitor>
+bool LINEAR_PROBE_HASH_TABLE_TYPE::Probe(page_id_t header_page_id, const KeyType &key, bool for_write,
+                                         Visitor &&visit) {
+  auto *header = reinterpret_cast<HashTableHeaderPage *>(FetchPage(header_page_id)->GetData());
+  size_t size = header->GetSize();
+  size_t start = hash_fn_.GetHash(key) % size;
+  bool stopped = false;
+  for (size_t i = 0; i < size && !stopped;) {
+    // visit the rest of one block at a time
+    size_t bucket = (start + i) % size;
+    page_id_t block_page_id = header->GetBlockPageId(bucket / BLOCK_ARRAY_SIZE);
+    Page *page = FetchPage(block_page_id);
+    auto *block = reinterpret_cast<HASH_TABLE_BLOCK_TYPE *>(page->GetData());
+    // an insert's claimed bucket is only readable once its pair is written; until then, a writer of the same pair
+    // that is not held off would take it for a tombstone and claim the next bucket too
+    if (for_write) {
+      page->WLatch();
+    }
+    for (auto bucket_ind = static_cast<slot_offset_t>(bucket % BLOCK_ARRAY_SIZE);
+         bucket_ind < BLOCK_ARRAY_SIZE && i < size && !stopped; bucket_ind++, i++) {
+      stopped = visit(block, bucket_ind);
+    }
+    if (for_write) {
+      page->WUnlatch();
+    }
+    buffer_pool_manager_->UnpinPage(block_page_id, for_write);
+  }
+  buffer_pool_manager_->UnpinPage(header_page_id, false);
+  return stopped;
+}
+
+template <typename KeyType, typename ValueType, typename KeyComparator>
+Page *LINEAR_PROBE_HASH_TABLE_TYPE::FetchPage(page_id_t page_id) {
+  Page *page = buffer_pool_manager_->FetchPage(page_id);
+  if (page == nullptr) {
+    throw Exception(ExceptionType::OUT_OF_MEMORY, "Cannot fetch hash table page");
+  }
+  return page;
+}
 
 /*****************************************************************************
  * GETSIZE
  *****************************************************************************/
 template <typename KeyType, typename ValueType, typename KeyComparator>
-size_t HASH_TABLE_TYPE::GetSize() {
-  return 0;
+size_t LINEAR_PROBE_HASH_TABLE_TYPE::GetSize() {
+  table_latch_.RLock();
+  size_t size = NumBuckets();
+  table_latch_.RUnlock();
+  return size;
+}
+
+template <typename KeyType, typename ValueType, typename KeyComparator>
+size_t LINEAR_PROBE_HASH_TABLE_TYPE::NumBuckets() {
+  auto *header = reinterpret_cast<HashTableHeaderPage *>(FetchPage(header_page_id_)->GetData());
+  size_t size = header->GetSize();
+  buffer_pool_manager_->UnpinPage(header_page_id_, false);
+  return size;
 }
 
 template class LinearProbeHashTable<int, int, IntComparator>;
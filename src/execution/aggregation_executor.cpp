@@ -1,29 +1,424 @@
-//===----------------------------------------------------------------------===//
-//
-//                         BusTub
-//
-// aggregation_executor.cpp
-//
-// Identification: src/execution/aggregation_executor.cpp
-//
-// Copyright (c) 2015-2021, Carnegie Mellon University Database Group
-//
-//===----------------------------------------------------------------------===//
-#include <memory>
-#include <vector>
-
-#include "execution/executors/aggregation_executor.h"
-
-namespace bustub {
-
-AggregationExecutor::AggregationExecutor(ExecutorContext *exec_ctx, const AggregationPlanNode *plan,
-                                         std::unique_ptr<AbstractExecutor> &&child)
-    : AbstractExecutor(exec_ctx) {}
-
-void AggregationExecutor::Init() {}
-
-bool AggregationExecutor::Next(Tuple *tuple, RID *rid) { return false; }
-
-const AbstractExecutor *AggregationExecutor::GetChildExecutor() const { return child_.get(); }
-
-}  // namespace bustub
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// aggregation_executor.cpp
+//
+// Identification: src/execution/aggregation_executor.cpp
+//
+// Copyright (c) 2015-2021, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+#include <algorithm>
+#include <cstring>
+#include <memory>
+#include <vector>
+
+#include "common/exception.h"
+#include "execution/executors/aggregation_executor.h"
+
+namespace bustub {
+
+namespace {
+
+/** @return true if the type is one of the integer types */
+bool IsIntegerType(TypeId type) {
+  return type == TypeId::TINYINT || type == TypeId::SMALLINT || type == TypeId::INTEGER || type == TypeId::BIGINT;
+}
+
+/** @return the high bits of a hash, which a slot keeps to skip most groups without comparing their keys */
+uint32_t HashTag(hash_t hash) { return static_cast<uint32_t>(static_cast<uint64_t>(hash) >> 32); }
+
+/**
+ * Converts a column of integer keys of one type into the key words of the rows, flagging the null ones.
+ * @param key the position of the key among the group-by keys
+ * @param key_words the number of key words of a row, the first of them its bitmap of null keys
+ */
+template <typename T>
+void ReadKeys(const std::vector<Value> &column, const std::vector<uint32_t> &rows, uint32_t key, uint32_t key_words,
+              uint64_t *words) {
+  for (size_t i = 0; i < rows.size(); i++, words += key_words) {
+    const Value &value = column[rows[i]];
+    if (value.IsNull()) {
+      words[0] |= 1ULL << key;
+      words[1 + key] = 0;
+    } else {
+      words[1 + key] = static_cast<uint64_t>(static_cast<int64_t>(value.GetAs<T>()));
+    }
+  }
+}
+
+/** @return a value of an integer type */
+Value MakeIntegerValue(TypeId type, int64_t integer) {
+  switch (type) {
+    case TypeId::TINYINT:
+      return ValueFactory::GetTinyIntValue(static_cast<int8_t>(integer));
+    case TypeId::SMALLINT:
+      return ValueFactory::GetSmallIntValue(static_cast<int16_t>(integer));
+    case TypeId::INTEGER:
+      return ValueFactory::GetIntegerValue(static_cast<int32_t>(integer));
+    default:
+      return ValueFactory::GetBigIntValue(integer);
+  }
+}
+
+}  // namespace
+
+bool FlatAggregationTable::CanAggregate(const AggregationPlanNode *plan) {
+  const auto &group_bys = plan->GetGroupBys();
+  const auto &aggregates = plan->GetAggregates();
+  // one bit per key and per aggregate in the bitmaps of nulls
+  if (group_bys.size() > 64 || aggregates.size() > 64) {
+    return false;
+  }
+  if (!std::all_of(group_bys.begin(), group_bys.end(),
+                   [](const AbstractExpression *expr) { return IsIntegerType(expr->GetReturnType()); })) {
+    return false;
+  }
+  // a count ignores its input, and the other aggregates of INTEGER values are INTEGER values too
+  for (uint32_t i = 0; i < aggregates.size(); i++) {
+    if (plan->GetAggregateTypes()[i] != AggregationType::CountAggregate &&
+        aggregates[i]->GetReturnType() != TypeId::INTEGER) {
+      return false;
+    }
+  }
+  return true;
+}
+
+FlatAggregationTable::FlatAggregationTable(const AggregationPlanNode *plan, uint32_t partition_bits)
+    : agg_types_(plan->GetAggregateTypes()), partition_bits_(partition_bits), partitions_(1U << partition_bits) {
+  for (const auto *expr : plan->GetGroupBys()) {
+    key_types_.push_back(expr->GetReturnType());
+  }
+  key_words_ = 1 + static_cast<uint32_t>(key_types_.size());
+  agg_nulls_word_ = KEY_WORD + key_words_;
+  entry_words_ = agg_nulls_word_ + 1 + static_cast<uint32_t>(agg_types_.size());
+}
+
+void FlatAggregationTable::Clear() {
+  for (auto &partition : partitions_) {
+    partition.blocks_.clear();
+    partition.slots_.clear();
+    partition.num_groups_ = 0;
+  }
+}
+
+void FlatAggregationTable::InsertBatch(const std::vector<std::vector<Value>> &group_by_columns,
+                                       const std::vector<std::vector<Value>> &aggregate_columns,
+                                       const std::vector<uint32_t> &rows) {
+  // the keys of every row, a column at a time
+  batch_keys_.assign(rows.size() * key_words_, 0);
+  for (uint32_t key = 0; key < key_types_.size(); key++) {
+    switch (key_types_[key]) {
+      case TypeId::TINYINT:
+        ReadKeys<int8_t>(group_by_columns[key], rows, key, key_words_, batch_keys_.data());
+        break;
+      case TypeId::SMALLINT:
+        ReadKeys<int16_t>(group_by_columns[key], rows, key, key_words_, batch_keys_.data());
+        break;
+      case TypeId::INTEGER:
+        ReadKeys<int32_t>(group_by_columns[key], rows, key, key_words_, batch_keys_.data());
+        break;
+      default:
+        ReadKeys<int64_t>(group_by_columns[key], rows, key, key_words_, batch_keys_.data());
+        break;
+    }
+  }
+
+  // their hashes, and the entries of their groups
+  batch_hashes_.resize(rows.size());
+  batch_entries_.resize(rows.size());
+  for (size_t i = 0; i < rows.size(); i++) {
+    const uint64_t *key = &batch_keys_[i * key_words_];
+    hash_t hash = HashUtil::HashInt(key[0]);
+    for (uint32_t word = 1; word < key_words_; word++) {
+      hash = HashUtil::CombineHashes(hash, HashUtil::HashInt(key[word]));
+    }
+    batch_hashes_[i] = hash;
+  }
+  for (size_t i = 0; i < rows.size(); i++) {
+    hash_t hash = batch_hashes_[i];
+    batch_entries_[i] = FindOrInsert(&partitions_[GetPartition(hash)], hash, &batch_keys_[i * key_words_]);
+  }
+
+  // every aggregate, a column at a time
+  for (uint32_t agg = 0; agg < agg_types_.size(); agg++) {
+    const std::vector<Value> &column = aggregate_columns[agg];
+    uint32_t acc_word = agg_nulls_word_ + 1 + agg;
+    uint64_t null_bit = 1ULL << agg;
+    AggregationType agg_type = agg_types_[agg];
+    if (agg_type == AggregationType::CountAggregate) {
+      for (uint64_t *entry : batch_entries_) {
+        entry[acc_word]++;
+      }
+      continue;
+    }
+    for (size_t i = 0; i < rows.size(); i++) {
+      const Value &value = column[rows[i]];
+      uint64_t *entry = batch_entries_[i];
+      // a null input makes the aggregate null for good
+      if (value.IsNull()) {
+        entry[agg_nulls_word_] |= null_bit;
+        continue;
+      }
+      auto input = static_cast<int64_t>(value.GetAs<int32_t>());
+      auto acc = static_cast<int64_t>(entry[acc_word]);
+      if (agg_type == AggregationType::SumAggregate) {
+        acc += input;
+      } else if (agg_type == AggregationType::MinAggregate) {
+        acc = std::min(acc, input);
+      } else {
+        acc = std::max(acc, input);
+      }
+      entry[acc_word] = static_cast<uint64_t>(acc);
+    }
+  }
+}
+
+void FlatAggregationTable::MergePartition(uint32_t partition, const FlatAggregationTable &other) {
+  const Partition &from = other.partitions_[partition];
+  Partition *to = &partitions_[partition];
+  for (uint32_t group = 0; group < from.num_groups_; group++) {
+    const uint64_t *other_entry = other.GetEntry(from, group);
+    uint64_t *entry = FindOrInsert(to, other_entry[HASH_WORD], other_entry + KEY_WORD);
+    entry[agg_nulls_word_] |= other_entry[agg_nulls_word_];
+    for (uint32_t agg = 0; agg < agg_types_.size(); agg++) {
+      uint32_t acc_word = agg_nulls_word_ + 1 + agg;
+      auto acc = static_cast<int64_t>(entry[acc_word]);
+      auto partial = static_cast<int64_t>(other_entry[acc_word]);
+      switch (agg_types_[agg]) {
+        case AggregationType::CountAggregate:
+        case AggregationType::SumAggregate:
+          acc += partial;
+          break;
+        case AggregationType::MinAggregate:
+          acc = std::min(acc, partial);
+          break;
+        case AggregationType::MaxAggregate:
+          acc = std::max(acc, partial);
+          break;
+      }
+      entry[acc_word] = static_cast<uint64_t>(acc);
+    }
+  }
+}
+
+void FlatAggregationTable::GetGroup(uint32_t partition, uint32_t group, std::vector<Value> *group_bys,
+                                    std::vector<Value> *aggregates) const {
+  const uint64_t *entry = GetEntry(partitions_[partition], group);
+  group_bys->clear();
+  for (uint32_t key = 0; key < key_types_.size(); key++) {
+    if ((entry[KEY_WORD] & (1ULL << key)) != 0) {
+      group_bys->push_back(ValueFactory::GetNullValueByType(key_types_[key]));
+    } else {
+      group_bys->push_back(MakeIntegerValue(key_types_[key], static_cast<int64_t>(entry[KEY_WORD + 1 + key])));
+    }
+  }
+  aggregates->clear();
+  for (uint32_t agg = 0; agg < agg_types_.size(); agg++) {
+    if ((entry[agg_nulls_word_] & (1ULL << agg)) != 0) {
+      aggregates->push_back(ValueFactory::GetNullValueByType(TypeId::INTEGER));
+      continue;
+    }
+    // the accumulators are wider than the INTEGER values they stand for
+    auto acc = static_cast<int64_t>(entry[agg_nulls_word_ + 1 + agg]);
+    if (acc < BUSTUB_INT32_MIN || acc > BUSTUB_INT32_MAX) {
+      throw Exception(ExceptionType::OUT_OF_RANGE, "Numeric value out of range.");
+    }
+    aggregates->push_back(ValueFactory::GetIntegerValue(static_cast<int32_t>(acc)));
+  }
+}
+
+uint64_t *FlatAggregationTable::FindOrInsert(Partition *partition, hash_t hash, const uint64_t *key) {
+  if (2 * (static_cast<size_t>(partition->num_groups_) + 1) > partition->slots_.size()) {
+    Grow(partition);
+  }
+  size_t mask = partition->slots_.size() - 1;
+  for (size_t slot = hash & mask;; slot = (slot + 1) & mask) {
+    Slot &entry = partition->slots_[slot];
+    if (entry.group_ == NO_GROUP) {
+      uint32_t group = partition->num_groups_++;
+      if ((group >> BLOCK_ENTRIES_BITS) == partition->blocks_.size()) {
+        partition->blocks_.push_back(std::make_unique<uint64_t[]>(static_cast<size_t>(entry_words_)
+                                                                  << BLOCK_ENTRIES_BITS));
+      }
+      uint64_t *words = GetEntry(*partition, group);
+      words[HASH_WORD] = hash;
+      memcpy(words + KEY_WORD, key, key_words_ * sizeof(uint64_t));
+      words[agg_nulls_word_] = 0;
+      for (uint32_t agg = 0; agg < agg_types_.size(); agg++) {
+        int64_t initial = 0;
+        if (agg_types_[agg] == AggregationType::MinAggregate) {
+          initial = std::numeric_limits<int64_t>::max();
+        } else if (agg_types_[agg] == AggregationType::MaxAggregate) {
+          initial = std::numeric_limits<int64_t>::min();
+        }
+        words[agg_nulls_word_ + 1 + agg] = static_cast<uint64_t>(initial);
+      }
+      entry = Slot{HashTag(hash), group};
+      return words;
+    }
+    if (entry.hash_tag_ == HashTag(hash)) {
+      uint64_t *words = GetEntry(*partition, entry.group_);
+      if (memcmp(words + KEY_WORD, key, key_words_ * sizeof(uint64_t)) == 0) {
+        return words;
+      }
+    }
+  }
+}
+
+void FlatAggregationTable::Grow(Partition *partition) {
+  partition->slots_.assign(std::max<size_t>(16, 2 * partition->slots_.size()), Slot{0, NO_GROUP});
+  size_t mask = partition->slots_.size() - 1;
+  for (uint32_t group = 0; group < partition->num_groups_; group++) {
+    hash_t hash = GetEntry(*partition, group)[HASH_WORD];
+    size_t slot = hash & mask;
+    while (partition->slots_[slot].group_ != NO_GROUP) {
+      slot = (slot + 1) & mask;
+    }
+    partition->slots_[slot] = Slot{HashTag(hash), group};
+  }
+}
+
+AggregationExecutor::AggregationExecutor(ExecutorContext *exec_ctx, const AggregationPlanNode *plan,
+                                         std::unique_ptr<AbstractExecutor> &&child)
+    : BatchExecutor(exec_ctx),
+      plan_(plan),
+      child_(std::move(child)),
+      aht_(plan->GetAggregates(), plan->GetAggregateTypes()),
+      output_aht_(&aht_),
+      aht_iterator_(aht_.Begin()) {}
+
+void AggregationExecutor::Init() {
+  BatchExecutor::Init();
+  child_->Init();
+
+  aht_.Clear();
+  ParallelState *parallel_state = GetExecutorContext()->GetParallelState();
+  flat_ = FlatAggregationTable::CanAggregate(plan_);
+  flat_aht_.reset();
+  if (flat_) {
+    uint32_t partition_bits = parallel_state != nullptr ? FlatAggregationTable::PARALLEL_PARTITION_BITS : 0;
+    flat_aht_ = std::make_unique<FlatAggregationTable>(plan_, partition_bits);
+  }
+  flat_outputs_.clear();
+  flat_output_ = 0;
+  flat_group_ = 0;
+  const auto &group_by_exprs = plan_->GetGroupBys();
+  const auto &aggregate_exprs = plan_->GetAggregates();
+  std::vector<std::vector<Value>> group_by_columns(group_by_exprs.size());
+  std::vector<std::vector<Value>> aggregate_columns(aggregate_exprs.size());
+  TupleBatch batch;
+  while (child_->NextBatch(&batch)) {
+    for (uint32_t i = 0; i < group_by_exprs.size(); i++) {
+      group_by_exprs[i]->EvaluateBatch(batch, &group_by_columns[i]);
+    }
+    for (uint32_t i = 0; i < aggregate_exprs.size(); i++) {
+      aggregate_exprs[i]->EvaluateBatch(batch, &aggregate_columns[i]);
+    }
+    if (flat_aht_ != nullptr) {
+      flat_aht_->InsertBatch(group_by_columns, aggregate_columns, batch.GetSelection());
+      continue;
+    }
+    for (uint32_t row : batch.GetSelection()) {
+      AggregateKey key;
+      key.group_bys_.reserve(group_by_columns.size());
+      for (const auto &column : group_by_columns) {
+        key.group_bys_.push_back(column[row]);
+      }
+      AggregateValue value;
+      value.aggregates_.reserve(aggregate_columns.size());
+      for (const auto &column : aggregate_columns) {
+        value.aggregates_.push_back(column[row]);
+      }
+      aht_.InsertCombine(key, value);
+    }
+  }
+  output_aht_ = &aht_;
+  output_worker_id_ = 0;
+  num_output_workers_ = 1;
+
+  if (flat_) {
+    if (parallel_state != nullptr) {
+      MergeFlatTables(parallel_state);
+    } else {
+      flat_outputs_.emplace_back(flat_aht_.get(), 0);
+    }
+  } else if (parallel_state != nullptr) {
+    auto *shared = parallel_state->GetSharedState<SharedAggregation>(plan_, plan_->GetAggregates(),
+                                                                      plan_->GetAggregateTypes());
+    {
+      std::scoped_lock lock(shared->latch_);
+      shared->aht_.Merge(aht_);
+    }
+    aht_.Clear();
+    parallel_state->ArriveAndWait(plan_);
+    output_aht_ = &shared->aht_;
+    output_worker_id_ = GetExecutorContext()->GetWorkerId();
+    num_output_workers_ = parallel_state->GetNumWorkers();
+  }
+  aht_iterator_ = output_aht_->Begin();
+  aht_position_ = 0;
+}
+
+void AggregationExecutor::MergeFlatTables(ParallelState *parallel_state) {
+  auto *shared = parallel_state->GetSharedState<SharedFlatAggregation>(plan_, parallel_state->GetNumWorkers());
+  {
+    std::scoped_lock lock(shared->latch_);
+    shared->tables_[GetExecutorContext()->GetWorkerId()] = std::move(flat_aht_);
+  }
+  parallel_state->ArriveAndWait(plan_);
+  // every partition is merged by a single worker, so the workers never touch the same groups
+  FlatAggregationTable *result = shared->tables_[0].get();
+  for (uint32_t partition = shared->next_partition_++; partition < result->GetNumPartitions();
+       partition = shared->next_partition_++) {
+    for (size_t worker = 1; worker < shared->tables_.size(); worker++) {
+      result->MergePartition(partition, *shared->tables_[worker]);
+    }
+    flat_outputs_.emplace_back(result, partition);
+  }
+}
+
+bool AggregationExecutor::NextBatch(TupleBatch *batch) {
+  batch->Reset(GetOutputSchema());
+  if (flat_) {
+    std::vector<Value> group_bys;
+    std::vector<Value> aggregates;
+    while (!batch->IsFull() && flat_output_ < flat_outputs_.size()) {
+      auto [table, partition] = flat_outputs_[flat_output_];
+      if (flat_group_ == table->GetNumGroups(partition)) {
+        flat_output_++;
+        flat_group_ = 0;
+        continue;
+      }
+      table->GetGroup(partition, flat_group_++, &group_bys, &aggregates);
+      OutputGroup(group_bys, aggregates, batch);
+    }
+    return batch->GetNumSelected() > 0;
+  }
+  for (; !batch->IsFull() && aht_iterator_ != output_aht_->End(); ++aht_iterator_) {
+    if (aht_position_++ % num_output_workers_ != output_worker_id_) {
+      continue;
+    }
+    OutputGroup(aht_iterator_.Key().group_bys_, aht_iterator_.Val().aggregates_, batch);
+  }
+  return batch->GetNumSelected() > 0;
+}
+
+void AggregationExecutor::OutputGroup(const std::vector<Value> &group_bys, const std::vector<Value> &aggregates,
+                                      TupleBatch *batch) {
+  const AbstractExpression *having = plan_->GetHaving();
+  if (having != nullptr && !having->EvaluateAggregate(group_bys, aggregates).GetAs<bool>()) {
+    return;
+  }
+  std::vector<Value> values;
+  values.reserve(GetOutputSchema()->GetColumnCount());
+  for (const auto &column : GetOutputSchema()->GetColumns()) {
+    values.push_back(column.GetExpr()->EvaluateAggregate(group_bys, aggregates));
+  }
+  batch->AppendRow(values, RID());
+}
+
+const AbstractExecutor *AggregationExecutor::GetChildExecutor() const { return child_.get(); }
+
+}  // namespace bustub
@@ -0,0 +1,35 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// batch_executor.cpp
+//
+// Identification: src/execution/batch_executor.cpp
+//
+// Copyright (c) 2015-2021, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "execution/executors/batch_executor.h"
+
+namespace bustub {
+
+void BatchExecutor::Init() {
+  buffer_.Reset(GetOutputSchema());
+  next_selected_ = 0;
+}
+
+bool BatchExecutor::Next(Tuple *tuple, RID *rid) {
+  if (next_selected_ == buffer_.GetNumSelected()) {
+    if (!NextBatch(&buffer_)) {
+      return false;
+    }
+    next_selected_ = 0;
+  }
+  uint32_t row = buffer_.GetSelection()[next_selected_++];
+  *tuple = buffer_.ToTuple(row);
+  *rid = buffer_.GetRid(row);
+  return true;
+}
+
+}  // namespace bustub
@@ -0,0 +1,82 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// execution_engine.cpp
+//
+// Identification: src/execution/execution_engine.cpp
+//
+// Copyright (c) 2015-2021, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "execution/execution_engine.h"
+
+#include <exception>
+#include <mutex>   // NOLINT
+#include <thread>  // NOLINT
+
+#include "execution/parallel_state.h"
+
+namespace bustub {
+
+bool ExecutionEngine::ExecuteParallel(const AbstractPlanNode *plan, std::vector<Tuple> *result_set, Transaction *txn,
+                                      ExecutorContext *exec_ctx, uint32_t num_workers, uint32_t morsel_size) {
+  // The locks a read takes are recorded in the transaction, which the workers cannot share.
+  if (num_workers <= 1 || enable_logging || !ParallelState::CanParallelize(plan)) {
+    return Execute(plan, result_set, txn, exec_ctx);
+  }
+
+  ParallelState parallel_state(num_workers, morsel_size);
+  std::vector<std::vector<Tuple>> worker_results(num_workers);
+  std::vector<std::thread> workers;
+  // the first worker failure; the abort below makes the other workers fail only as a consequence
+  std::exception_ptr failure;
+  std::mutex failure_latch;
+  for (uint32_t worker_id = 0; worker_id < num_workers; worker_id++) {
+    workers.emplace_back([&, worker_id] {
+      ExecutorContext worker_ctx(txn, exec_ctx->GetCatalog(), exec_ctx->GetBufferPoolManager(),
+                                 exec_ctx->GetTransactionManager(), exec_ctx->GetLockManager());
+      worker_ctx.SetParallelState(&parallel_state, worker_id);
+      try {
+        auto executor = ExecutorFactory::CreateExecutor(&worker_ctx, plan);
+        executor->Init();
+        TupleBatch batch;
+        while (executor->NextBatch(&batch)) {
+          for (uint32_t row : batch.GetSelection()) {
+            worker_results[worker_id].push_back(batch.ToTuple(row));
+          }
+        }
+      } catch (...) {
+        {
+          std::scoped_lock lock(failure_latch);
+          if (failure == nullptr) {
+            failure = std::current_exception();
+          }
+        }
+        // don't leave the other workers waiting for this one at a barrier
+        parallel_state.Abort();
+      }
+    });
+  }
+  for (auto &worker : workers) {
+    worker.join();
+  }
+  if (failure != nullptr) {
+    // a query error fails the query as a whole, without the rows some workers produced; anything else is not ours
+    try {
+      std::rethrow_exception(failure);
+    } catch (Exception &e) {
+      return false;
+    }
+  }
+
+  if (result_set != nullptr) {
+    for (auto &tuples : worker_results) {
+      result_set->insert(result_set->end(), tuples.begin(), tuples.end());
+    }
+  }
+  return true;
+}
+
+}  // namespace bustub
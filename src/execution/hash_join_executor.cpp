@@ -12,15 +12,493 @@
 
 #include "execution/executors/hash_join_executor.h"
 
+#include <algorithm>
+
+#include "execution/expressions/column_value_expression.h"
+
 namespace bustub {
 
+namespace {
+
+/** @return the high bits of a hash, which a slot keeps to skip most keys without comparing them */
+uint32_t HashTag(hash_t hash) { return static_cast<uint32_t>(static_cast<uint64_t>(hash) >> 32); }
+
+}  // namespace
+
+void JoinHashTable::Clear() {
+  columns_.clear();
+  keys_.clear();
+  hashes_.clear();
+  next_rows_.clear();
+  num_rows_ = 0;
+  radix_bits_ = 0;
+  partition_slots_.clear();
+  slots_.clear();
+  built_ = false;
+  filter_.reset();
+}
+
+void JoinHashTable::Append(const TupleBatch &batch, uint32_t row, const Value &key, hash_t hash) {
+  for (uint32_t col_idx = 0; col_idx < columns_.size(); col_idx++) {
+    columns_[col_idx].push_back(batch.GetValue(col_idx, row));
+  }
+  keys_.push_back(key);
+  hashes_.push_back(hash);
+  num_rows_++;
+  built_ = false;
+}
+
+void JoinHashTable::Merge(const JoinHashTable &other) {
+  if (other.num_rows_ == 0) {
+    return;
+  }
+  if (columns_.empty()) {
+    columns_.resize(other.columns_.size());
+  }
+  for (uint32_t col_idx = 0; col_idx < columns_.size(); col_idx++) {
+    columns_[col_idx].insert(columns_[col_idx].end(), other.columns_[col_idx].begin(), other.columns_[col_idx].end());
+  }
+  keys_.insert(keys_.end(), other.keys_.begin(), other.keys_.end());
+  hashes_.insert(hashes_.end(), other.hashes_.begin(), other.hashes_.end());
+  num_rows_ += other.num_rows_;
+  built_ = false;
+}
+
+void JoinHashTable::Build() {
+  // a partition gets two slots per row at most, so that probe sequences stay short
+  radix_bits_ = 0;
+  while (radix_bits_ < MAX_RADIX_BITS &&
+         (static_cast<size_t>(num_rows_) >> radix_bits_) * 2 * sizeof(Slot) > PARTITION_BYTES) {
+    radix_bits_++;
+  }
+  uint32_t num_partitions = GetNumPartitions();
+
+  // a counting sort of the rows by partition
+  std::vector<uint32_t> partition_rows(num_partitions + 1, 0);
+  for (hash_t hash : hashes_) {
+    partition_rows[GetPartition(hash) + 1]++;
+  }
+  partition_slots_.assign(num_partitions + 1, 0);
+  for (uint32_t partition = 0; partition < num_partitions; partition++) {
+    uint32_t num_slots = 1;
+    while (num_slots < 2 * partition_rows[partition + 1]) {
+      num_slots <<= 1;
+    }
+    partition_slots_[partition + 1] = partition_slots_[partition] + num_slots;
+    partition_rows[partition + 1] += partition_rows[partition];
+  }
+  std::vector<uint32_t> rows(num_rows_);
+  std::vector<uint32_t> next_positions(partition_rows.begin(), partition_rows.end() - 1);
+  for (uint32_t row = 0; row < num_rows_; row++) {
+    rows[next_positions[GetPartition(hashes_[row])]++] = row;
+  }
+
+  // each partition is filled in on its own, while its slots are in cache; rows go in backwards so that every chain
+  // lists its rows in the order they were appended
+  slots_.assign(partition_slots_.back(), Slot{0, NO_ROW});
+  next_rows_.assign(num_rows_, NO_ROW);
+  for (uint32_t partition = 0; partition < num_partitions; partition++) {
+    for (uint32_t i = partition_rows[partition + 1]; i > partition_rows[partition]; i--) {
+      uint32_t row = rows[i - 1];
+      hash_t hash = hashes_[row];
+      for (uint32_t slot = FirstSlot(hash);; slot = NextSlot(hash, slot)) {
+        Slot &entry = slots_[slot];
+        if (entry.row_ == NO_ROW) {
+          entry = Slot{HashTag(hash), row};
+          break;
+        }
+        if (entry.hash_tag_ == HashTag(hash) && keys_[entry.row_].CompareEquals(keys_[row]) == CmpBool::CmpTrue) {
+          next_rows_[row] = entry.row_;
+          entry.row_ = row;
+          break;
+        }
+      }
+    }
+  }
+  built_ = true;
+}
+
+uint32_t JoinHashTable::Find(const Value &key, hash_t hash) const {
+  for (uint32_t slot = FirstSlot(hash);; slot = NextSlot(hash, slot)) {
+    const Slot &entry = slots_[slot];
+    if (entry.row_ == NO_ROW) {
+      return NO_ROW;
+    }
+    if (entry.hash_tag_ == HashTag(hash) && keys_[entry.row_].CompareEquals(key) == CmpBool::CmpTrue) {
+      return entry.row_;
+    }
+  }
+}
+
+Tuple JoinHashTable::GetTuple(uint32_t row, const Schema *schema) const {
+  std::vector<Value> values;
+  values.reserve(columns_.size());
+  for (const auto &column : columns_) {
+    values.push_back(column[row]);
+  }
+  return Tuple(values, schema);
+}
+
+uint32_t JoinHashTable::FirstSlot(hash_t hash) const {
+  uint32_t partition = GetPartition(hash);
+  uint32_t num_slots = partition_slots_[partition + 1] - partition_slots_[partition];
+  return partition_slots_[partition] + (static_cast<uint32_t>(hash >> radix_bits_) & (num_slots - 1));
+}
+
+uint32_t JoinHashTable::NextSlot(hash_t hash, uint32_t slot) const {
+  uint32_t partition = GetPartition(hash);
+  uint32_t num_slots = partition_slots_[partition + 1] - partition_slots_[partition];
+  return partition_slots_[partition] + ((slot - partition_slots_[partition] + 1) & (num_slots - 1));
+}
+
 HashJoinExecutor::HashJoinExecutor(ExecutorContext *exec_ctx, const HashJoinPlanNode *plan,
                                    std::unique_ptr<AbstractExecutor> &&left_child,
                                    std::unique_ptr<AbstractExecutor> &&right_child)
-    : AbstractExecutor(exec_ctx) {}
+    : BatchExecutor(exec_ctx), plan_(plan), left_(std::move(left_child)), right_(std::move(right_child)) {}
+
+void HashJoinExecutor::Init() {
+  BatchExecutor::Init();
+  left_->Init();
+  right_->Init();
+
+  const Schema *build_schema = left_->GetOutputSchema();
+  row_bytes_ = sizeof(Value) * (build_schema->GetColumnCount() + 1) + sizeof(hash_t) + sizeof(uint32_t);
+  for (const auto &column : build_schema->GetColumns()) {
+    row_bytes_ += column.IsInlined() ? 0 : column.GetLength();
+  }
+  ParallelState *parallel_state = GetExecutorContext()->GetParallelState();
+  spilling_ = plan_->GetMemoryBudget() != HashJoinPlanNode::NO_MEMORY_BUDGET && parallel_state == nullptr;
+  level_ = 0;
+  chunked_ = false;
+  build_input_.reset();
+  probe_input_.reset();
+  pending_.clear();
+  num_spilled_partitions_ = 0;
+  build_ = &local_build_;
+
+  if (spilling_) {
+    BuildPass();
+  } else {
+    local_build_.Clear();
+    local_build_.columns_.resize(build_schema->GetColumnCount());
+    TupleBatch batch;
+    std::vector<Value> keys;
+    while (left_->NextBatch(&batch)) {
+      plan_->LeftJoinKeyExpression()->EvaluateBatch(batch, &keys);
+      for (uint32_t row : batch.GetSelection()) {
+        // a null key equals nothing, not even another null
+        if (!keys[row].IsNull()) {
+          local_build_.Append(batch, row, keys[row], HashUtil::HashValue(&keys[row]));
+        }
+      }
+    }
+  }
+
+  if (parallel_state != nullptr) {
+    auto *shared_build = parallel_state->GetSharedState<JoinHashTable>(plan_);
+    {
+      std::scoped_lock lock(shared_build->latch_);
+      shared_build->Merge(local_build_);
+    }
+    local_build_.Clear();
+    parallel_state->ArriveAndWait(plan_);
+    {
+      std::scoped_lock lock(shared_build->latch_);
+      if (!shared_build->built_) {
+        shared_build->Build();
+        shared_build->BuildFilter();
+      }
+    }
+    build_ = shared_build;
+    PushDownJoinFilter();
+  } else if (!spilling_) {
+    local_build_.Build();
+    local_build_.BuildFilter();
+    PushDownJoinFilter();
+  }
+
+  probe_batch_.Reset(right_->GetOutputSchema());
+  probe_order_.clear();
+  probe_first_matches_.clear();
+  probe_position_ = 0;
+  probe_match_ = JoinHashTable::NO_ROW;
+}
+
+void HashJoinExecutor::PushDownJoinFilter() {
+  // the key is evaluated over the right child's rows alone, whichever side its expression names
+  const auto *key = dynamic_cast<const ColumnValueExpression *>(plan_->RightJoinKeyExpression());
+  if (key != nullptr) {
+    right_->PushDownJoinFilter(build_->filter_.get(), key->GetColIdx());
+  }
+}
+
+void HashJoinExecutor::BuildPass() {
+  const Schema *build_schema = left_->GetOutputSchema();
+  std::vector<JoinHashTable> partitions(SPILL_FANOUT);
+  for (auto &partition : partitions) {
+    partition.columns_.resize(build_schema->GetColumnCount());
+  }
+  build_spills_.clear();
+  build_spills_.resize(SPILL_FANOUT);
+  probe_spills_.clear();
+  probe_spills_.resize(SPILL_FANOUT);
+  pass_build_rows_ = 0;
+
+  size_t memory_used = 0;
+  TupleBatch batch;
+  std::vector<Value> keys;
+  while (NextBuildInput(&batch)) {
+    plan_->LeftJoinKeyExpression()->EvaluateBatch(batch, &keys);
+    for (uint32_t row : batch.GetSelection()) {
+      // a null key equals nothing, so its row is never spilled either
+      if (keys[row].IsNull()) {
+        continue;
+      }
+      pass_build_rows_++;
+      hash_t hash = HashUtil::HashValue(&keys[row]);
+      uint32_t partition = GetSpillPartition(hash, level_);
+      if (build_spills_[partition] != nullptr) {
+        build_spills_[partition]->Append(batch.ToTuple(row));
+        continue;
+      }
+      partitions[partition].Append(batch, row, keys[row], hash);
+      memory_used += row_bytes_;
+      // a spilled partition takes all of its rows out of memory, so the largest one frees up the most
+      while (memory_used > plan_->GetMemoryBudget()) {
+        auto largest = std::max_element(partitions.begin(), partitions.end(), [](const auto &a, const auto &b) {
+          return a.num_rows_ < b.num_rows_;
+        });
+        auto spilled = static_cast<uint32_t>(largest - partitions.begin());
+        build_spills_[spilled] = std::make_unique<SpillFile>(GetExecutorContext()->GetBufferPoolManager());
+        probe_spills_[spilled] = std::make_unique<SpillFile>(GetExecutorContext()->GetBufferPoolManager());
+        for (uint32_t spilled_row = 0; spilled_row < largest->num_rows_; spilled_row++) {
+          build_spills_[spilled]->Append(largest->GetTuple(spilled_row, build_schema));
+        }
+        memory_used -= largest->num_rows_ * row_bytes_;
+        largest->Clear();
+        num_spilled_partitions_++;
+      }
+    }
+  }
+
+  // the partitions left in memory make up the hash table of the pass
+  local_build_.Clear();
+  local_build_.columns_.resize(build_schema->GetColumnCount());
+  for (auto &partition : partitions) {
+    local_build_.Merge(partition);
+    partition.Clear();
+  }
+  local_build_.Build();
+}
+
+void HashJoinExecutor::BuildChunk() {
+  local_build_.Clear();
+  local_build_.columns_.resize(left_->GetOutputSchema()->GetColumnCount());
+  TupleBatch batch;
+  std::vector<Value> keys;
+  // whole pages at a time, and at least one whatever the budget
+  build_input_done_ = true;
+  while (NextBuildInput(&batch)) {
+    plan_->LeftJoinKeyExpression()->EvaluateBatch(batch, &keys);
+    for (uint32_t row : batch.GetSelection()) {
+      local_build_.Append(batch, row, keys[row], HashUtil::HashValue(&keys[row]));
+    }
+    if (local_build_.num_rows_ * row_bytes_ >= plan_->GetMemoryBudget()) {
+      build_input_done_ = false;
+      break;
+    }
+  }
+  local_build_.Build();
+}
+
+bool HashJoinExecutor::NextProbeBatch() {
+  while (true) {
+    if (NextProbeInput(&probe_batch_)) {
+      LookUpProbeBatch();
+      return true;
+    }
+    if (!spilling_) {
+      return false;
+    }
+    if (chunked_ && !build_input_done_) {
+      BuildChunk();
+      probe_input_->Rewind();
+      continue;
+    }
+    FinishPass();
+    if (!StartPass()) {
+      return false;
+    }
+  }
+}
+
+void HashJoinExecutor::FinishPass() {
+  for (uint32_t partition = 0; partition < build_spills_.size(); partition++) {
+    if (build_spills_[partition] == nullptr || probe_spills_[partition]->GetNumTuples() == 0) {
+      continue;
+    }
+    // a partition that took every build row of the pass will not split any better a level down
+    bool chunked =
+        level_ + 1 >= MAX_SPILL_LEVEL || build_spills_[partition]->GetNumTuples() == pass_build_rows_;
+    pending_.push_back(SpilledPartition{std::move(build_spills_[partition]), std::move(probe_spills_[partition]),
+                                        level_ + 1, chunked});
+  }
+  build_spills_.clear();
+  probe_spills_.clear();
+  build_input_.reset();
+  probe_input_.reset();
+  chunked_ = false;
+  local_build_.Clear();
+}
+
+bool HashJoinExecutor::StartPass() {
+  if (pending_.empty()) {
+    return false;
+  }
+  SpilledPartition next = std::move(pending_.back());
+  pending_.pop_back();
+  build_input_ = std::move(next.build_);
+  probe_input_ = std::move(next.probe_);
+  level_ = next.level_;
+  chunked_ = next.chunked_;
+  build_input_->Rewind();
+  probe_input_->Rewind();
+  if (chunked_) {
+    BuildChunk();
+  } else {
+    BuildPass();
+  }
+  return true;
+}
+
+bool HashJoinExecutor::NextBuildInput(TupleBatch *batch) {
+  if (build_input_ == nullptr) {
+    return left_->NextBatch(batch);
+  }
+  return ReadSpillFile(build_input_.get(), left_->GetOutputSchema(), batch);
+}
+
+bool HashJoinExecutor::NextProbeInput(TupleBatch *batch) {
+  if (probe_input_ == nullptr) {
+    return level_ == 0 && right_->NextBatch(batch);
+  }
+  return ReadSpillFile(probe_input_.get(), right_->GetOutputSchema(), batch);
+}
+
+bool HashJoinExecutor::ReadSpillFile(SpillFile *file, const Schema *schema, TupleBatch *batch) {
+  std::vector<Tuple> tuples;
+  if (!file->ReadPage(&tuples)) {
+    return false;
+  }
+  batch->Reset(schema);
+  for (const auto &tuple : tuples) {
+    batch->AppendTuple(tuple, RID{});
+  }
+  return true;
+}
+
+bool HashJoinExecutor::NextBatch(TupleBatch *batch) {
+  batch->Reset(GetOutputSchema());
+  // the matches that make up the output, as pairs of a build row and a row of the probe batch
+  std::vector<uint32_t> build_rows;
+  std::vector<uint32_t> probe_rows;
+  while (build_rows.size() < batch->GetCapacity()) {
+    if (probe_position_ == probe_order_.size()) {
+      // the pairs point into the probe batch, so the output never spans two of them
+      if (!build_rows.empty()) {
+        break;
+      }
+      if (!NextProbeBatch()) {
+        return false;
+      }
+      continue;
+    }
+    if (probe_match_ == JoinHashTable::NO_ROW) {
+      if (++probe_position_ < probe_order_.size()) {
+        probe_match_ = probe_first_matches_[probe_position_];
+      }
+      continue;
+    }
+    build_rows.push_back(probe_match_);
+    probe_rows.push_back(probe_order_[probe_position_]);
+    probe_match_ = build_->next_rows_[probe_match_];
+  }
+
+  auto num_rows = static_cast<uint32_t>(build_rows.size());
+  batch->Resize(num_rows);
+  const Schema *probe_schema = right_->GetOutputSchema();
+  for (uint32_t col_idx = 0; col_idx < GetOutputSchema()->GetColumnCount(); col_idx++) {
+    const AbstractExpression *expr = GetOutputSchema()->GetColumn(col_idx).GetExpr();
+    std::vector<Value> &column = *batch->GetMutableColumn(col_idx);
+    if (const auto *column_expr = dynamic_cast<const ColumnValueExpression *>(expr); column_expr != nullptr) {
+      if (column_expr->GetTupleIdx() == 0) {
+        const std::vector<Value> &build_column = build_->columns_[column_expr->GetColIdx()];
+        for (uint32_t i = 0; i < num_rows; i++) {
+          column[i] = build_column[build_rows[i]];
+        }
+      } else {
+        const std::vector<Value> &probe_column = probe_batch_.GetColumn(column_expr->GetColIdx());
+        for (uint32_t i = 0; i < num_rows; i++) {
+          column[i] = probe_column[probe_rows[i]];
+        }
+      }
+      continue;
+    }
+    for (uint32_t i = 0; i < num_rows; i++) {
+      Tuple build_tuple = build_->GetTuple(build_rows[i], left_->GetOutputSchema());
+      Tuple probe_tuple = probe_batch_.ToTuple(probe_rows[i]);
+      column[i] = expr->EvaluateJoin(&build_tuple, left_->GetOutputSchema(), &probe_tuple, probe_schema);
+    }
+  }
+  return true;
+}
+
+void HashJoinExecutor::LookUpProbeBatch() {
+  plan_->RightJoinKeyExpression()->EvaluateBatch(probe_batch_, &probe_keys_);
+  probe_hashes_.resize(probe_batch_.GetNumRows());
+  probe_order_.clear();
+  // a null key equals nothing, so its row is left out, and the rows of spilled partitions are set aside for later
+  for (uint32_t row : probe_batch_.GetSelection()) {
+    if (probe_keys_[row].IsNull()) {
+      continue;
+    }
+    hash_t hash = HashUtil::HashValue(&probe_keys_[row]);
+    if (!probe_spills_.empty()) {
+      if (auto &spill = probe_spills_[GetSpillPartition(hash, level_)]; spill != nullptr) {
+        spill->Append(probe_batch_.ToTuple(row));
+        continue;
+      }
+    }
+    probe_hashes_[row] = hash;
+    probe_order_.push_back(row);
+  }
 
-void HashJoinExecutor::Init() {}
+  uint32_t num_partitions = build_->GetNumPartitions();
+  if (num_partitions > 1) {
+    std::vector<uint32_t> next_positions(num_partitions + 1, 0);
+    for (uint32_t row : probe_order_) {
+      next_positions[build_->GetPartition(probe_hashes_[row]) + 1]++;
+    }
+    for (uint32_t partition = 0; partition < num_partitions; partition++) {
+      next_positions[partition + 1] += next_positions[partition];
+    }
+    std::vector<uint32_t> rows(probe_order_.size());
+    for (uint32_t row : probe_order_) {
+      rows[next_positions[build_->GetPartition(probe_hashes_[row])]++] = row;
+    }
+    probe_order_.swap(rows);
+  }
 
-bool HashJoinExecutor::Next(Tuple *tuple, RID *rid) { return false; }
+  probe_first_matches_.resize(probe_order_.size());
+  for (size_t i = 0; i < probe_order_.size(); i++) {
+    if (i + PREFETCH_DISTANCE < probe_order_.size()) {
+      build_->Prefetch(probe_hashes_[probe_order_[i + PREFETCH_DISTANCE]]);
+    }
+    uint32_t row = probe_order_[i];
+    probe_first_matches_[i] = build_->Find(probe_keys_[row], probe_hashes_[row]);
+  }
+  probe_position_ = 0;
+  probe_match_ = probe_order_.empty() ? JoinHashTable::NO_ROW : probe_first_matches_[0];
+}
 
 }  // namespace bustub
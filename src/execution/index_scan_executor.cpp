@@ -11,12 +11,220 @@
 //===----------------------------------------------------------------------===//
 #include "execution/executors/index_scan_executor.h"
 
+#include <algorithm>
+#include <exception>
+#include <optional>
+#include <utility>
+
+#include "execution/expressions/column_value_expression.h"
+#include "execution/expressions/comparison_expression.h"
+#include "execution/expressions/constant_value_expression.h"
+#include "type/value_factory.h"
+
 namespace bustub {
+
+namespace {
+
+// the comparison that holds with the operands swapped: (c < x) == (x > c)
+ComparisonType Mirror(ComparisonType comp_type) {
+  switch (comp_type) {
+    case ComparisonType::LessThan:
+      return ComparisonType::GreaterThan;
+    case ComparisonType::LessThanOrEqual:
+      return ComparisonType::GreaterThanOrEqual;
+    case ComparisonType::GreaterThan:
+      return ComparisonType::LessThan;
+    case ComparisonType::GreaterThanOrEqual:
+      return ComparisonType::LessThanOrEqual;
+    default:
+      return comp_type;
+  }
+}
+
+// the constant as a value of the key type, or nothing if no key equals it: a truncated bound, say 3 for colA < 3.5,
+// would cut off keys that match, and a constant out of the range of the key type has no bound at all
+std::optional<Value> ExactKeyValue(const Value &constant, TypeId key_type) {
+  if (constant.GetTypeId() == key_type) {
+    return constant;
+  }
+  try {
+    Value key_value = constant.CastAs(key_type);
+    if (key_value.CastAs(constant.GetTypeId()).CompareEquals(constant) == CmpBool::CmpTrue) {
+      return key_value;
+    }
+  } catch (const std::exception &e) {
+    // not a value of the key type
+  }
+  return std::nullopt;
+}
+
+}  // namespace
+
 IndexScanExecutor::IndexScanExecutor(ExecutorContext *exec_ctx, const IndexScanPlanNode *plan)
-    : AbstractExecutor(exec_ctx) {}
+    : AbstractExecutor(exec_ctx), plan_(plan) {}
+
+void IndexScanExecutor::Init() {
+  Catalog *catalog = GetExecutorContext()->GetCatalog();
+  index_info_ = catalog->GetIndex(plan_->GetIndexOid());
+  table_info_ = catalog->GetTable(index_info_->table_name_);
+  rids_.clear();
+  entries_.clear();
+  next_rid_ = 0;
+  cursor_.reset();
+  join_filter_ = nullptr;
+
+  Index *index = index_info_->index_.get();
+  KeyRange<Tuple> range = RangeFromPredicate();
+  range.reverse_ = plan_->IsReverse();
+  if (index->SupportsRangeScan()) {
+    cursor_ = index->ScanRange(range, GetExecutorContext()->GetTransaction());
+    index_only_ = index->SupportsIndexOnlyScan() && IsCovered(plan_->GetPredicate());
+    for (const auto &column : GetOutputSchema()->GetColumns()) {
+      index_only_ = index_only_ && IsCovered(column.GetExpr());
+    }
+    return;
+  }
+  index_only_ = false;
+  if (!range.lower_.has_value() || !range.upper_.has_value() || !range.lower_inclusive_ || !range.upper_inclusive_ ||
+      range.lower_->GetValue(&index_info_->key_schema_, 0).CompareNotEquals(
+          range.upper_->GetValue(&index_info_->key_schema_, 0)) == CmpBool::CmpTrue) {
+    throw Exception(ExceptionType::NOT_IMPLEMENTED, "Index " + index->GetName() + " only supports equality lookups");
+  }
+  index->ScanKey(*range.lower_, &rids_, GetExecutorContext()->GetTransaction());
+}
+
+bool IndexScanExecutor::Next(Tuple *tuple, RID *rid) {
+  const Schema *table_schema = &table_info_->schema_;
+  const AbstractExpression *predicate = plan_->GetPredicate();
+  Transaction *txn = GetExecutorContext()->GetTransaction();
+  while (true) {
+    if (next_rid_ == rids_.size()) {
+      if (cursor_ == nullptr) {
+        return false;
+      }
+      if (!(index_only_ ? cursor_->NextEntryBatch(&rids_, &entries_) : cursor_->NextBatch(&rids_))) {
+        // an exhausted cursor must not be read again, nor the RIDs it left behind
+        cursor_.reset();
+        rids_.clear();
+        next_rid_ = 0;
+        return false;
+      }
+      next_rid_ = 0;
+    }
+    size_t position = next_rid_++;
+    RID table_rid = rids_[position];
+    Tuple table_tuple;
+    if (index_only_) {
+      // the same lock reading the tuple from the table would take
+      LockManager *lock_manager = GetExecutorContext()->GetLockManager();
+      if (enable_logging && !txn->IsSharedLocked(table_rid) && !txn->IsExclusiveLocked(table_rid) &&
+          !lock_manager->LockShared(txn, table_rid)) {
+        continue;
+      }
+      table_tuple = TupleFromEntry(entries_[position]);
+    } else if (!table_info_->table_->GetTuple(table_rid, &table_tuple, txn)) {
+      continue;
+    }
+    if (join_filter_ != nullptr && !join_filter_->MayContain(table_tuple.GetValue(table_schema, join_filter_column_))) {
+      continue;
+    }
+    if (predicate != nullptr && !predicate->Evaluate(&table_tuple, table_schema).GetAs<bool>()) {
+      continue;
+    }
+
+    std::vector<Value> values;
+    values.reserve(GetOutputSchema()->GetColumnCount());
+    for (const auto &column : GetOutputSchema()->GetColumns()) {
+      values.push_back(column.GetExpr()->Evaluate(&table_tuple, table_schema));
+    }
+    *tuple = Tuple(values, GetOutputSchema());
+    *rid = table_rid;
+    return true;
+  }
+}
+
+bool IndexScanExecutor::PushDownJoinFilter(const JoinFilter *filter, uint32_t col_idx) {
+  const auto *column = dynamic_cast<const ColumnValueExpression *>(GetOutputSchema()->GetColumn(col_idx).GetExpr());
+  if (column == nullptr) {
+    return false;
+  }
+  join_filter_ = filter;
+  join_filter_column_ = column->GetColIdx();
+  return true;
+}
+
+bool IndexScanExecutor::IsCovered(const AbstractExpression *expr) const {
+  if (expr == nullptr) {
+    return true;
+  }
+  if (const auto *column = dynamic_cast<const ColumnValueExpression *>(expr); column != nullptr) {
+    const auto &entry_attrs = index_info_->index_->GetEntryAttrs();
+    return std::find(entry_attrs.begin(), entry_attrs.end(), column->GetColIdx()) != entry_attrs.end();
+  }
+  return std::all_of(expr->GetChildren().begin(), expr->GetChildren().end(),
+                     [this](const AbstractExpression *child) { return IsCovered(child); });
+}
+
+Tuple IndexScanExecutor::TupleFromEntry(const Tuple &entry) const {
+  const Schema *table_schema = &table_info_->schema_;
+  const Index *index = index_info_->index_.get();
+  std::vector<Value> values;
+  values.reserve(table_schema->GetColumnCount());
+  for (const auto &column : table_schema->GetColumns()) {
+    values.push_back(ValueFactory::GetZeroValueByType(column.GetType()));
+  }
+  const auto &entry_attrs = index->GetEntryAttrs();
+  for (uint32_t i = 0; i < entry_attrs.size(); i++) {
+    values[entry_attrs[i]] = entry.GetValue(index->GetEntrySchema(), i);
+  }
+  return Tuple(values, table_schema);
+}
+
+KeyRange<Tuple> IndexScanExecutor::RangeFromPredicate() const {
+  KeyRange<Tuple> range;
+  const auto *comparison = dynamic_cast<const ComparisonExpression *>(plan_->GetPredicate());
+  const Schema *key_schema = &index_info_->key_schema_;
+  if (comparison == nullptr || key_schema->GetColumnCount() != 1) {
+    return range;
+  }
 
-void IndexScanExecutor::Init() {}
+  ComparisonType comp_type = comparison->GetComparisonType();
+  const auto *column = dynamic_cast<const ColumnValueExpression *>(comparison->GetChildAt(0));
+  const auto *constant = dynamic_cast<const ConstantValueExpression *>(comparison->GetChildAt(1));
+  if (column == nullptr) {
+    column = dynamic_cast<const ColumnValueExpression *>(comparison->GetChildAt(1));
+    constant = dynamic_cast<const ConstantValueExpression *>(comparison->GetChildAt(0));
+    comp_type = Mirror(comp_type);
+  }
+  if (column == nullptr || constant == nullptr || column->GetColIdx() != index_info_->index_->GetKeyAttrs()[0]) {
+    return range;
+  }
 
-bool IndexScanExecutor::Next(Tuple *tuple, RID *rid) { return false; }
+  // without an exact bound the scan covers every key, and the predicate alone picks the matching ones
+  std::optional<Value> bound = ExactKeyValue(constant->Evaluate(nullptr, nullptr), key_schema->GetColumn(0).GetType());
+  if (!bound.has_value()) {
+    return range;
+  }
+  Tuple key({*bound}, key_schema);
+  switch (comp_type) {
+    case ComparisonType::Equal:
+      range.lower_ = key;
+      range.upper_ = key;
+      break;
+    case ComparisonType::LessThan:
+    case ComparisonType::LessThanOrEqual:
+      range.upper_ = key;
+      range.upper_inclusive_ = comp_type == ComparisonType::LessThanOrEqual;
+      break;
+    case ComparisonType::GreaterThan:
+    case ComparisonType::GreaterThanOrEqual:
+      range.lower_ = key;
+      range.lower_inclusive_ = comp_type == ComparisonType::GreaterThanOrEqual;
+      break;
+    default:
+      break;
+  }
+  return range;
+}
 
 }  // namespace bustub
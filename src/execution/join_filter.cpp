@@ -0,0 +1,78 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// join_filter.cpp
+//
+// Identification: src/execution/join_filter.cpp
+//
+// Copyright (c) 2015-2021, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "execution/join_filter.h"
+
+#include <algorithm>
+#include <limits>
+
+namespace bustub {
+
+namespace {
+
+/**
+ * Read an integer value, whatever its width, the way the join compares them.
+ * @return false if the value is not an integer
+ */
+bool GetInteger(const Value &value, int64_t *integer) {
+  switch (value.GetTypeId()) {
+    case TypeId::TINYINT:
+      *integer = value.GetAs<int8_t>();
+      return true;
+    case TypeId::SMALLINT:
+      *integer = value.GetAs<int16_t>();
+      return true;
+    case TypeId::INTEGER:
+      *integer = value.GetAs<int32_t>();
+      return true;
+    case TypeId::BIGINT:
+      *integer = value.GetAs<int64_t>();
+      return true;
+    default:
+      return false;
+  }
+}
+
+}  // namespace
+
+JoinFilter::JoinFilter(const std::vector<Value> &keys, const std::vector<hash_t> &hashes)
+    : bloom_(hashes.size()),
+      min_key_(std::numeric_limits<int64_t>::max()),
+      max_key_(std::numeric_limits<int64_t>::min()) {
+  for (hash_t hash : hashes) {
+    bloom_.Insert(hash);
+  }
+  for (const auto &key : keys) {
+    int64_t integer;
+    if (!GetInteger(key, &integer)) {
+      has_range_ = false;
+      break;
+    }
+    min_key_ = std::min(min_key_, integer);
+    max_key_ = std::max(max_key_, integer);
+  }
+}
+
+bool JoinFilter::MayContain(const Value &key) const {
+  // a null key equals nothing
+  if (key.IsNull()) {
+    return false;
+  }
+  // the range is the cheaper test, and the one that rules out the most keys of a join on a narrow range
+  int64_t integer;
+  if (has_range_ && GetInteger(key, &integer) && (integer < min_key_ || integer > max_key_)) {
+    return false;
+  }
+  return bloom_.MayContain(HashUtil::HashValue(&key));
+}
+
+}  // namespace bustub
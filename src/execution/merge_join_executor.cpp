@@ -0,0 +1,149 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// merge_join_executor.cpp
+//
+// Identification: src/execution/merge_join_executor.cpp
+//
+// Copyright (c) 2015-2021, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "execution/executors/merge_join_executor.h"
+
+#include <algorithm>
+
+#include "common/exception.h"
+
+namespace bustub {
+
+namespace {
+
+bool Less(const Value &a, const Value &b) { return a.CompareLessThan(b) == CmpBool::CmpTrue; }
+
+bool Equals(const Value &a, const Value &b) { return a.CompareEquals(b) == CmpBool::CmpTrue; }
+
+}  // namespace
+
+MergeJoinExecutor::MergeJoinExecutor(ExecutorContext *exec_ctx, const MergeJoinPlanNode *plan,
+                                     std::unique_ptr<AbstractExecutor> &&left_child,
+                                     std::unique_ptr<AbstractExecutor> &&right_child)
+    : BatchExecutor(exec_ctx), plan_(plan), left_(std::move(left_child)), right_(std::move(right_child)) {}
+
+void MergeJoinExecutor::Init() {
+  BatchExecutor::Init();
+  left_->Init();
+  right_->Init();
+  left_cursor_ = Cursor();
+  right_cursor_ = Cursor();
+  window_.clear();
+  max_window_size_ = 0;
+  has_left_row_ = false;
+  next_match_ = 0;
+}
+
+bool MergeJoinExecutor::NextBatch(TupleBatch *batch) {
+  batch->Reset(GetOutputSchema());
+  const Schema *left_schema = left_->GetOutputSchema();
+  const Schema *right_schema = right_->GetOutputSchema();
+  const AbstractExpression *predicate = plan_->Predicate();
+  std::vector<Value> values(GetOutputSchema()->GetColumnCount());
+  while (!batch->IsFull()) {
+    if (!has_left_row_ || next_match_ == window_.size()) {
+      if (has_left_row_) {
+        AdvanceRow(&left_cursor_);
+        has_left_row_ = false;
+      }
+      if (!PeekRow(left_.get(), plan_->LeftJoinKeyExpression(), &left_cursor_)) {
+        break;
+      }
+      uint32_t row = left_cursor_.CurrentRow();
+      MoveWindow(left_cursor_.keys_[row]);
+      // a left row is only materialized if it has matches to join with
+      if (!window_.empty()) {
+        left_tuple_ = left_cursor_.batch_.ToTuple(row);
+      }
+      has_left_row_ = true;
+      next_match_ = 0;
+      continue;
+    }
+
+    const Tuple &right_tuple = window_[next_match_++].tuple_;
+    if (predicate != nullptr) {
+      Value result = predicate->EvaluateJoin(&left_tuple_, left_schema, &right_tuple, right_schema);
+      if (result.IsNull() || !result.GetAs<bool>()) {
+        continue;
+      }
+    }
+    for (uint32_t col_idx = 0; col_idx < values.size(); col_idx++) {
+      values[col_idx] = GetOutputSchema()->GetColumn(col_idx).GetExpr()->EvaluateJoin(&left_tuple_, left_schema,
+                                                                                        &right_tuple, right_schema);
+    }
+    batch->AppendRow(values, RID());
+  }
+  return batch->GetNumSelected() > 0;
+}
+
+bool MergeJoinExecutor::PeekRow(AbstractExecutor *child, const AbstractExpression *key_expression, Cursor *cursor) {
+  while (!cursor->exhausted_) {
+    if (cursor->position_ == cursor->batch_.GetSelection().size()) {
+      // a child that has run out is not read again
+      if (!child->NextBatch(&cursor->batch_)) {
+        cursor->exhausted_ = true;
+        return false;
+      }
+      key_expression->EvaluateBatch(cursor->batch_, &cursor->keys_);
+      cursor->position_ = 0;
+      continue;
+    }
+    const Value &key = cursor->keys_[cursor->CurrentRow()];
+    if (key.IsNull()) {
+      // a null key joins nothing
+      cursor->position_++;
+      continue;
+    }
+    if (cursor->has_last_key_ && Less(key, cursor->last_key_)) {
+      throw Exception(ExceptionType::INVALID, "Merge join child is not ordered on its join key");
+    }
+    return true;
+  }
+  return false;
+}
+
+void MergeJoinExecutor::AdvanceRow(Cursor *cursor) {
+  cursor->last_key_ = cursor->keys_[cursor->CurrentRow()];
+  cursor->has_last_key_ = true;
+  cursor->position_++;
+}
+
+void MergeJoinExecutor::MoveWindow(const Value &left_key) {
+  ComparisonType comparison = plan_->GetKeyComparison();
+  bool right_after = comparison == ComparisonType::LessThan || comparison == ComparisonType::LessThanOrEqual;
+  // the right rows before the left key, or up to it, join no later left key either, whose keys are no smaller
+  auto stale = [&](const Value &key) {
+    return (comparison == ComparisonType::Equal || right_after) &&
+           (Less(key, left_key) || (comparison == ComparisonType::LessThan && Equals(key, left_key)));
+  };
+  while (!window_.empty() && stale(window_.front().key_)) {
+    window_.pop_front();
+  }
+
+  // on left < right the window takes in the rest of the right child, whose rows past the left key all join it;
+  // otherwise it takes in the right rows before the left key, or up to it
+  bool pull_equal = comparison != ComparisonType::GreaterThan;
+  while (PeekRow(right_.get(), plan_->RightJoinKeyExpression(), &right_cursor_)) {
+    uint32_t row = right_cursor_.CurrentRow();
+    const Value &key = right_cursor_.keys_[row];
+    if (!right_after && !Less(key, left_key) && !(pull_equal && Equals(key, left_key))) {
+      break;
+    }
+    if (!stale(key)) {
+      window_.push_back({key, right_cursor_.batch_.ToTuple(row)});
+    }
+    AdvanceRow(&right_cursor_);
+  }
+  max_window_size_ = std::max(max_window_size_, window_.size());
+}
+
+}  // namespace bustub
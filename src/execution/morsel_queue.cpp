@@ -0,0 +1,32 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// morsel_queue.cpp
+//
+// Identification: src/execution/morsel_queue.cpp
+//
+// Copyright (c) 2015-2021, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "execution/morsel_queue.h"
+
+#include <algorithm>
+
+namespace bustub {
+
+MorselQueue::MorselQueue(TableHeap *table_heap, uint32_t morsel_size)
+    : table_heap_(table_heap), morsel_size_(std::max(morsel_size, 1U)), num_pages_(table_heap->GetNumPages()) {}
+
+bool MorselQueue::Next(std::vector<page_id_t> *page_ids) {
+  size_t begin = next_position_.fetch_add(morsel_size_);
+  if (begin >= num_pages_) {
+    page_ids->clear();
+    return false;
+  }
+  table_heap_->GetPageIds(begin, std::min(begin + morsel_size_, num_pages_), page_ids);
+  return true;
+}
+
+}  // namespace bustub
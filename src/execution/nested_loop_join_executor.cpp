@@ -17,10 +17,88 @@ namespace bustub {
 NestedLoopJoinExecutor::NestedLoopJoinExecutor(ExecutorContext *exec_ctx, const NestedLoopJoinPlanNode *plan,
                                                std::unique_ptr<AbstractExecutor> &&left_executor,
                                                std::unique_ptr<AbstractExecutor> &&right_executor)
-    : AbstractExecutor(exec_ctx) {}
+    : BatchExecutor(exec_ctx), plan_(plan), left_(std::move(left_executor)), right_(std::move(right_executor)) {}
 
-void NestedLoopJoinExecutor::Init() {}
+void NestedLoopJoinExecutor::Init() {
+  BatchExecutor::Init();
+  left_->Init();
+  left_batch_ = TupleBatch();
+  next_left_row_ = 0;
+  left_exhausted_ = false;
+  block_.clear();
+  right_tuples_.clear();
+  block_position_ = 0;
+  right_position_ = 0;
+  num_right_scans_ = 0;
+}
 
-bool NestedLoopJoinExecutor::Next(Tuple *tuple, RID *rid) { return false; }
+bool NestedLoopJoinExecutor::NextBatch(TupleBatch *batch) {
+  batch->Reset(GetOutputSchema());
+  const Schema *left_schema = left_->GetOutputSchema();
+  const Schema *right_schema = right_->GetOutputSchema();
+  const AbstractExpression *predicate = plan_->Predicate();
+  std::vector<Value> values(GetOutputSchema()->GetColumnCount());
+  while (!batch->IsFull()) {
+    if (right_position_ == right_tuples_.size()) {
+      // the right batch is joined with every tuple of the block in turn, then the scan moves on to its next batch,
+      // and once it is over, to the next block
+      right_position_ = 0;
+      if (!right_tuples_.empty() && ++block_position_ < block_.size()) {
+        continue;
+      }
+      block_position_ = 0;
+      if (!NextRightBatch() && !NextBlock()) {
+        break;
+      }
+      continue;
+    }
+
+    const Tuple &left_tuple = block_[block_position_];
+    const Tuple &right_tuple = right_tuples_[right_position_++];
+    if (predicate != nullptr) {
+      Value result = predicate->EvaluateJoin(&left_tuple, left_schema, &right_tuple, right_schema);
+      if (result.IsNull() || !result.GetAs<bool>()) {
+        continue;
+      }
+    }
+    for (uint32_t col_idx = 0; col_idx < values.size(); col_idx++) {
+      values[col_idx] = GetOutputSchema()->GetColumn(col_idx).GetExpr()->EvaluateJoin(&left_tuple, left_schema,
+                                                                                        &right_tuple, right_schema);
+    }
+    batch->AppendRow(values, RID());
+  }
+  return batch->GetNumSelected() > 0;
+}
+
+bool NestedLoopJoinExecutor::NextBlock() {
+  block_.clear();
+  while (!left_exhausted_ && block_.size() < plan_->GetBlockSize()) {
+    if (next_left_row_ == left_batch_.GetSelection().size()) {
+      // a child that has run out is not read again
+      left_exhausted_ = !left_->NextBatch(&left_batch_);
+      next_left_row_ = 0;
+      continue;
+    }
+    block_.push_back(left_batch_.ToTuple(left_batch_.GetSelection()[next_left_row_++]));
+  }
+  if (block_.empty()) {
+    return false;
+  }
+  right_->Init();
+  num_right_scans_++;
+  return true;
+}
+
+bool NestedLoopJoinExecutor::NextRightBatch() {
+  right_tuples_.clear();
+  if (block_.empty() || !right_->NextBatch(&right_batch_)) {
+    return false;
+  }
+  right_tuples_.reserve(right_batch_.GetNumSelected());
+  for (uint32_t row : right_batch_.GetSelection()) {
+    right_tuples_.push_back(right_batch_.ToTuple(row));
+  }
+  return true;
+}
 
 }  // namespace bustub
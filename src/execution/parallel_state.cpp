@@ -0,0 +1,51 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// parallel_state.cpp
+//
+// Identification: src/execution/parallel_state.cpp
+//
+// Copyright (c) 2015-2021, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "execution/parallel_state.h"
+
+#include <algorithm>
+
+#include "common/exception.h"
+
+namespace bustub {
+
+bool ParallelState::CanParallelize(const AbstractPlanNode *plan) {
+  switch (plan->GetType()) {
+    case PlanType::SeqScan:
+    case PlanType::HashJoin:
+    case PlanType::Aggregation:
+      return std::all_of(plan->GetChildren().begin(), plan->GetChildren().end(), CanParallelize);
+    default:
+      // every other executor produces its whole output in each worker that runs it
+      return false;
+  }
+}
+
+void ParallelState::ArriveAndWait(const AbstractPlanNode *plan) {
+  std::unique_lock lock(latch_);
+  uint32_t arrivals = ++arrivals_[plan];
+  if (arrivals == num_workers_) {
+    arrived_.notify_all();
+  }
+  arrived_.wait(lock, [&] { return aborted_ || arrivals_[plan] == num_workers_; });
+  if (aborted_) {
+    throw Exception("Another worker of the parallel query failed");
+  }
+}
+
+void ParallelState::Abort() {
+  std::scoped_lock lock(latch_);
+  aborted_ = true;
+  arrived_.notify_all();
+}
+
+}  // namespace bustub
@@ -1,23 +1,174 @@
-//===----------------------------------------------------------------------===//
-//
-//                         BusTub
-//
-// seq_scan_executor.cpp
-//
-// Identification: src/execution/seq_scan_executor.cpp
-//
-// Copyright (c) 2015-2021, Carnegie Mellon University Database Group
-//
-//===----------------------------------------------------------------------===//
-
-#include "execution/executors/seq_scan_executor.h"
-
-namespace bustub {
-
-SeqScanExecutor::SeqScanExecutor(ExecutorContext *exec_ctx, const SeqScanPlanNode *plan) : AbstractExecutor(exec_ctx) {}
-
-void SeqScanExecutor::Init() {}
-
-bool SeqScanExecutor::Next(Tuple *tuple, RID *rid) { return false; }
-
-}  // namespace bustub
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// seq_scan_executor.cpp
+//
+// Identification: src/execution/seq_scan_executor.cpp
+//
+// Copyright (c) 2015-2021, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "execution/executors/seq_scan_executor.h"
+
+#include <functional>
+#include <utility>
+
+#include "common/config.h"
+#include "execution/expressions/column_value_expression.h"
+#include "execution/parallel_state.h"
+
+namespace bustub {
+
+SeqScanExecutor::SeqScanExecutor(ExecutorContext *exec_ctx, const SeqScanPlanNode *plan)
+    : BatchExecutor(exec_ctx), plan_(plan) {}
+
+SeqScanExecutor::~SeqScanExecutor() { StopScanThreads(); }
+
+void SeqScanExecutor::Init() {
+  StopScanThreads();
+  BatchExecutor::Init();
+  table_info_ = GetExecutorContext()->GetCatalog()->GetTable(plan_->GetTableOid());
+  TableHeap *table_heap = table_info_->table_.get();
+  ParallelState *parallel_state = GetExecutorContext()->GetParallelState();
+  if (parallel_state != nullptr) {
+    morsels_ = parallel_state->GetSharedState<MorselQueue>(plan_, table_heap, parallel_state->GetMorselSize());
+  } else {
+    own_morsels_ = std::make_unique<MorselQueue>(table_heap);
+    morsels_ = own_morsels_.get();
+  }
+  cursor_.morsel_.clear();
+  cursor_.next_page_ = 0;
+  cursor_.page_tuples_.clear();
+  cursor_.next_tuple_ = 0;
+  // a worker of a parallel query is one thread among many already, and locks are only taken on the transaction's own
+  threaded_ = parallel_state == nullptr && plan_->GetNumThreads() > 1 && !enable_logging;
+  results_.reset();
+  error_ = nullptr;
+  join_filter_ = nullptr;
+}
+
+bool SeqScanExecutor::PushDownJoinFilter(const JoinFilter *filter, uint32_t col_idx) {
+  // a tuple the filter drops is never read, so it would miss the lock reading it takes under logging
+  const auto *column = dynamic_cast<const ColumnValueExpression *>(GetOutputSchema()->GetColumn(col_idx).GetExpr());
+  if (column == nullptr || enable_logging) {
+    return false;
+  }
+  join_filter_ = filter;
+  join_filter_column_ = column->GetColIdx();
+  return true;
+}
+
+bool SeqScanExecutor::NextBatch(TupleBatch *batch) {
+  if (!threaded_) {
+    return ScanBatch(&cursor_, batch);
+  }
+  if (results_ == nullptr) {
+    StartScanThreads(batch->GetCapacity());
+  }
+  if (results_->Pop(batch)) {
+    return true;
+  }
+  // the queue is closed once every thread is done, or as soon as one of them fails
+  StopScanThreads();
+  if (error_ != nullptr) {
+    std::rethrow_exception(std::exchange(error_, nullptr));
+  }
+  batch->Reset(GetOutputSchema());
+  return false;
+}
+
+bool SeqScanExecutor::ScanBatch(ScanCursor *cursor, TupleBatch *batch) {
+  while (FillScanBatch(cursor, batch->GetCapacity())) {
+    if (plan_->GetPredicate() != nullptr) {
+      cursor->scan_batch_.Select(plan_->GetPredicate());
+    }
+    if (cursor->scan_batch_.GetNumSelected() > 0) {
+      batch->Project(cursor->scan_batch_, GetOutputSchema());
+      return true;
+    }
+  }
+  batch->Reset(GetOutputSchema());
+  return false;
+}
+
+bool SeqScanExecutor::FillScanBatch(ScanCursor *cursor, uint32_t capacity) {
+  cursor->scan_batch_.Reset(&table_info_->schema_);
+  while (cursor->scan_batch_.GetNumRows() < capacity) {
+    if (cursor->next_tuple_ == cursor->page_tuples_.size()) {
+      if (!ReadNextPage(cursor)) {
+        break;
+      }
+      continue;
+    }
+    const Tuple &tuple = cursor->page_tuples_[cursor->next_tuple_++];
+    cursor->scan_batch_.AppendTuple(tuple, tuple.GetRid());
+  }
+  return cursor->scan_batch_.GetNumRows() > 0;
+}
+
+bool SeqScanExecutor::ReadNextPage(ScanCursor *cursor) {
+  cursor->page_tuples_.clear();
+  cursor->next_tuple_ = 0;
+  if (cursor->next_page_ == cursor->morsel_.size()) {
+    // an empty morsel, once the queue runs out, keeps this true
+    cursor->next_page_ = 0;
+    if (!morsels_->Next(&cursor->morsel_)) {
+      return false;
+    }
+  }
+  std::function<bool(const Tuple &)> filter;
+  if (join_filter_ != nullptr) {
+    filter = [this](const Tuple &tuple) {
+      return join_filter_->MayContain(tuple.GetValue(&table_info_->schema_, join_filter_column_));
+    };
+  }
+  table_info_->table_->GetPageTuples(cursor->morsel_[cursor->next_page_++], &cursor->page_tuples_,
+                                     GetExecutorContext()->GetTransaction(), filter);
+  return true;
+}
+
+void SeqScanExecutor::StartScanThreads(uint32_t capacity) {
+  uint32_t num_threads = plan_->GetNumThreads();
+  // a couple of batches per thread lets every thread run ahead of the consumer, but not by much
+  results_ = std::make_unique<BoundedQueue<TupleBatch>>(2 * num_threads);
+  num_running_ = num_threads;
+  for (uint32_t i = 0; i < num_threads; i++) {
+    scan_threads_.emplace_back(&SeqScanExecutor::RunScanThread, this, capacity);
+  }
+}
+
+void SeqScanExecutor::RunScanThread(uint32_t capacity) {
+  try {
+    ScanCursor cursor;
+    TupleBatch batch{capacity};
+    // a push fails once the scan is stopped, before it reached the end
+    while (ScanBatch(&cursor, &batch) && results_->Push(std::move(batch))) {
+      batch = TupleBatch{capacity};
+    }
+  } catch (...) {
+    {
+      std::scoped_lock lock(error_latch_);
+      if (error_ == nullptr) {
+        error_ = std::current_exception();
+      }
+    }
+    results_->Close();
+  }
+  if (--num_running_ == 0) {
+    results_->Close();
+  }
+}
+
+void SeqScanExecutor::StopScanThreads() {
+  if (results_ != nullptr) {
+    results_->Close();
+  }
+  for (auto &thread : scan_threads_) {
+    thread.join();
+  }
+  scan_threads_.clear();
+}
+
+}  // namespace bustub
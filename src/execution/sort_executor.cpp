@@ -0,0 +1,130 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// sort_executor.cpp
+//
+// Identification: src/execution/sort_executor.cpp
+//
+// Copyright (c) 2015-2021, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "execution/executors/sort_executor.h"
+
+#include <algorithm>
+#include <string_view>
+
+namespace bustub {
+
+SortExecutor::SortExecutor(ExecutorContext *exec_ctx, const SortPlanNode *plan,
+                           std::unique_ptr<AbstractExecutor> &&child)
+    : BatchExecutor(exec_ctx),
+      plan_(plan),
+      child_(std::move(child)),
+      encoder_(plan->GetOrderBys()),
+      // a merge reads as many runs at once as the budget has pages for
+      merger_(this, plan->GetMemoryBudget() / PAGE_SIZE) {}
+
+void SortExecutor::Init() {
+  BatchExecutor::Init();
+  child_->Init();
+  arena_.clear();
+  entries_.clear();
+  merger_.Clear();
+  num_spilled_runs_ = 0;
+
+  TupleBatch batch;
+  std::vector<std::string> keys;
+  while (child_->NextBatch(&batch)) {
+    encoder_.EncodeBatch(batch, &keys);
+    for (uint32_t row : batch.GetSelection()) {
+      AppendRow(keys[row], batch.ToTuple(row));
+      if (arena_.size() + entries_.size() * sizeof(RowEntry) > plan_->GetMemoryBudget()) {
+        SpillRows();
+      }
+    }
+  }
+
+  // the rows left make the last run, which keeps them in memory
+  SortRows();
+  merger_.AddRun(Run{});
+  num_spilled_runs_ += merger_.MergeRunGroups(merger_.GetFanIn());
+  merger_.StartMerge();
+}
+
+bool SortExecutor::NextBatch(TupleBatch *batch) {
+  batch->Reset(GetOutputSchema());
+  for (const Run *run; !batch->IsFull() && (run = merger_.MinRun()) != nullptr; merger_.AdvanceMinRun()) {
+    batch->AppendTuple(run->tuples_[run->next_row_], RID());
+  }
+  return batch->GetNumSelected() > 0;
+}
+
+void SortExecutor::AppendRow(const std::string &key, const Tuple &tuple) {
+  entries_.push_back({arena_.size(), static_cast<uint32_t>(key.size())});
+  arena_.insert(arena_.end(), key.begin(), key.end());
+  // the tuple serializes as its length followed by its data
+  size_t offset = arena_.size();
+  arena_.resize(offset + sizeof(uint32_t) + tuple.GetLength());
+  tuple.SerializeTo(arena_.data() + offset);
+}
+
+void SortExecutor::SortRows() {
+  const char *arena = arena_.data();
+  std::stable_sort(entries_.begin(), entries_.end(), [arena](const RowEntry &a, const RowEntry &b) {
+    return std::string_view(arena + a.offset_, a.key_size_) < std::string_view(arena + b.offset_, b.key_size_);
+  });
+}
+
+void SortExecutor::SpillRows() {
+  SortRows();
+  Run run = NewRun();
+  Tuple tuple;
+  for (const auto &entry : entries_) {
+    tuple.DeserializeFrom(arena_.data() + entry.offset_ + entry.key_size_);
+    run.file_->Append(tuple);
+  }
+  SealRun(&run);
+  merger_.AddRun(std::move(run));
+  num_spilled_runs_++;
+  arena_.clear();
+  entries_.clear();
+}
+
+bool SortExecutor::FillRun(Run *run) {
+  if (run->next_row_ < run->tuples_.size()) {
+    return true;
+  }
+  run->tuples_.clear();
+  run->keys_.clear();
+  run->next_row_ = 0;
+
+  if (run->file_ == nullptr) {
+    // the run in memory hands out a batch's worth of its rows at a time
+    size_t end = std::min<size_t>(entries_.size(), run->next_entry_ + TupleBatch::DEFAULT_CAPACITY);
+    run->tuples_.reserve(end - run->next_entry_);
+    for (; run->next_entry_ < end; run->next_entry_++) {
+      const RowEntry &entry = entries_[run->next_entry_];
+      run->keys_.emplace_back(arena_.data() + entry.offset_, entry.key_size_);
+      run->tuples_.emplace_back();
+      run->tuples_.back().DeserializeFrom(arena_.data() + entry.offset_ + entry.key_size_);
+    }
+    return !run->tuples_.empty();
+  }
+
+  // a spilled run keeps only the tuples, whose keys are encoded again as their page is read
+  while (run->tuples_.empty()) {
+    if (!run->file_->ReadPage(&run->tuples_)) {
+      return false;
+    }
+  }
+  page_batch_.Reset(child_->GetOutputSchema());
+  for (const auto &tuple : run->tuples_) {
+    page_batch_.AppendTuple(tuple, RID());
+  }
+  encoder_.EncodeBatch(page_batch_, &run->keys_);
+  return true;
+}
+
+}  // namespace bustub
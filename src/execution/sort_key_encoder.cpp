@@ -0,0 +1,40 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// sort_key_encoder.cpp
+//
+// Identification: src/execution/sort_key_encoder.cpp
+//
+// Copyright (c) 2015-2021, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "execution/sort_key_encoder.h"
+
+#include "execution/expressions/abstract_expression.h"
+#include "storage/index/key_encoder.h"
+
+namespace bustub {
+
+void SortKeyEncoder::EncodeBatch(const TupleBatch &batch, std::vector<std::string> *keys) {
+  keys->resize(batch.GetNumRows());
+  for (auto &key : *keys) {
+    key.clear();
+  }
+  for (const auto &[order_by_type, expr] : order_bys_) {
+    expr->EvaluateBatch(batch, &values_);
+    for (uint32_t row = 0; row < batch.GetNumRows(); row++) {
+      std::string &key = (*keys)[row];
+      size_t begin = key.size();
+      KeyEncoder::AppendValue(values_[row], &key);
+      if (order_by_type == OrderByType::Desc) {
+        for (size_t i = begin; i < key.size(); i++) {
+          key[i] = static_cast<char>(~key[i]);
+        }
+      }
+    }
+  }
+}
+
+}  // namespace bustub
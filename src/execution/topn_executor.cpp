@@ -0,0 +1,77 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// topn_executor.cpp
+//
+// Identification: src/execution/topn_executor.cpp
+//
+// Copyright (c) 2015-2021, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "execution/executors/topn_executor.h"
+
+#include <algorithm>
+
+namespace bustub {
+
+TopNExecutor::TopNExecutor(ExecutorContext *exec_ctx, const TopNPlanNode *plan,
+                           std::unique_ptr<AbstractExecutor> &&child)
+    : BatchExecutor(exec_ctx), plan_(plan), child_(std::move(child)), encoder_(plan->GetOrderBys()) {}
+
+void TopNExecutor::Init() {
+  BatchExecutor::Init();
+  child_->Init();
+  keys_.clear();
+  positions_.clear();
+  tuples_.clear();
+  heap_.clear();
+  next_slot_ = 0;
+
+  size_t n = plan_->GetN();
+  auto before = [this](size_t a, size_t b) { return SlotBefore(a, b); };
+  TupleBatch batch;
+  std::vector<std::string> keys;
+  size_t position = 0;
+  while (child_->NextBatch(&batch)) {
+    encoder_.EncodeBatch(batch, &keys);
+    for (uint32_t row : batch.GetSelection()) {
+      if (heap_.size() < n) {
+        heap_.push_back(keys_.size());
+        keys_.push_back(std::move(keys[row]));
+        positions_.push_back(position++);
+        tuples_.push_back(batch.ToTuple(row));
+        std::push_heap(heap_.begin(), heap_.end(), before);
+        continue;
+      }
+      // the row came after every row kept, so it must come strictly before the last of them to take its place
+      if (n == 0 || keys[row] >= keys_[heap_.front()]) {
+        position++;
+        continue;
+      }
+      std::pop_heap(heap_.begin(), heap_.end(), before);
+      size_t slot = heap_.back();
+      keys_[slot] = std::move(keys[row]);
+      positions_[slot] = position++;
+      tuples_[slot] = batch.ToTuple(row);
+      std::push_heap(heap_.begin(), heap_.end(), before);
+    }
+  }
+  std::sort_heap(heap_.begin(), heap_.end(), before);
+}
+
+bool TopNExecutor::NextBatch(TupleBatch *batch) {
+  batch->Reset(GetOutputSchema());
+  for (; !batch->IsFull() && next_slot_ < heap_.size(); next_slot_++) {
+    batch->AppendTuple(tuples_[heap_[next_slot_]], RID());
+  }
+  return batch->GetNumSelected() > 0;
+}
+
+bool TopNExecutor::SlotBefore(size_t a, size_t b) const {
+  int cmp = keys_[a].compare(keys_[b]);
+  return cmp < 0 || (cmp == 0 && positions_[a] < positions_[b]);
+}
+
+}  // namespace bustub
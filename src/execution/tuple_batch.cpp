@@ -0,0 +1,84 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// tuple_batch.cpp
+//
+// Identification: src/execution/tuple_batch.cpp
+//
+// Copyright (c) 2015-2021, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "execution/tuple_batch.h"
+
+#include <algorithm>
+
+#include "execution/expressions/abstract_expression.h"
+
+namespace bustub {
+
+void TupleBatch::Reset(const Schema *schema) {
+  schema_ = schema;
+  // keep the vectors around, so that a batch reused across calls allocates only once
+  columns_.resize(schema->GetColumnCount());
+  for (auto &column : columns_) {
+    column.clear();
+  }
+  rids_.clear();
+  selection_.clear();
+}
+
+void TupleBatch::AppendTuple(const Tuple &tuple, const RID &rid) {
+  selection_.push_back(GetNumRows());
+  for (uint32_t col_idx = 0; col_idx < columns_.size(); col_idx++) {
+    columns_[col_idx].push_back(tuple.GetValue(schema_, col_idx));
+  }
+  rids_.push_back(rid);
+}
+
+void TupleBatch::AppendRow(const std::vector<Value> &values, const RID &rid) {
+  selection_.push_back(GetNumRows());
+  for (uint32_t col_idx = 0; col_idx < columns_.size(); col_idx++) {
+    columns_[col_idx].push_back(values[col_idx]);
+  }
+  rids_.push_back(rid);
+}
+
+void TupleBatch::Resize(uint32_t num_rows) {
+  for (auto &column : columns_) {
+    column.resize(num_rows);
+  }
+  rids_.resize(num_rows);
+  selection_.resize(num_rows);
+  for (uint32_t row = 0; row < num_rows; row++) {
+    selection_[row] = row;
+  }
+}
+
+void TupleBatch::Select(const AbstractExpression *predicate) {
+  std::vector<Value> result;
+  predicate->EvaluateBatch(*this, &result);
+  auto rejected = [&result](uint32_t row) { return result[row].IsNull() || !result[row].GetAs<bool>(); };
+  selection_.erase(std::remove_if(selection_.begin(), selection_.end(), rejected), selection_.end());
+}
+
+void TupleBatch::Project(const TupleBatch &input, const Schema *schema) {
+  Reset(schema);
+  for (uint32_t col_idx = 0; col_idx < columns_.size(); col_idx++) {
+    schema->GetColumn(col_idx).GetExpr()->EvaluateBatch(input, &columns_[col_idx]);
+  }
+  rids_ = input.rids_;
+  selection_ = input.selection_;
+}
+
+Tuple TupleBatch::ToTuple(uint32_t row) const {
+  std::vector<Value> values;
+  values.reserve(columns_.size());
+  for (const auto &column : columns_) {
+    values.push_back(column[row]);
+  }
+  return Tuple(values, schema_);
+}
+
+}  // namespace bustub
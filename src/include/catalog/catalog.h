@@ -21,8 +21,10 @@
 #include "buffer/buffer_pool_manager.h"
 #include "catalog/schema.h"
 #include "container/hash/hash_function.h"
+#include "storage/index/b_plus_tree_index.h"
 #include "storage/index/extendible_hash_table_index.h"
 #include "storage/index/index.h"
+#include "storage/index/index_factory.h"
 #include "storage/table/table_heap.h"
 
 namespace bustub {
@@ -186,57 +188,59 @@ class Catalog {
    * @param key_attrs Key attributes
    * @param keysize Size of the key
    * @param hash_function The hash function for the index
+   * @param include_attrs Columns stored in the index entries next to the key, for index-only scans; an index with
+   * included columns is a unique B+ tree, and the key and included columns together must fit in KeyType
    * @return A (non-owning) pointer to the metadata of the new table
    */
   template <class KeyType, class ValueType, class KeyComparator>
   IndexInfo *CreateIndex(Transaction *txn, const std::string &index_name, const std::string &table_name,
                          const Schema &schema, const Schema &key_schema, const std::vector<uint32_t> &key_attrs,
-                         std::size_t keysize, HashFunction<KeyType> hash_function) {
-    // Reject the creation request for nonexistent table
-    if (table_names_.find(table_name) == table_names_.end()) {
-      return NULL_INDEX_INFO;
-    }
-
-    // If the table exists, an entry for the table should already be present in index_names_
-    BUSTUB_ASSERT((index_names_.find(table_name) != index_names_.end()), "Broken Invariant");
-
-    // Determine if the requested index already exists for this table
-    auto &table_indexes = index_names_.find(table_name)->second;
-    if (table_indexes.find(index_name) != table_indexes.end()) {
-      // The requested index already exists for this table
+                         std::size_t keysize, HashFunction<KeyType> hash_function,
+                         const std::vector<uint32_t> &include_attrs = {}) {
+    if (!CanCreateIndex(index_name, table_name)) {
       return NULL_INDEX_INFO;
     }
 
     // Construct index metdata
-    auto meta = std::make_unique<IndexMetadata>(index_name, table_name, &schema, key_attrs);
+    auto meta = std::make_unique<IndexMetadata>(index_name, table_name, &schema, key_attrs, include_attrs);
 
     // Construct the index, take ownership of metadata
-    // TODO(Kyle): We should update the API for CreateIndex
-    // to allow specification of the index type itself, not
-    // just the key, value, and comparator types
-    auto index = std::make_unique<ExtendibleHashTableIndex<KeyType, ValueType, KeyComparator>>(std::move(meta), bpm_,
-                                                                                               hash_function);
-
-    // Populate the index with all tuples in table heap
-    auto *table_meta = GetTable(table_name);
-    auto *heap = table_meta->table_.get();
-    for (auto tuple = heap->Begin(txn); tuple != heap->End(); ++tuple) {
-      index->InsertEntry(tuple->KeyFromTuple(schema, key_schema, key_attrs), tuple->GetRid(), txn);
+    std::unique_ptr<Index> index;
+    if (include_attrs.empty()) {
+      index = std::make_unique<ExtendibleHashTableIndex<KeyType, ValueType, KeyComparator>>(std::move(meta), bpm_,
+                                                                                            hash_function);
+    } else {
+      index = std::make_unique<BPlusTreeIndex<KeyType, ValueType, KeyComparator>>(std::move(meta), bpm_);
     }
 
-    // Get the next OID for the new index
-    const auto index_oid = next_index_oid_.fetch_add(1);
-
-    // Construct index information; IndexInfo takes ownership of the Index itself
-    auto index_info =
-        std::make_unique<IndexInfo>(key_schema, index_name, std::move(index), index_oid, table_name, keysize);
-    auto *tmp = index_info.get();
+    return AddIndex(txn, table_name, schema, key_schema, std::move(index), keysize);
+  }
 
-    // Update internal tracking
-    indexes_.emplace(index_oid, std::move(index_info));
-    table_indexes.emplace(index_name, index_oid);
+  /**
+   * Create a new index of the given type, populate existing data of the table and return its metadata. The key size
+   * is picked to fit the key, see IndexFactory.
+   * @param txn The transaction in which the table is being created
+   * @param index_name The name of the new index
+   * @param table_name The name of the table
+   * @param schema The schema of the table
+   * @param key_attrs Key attributes
+   * @param index_type The index implementation to use
+   * @param unique_keys Whether a key may have only one RID; only B+ tree indexes can be unique
+   * @param include_attrs Columns stored in the index entries next to the key, for index-only scans; only unique B+
+   * tree indexes take them
+   * @return A (non-owning) pointer to the metadata of the new table
+   */
+  IndexInfo *CreateIndex(Transaction *txn, const std::string &index_name, const std::string &table_name,
+                         const Schema &schema, const std::vector<uint32_t> &key_attrs, IndexType index_type,
+                         bool unique_keys = true, const std::vector<uint32_t> &include_attrs = {}) {
+    if (!CanCreateIndex(index_name, table_name)) {
+      return NULL_INDEX_INFO;
+    }
 
-    return tmp;
+    auto meta = std::make_unique<IndexMetadata>(index_name, table_name, &schema, key_attrs, include_attrs);
+    std::size_t keysize = IndexFactory::KeySize(index_type, *meta);
+    auto index = IndexFactory::Create(index_type, std::move(meta), bpm_, unique_keys);
+    return AddIndex(txn, table_name, schema, *index->GetKeySchema(), std::move(index), keysize);
   }
 
   /**
@@ -323,6 +327,45 @@ class Catalog {
   }
 
  private:
+  /** @return whether the table exists and has no index of that name yet */
+  bool CanCreateIndex(const std::string &index_name, const std::string &table_name) {
+    // Reject the creation request for nonexistent table
+    if (table_names_.find(table_name) == table_names_.end()) {
+      return false;
+    }
+
+    // If the table exists, an entry for the table should already be present in index_names_
+    BUSTUB_ASSERT((index_names_.find(table_name) != index_names_.end()), "Broken Invariant");
+
+    // Determine if the requested index already exists for this table
+    const auto &table_indexes = index_names_.find(table_name)->second;
+    return table_indexes.find(index_name) == table_indexes.end();
+  }
+
+  /** Populate a new index with all tuples of its table and register it. */
+  IndexInfo *AddIndex(Transaction *txn, const std::string &table_name, const Schema &schema, const Schema &key_schema,
+                      std::unique_ptr<Index> &&index, std::size_t keysize) {
+    // Populate the index with all tuples in table heap
+    auto *table_meta = GetTable(table_name);
+    auto *heap = table_meta->table_.get();
+    index->BuildFromTable(heap, schema, txn);
+
+    // Get the next OID for the new index
+    const auto index_oid = next_index_oid_.fetch_add(1);
+
+    // Construct index information; IndexInfo takes ownership of the Index itself
+    std::string index_name = index->GetName();
+    auto index_info =
+        std::make_unique<IndexInfo>(key_schema, index_name, std::move(index), index_oid, table_name, keysize);
+    auto *tmp = index_info.get();
+
+    // Update internal tracking
+    indexes_.emplace(index_oid, std::move(index_info));
+    index_names_.find(table_name)->second.emplace(index_name, index_oid);
+
+    return tmp;
+  }
+
   [[maybe_unused]] BufferPoolManager *bpm_;
   [[maybe_unused]] LockManager *lock_manager_;
   [[maybe_unused]] LogManager *log_manager_;
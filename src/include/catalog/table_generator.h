@@ -31,7 +31,6 @@ class TableGenerator {
    */
   void GenerateTestTables();
 
- private:
   /** Enumeration to characterize the distribution of values in a given column */
   enum class Dist : uint8_t { Uniform, Zipf_50, Zipf_75, Zipf_95, Zipf_99, Serial, Cyclic };
 
@@ -65,9 +64,13 @@ class TableGenerator {
      */
     uint64_t max_;
     /**
-     * Counter to generate serial data
+     * Counter to generate serial data, and of the values generated so far for Zipf data
      */
     uint64_t serial_counter_{0};
+    /**
+     * Normalization constant of a Zipf distribution, computed with the first values
+     */
+    double zipf_zeta_{0};
 
     /**
      * Constructor
@@ -101,6 +104,13 @@ class TableGenerator {
         : name_(name), num_rows_(num_rows), col_meta_(std::move(col_meta)) {}
   };
 
+  /**
+   * Generate a table besides the test tables, e.g. one with skewed columns for a benchmark.
+   * @return the new table
+   */
+  TableInfo *GenerateTable(TableInsertMeta *table_meta);
+
+ private:
   void FillTable(TableInfo *info, TableInsertMeta *table_meta);
 
   std::vector<Value> MakeValues(ColumnInsertMeta *col_meta, uint32_t count);
@@ -108,7 +118,6 @@ class TableGenerator {
   template <typename CppType>
   std::vector<Value> GenNumericValues(ColumnInsertMeta *col_meta, uint32_t count);
 
- private:
   ExecutorContext *exec_ctx_;
 };
 }  // namespace bustub
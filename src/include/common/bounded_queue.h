@@ -0,0 +1,88 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// bounded_queue.h
+//
+// Identification: src/include/common/bounded_queue.h
+//
+// Copyright (c) 2015-2021, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <condition_variable>  // NOLINT
+#include <deque>
+#include <mutex>  // NOLINT
+#include <utility>
+
+namespace bustub {
+
+/**
+ * BoundedQueue is a blocking FIFO queue of at most a fixed number of items, for handing work from producer threads
+ * to consumer threads. Producers block while the queue is full, so they can only run so far ahead of the consumers,
+ * and consumers block while it is empty.
+ *
+ * Closing the queue ends the exchange from either side: pushes fail from then on, and pops fail once the items left
+ * in the queue have been taken.
+ */
+template <typename T>
+class BoundedQueue {
+ public:
+  explicit BoundedQueue(size_t capacity) : capacity_(capacity) {}
+
+  /**
+   * Append an item, waiting for room if the queue is full.
+   * @return false if the queue is closed, in which case the item is dropped
+   */
+  bool Push(T item) {
+    std::unique_lock lock(latch_);
+    not_full_.wait(lock, [&] { return closed_ || items_.size() < capacity_; });
+    if (closed_) {
+      return false;
+    }
+    items_.push_back(std::move(item));
+    not_empty_.notify_one();
+    return true;
+  }
+
+  /**
+   * Take the oldest item, waiting for one if the queue is empty.
+   * @param[out] item the item taken
+   * @return false if the queue is closed and empty
+   */
+  bool Pop(T *item) {
+    std::unique_lock lock(latch_);
+    not_empty_.wait(lock, [&] { return closed_ || !items_.empty(); });
+    if (items_.empty()) {
+      return false;
+    }
+    *item = std::move(items_.front());
+    items_.pop_front();
+    not_full_.notify_one();
+    return true;
+  }
+
+  /** Close the queue, waking up every thread waiting on it. */
+  void Close() {
+    {
+      std::scoped_lock lock(latch_);
+      closed_ = true;
+    }
+    not_full_.notify_all();
+    not_empty_.notify_all();
+  }
+
+ private:
+  /** The number of items the queue holds at most. */
+  const size_t capacity_;
+  /** Protects items_ and closed_. */
+  std::mutex latch_;
+  std::condition_variable not_full_;
+  std::condition_variable not_empty_;
+  std::deque<T> items_;
+  bool closed_{false};
+};
+
+}  // namespace bustub
@@ -21,6 +21,9 @@ namespace bustub {
 /** Cycle detection is performed every CYCLE_DETECTION_INTERVAL milliseconds. */
 extern std::chrono::milliseconds cycle_detection_interval;
 
+/** B+ trees with a merge thread merge the pages lazy removes left underfull every INDEX_MERGE_INTERVAL milliseconds. */
+extern std::chrono::milliseconds index_merge_interval;
+
 /** True if logging should be enabled, false otherwise. */
 extern std::atomic<bool> enable_logging;
 
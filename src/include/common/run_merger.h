@@ -0,0 +1,158 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// run_merger.h
+//
+// Identification: src/include/common/run_merger.h
+//
+// Copyright (c) 2015-2021, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <algorithm>
+#include <iterator>
+#include <utility>
+#include <vector>
+
+namespace bustub {
+
+/**
+ * RunMerger is the merge half of an external merge sort: it holds the sorted runs a sort wrote out, merges them into
+ * fewer, longer runs while there are too many to merge at once, and finally hands out the entries of all of them in
+ * order, through a heap on the current entry of each run.
+ *
+ * What a run holds, and how it is written and read back, is up to the store, which provides:
+ *
+ *   Run                                          a movable run, read through a cursor on its current entry
+ *   Run NewRun()                                 an empty run to write to
+ *   void AppendToRun(Run *run, const Run &from)  append the current entry of from to run
+ *   void SealRun(Run *run)                       finish writing a run, so that it reads from its first entry
+ *   bool FillRun(Run *run)                       make sure a run has a current entry; false once it is exhausted
+ *   void AdvanceRun(Run *run)                    move a run on from its current entry
+ *   int CompareRuns(const Run &a, const Run &b)  the order of the current entries of two runs, like memcmp
+ *
+ * Runs stay in the order they were added in, and ties between runs go to the earlier one, so merging stably sorted
+ * runs is stable too. With unique entries, every run must hold distinct entries, and of equal entries in different
+ * runs only the one of the earliest run is kept.
+ */
+template <typename Store>
+class RunMerger {
+ public:
+  using Run = typename Store::Run;
+
+  /**
+   * @param store the store of the runs
+   * @param fan_in the number of runs merged at once, at least two
+   * @param unique_entries whether equal entries are merged into one
+   */
+  RunMerger(Store *store, size_t fan_in, bool unique_entries = false)
+      : store_(store), fan_in_(std::max<size_t>(fan_in, 2)), unique_entries_(unique_entries) {}
+
+  /** Adds a sealed run, after all the runs added before it. */
+  void AddRun(Run &&run) { runs_.push_back(std::move(run)); }
+
+  /** Drops every run, and any merge in progress. */
+  void Clear() {
+    runs_.clear();
+    heap_.clear();
+  }
+
+  /** @return the number of runs merged at once */
+  size_t GetFanIn() const { return fan_in_; }
+
+  /** @return the runs, in the order they were added in */
+  std::vector<Run> &GetRuns() { return runs_; }
+
+  /**
+   * Merges consecutive groups of fan_in runs into single runs until at most max_runs are left.
+   * @return the number of runs written
+   */
+  size_t MergeRunGroups(size_t max_runs) {
+    size_t num_written = 0;
+    while (runs_.size() > std::max<size_t>(max_runs, 1)) {
+      std::vector<Run> merged_runs;
+      for (size_t begin = 0; begin < runs_.size(); begin += fan_in_) {
+        size_t end = std::min(begin + fan_in_, runs_.size());
+        if (end - begin == 1) {
+          merged_runs.push_back(std::move(runs_[begin]));
+          continue;
+        }
+        RunMerger group(store_, fan_in_, unique_entries_);
+        group.runs_.assign(std::make_move_iterator(runs_.begin() + begin),
+                           std::make_move_iterator(runs_.begin() + end));
+        group.StartMerge();
+        Run merged = store_->NewRun();
+        for (const Run *run; (run = group.MinRun()) != nullptr; group.AdvanceMinRun()) {
+          store_->AppendToRun(&merged, *run);
+        }
+        store_->SealRun(&merged);
+        merged_runs.push_back(std::move(merged));
+        num_written++;
+      }
+      runs_ = std::move(merged_runs);
+    }
+    return num_written;
+  }
+
+  /** Starts merging the runs; their entries are then read through MinRun() and AdvanceMinRun(). */
+  void StartMerge() {
+    heap_.clear();
+    for (size_t run_idx = 0; run_idx < runs_.size(); run_idx++) {
+      if (store_->FillRun(&runs_[run_idx])) {
+        heap_.push_back(run_idx);
+      }
+    }
+    std::make_heap(heap_.begin(), heap_.end(), RunAfter{this});
+  }
+
+  /** @return the run whose current entry comes first, or nullptr once every run is exhausted */
+  const Run *MinRun() const { return heap_.empty() ? nullptr : &runs_[heap_.front()]; }
+
+  /** Moves on from the first entry, and with unique entries, from the entries of later runs equal to it. */
+  void AdvanceMinRun() {
+    size_t min_run = PopRun();
+    while (unique_entries_ && !heap_.empty() && store_->CompareRuns(runs_[heap_.front()], runs_[min_run]) == 0) {
+      PushRun(PopRun());
+    }
+    PushRun(min_run);
+  }
+
+ private:
+  // the heap is a max-heap on this order, which makes its front the run whose entry comes first
+  struct RunAfter {
+    bool operator()(size_t a, size_t b) const {
+      int cmp = merger_->store_->CompareRuns(merger_->runs_[a], merger_->runs_[b]);
+      return cmp > 0 || (cmp == 0 && a > b);
+    }
+    const RunMerger *merger_;
+  };
+
+  // takes the run with the first entry off the heap, without moving it on
+  size_t PopRun() {
+    std::pop_heap(heap_.begin(), heap_.end(), RunAfter{this});
+    size_t run_idx = heap_.back();
+    heap_.pop_back();
+    return run_idx;
+  }
+
+  // moves a run taken off the heap on to its next entry, and puts it back unless it is exhausted
+  void PushRun(size_t run_idx) {
+    store_->AdvanceRun(&runs_[run_idx]);
+    if (store_->FillRun(&runs_[run_idx])) {
+      heap_.push_back(run_idx);
+      std::push_heap(heap_.begin(), heap_.end(), RunAfter{this});
+    }
+  }
+
+  Store *store_;
+  size_t fan_in_;
+  bool unique_entries_;
+  std::vector<Run> runs_;
+  // the positions in runs_ of the runs with an entry left
+  std::vector<size_t> heap_;
+};
+
+}  // namespace bustub
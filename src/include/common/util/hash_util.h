@@ -13,12 +13,16 @@
 #pragma once
 
 #include <algorithm>
+#include <cstdint>
 #include <cstdlib>
+#include <cstring>
 #include <iostream>
 #include <string>
+#include <type_traits>
 
 #include "common/macros.h"
 #include "type/value.h"
+#include "wyhash/wyhash.h"
 
 namespace bustub {
 
@@ -29,32 +33,38 @@ class HashUtil {
   static const hash_t PRIME_FACTOR = 10000019;
 
  public:
+  /**
+   * Hash an arbitrary byte string. This is wyhash: it consumes the input a word at a time and is
+   * several times faster than a per-byte shift/xor loop on anything longer than a couple of bytes.
+   */
   static inline hash_t HashBytes(const char *bytes, size_t length) {
-    // https://github.com/greenplum-db/gpos/blob/b53c1acd6285de94044ff91fbee91589543feba1/libgpos/src/utils.cpp#L126
-    hash_t hash = length;
-    for (size_t i = 0; i < length; ++i) {
-      hash = ((hash << 5) ^ (hash >> 27)) ^ bytes[i];
-    }
-    return hash;
+    return static_cast<hash_t>(wyhash::Hash(bytes, length));
   }
 
+  /** Hash a single fixed-width integer without going through the byte-string path. */
+  static inline hash_t HashInt(uint64_t val) { return static_cast<hash_t>(wyhash::Hash64(val)); }
+
   static inline hash_t CombineHashes(hash_t l, hash_t r) {
-    hash_t both[2] = {};
-    both[0] = l;
-    both[1] = r;
-    return HashBytes(reinterpret_cast<char *>(both), sizeof(hash_t) * 2);
+    return static_cast<hash_t>(wyhash::Hash64(r, wyhash::Mix(l, wyhash::kSecret[2])));
   }
 
   static inline hash_t SumHashes(hash_t l, hash_t r) { return (l % PRIME_FACTOR + r % PRIME_FACTOR) % PRIME_FACTOR; }
 
   template <typename T>
   static inline hash_t Hash(const T *ptr) {
-    return HashBytes(reinterpret_cast<const char *>(ptr), sizeof(T));
+    if constexpr (sizeof(T) <= sizeof(uint64_t) && std::is_trivially_copyable_v<T>) {
+      // Fixed-width fast path: widen the value to one word and hash that.
+      uint64_t raw = 0;
+      memcpy(&raw, ptr, sizeof(T));
+      return HashInt(raw);
+    } else {
+      return HashBytes(reinterpret_cast<const char *>(ptr), sizeof(T));
+    }
   }
 
   template <typename T>
   static inline hash_t HashPtr(const T *ptr) {
-    return HashBytes(reinterpret_cast<const char *>(&ptr), sizeof(void *));
+    return HashInt(reinterpret_cast<uintptr_t>(ptr));
   }
 
   /** @return the hash of the value */
@@ -0,0 +1,92 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// counting_bloom_filter.h
+//
+// Identification: src/include/container/hash/counting_bloom_filter.h
+//
+// Copyright (c) 2015-2021, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+
+#include "common/macros.h"
+
+namespace bustub {
+
+/**
+ * CountingBloomFilter is an in-memory approximate membership filter that supports deletes.
+ *
+ * It answers "definitely absent" or "maybe present" for a 64-bit key hash. Each cache-line sized block holds 128
+ * 4-bit counters, and every key sets NUM_PROBES counters inside a single block, so a probe touches one cache line.
+ * Counters that reach 15 saturate and are never decremented again; they can only cause false positives.
+ *
+ * Insert, Remove and MayContain are thread-safe with respect to each other. Reset is not.
+ */
+class CountingBloomFilter {
+ public:
+  /** Number of counters set per key. */
+  static constexpr uint32_t NUM_PROBES = 4;
+  /** Number of counters provisioned per expected entry; ~1.5% false positives at full capacity. */
+  static constexpr uint32_t COUNTERS_PER_ENTRY = 12;
+
+  /**
+   * Creates a filter sized for the given number of entries.
+   * @param capacity expected number of entries
+   */
+  explicit CountingBloomFilter(size_t capacity);
+
+  DISALLOW_COPY_AND_MOVE(CountingBloomFilter);
+
+  /** Adds a key hash to the filter. */
+  void Insert(uint64_t hash);
+
+  /** Removes a key hash that was previously inserted. */
+  void Remove(uint64_t hash);
+
+  /** @return false if the key hash was definitely never inserted (or has since been removed) */
+  bool MayContain(uint64_t hash) const;
+
+  /**
+   * Drops all entries and resizes the filter for a new capacity. Not thread-safe.
+   * @param capacity expected number of entries
+   */
+  void Reset(size_t capacity);
+
+  /** @return the number of entries the filter was sized for */
+  size_t GetCapacity() const { return capacity_; }
+
+  /** @return the current number of entries */
+  size_t GetSize() const { return size_.load(std::memory_order_relaxed); }
+
+ private:
+  static constexpr uint32_t WORDS_PER_BLOCK = 8;
+  static constexpr uint32_t COUNTERS_PER_WORD = 16;
+  static constexpr uint64_t COUNTER_MASK = 0xF;
+
+  struct alignas(64) Block {
+    std::atomic<uint64_t> words_[WORDS_PER_BLOCK];
+  };
+
+  /** @return the block that holds every counter for the hash */
+  Block *BlockFor(uint64_t hash) const;
+
+  /** @return the hash the counter positions within a block are drawn from */
+  static uint64_t ProbeHash(uint64_t hash);
+
+  /** @return the index (0-127) within its block of the probe-th counter, 7 bits of the probe hash each */
+  static uint32_t CounterIndex(uint64_t probe_hash, uint32_t probe);
+
+  size_t capacity_;
+  size_t num_blocks_;
+  std::unique_ptr<Block[]> blocks_;
+  std::atomic<size_t> size_{0};
+};
+
+}  // namespace bustub
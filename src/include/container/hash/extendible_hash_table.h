@@ -12,12 +12,14 @@
 
 #pragma once
 
+#include <memory>
 #include <queue>
 #include <string>
 #include <vector>
 
 #include "buffer/buffer_pool_manager.h"
 #include "concurrency/transaction.h"
+#include "container/hash/counting_bloom_filter.h"
 #include "container/hash/hash_function.h"
 #include "storage/page/hash_table_bucket_page.h"
 #include "storage/page/hash_table_directory_page.h"
@@ -40,9 +42,12 @@ class ExtendibleHashTable {
    * @param buffer_pool_manager buffer pool manager to be used
    * @param comparator comparator for keys
    * @param hash_fn the hash function
+   * @param use_membership_filter whether to keep an in-memory filter that answers most lookups of absent keys
+   * without touching the buffer pool
    */
   explicit ExtendibleHashTable(const std::string &name, BufferPoolManager *buffer_pool_manager,
-                               const KeyComparator &comparator, HashFunction<KeyType> hash_fn);
+                               const KeyComparator &comparator, HashFunction<KeyType> hash_fn,
+                               bool use_membership_filter = false);
 
   /**
    * Inserts a key-value pair into the hash table.
@@ -74,6 +79,13 @@ class ExtendibleHashTable {
    */
   bool GetValue(Transaction *transaction, const KeyType &key, std::vector<ValueType> *result);
 
+  /**
+   * Rebuilds the membership filter from the contents of every bucket, sized for twice the current number of
+   * entries. Call this after the table's pages have been loaded from disk; Insert also calls it when the filter
+   * fills up. Does nothing if the table was created without a filter.
+   */
+  void RebuildFilter();
+
   /**
    * Returns the global depth.  Do not touch.
    */
@@ -121,6 +133,15 @@ class ExtendibleHashTable {
    */
   inline uint32_t KeyToPageId(KeyType key, HashTableDirectoryPage *dir_page);
 
+  /**
+   * Fetches a page from the buffer pool manager.
+   *
+   * @param page_id the page_id to fetch
+   * @return a pointer to the page
+   * @throws Exception if the buffer pool has no frame to hold the page
+   */
+  Page *FetchPage(page_id_t page_id);
+
   /**
    * Fetches the directory page from the buffer pool manager.
    *
@@ -154,6 +175,7 @@ class ExtendibleHashTable {
    * 1. The bucket is no longer empty.
    * 2. The bucket has local depth 0.
    * 3. The bucket's local depth doesn't match its split image's local depth.
+   * After a merge the combined bucket is checked against its own split image in the same way.
    *
    * @param transaction a pointer to the current transaction
    * @param key the key that was removed
@@ -169,6 +191,10 @@ class ExtendibleHashTable {
   // Readers includes inserts and removes, writers are splits and merges
   ReaderWriterLatch table_latch_;
   HashFunction<KeyType> hash_fn_;
+
+  // Approximate set of the hashes of all keys in the table, or nullptr if disabled.
+  // Updated under the read side of table_latch_, replaced under the write side.
+  std::unique_ptr<CountingBloomFilter> filter_;
 };
 
 }  // namespace bustub
@@ -13,11 +13,47 @@
 #pragma once
 
 #include <cstdint>
+#include <cstring>
+#include <type_traits>
 
-#include "murmur3/MurmurHash3.h"
+#include "wyhash/wyhash.h"
 
 namespace bustub {
 
+template <size_t KeySize>
+class GenericKey;
+
+/**
+ * HashFunctionTraits picks the hashing strategy for a key type at compile time.
+ *
+ * Integral keys fit in one word and are hashed directly. GenericKey<N> is a fixed-size byte array, so the length
+ * passed to wyhash is a constant and the compiler unrolls the word loop for each N. Everything else is hashed as
+ * raw bytes.
+ */
+template <typename KeyType>
+struct HashFunctionTraits {
+  static inline uint64_t Hash(const KeyType &key) {
+    if constexpr (std::is_integral_v<KeyType> && sizeof(KeyType) <= sizeof(uint64_t)) {
+      return wyhash::Hash64(static_cast<uint64_t>(key));
+    } else {
+      return wyhash::Hash(reinterpret_cast<const void *>(&key), sizeof(KeyType));
+    }
+  }
+};
+
+template <size_t KeySize>
+struct HashFunctionTraits<GenericKey<KeySize>> {
+  static inline uint64_t Hash(const GenericKey<KeySize> &key) {
+    if constexpr (KeySize == sizeof(uint64_t)) {
+      uint64_t word;
+      memcpy(&word, key.data_, sizeof(uint64_t));
+      return wyhash::Hash64(word);
+    } else {
+      return wyhash::Hash(key.data_, KeySize);
+    }
+  }
+};
+
 template <typename KeyType>
 class HashFunction {
  public:
@@ -25,12 +61,7 @@ class HashFunction {
    * @param key the key to be hashed
    * @return the hashed value
    */
-  virtual uint64_t GetHash(KeyType key) {
-    uint64_t hash[2];
-    murmur3::MurmurHash3_x64_128(reinterpret_cast<const void *>(&key), static_cast<int>(sizeof(KeyType)), 0,
-                                 reinterpret_cast<void *>(&hash));
-    return hash[0];
-  }
+  virtual uint64_t GetHash(KeyType key) { return HashFunctionTraits<KeyType>::Hash(key); }
 };
 
 }  // namespace bustub
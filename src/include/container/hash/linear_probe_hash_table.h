@@ -26,12 +26,15 @@
 
 namespace bustub {
 
-#define HASH_TABLE_TYPE LinearProbeHashTable<KeyType, ValueType, KeyComparator>
+#define LINEAR_PROBE_HASH_TABLE_TYPE LinearProbeHashTable<KeyType, ValueType, KeyComparator>
 
 /**
  * Implementation of linear probing hash table that is backed by a buffer pool
  * manager. Non-unique keys are supported. Supports insert and delete. The
  * table dynamically grows once full.
+ *
+ * Removed entries leave tombstones behind, which keep probes going and are only
+ * reclaimed when the table grows.
  */
 template <typename KeyType, typename ValueType, typename KeyComparator>
 class LinearProbeHashTable : public HashTable<KeyType, ValueType, KeyComparator> {
@@ -87,12 +90,41 @@ class LinearProbeHashTable : public HashTable<KeyType, ValueType, KeyComparator>
   size_t GetSize();
 
  private:
+  // create the header and block pages of an empty table with at least num_buckets buckets
+  page_id_t NewTable(size_t num_buckets);
+
+  /*
+   * Move every entry into a new table with at least num_buckets buckets, and at least twice as many as there are
+   * entries, dropping all tombstones, then free the old table. Needs the write latch.
+   */
+  void Grow(size_t num_buckets);
+
+  // GetSize for callers that hold the latch
+  size_t NumBuckets();
+
+  // claim the first free bucket in the key's probe sequence, unless the pair is already there; returns false if the
+  // table has no free bucket left
+  bool InsertInto(page_id_t header_page_id, const KeyType &key, const ValueType &value, bool *inserted);
+
+  /*
+   * Visit the buckets of the table in the key's probe sequence until visit(block, bucket_ind) returns true or every
+   * bucket has been visited. Returns whether visit stopped the probe.
+   *
+   * With for_write, each block is write latched while it is visited and marked dirty. Every probe of a key visits the
+   * blocks in the same order, so of two writers of the same key, the second sees what the first did to each block.
+   */
+  template <typename Visitor>
+  bool Probe(page_id_t header_page_id, const KeyType &key, bool for_write, Visitor &&visit);
+
+  Page *FetchPage(page_id_t page_id);
+
   // member variable
   page_id_t header_page_id_;
   BufferPoolManager *buffer_pool_manager_;
   KeyComparator comparator_;
 
-  // Readers includes inserts and removes, writer is only resize
+  // Readers includes inserts and removes, writer is only resize; buckets are claimed with atomic flags, under the
+  // block's page latch for inserts and removes
   ReaderWriterLatch table_latch_;
 
   // Hash function
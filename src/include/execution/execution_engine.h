@@ -19,7 +19,9 @@
 #include "concurrency/transaction_manager.h"
 #include "execution/executor_context.h"
 #include "execution/executor_factory.h"
+#include "execution/morsel_queue.h"
 #include "execution/plans/abstract_plan.h"
+#include "execution/tuple_batch.h"
 #include "storage/table/tuple.h"
 namespace bustub {
 
@@ -55,13 +57,14 @@ class ExecutionEngine {
     // Prepare the root executor
     executor->Init();
 
-    // Execute the query plan
+    // Execute the query plan, a batch at a time
     try {
-      Tuple tuple;
-      RID rid;
-      while (executor->Next(&tuple, &rid)) {
+      TupleBatch batch;
+      while (executor->NextBatch(&batch)) {
         if (result_set != nullptr) {
-          result_set->push_back(tuple);
+          for (uint32_t row : batch.GetSelection()) {
+            result_set->push_back(batch.ToTuple(row));
+          }
         }
       }
     } catch (Exception &e) {
@@ -71,6 +74,25 @@ class ExecutionEngine {
     return true;
   }
 
+  /**
+   * Execute a query plan with morsel-driven parallelism: every worker thread runs the whole plan over its own share of
+   * the tables scanned, taking morsels of pages from queues shared by all workers (see ParallelState). Plans with
+   * executors that cannot run in parallel, and every plan while logging is enabled, are executed by Execute() on the
+   * calling thread instead.
+   * @param plan The query plan to execute
+   * @param result_set The set of tuples produced by executing the plan, in no particular order
+   * @param txn The transaction context in which the query executes
+   * @param exec_ctx The executor context in which the query executes
+   * @param num_workers The number of worker threads
+   * @param morsel_size The number of pages in a morsel
+   * @return `true` if execution of the query plan succeeds, `false` if a worker failed, with no tuples added to the
+   * result set
+   * @throws any exception other than Exception that a worker threw, once every worker has stopped
+   */
+  bool ExecuteParallel(const AbstractPlanNode *plan, std::vector<Tuple> *result_set, Transaction *txn,
+                       ExecutorContext *exec_ctx, uint32_t num_workers,
+                       uint32_t morsel_size = MorselQueue::DEFAULT_MORSEL_SIZE);
+
  private:
   /** The buffer pool manager used during query execution */
   [[maybe_unused]] BufferPoolManager *bpm_;
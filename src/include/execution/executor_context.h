@@ -21,6 +21,9 @@
 #include "storage/page/tmp_tuple_page.h"
 
 namespace bustub {
+
+class ParallelState;
+
 /**
  * ExecutorContext stores all the context necessary to run an executor.
  */
@@ -60,6 +63,22 @@ class ExecutorContext {
   /** @return the transaction manager */
   TransactionManager *GetTransactionManager() { return txn_mgr_; }
 
+  /**
+   * Makes the executors run as one of the workers of a parallel query.
+   * @param parallel_state The state the workers share
+   * @param worker_id The number of this worker, from 0
+   */
+  void SetParallelState(ParallelState *parallel_state, uint32_t worker_id) {
+    parallel_state_ = parallel_state;
+    worker_id_ = worker_id;
+  }
+
+  /** @return the state the workers of the parallel query share, nullptr if the query runs on one thread */
+  ParallelState *GetParallelState() const { return parallel_state_; }
+
+  /** @return the number of the worker the executors run as */
+  uint32_t GetWorkerId() const { return worker_id_; }
+
  private:
   /** The transaction context associated with this executor context */
   Transaction *transaction_;
@@ -71,6 +90,10 @@ class ExecutorContext {
   TransactionManager *txn_mgr_;
   /** The lock manager associated with this executor context */
   LockManager *lock_mgr_;
+  /** The state shared with the other workers of a parallel query, if any */
+  ParallelState *parallel_state_{nullptr};
+  /** The number of the worker of a parallel query */
+  uint32_t worker_id_{0};
 };
 
 }  // namespace bustub
@@ -13,11 +13,16 @@
 #pragma once
 
 #include "execution/executor_context.h"
+#include "execution/tuple_batch.h"
 #include "storage/table/tuple.h"
 
 namespace bustub {
+
+class JoinFilter;
+
 /**
- * The AbstractExecutor implements the Volcano tuple-at-a-time iterator model.
+ * The AbstractExecutor implements the Volcano tuple-at-a-time iterator model,
+ * along with its batch-at-a-time variant, NextBatch().
  * This is the base class from which all executors in the BustTub execution
  * engine inherit, and defines the minimal interface that all executors support.
  */
@@ -46,6 +51,33 @@ class AbstractExecutor {
    */
   virtual bool Next(Tuple *tuple, RID *rid) = 0;
 
+  /**
+   * Yield the next batch of tuples from this executor. Executors that work a batch at a time override this (see
+   * BatchExecutor); the default adapts a tuple-at-a-time executor by calling Next() until the batch is full, so
+   * Next() must keep returning `false` once there are no more tuples.
+   * @param[out] batch The batch to fill, emptied first
+   * @return `true` if the batch has at least one selected row, `false` if there are no more tuples
+   */
+  virtual bool NextBatch(TupleBatch *batch) {
+    batch->Reset(GetOutputSchema());
+    Tuple tuple;
+    RID rid;
+    while (!batch->IsFull() && Next(&tuple, &rid)) {
+      batch->AppendTuple(tuple, rid);
+    }
+    return batch->GetNumSelected() > 0;
+  }
+
+  /**
+   * Offer the executor a runtime filter on one of its output columns, the probe key of a hash join above it, to apply
+   * as early as it can. The filter only tells which rows need not be produced: the join still checks every row it
+   * gets, so an executor is free to ignore it, as the default does. The filter is dropped by the next Init().
+   * @param filter the filter, which outlives the executor's use of it
+   * @param col_idx the output column the filter applies to
+   * @return `true` if the executor applies the filter
+   */
+  virtual bool PushDownJoinFilter(const JoinFilter *filter, uint32_t col_idx) { return false; }
+
   /** @return The schema of the tuples that this executor produces */
   virtual const Schema *GetOutputSchema() = 0;
 
@@ -12,17 +12,24 @@
 
 #pragma once
 
+#include <atomic>
+#include <limits>
 #include <memory>
+#include <mutex>  // NOLINT
 #include <unordered_map>
 #include <utility>
 #include <vector>
 
+#include "common/macros.h"
 #include "common/util/hash_util.h"
 #include "container/hash/hash_function.h"
 #include "execution/executor_context.h"
 #include "execution/executors/abstract_executor.h"
+#include "execution/executors/batch_executor.h"
 #include "execution/expressions/abstract_expression.h"
+#include "execution/parallel_state.h"
 #include "execution/plans/aggregation_plan.h"
+#include "execution/tuple_batch.h"
 #include "storage/table/tuple.h"
 #include "type/value_factory.h"
 
@@ -108,6 +115,40 @@ class SimpleAggregationHashTable {
     CombineAggregateValues(&ht_[agg_key], agg_val);
   }
 
+  /**
+   * Combines the aggregates of another hash table, e.g. one another worker built over its share of the input, into
+   * this one.
+   * @param other The hash table to merge, over the same aggregations
+   */
+  void Merge(const SimpleAggregationHashTable &other) {
+    for (const auto &[agg_key, partial] : other.ht_) {
+      auto it = ht_.find(agg_key);
+      if (it == ht_.end()) {
+        ht_.insert({agg_key, partial});
+        continue;
+      }
+      auto &result = it->second;
+      for (uint32_t i = 0; i < agg_types_.size(); i++) {
+        switch (agg_types_[i]) {
+          case AggregationType::CountAggregate:
+          case AggregationType::SumAggregate:
+            // Partial counts and sums add up.
+            result.aggregates_[i] = result.aggregates_[i].Add(partial.aggregates_[i]);
+            break;
+          case AggregationType::MinAggregate:
+            result.aggregates_[i] = result.aggregates_[i].Min(partial.aggregates_[i]);
+            break;
+          case AggregationType::MaxAggregate:
+            result.aggregates_[i] = result.aggregates_[i].Max(partial.aggregates_[i]);
+            break;
+        }
+      }
+    }
+  }
+
+  /** Removes every aggregate from the hash table. */
+  void Clear() { ht_.clear(); }
+
   /** An iterator over the aggregation hash table */
   class Iterator {
    public:
@@ -152,11 +193,165 @@ class SimpleAggregationHashTable {
   const std::vector<AggregationType> &agg_types_;
 };
 
+/** SharedAggregation is the hash table the workers of a parallel query merge their aggregates into */
+struct SharedAggregation : public SharedOperatorState {
+  SharedAggregation(const std::vector<const AbstractExpression *> &agg_exprs,
+                    const std::vector<AggregationType> &agg_types)
+      : aht_{agg_exprs, agg_types} {}
+
+  /** The merged aggregates */
+  SimpleAggregationHashTable aht_;
+  /** Protects aht_ while the workers merge into it */
+  std::mutex latch_;
+};
+
+/**
+ * FlatAggregationTable is the hash table of an aggregation whose group-by keys are all integers, and whose aggregates
+ * are counts or read INTEGER values. Instead of vectors of boxed Values, a group is a fixed-width entry of 64-bit
+ * words: the hash of its key, a bitmap of its null keys, the keys themselves, a bitmap of its null aggregates, and a
+ * typed accumulator per aggregate, a count or a sum or a running min or max. The entries are laid out back to back in
+ * blocks of an arena, which never move, and are found through an open-addressing table of slots pointing into them.
+ *
+ * A row is combined in two steps, each over the whole batch: its keys are converted and hashed a column at a time,
+ * and its group found; then every aggregate is applied a column at a time, with the type of the aggregate decided
+ * once per batch rather than once per value.
+ *
+ * The table can be split into partitions on the high bits of the hash, each with slots and an arena of its own. In a
+ * parallel query, every worker pre-aggregates its share of the input into a partitioned table of its own; the tables
+ * are then merged a partition at a time, each partition by whichever worker claims it first.
+ */
+class FlatAggregationTable {
+ public:
+  /** The number of high hash bits that pick the partition of a group in a parallel query. */
+  static constexpr uint32_t PARALLEL_PARTITION_BITS = 6;
+
+  /** @return true if the group-by keys and aggregates of the plan fit the table */
+  static bool CanAggregate(const AggregationPlanNode *plan);
+
+  /**
+   * Creates an empty table for an aggregation.
+   * @param plan the aggregation, which CanAggregate() must accept
+   * @param partition_bits the number of high hash bits that pick the partition of a group
+   */
+  FlatAggregationTable(const AggregationPlanNode *plan, uint32_t partition_bits);
+
+  DISALLOW_COPY_AND_MOVE(FlatAggregationTable);
+
+  /** Removes every group. */
+  void Clear();
+
+  /**
+   * Combines rows into the aggregates of their groups.
+   * @param group_by_columns the value of every group-by expression for each row
+   * @param aggregate_columns the value of every aggregate expression for each row
+   * @param rows the rows to combine
+   */
+  void InsertBatch(const std::vector<std::vector<Value>> &group_by_columns,
+                   const std::vector<std::vector<Value>> &aggregate_columns, const std::vector<uint32_t> &rows);
+
+  /** Combines the groups of a partition of another table, over the same aggregation and partitions, into this one. */
+  void MergePartition(uint32_t partition, const FlatAggregationTable &other);
+
+  /** @return the number of partitions */
+  uint32_t GetNumPartitions() const { return static_cast<uint32_t>(partitions_.size()); }
+
+  /** @return the number of groups in a partition */
+  uint32_t GetNumGroups(uint32_t partition) const { return partitions_[partition].num_groups_; }
+
+  /** Reads the group-by values and the aggregates of a group of a partition. */
+  void GetGroup(uint32_t partition, uint32_t group, std::vector<Value> *group_bys,
+                std::vector<Value> *aggregates) const;
+
+ private:
+  /** The log of the number of entries in an arena block. */
+  static constexpr uint32_t BLOCK_ENTRIES_BITS = 10;
+  /** Marks an empty slot. */
+  static constexpr uint32_t NO_GROUP = std::numeric_limits<uint32_t>::max();
+  /** The word of an entry that holds its hash, and the one its key starts at, with the bitmap of null keys. */
+  static constexpr uint32_t HASH_WORD = 0;
+  static constexpr uint32_t KEY_WORD = 1;
+
+  /** A slot of the table: the high bits of a group's hash, next to the group. */
+  struct Slot {
+    uint32_t hash_tag_;
+    uint32_t group_;
+  };
+
+  /** The groups of one partition. */
+  struct Partition {
+    /** The arena blocks the entries are in, 1 << BLOCK_ENTRIES_BITS of them per block. */
+    std::vector<std::unique_ptr<uint64_t[]>> blocks_;
+    /** The slots, a power of two of them, at most half of them full. */
+    std::vector<Slot> slots_;
+    uint32_t num_groups_{0};
+  };
+
+  /** @return the entry of a group */
+  uint64_t *GetEntry(const Partition &partition, uint32_t group) const {
+    return partition.blocks_[group >> BLOCK_ENTRIES_BITS].get() +
+           static_cast<size_t>(group & ((1U << BLOCK_ENTRIES_BITS) - 1)) * entry_words_;
+  }
+
+  /** @return the partition of a hash */
+  uint32_t GetPartition(hash_t hash) const {
+    return partition_bits_ == 0 ? 0 : static_cast<uint32_t>(static_cast<uint64_t>(hash) >> (64 - partition_bits_));
+  }
+
+  /**
+   * Finds the entry of the group with the given key, adding one with empty aggregates if there is none.
+   * @param partition the partition of the hash
+   * @param hash the hash of the key
+   * @param key the key words: the bitmap of null keys, then the keys
+   * @return the entry of the group
+   */
+  uint64_t *FindOrInsert(Partition *partition, hash_t hash, const uint64_t *key);
+
+  /** Doubles the number of slots of a partition. */
+  void Grow(Partition *partition);
+
+  /** The types of the group-by keys, and of the aggregates. */
+  std::vector<TypeId> key_types_;
+  std::vector<AggregationType> agg_types_;
+  /** The number of words of the key of an entry, with its bitmap, and of a whole entry. */
+  uint32_t key_words_;
+  uint32_t entry_words_;
+  /** The word of an entry that holds the bitmap of null aggregates, followed by the accumulators. */
+  uint32_t agg_nulls_word_;
+  /** The number of high hash bits that pick a partition. */
+  uint32_t partition_bits_;
+  std::vector<Partition> partitions_;
+  /** The key words, hash and entry of every row of the batch being inserted, kept to allocate only once. */
+  std::vector<uint64_t> batch_keys_;
+  std::vector<hash_t> batch_hashes_;
+  std::vector<uint64_t *> batch_entries_;
+};
+
+/** SharedFlatAggregation is what the workers of a parallel query share to merge their flat aggregation tables. */
+struct SharedFlatAggregation : public SharedOperatorState {
+  explicit SharedFlatAggregation(uint32_t num_workers) : tables_(num_workers) {}
+
+  /** The table every worker pre-aggregated its share of the input into; the first one ends up with every group. */
+  std::vector<std::unique_ptr<FlatAggregationTable>> tables_;
+  /** Protects tables_ while the workers hand their tables over */
+  std::mutex latch_;
+  /** The next partition for a worker to merge and output */
+  std::atomic<uint32_t> next_partition_{0};
+};
+
 /**
  * AggregationExecutor executes an aggregation operation (e.g. COUNT, SUM, MIN, MAX)
  * over the tuples produced by a child executor.
+ *
+ * Init() consumes the child a batch at a time, evaluating the group-by and aggregate expressions a column at a time
+ * before the rows are combined into the hash table: a FlatAggregationTable if the aggregation fits one, and a
+ * SimpleAggregationHashTable otherwise.
+ *
+ * In a parallel query, every worker aggregates its share of the child's output first. A worker with a flat table
+ * hands it over to the other workers, and once all of them have, claims partitions of the tables one at a time,
+ * merges them, and outputs their groups. A worker with a simple table merges it into one shared by all workers, and
+ * once all of them have, outputs every n-th group of the shared table, for n workers.
  */
-class AggregationExecutor : public AbstractExecutor {
+class AggregationExecutor : public BatchExecutor {
  public:
   /**
    * Construct a new AggregationExecutor instance.
@@ -171,12 +366,11 @@ class AggregationExecutor : public AbstractExecutor {
   void Init() override;
 
   /**
-   * Yield the next tuple from the insert.
-   * @param[out] tuple The next tuple produced by the insert
-   * @param[out] rid The next tuple RID produced by the insert
-   * @return `true` if a tuple was produced, `false` if there are no more tuples
+   * Yield the next batch of tuples from the aggregation.
+   * @param[out] batch The next batch produced by the aggregation
+   * @return `true` if a batch was produced, `false` if there are no more tuples
    */
-  bool Next(Tuple *tuple, RID *rid) override;
+  bool NextBatch(TupleBatch *batch) override;
 
   /** @return The output schema for the aggregation */
   const Schema *GetOutputSchema() override { return plan_->OutputSchema(); };
@@ -185,32 +379,32 @@ class AggregationExecutor : public AbstractExecutor {
   const AbstractExecutor *GetChildExecutor() const;
 
  private:
-  /** @return The tuple as an AggregateKey */
-  AggregateKey MakeAggregateKey(const Tuple *tuple) {
-    std::vector<Value> keys;
-    for (const auto &expr : plan_->GetGroupBys()) {
-      keys.emplace_back(expr->Evaluate(tuple, child_->GetOutputSchema()));
-    }
-    return {keys};
-  }
+  /** Takes part in merging the flat tables of the workers of a parallel query, keeping the partitions to output. */
+  void MergeFlatTables(ParallelState *parallel_state);
 
-  /** @return The tuple as an AggregateValue */
-  AggregateValue MakeAggregateValue(const Tuple *tuple) {
-    std::vector<Value> vals;
-    for (const auto &expr : plan_->GetAggregates()) {
-      vals.emplace_back(expr->Evaluate(tuple, child_->GetOutputSchema()));
-    }
-    return {vals};
-  }
+  /** Appends the output row of a group to the batch, unless the HAVING clause rejects it. */
+  void OutputGroup(const std::vector<Value> &group_bys, const std::vector<Value> &aggregates, TupleBatch *batch);
 
- private:
   /** The aggregation plan node */
   const AggregationPlanNode *plan_;
   /** The child executor that produces tuples over which the aggregation is computed */
   std::unique_ptr<AbstractExecutor> child_;
   /** Simple aggregation hash table */
-  // TODO(Student): Uncomment SimpleAggregationHashTable aht_;
+  SimpleAggregationHashTable aht_;
+  /** The hash table the output comes from: aht_, or the one shared by the workers of a parallel query */
+  SimpleAggregationHashTable *output_aht_;
   /** Simple aggregation hash table iterator */
-  // TODO(Student): Uncomment SimpleAggregationHashTable::Iterator aht_iterator_;
+  SimpleAggregationHashTable::Iterator aht_iterator_;
+  /** The position of aht_iterator_ in the hash table, and which of the positions this executor outputs */
+  uint32_t aht_position_{0};
+  uint32_t output_worker_id_{0};
+  uint32_t num_output_workers_{1};
+  /** Whether the aggregation fits a flat hash table, and the table, until a parallel query's worker hands it over. */
+  bool flat_{false};
+  std::unique_ptr<FlatAggregationTable> flat_aht_;
+  /** The partitions of flat tables this executor outputs, the position of the one being output, and of its group. */
+  std::vector<std::pair<const FlatAggregationTable *, uint32_t>> flat_outputs_;
+  size_t flat_output_{0};
+  uint32_t flat_group_{0};
 };
 }  // namespace bustub
@@ -0,0 +1,54 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// batch_executor.h
+//
+// Identification: src/include/execution/executors/batch_executor.h
+//
+// Copyright (c) 2015-2021, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include "execution/executor_context.h"
+#include "execution/executors/abstract_executor.h"
+#include "execution/tuple_batch.h"
+#include "storage/table/tuple.h"
+
+namespace bustub {
+
+/**
+ * BatchExecutor is the base class of the executors that produce whole batches natively. They implement NextBatch(),
+ * and Next() hands out the rows of a buffered batch one at a time, for parents that still pull single tuples.
+ */
+class BatchExecutor : public AbstractExecutor {
+ public:
+  /**
+   * Construct a new BatchExecutor instance.
+   * @param exec_ctx the executor context that the executor runs with
+   */
+  explicit BatchExecutor(ExecutorContext *exec_ctx) : AbstractExecutor(exec_ctx) {}
+
+  /**
+   * Drop the rows buffered for Next(), which a re-initialized executor must not return.
+   * @warning Executors that override Init() must call this first.
+   */
+  void Init() override;
+
+  /**
+   * Yield the next tuple of the buffered batch, producing a new batch once it runs out.
+   * @param[out] tuple The next tuple produced by this executor
+   * @param[out] rid The next tuple RID produced by this executor
+   * @return `true` if a tuple was produced, `false` if there are no more tuples
+   */
+  bool Next(Tuple *tuple, RID *rid) final;
+
+ private:
+  /** The batch Next() hands out, and the position in its selection of the next row to return. */
+  TupleBatch buffer_;
+  uint32_t next_selected_{0};
+};
+
+}  // namespace bustub
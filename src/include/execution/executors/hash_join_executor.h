@@ -12,20 +12,111 @@
 
 #pragma once
 
+#include <limits>
 #include <memory>
+#include <mutex>  // NOLINT
 #include <utility>
+#include <vector>
 
+#include "common/util/hash_util.h"
 #include "execution/executor_context.h"
-#include "execution/executors/abstract_executor.h"
+#include "execution/executors/batch_executor.h"
+#include "execution/join_filter.h"
+#include "execution/parallel_state.h"
 #include "execution/plans/hash_join_plan.h"
+#include "execution/tuple_batch.h"
+#include "storage/table/spill_file.h"
 #include "storage/table/tuple.h"
 
 namespace bustub {
 
 /**
- * HashJoinExecutor executes a nested-loop JOIN on two tables.
+ * JoinHashTable is the build side of a hash join. Its rows are kept column by column, along with their join key and
+ * its hash, and are looked up through a flat open-addressing table with a slot per distinct key. The rows that share
+ * a key are chained to each other through next_rows_.
+ *
+ * The slots are radix-partitioned on the low bits of the hash, into enough partitions for each to fit in the L2
+ * cache. The table is built a partition at a time, and the executor looks up a probe batch a partition at a time.
  */
-class HashJoinExecutor : public AbstractExecutor {
+struct JoinHashTable : public SharedOperatorState {
+  /** A slot of the flat table: the high bits of a key's hash, next to the first row with the key */
+  struct Slot {
+    uint32_t hash_tag_;
+    uint32_t row_;
+  };
+
+  /** Marks an empty slot and the end of a chain of rows */
+  static constexpr uint32_t NO_ROW = std::numeric_limits<uint32_t>::max();
+  /** The size the slots of a partition are kept under, that of a typical L2 cache */
+  static constexpr size_t PARTITION_BYTES = 256 * 1024;
+  /** The number of radix bits at most, bounding the per-partition bookkeeping */
+  static constexpr uint32_t MAX_RADIX_BITS = 12;
+
+  /** Removes every row. */
+  void Clear();
+
+  /** Appends a row of a batch, with its join key and its hash. The table must be built again before it is probed. */
+  void Append(const TupleBatch &batch, uint32_t row, const Value &key, hash_t hash);
+
+  /** Appends the rows of another table, e.g. one another worker built over its share of the build side. */
+  void Merge(const JoinHashTable &other);
+
+  /** Partitions the rows and builds the flat table over them. */
+  void Build();
+
+  /** Builds the join filter over the keys of the rows. */
+  void BuildFilter() { filter_ = std::make_unique<JoinFilter>(keys_, hashes_); }
+
+  /** @return the row as a tuple of the given schema, that of the build side */
+  Tuple GetTuple(uint32_t row, const Schema *schema) const;
+
+  /** @return the number of partitions of the flat table */
+  uint32_t GetNumPartitions() const { return 1U << radix_bits_; }
+
+  /** @return the partition the lookups of a hash go to */
+  uint32_t GetPartition(hash_t hash) const { return static_cast<uint32_t>(hash) & (GetNumPartitions() - 1); }
+
+  /** Prefetches the slot the lookup of a hash starts at. */
+  void Prefetch(hash_t hash) const { __builtin_prefetch(&slots_[FirstSlot(hash)]); }
+
+  /** @return the first row with the key, or NO_ROW if there is none */
+  uint32_t Find(const Value &key, hash_t hash) const;
+
+  /** @return the position in slots_ of the slot the lookup of a hash starts at */
+  uint32_t FirstSlot(hash_t hash) const;
+
+  /** @return the position in slots_ of the slot after the given one, wrapping around within its partition */
+  uint32_t NextSlot(hash_t hash, uint32_t slot) const;
+
+  /** One vector per column of the build side, each with a value per row */
+  std::vector<std::vector<Value>> columns_;
+  /** The join key of every row, and its hash */
+  std::vector<Value> keys_;
+  std::vector<hash_t> hashes_;
+  /** The next row with the same join key as every row, or NO_ROW */
+  std::vector<uint32_t> next_rows_;
+  /** The number of rows */
+  uint32_t num_rows_{0};
+  /** The number of low hash bits that pick a partition */
+  uint32_t radix_bits_{0};
+  /** The position in slots_ of the first slot of every partition, and the end of the last one */
+  std::vector<uint32_t> partition_slots_;
+  /** The slots of every partition, a power of two of them per partition */
+  std::vector<Slot> slots_;
+  /** Whether the flat table is built over every row */
+  bool built_{false};
+  /** The join filter over the keys of the rows, if built */
+  std::unique_ptr<JoinFilter> filter_;
+  /** Protects the table while the workers of a parallel query merge into it and build it */
+  std::mutex latch_;
+};
+
+/**
+ * HashJoinExecutor executes an equi-JOIN on two tables: it builds a radix-partitioned hash table from the left child
+ * and probes it with the right child a batch at a time. Under a memory budget, the partitions that outgrow it are
+ * spilled and joined in later passes; otherwise a JoinFilter over the build keys is offered to the right child.
+ */
+class HashJoinExecutor : public BatchExecutor {
  public:
   /**
    * Construct a new HashJoinExecutor instance.
@@ -41,19 +132,119 @@ class HashJoinExecutor : public AbstractExecutor {
   void Init() override;
 
   /**
-   * Yield the next tuple from the join.
-   * @param[out] tuple The next tuple produced by the join
-   * @param[out] rid The next tuple RID produced by the join
-   * @return `true` if a tuple was produced, `false` if there are no more tuples
+   * Yield the next batch of tuples from the join.
+   * @param[out] batch The next batch produced by the join
+   * @return `true` if a batch was produced, `false` if there are no more tuples
    */
-  bool Next(Tuple *tuple, RID *rid) override;
+  bool NextBatch(TupleBatch *batch) override;
 
   /** @return The output schema for the join */
   const Schema *GetOutputSchema() override { return plan_->OutputSchema(); };
 
+  /** @return the number of partitions the join spilled to disk since Init() */
+  size_t GetNumSpilledPartitions() const { return num_spilled_partitions_; }
+
  private:
-  /** The NestedLoopJoin plan node to be executed. */
+  /** The number of probe rows a lookup prefetches ahead of itself. */
+  static constexpr size_t PREFETCH_DISTANCE = 8;
+
+  /** The number of partitions a pass of a join under a memory budget splits its inputs into, and its log. */
+  static constexpr uint32_t SPILL_FANOUT = 16;
+  static constexpr uint32_t SPILL_BITS = 4;
+  /** The number of times a partition is split at most, after which it is joined a chunk at a time. */
+  static constexpr uint32_t MAX_SPILL_LEVEL = 5;
+
+  /** The build and probe rows of a partition a pass spilled, joined by a pass of their own. */
+  struct SpilledPartition {
+    std::unique_ptr<SpillFile> build_;
+    std::unique_ptr<SpillFile> probe_;
+    /** The level of the pass that joins them */
+    uint32_t level_;
+    /** Whether the pass joins them a chunk of the build rows at a time, instead of splitting them further */
+    bool chunked_;
+  };
+
+  /** Builds the hash table over the build rows of a pass, keeping the partitions that fit in the budget. */
+  void BuildPass();
+
+  /** Builds the hash table over the next chunk of build rows of a chunked pass. */
+  void BuildChunk();
+
+  /** Spills a partition of the pass's build rows. */
+  void SpillPartition(uint32_t partition);
+
+  /** Gets the next probe batch, and looks it up. Moves on to the next chunk or pass if needed. */
+  bool NextProbeBatch();
+
+  /** Offers the right child the join filter of the hash table to probe. */
+  void PushDownJoinFilter();
+
+  /** Orders the rows of the new probe batch by partition, and looks up their first matches. */
+  void LookUpProbeBatch();
+
+  /** Ends the current pass, keeping its spilled partitions for later passes. */
+  void FinishPass();
+
+  /**
+   * Starts the pass that joins the next spilled partition.
+   * @return false if no partition is left
+   */
+  bool StartPass();
+
+  /** Reads the next batch of build rows of the pass, from the left child or a spill file. */
+  bool NextBuildInput(TupleBatch *batch);
+
+  /** Reads the next batch of probe rows of the pass, from the right child or a spill file. */
+  bool NextProbeInput(TupleBatch *batch);
+
+  /** Reads the tuples of the next page of a spill file into a batch. */
+  static bool ReadSpillFile(SpillFile *file, const Schema *schema, TupleBatch *batch);
+
+  /** @return the partition a pass at the given level puts a hash in */
+  static uint32_t GetSpillPartition(hash_t hash, uint32_t level) {
+    return static_cast<uint32_t>(hash >> (JoinHashTable::MAX_RADIX_BITS + SPILL_BITS * level)) & (SPILL_FANOUT - 1);
+  }
+
+  /** The HashJoin plan node to be executed. */
   const HashJoinPlanNode *plan_;
+  /** The children that produce the build (left) and probe (right) sides of the join. */
+  std::unique_ptr<AbstractExecutor> left_;
+  std::unique_ptr<AbstractExecutor> right_;
+  /** The hash table built from this executor's left child, or from the build rows of the current pass. */
+  JoinHashTable local_build_;
+  /** The hash table to probe: the local one, or the one shared by the workers of a parallel query. */
+  const JoinHashTable *build_{nullptr};
+  /** The current probe batch, and the join key of every row and its hash. */
+  TupleBatch probe_batch_;
+  std::vector<Value> probe_keys_;
+  std::vector<hash_t> probe_hashes_;
+  /** The selected rows of the probe batch with a non-null key, by partition, and the first match of each of them. */
+  std::vector<uint32_t> probe_order_;
+  std::vector<uint32_t> probe_first_matches_;
+  /** The position in probe_order_ of the row being probed, and its next match to output. */
+  size_t probe_position_{0};
+  uint32_t probe_match_{JoinHashTable::NO_ROW};
+
+  /** Whether the join runs under a memory budget. */
+  bool spilling_{false};
+  /** The estimated size of a build row in memory. */
+  size_t row_bytes_{0};
+  /** The level of the current pass, and whether it is chunked. */
+  uint32_t level_{0};
+  bool chunked_{false};
+  /** The inputs of the current pass, null for the children on the first pass. */
+  std::unique_ptr<SpillFile> build_input_;
+  std::unique_ptr<SpillFile> probe_input_;
+  /** The number of build rows the current pass read, and whether it read them all. */
+  size_t pass_build_rows_{0};
+  bool build_input_done_{false};
+  /** The build and probe rows of each partition the current pass spilled, null for the others. */
+  std::vector<std::unique_ptr<SpillFile>> build_spills_;
+  std::vector<std::unique_ptr<SpillFile>> probe_spills_;
+  /** The spilled partitions left to join. */
+  std::vector<SpilledPartition> pending_;
+  /** The number of partitions spilled since Init(). */
+  size_t num_spilled_partitions_{0};
 };
 
 }  // namespace bustub
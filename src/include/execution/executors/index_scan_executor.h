@@ -12,18 +12,31 @@
 
 #pragma once
 
+#include <memory>
 #include <vector>
 
 #include "common/rid.h"
 #include "execution/executor_context.h"
 #include "execution/executors/abstract_executor.h"
+#include "execution/join_filter.h"
 #include "execution/plans/index_scan_plan.h"
+#include "storage/index/index.h"
 #include "storage/table/tuple.h"
 
 namespace bustub {
 
 /**
  * IndexScanExecutor executes an index scan over a table.
+ *
+ * A comparison between the index's key column and a constant narrows the scan to a key range, which is read from the
+ * index a batch of RIDs at a time. The full predicate is still checked against each fetched tuple. Indexes without
+ * range scans (hash indexes) can only serve equality predicates, with a point lookup.
+ *
+ * If the predicate and the output columns only read columns the index stores (its key and included columns), the
+ * scan is index-only: tuples are rebuilt from the index entries and the table is never read.
+ *
+ * A join filter pushed down into the scan is checked right after a tuple is fetched, before the predicate and the
+ * output columns are evaluated over it.
  */
 
 class IndexScanExecutor : public AbstractExecutor {
@@ -41,8 +54,40 @@ class IndexScanExecutor : public AbstractExecutor {
 
   bool Next(Tuple *tuple, RID *rid) override;
 
+  /** Apply a join filter to an output column that is a column of the table. */
+  bool PushDownJoinFilter(const JoinFilter *filter, uint32_t col_idx) override;
+
  private:
+  /**
+   * Derive the key range the predicate restricts the scan to. Only a single column key compared to a constant that is
+   * exactly a value of the key type narrows the range; anything else scans the whole index.
+   */
+  KeyRange<Tuple> RangeFromPredicate() const;
+
+  /** @return true if every column the expression reads is stored in the index entries */
+  bool IsCovered(const AbstractExpression *expr) const;
+
+  /**
+   * Rebuild a tuple of the table from an index entry. Columns the entry does not store hold zeros, which is fine for
+   * an index-only scan, since nothing reads them.
+   */
+  Tuple TupleFromEntry(const Tuple &entry) const;
+
   /** The index scan plan node to be executed. */
   const IndexScanPlanNode *plan_;
+  /** The index to scan and the table it indexes. */
+  IndexInfo *index_info_{nullptr};
+  TableInfo *table_info_{nullptr};
+  /** The range scan over the index, unset for point lookups. */
+  std::unique_ptr<IndexRangeCursor> cursor_;
+  /** The current batch of RIDs, and the position of the next one to fetch. */
+  std::vector<RID> rids_;
+  size_t next_rid_{0};
+  /** Whether the scan is answered from the index alone, and the entries the current RIDs came with if so. */
+  bool index_only_{false};
+  std::vector<Tuple> entries_;
+  /** The join filter pushed down into the scan, if any, and the column of the table it applies to. */
+  const JoinFilter *join_filter_{nullptr};
+  uint32_t join_filter_column_{0};
 };
 }  // namespace bustub
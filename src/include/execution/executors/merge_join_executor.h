@@ -0,0 +1,121 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// merge_join_executor.h
+//
+// Identification: src/include/execution/executors/merge_join_executor.h
+//
+// Copyright (c) 2015-2021, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <deque>
+#include <memory>
+#include <vector>
+
+#include "execution/executor_context.h"
+#include "execution/executors/batch_executor.h"
+#include "execution/plans/merge_join_plan.h"
+#include "execution/tuple_batch.h"
+#include "storage/table/tuple.h"
+#include "type/value.h"
+
+namespace bustub {
+
+/**
+ * MergeJoinExecutor executes a JOIN of two children ordered on their join keys by walking them side by side.
+ *
+ * The executor reads the left child a row at a time and keeps a window of the right rows whose keys join the current
+ * left key, every one of which joins it as far as the keys go. As the left key grows, the window slides forward over
+ * the right child, so each child is read once:
+ * - on equal keys, the window is the run of right rows with the left key, and it serves every left row with that
+ *   key: memory holds one run of duplicates at a time, whatever the size of the inputs;
+ * - on left < right (or <=), the window is every right row past the left key, so it starts out as the whole right
+ *   child and shrinks from the front;
+ * - on left > right (or >=), the window is every right row before the left key, and it only grows.
+ *
+ * A child that turns out not to be ordered on its key makes the join throw, rather than silently lose matches.
+ */
+class MergeJoinExecutor : public BatchExecutor {
+ public:
+  /**
+   * Construct a new MergeJoinExecutor instance.
+   * @param exec_ctx The executor context
+   * @param plan The merge join plan to be executed
+   * @param left_child The child executor that produces tuples for the left side of join
+   * @param right_child The child executor that produces tuples for the right side of join
+   */
+  MergeJoinExecutor(ExecutorContext *exec_ctx, const MergeJoinPlanNode *plan,
+                    std::unique_ptr<AbstractExecutor> &&left_child, std::unique_ptr<AbstractExecutor> &&right_child);
+
+  /** Initialize the join */
+  void Init() override;
+
+  /**
+   * Yield the next batch of tuples from the join.
+   * @param[out] batch The next batch produced by the join
+   * @return `true` if a batch was produced, `false` if there are no more tuples
+   */
+  bool NextBatch(TupleBatch *batch) override;
+
+  /** @return The output schema for the join */
+  const Schema *GetOutputSchema() override { return plan_->OutputSchema(); };
+
+  /** @return the largest number of right rows the join has held at once since Init() */
+  size_t GetMaxWindowSize() const { return max_window_size_; }
+
+ private:
+  /** A position in the output of a child, along with the join keys of the batch it is in. */
+  struct Cursor {
+    TupleBatch batch_;
+    std::vector<Value> keys_;
+    /** The position in the selection of the batch of the current row. */
+    uint32_t position_{0};
+    bool exhausted_{false};
+    /** The key of the last row moved past, which the next key must not be smaller than. */
+    Value last_key_;
+    bool has_last_key_{false};
+
+    /** @return the current row of the batch */
+    uint32_t CurrentRow() const { return batch_.GetSelection()[position_]; }
+  };
+
+  /** A right row of the window. */
+  struct WindowRow {
+    Value key_;
+    Tuple tuple_;
+  };
+
+  /**
+   * Makes sure the cursor is at a row with a non-null key, reading the child's next batch if needed.
+   * @return false if the child is exhausted
+   */
+  bool PeekRow(AbstractExecutor *child, const AbstractExpression *key_expression, Cursor *cursor);
+
+  /** Moves the cursor past its current row. */
+  static void AdvanceRow(Cursor *cursor);
+
+  /** Slides the window to the right rows that join the left key. */
+  void MoveWindow(const Value &left_key);
+
+  /** The merge join plan node to be executed */
+  const MergeJoinPlanNode *plan_;
+  /** The child executors */
+  std::unique_ptr<AbstractExecutor> left_;
+  std::unique_ptr<AbstractExecutor> right_;
+  /** Where the join is in either child */
+  Cursor left_cursor_;
+  Cursor right_cursor_;
+  /** The right rows whose keys join the current left key */
+  std::deque<WindowRow> window_;
+  size_t max_window_size_{0};
+  /** Whether there is a current left row, the row itself, and the position in the window of its next match */
+  bool has_left_row_{false};
+  Tuple left_tuple_;
+  size_t next_match_{0};
+};
+
+}  // namespace bustub
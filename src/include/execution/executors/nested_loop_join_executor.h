@@ -12,20 +12,28 @@
 
 #pragma once
 
+#include <deque>
 #include <memory>
 #include <utility>
+#include <vector>
 
 #include "execution/executor_context.h"
-#include "execution/executors/abstract_executor.h"
+#include "execution/executors/batch_executor.h"
 #include "execution/plans/nested_loop_join_plan.h"
+#include "execution/tuple_batch.h"
 #include "storage/table/tuple.h"
 
 namespace bustub {
 
 /**
- * NestedLoopJoinExecutor executes a nested-loop JOIN on two tables.
+ * NestedLoopJoinExecutor executes a block nested-loop JOIN on two tables.
+ *
+ * The executor buffers the plan's block size worth of left tuples, then scans the right child, re-initialized, a
+ * batch at a time, and evaluates the predicate through EvaluateJoin on every pair of a left tuple of the block and a
+ * right tuple of the batch. Once the right child runs out, the next block is read. Each tuple is materialized once
+ * per block, so the cost of a scan of the right child is shared by the whole block.
  */
-class NestedLoopJoinExecutor : public AbstractExecutor {
+class NestedLoopJoinExecutor : public BatchExecutor {
  public:
   /**
    * Construct a new NestedLoopJoinExecutor instance.
@@ -42,19 +50,51 @@ class NestedLoopJoinExecutor : public AbstractExecutor {
   void Init() override;
 
   /**
-   * Yield the next tuple from the join.
-   * @param[out] tuple The next tuple produced by the join
-   * @param[out] rid The next tuple RID produced by the join
-   * @return `true` if a tuple was produced, `false` if there are no more tuples
+   * Yield the next batch of tuples from the join.
+   * @param[out] batch The next batch produced by the join
+   * @return `true` if a batch was produced, `false` if there are no more tuples
    */
-  bool Next(Tuple *tuple, RID *rid) override;
+  bool NextBatch(TupleBatch *batch) override;
 
   /** @return The output schema for the insert */
   const Schema *GetOutputSchema() override { return plan_->OutputSchema(); };
 
+  /** @return the number of times the right child has been scanned since Init() */
+  size_t GetNumRightScans() const { return num_right_scans_; }
+
  private:
+  /**
+   * Buffers the next block of left tuples, and starts a scan of the right child for it.
+   * @return false once the left child is exhausted
+   */
+  bool NextBlock();
+
+  /**
+   * Reads the next batch of the right child's scan for the current block.
+   * @return false once the scan is over
+   */
+  bool NextRightBatch();
+
   /** The NestedLoopJoin plan node to be executed. */
   const NestedLoopJoinPlanNode *plan_;
+  /** The child executors */
+  std::unique_ptr<AbstractExecutor> left_;
+  std::unique_ptr<AbstractExecutor> right_;
+  /** The batch of the left child the next block starts in, and the position in its selection of the next row */
+  TupleBatch left_batch_;
+  uint32_t next_left_row_{0};
+  /** Whether the left child has run out */
+  bool left_exhausted_{false};
+  /** The left tuples of the current block */
+  std::deque<Tuple> block_;
+  /** The tuples of the current right batch */
+  TupleBatch right_batch_;
+  std::vector<Tuple> right_tuples_;
+  /** The position in the block and in the right batch of the next pair to join */
+  size_t block_position_{0};
+  size_t right_position_{0};
+  /** The number of times the right child has been scanned since Init() */
+  size_t num_right_scans_{0};
 };
 
 }  // namespace bustub
@@ -12,19 +12,40 @@
 
 #pragma once
 
+#include <atomic>
+#include <exception>
+#include <memory>
+#include <mutex>   // NOLINT
+#include <thread>  // NOLINT
 #include <vector>
 
+#include "catalog/catalog.h"
+#include "common/bounded_queue.h"
 #include "execution/executor_context.h"
-#include "execution/executors/abstract_executor.h"
+#include "execution/executors/batch_executor.h"
+#include "execution/join_filter.h"
+#include "execution/morsel_queue.h"
 #include "execution/plans/seq_scan_plan.h"
+#include "execution/tuple_batch.h"
 #include "storage/table/tuple.h"
 
 namespace bustub {
 
 /**
  * The SeqScanExecutor executor executes a sequential table scan.
+ *
+ * The table is read a morsel of pages at a time, and each page under a single latch. The predicate filters a batch
+ * of tuples through its selection vector, and the output columns are then computed a column at a time. In a parallel
+ * query, the scans of all workers take their morsels from the same queue.
+ *
+ * A plan can also ask for a scan of its own on several threads. Each of them takes morsels from the queue, filters
+ * and projects them, and pushes the batches onto a bounded queue that NextBatch pops them off, in no particular
+ * order. The threads start on the first call to NextBatch, and are stopped by Init and by the destructor.
+ *
+ * A join filter pushed down into the scan is applied to the tuples in place, while their page is latched, so the
+ * ones it rules out are never copied out of the page.
  */
-class SeqScanExecutor : public AbstractExecutor {
+class SeqScanExecutor : public BatchExecutor {
  public:
   /**
    * Construct a new SeqScanExecutor instance.
@@ -33,16 +54,23 @@ class SeqScanExecutor : public AbstractExecutor {
    */
   SeqScanExecutor(ExecutorContext *exec_ctx, const SeqScanPlanNode *plan);
 
+  ~SeqScanExecutor() override;
+
   /** Initialize the sequential scan */
   void Init() override;
 
   /**
-   * Yield the next tuple from the sequential scan.
-   * @param[out] tuple The next tuple produced by the scan
-   * @param[out] rid The next tuple RID produced by the scan
-   * @return `true` if a tuple was produced, `false` if there are no more tuples
+   * Yield the next batch of tuples from the sequential scan.
+   * @param[out] batch The next batch produced by the scan
+   * @return `true` if a batch was produced, `false` if there are no more tuples
    */
-  bool Next(Tuple *tuple, RID *rid) override;
+  bool NextBatch(TupleBatch *batch) override;
+
+  /**
+   * Apply a join filter to an output column that is a column of the table. Must be called before the first
+   * NextBatch() after Init(), since the scan threads read the filter without synchronization.
+   */
+  bool PushDownJoinFilter(const JoinFilter *filter, uint32_t col_idx) override;
 
   /** @return The output schema for the sequential scan */
   const Schema *GetOutputSchema() override { return plan_->OutputSchema(); }
@@ -50,5 +78,67 @@ class SeqScanExecutor : public AbstractExecutor {
  private:
   /** The sequential scan plan node to be executed */
   const SeqScanPlanNode *plan_;
+  /** The table being scanned. */
+  TableInfo *table_info_{nullptr};
+
+  /** The join filter pushed down into the scan, if any, and the column of the table it applies to. */
+  const JoinFilter *join_filter_{nullptr};
+  uint32_t join_filter_column_{0};
+
+  /** The position of a scan in the table; each scan thread has its own. */
+  struct ScanCursor {
+    /** The pages of the current morsel, and the position of the next one to read. */
+    std::vector<page_id_t> morsel_;
+    size_t next_page_{0};
+    /** The tuples of the current page, and the position of the next one to scan. */
+    std::vector<Tuple> page_tuples_;
+    size_t next_tuple_{0};
+    /** The batch of table tuples the output is projected from. */
+    TupleBatch scan_batch_;
+  };
+
+  /**
+   * Scan the next batch of output tuples from the cursor's position.
+   * @return false if there are no more tuples
+   */
+  bool ScanBatch(ScanCursor *cursor, TupleBatch *batch);
+
+  /**
+   * Fill the cursor's scan batch with the next tuples of the table.
+   * @return false if there are no more tuples
+   */
+  bool FillScanBatch(ScanCursor *cursor, uint32_t capacity);
+
+  /**
+   * Read the next page of the cursor's morsel, moving on to the next morsel if needed.
+   * @return false if there are no more pages
+   */
+  bool ReadNextPage(ScanCursor *cursor);
+
+  /** Start the scan threads, which produce batches of the given capacity. */
+  void StartScanThreads(uint32_t capacity);
+
+  /** The body of a scan thread. */
+  void RunScanThread(uint32_t capacity);
+
+  /** Stop the scan threads and wait for them to finish. */
+  void StopScanThreads();
+
+  /** The queue the morsels of the table come from, and the queue itself if this scan does not share one. */
+  MorselQueue *morsels_{nullptr};
+  std::unique_ptr<MorselQueue> own_morsels_;
+  /** The cursor of a scan on the calling thread. */
+  ScanCursor cursor_;
+
+  /** Whether this scan runs on threads of its own. */
+  bool threaded_{false};
+  /** The scan threads, and the queue of the batches they produced. */
+  std::vector<std::thread> scan_threads_;
+  std::unique_ptr<BoundedQueue<TupleBatch>> results_;
+  /** The number of scan threads still producing. The last one to finish closes results_. */
+  std::atomic<uint32_t> num_running_{0};
+  /** The first error a scan thread ran into, rethrown by NextBatch. */
+  std::mutex error_latch_;
+  std::exception_ptr error_;
 };
 }  // namespace bustub
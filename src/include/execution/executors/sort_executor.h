@@ -0,0 +1,133 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// sort_executor.h
+//
+// Identification: src/include/execution/executors/sort_executor.h
+//
+// Copyright (c) 2015-2021, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "common/run_merger.h"
+#include "execution/executor_context.h"
+#include "execution/executors/batch_executor.h"
+#include "execution/plans/sort_plan.h"
+#include "execution/sort_key_encoder.h"
+#include "execution/tuple_batch.h"
+#include "storage/table/spill_file.h"
+#include "storage/table/tuple.h"
+
+namespace bustub {
+
+/**
+ * SortExecutor executes an ORDER BY as an external merge sort.
+ *
+ * Init() reads the child a batch at a time, normalizing the sort key of every row with a SortKeyEncoder, and keeps
+ * the rows in memory, each serialized next to its key in an arena, so that sorting only moves small entries around.
+ * Whenever the rows outgrow the memory budget, they are sorted into a run that is spilled into a SpillFile. The rows
+ * left at the end make a last run, kept in memory.
+ *
+ * The runs are then merged by a RunMerger, reading each a page at a time. A merge reads as many runs at once as the
+ * budget has pages for, and no fewer than two: while there are more runs than that, consecutive groups of them are
+ * merged into longer runs first. Every run is sorted stably, and ties between runs go to the earlier one, so rows
+ * with equal keys come out in the order the child produced them in.
+ */
+class SortExecutor : public BatchExecutor {
+ public:
+  /**
+   * Construct a new SortExecutor instance.
+   * @param exec_ctx The executor context
+   * @param plan The sort plan to be executed
+   * @param child The child executor whose tuples are sorted
+   */
+  SortExecutor(ExecutorContext *exec_ctx, const SortPlanNode *plan, std::unique_ptr<AbstractExecutor> &&child);
+
+  /** Initialize the sort, consuming the whole child */
+  void Init() override;
+
+  /**
+   * Yield the next batch of tuples from the sort.
+   * @param[out] batch The next batch produced by the sort
+   * @return `true` if a batch was produced, `false` if there are no more tuples
+   */
+  bool NextBatch(TupleBatch *batch) override;
+
+  /** @return The output schema for the sort */
+  const Schema *GetOutputSchema() override { return plan_->OutputSchema(); }
+
+  /** @return the number of runs the sort spilled to disk since Init(), including those of intermediate merges */
+  size_t GetNumSpilledRuns() const { return num_spilled_runs_; }
+
+ private:
+  friend class RunMerger<SortExecutor>;
+
+  /** A row in memory: the position in the arena of its sort key, followed by the serialized tuple. */
+  struct RowEntry {
+    size_t offset_;
+    uint32_t key_size_;
+  };
+
+  /** A sorted run, read a chunk of rows at a time: a page of a spill file, or a batch's worth of the rows in memory. */
+  struct Run {
+    /** The file of a spilled run, null for the run in memory. */
+    std::unique_ptr<SpillFile> file_;
+    /** The position in entries_ of the next row of the run in memory to read. */
+    size_t next_entry_{0};
+    /** The rows of the current chunk, their sort keys, and the position of the current one. */
+    std::vector<Tuple> tuples_;
+    std::vector<std::string> keys_;
+    size_t next_row_{0};
+  };
+
+  /** Appends a row to the ones in memory. */
+  void AppendRow(const std::string &key, const Tuple &tuple);
+
+  /** Sorts the rows in memory, stably. */
+  void SortRows();
+
+  /** Sorts the rows in memory into a run and spills it. */
+  void SpillRows();
+
+  /** The run store of merger_, see RunMerger; every run written is spilled. */
+  Run NewRun() {
+    Run run;
+    run.file_ = std::make_unique<SpillFile>(GetExecutorContext()->GetBufferPoolManager());
+    return run;
+  }
+  void AppendToRun(Run *run, const Run &from) { run->file_->Append(from.tuples_[from.next_row_]); }
+  void SealRun(Run *run) { run->file_->Rewind(); }
+  void AdvanceRun(Run *run) { run->next_row_++; }
+  int CompareRuns(const Run &a, const Run &b) const { return a.keys_[a.next_row_].compare(b.keys_[b.next_row_]); }
+
+  /**
+   * Makes sure the run has a current row, reading its next chunk if needed.
+   * @return false if the run is exhausted
+   */
+  bool FillRun(Run *run);
+
+  /** The sort plan node to be executed */
+  const SortPlanNode *plan_;
+  /** The child executor whose tuples are sorted */
+  std::unique_ptr<AbstractExecutor> child_;
+  /** Normalizes the sort keys of the rows */
+  SortKeyEncoder encoder_;
+  /** The rows in memory, laid out back to back in the arena */
+  std::vector<char> arena_;
+  std::vector<RowEntry> entries_;
+  /** Merges the sorted runs, which are in the order of the rows they hold in the child's output */
+  RunMerger<SortExecutor> merger_;
+  /** The batch the tuples of a spilled page are encoded from */
+  TupleBatch page_batch_;
+  /** The number of runs spilled since Init() */
+  size_t num_spilled_runs_{0};
+};
+
+}  // namespace bustub
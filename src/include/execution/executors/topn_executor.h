@@ -0,0 +1,79 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// topn_executor.h
+//
+// Identification: src/include/execution/executors/topn_executor.h
+//
+// Copyright (c) 2015-2021, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <deque>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "execution/executor_context.h"
+#include "execution/executors/batch_executor.h"
+#include "execution/plans/topn_plan.h"
+#include "execution/sort_key_encoder.h"
+#include "execution/tuple_batch.h"
+#include "storage/table/tuple.h"
+
+namespace bustub {
+
+/**
+ * TopNExecutor executes an ORDER BY ... LIMIT n without sorting its whole input: Init() keeps the n first rows seen
+ * so far in a max-heap on their normalized sort keys, so memory stays in O(n) however large the child is.
+ *
+ * A row is compared against the last of the heap on its key alone, and only materialized into a tuple if it takes
+ * that one's place. Rows with equal keys keep the order the child produced them in, as they do in a sort.
+ */
+class TopNExecutor : public BatchExecutor {
+ public:
+  /**
+   * Construct a new TopNExecutor instance.
+   * @param exec_ctx The executor context
+   * @param plan The top-n plan to be executed
+   * @param child The child executor whose tuples are sorted
+   */
+  TopNExecutor(ExecutorContext *exec_ctx, const TopNPlanNode *plan, std::unique_ptr<AbstractExecutor> &&child);
+
+  /** Initialize the top-n, consuming the whole child */
+  void Init() override;
+
+  /**
+   * Yield the next batch of tuples from the top-n.
+   * @param[out] batch The next batch produced by the top-n
+   * @return `true` if a batch was produced, `false` if there are no more tuples
+   */
+  bool NextBatch(TupleBatch *batch) override;
+
+  /** @return The output schema for the top-n */
+  const Schema *GetOutputSchema() override { return plan_->OutputSchema(); }
+
+ private:
+  /** @return whether the row in slot a comes before the one in slot b */
+  bool SlotBefore(size_t a, size_t b) const;
+
+  /** The top-n plan node to be executed */
+  const TopNPlanNode *plan_;
+  /** The child executor whose tuples are sorted */
+  std::unique_ptr<AbstractExecutor> child_;
+  /** Normalizes the sort keys of the rows */
+  SortKeyEncoder encoder_;
+  /** The rows kept, by slot: their keys, their positions in the child's output, and their tuples */
+  std::vector<std::string> keys_;
+  std::vector<size_t> positions_;
+  std::deque<Tuple> tuples_;
+  /** The slots, as a max-heap until Init() sorts them into the output order */
+  std::vector<size_t> heap_;
+  /** The position in heap_ of the next row to output */
+  size_t next_slot_{0};
+};
+
+}  // namespace bustub
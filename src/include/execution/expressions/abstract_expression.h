@@ -16,6 +16,7 @@
 #include <vector>
 
 #include "catalog/schema.h"
+#include "execution/tuple_batch.h"
 #include "storage/table/tuple.h"
 
 namespace bustub {
@@ -39,6 +40,20 @@ class AbstractExpression {
   /** @return The value obtained by evaluating the tuple with the given schema */
   virtual Value Evaluate(const Tuple *tuple, const Schema *schema) const = 0;
 
+  /**
+   * Evaluates the expression against every selected row of a batch, as Evaluate does against a tuple of the batch's
+   * schema. Expressions that can work a column at a time override this; by default each row becomes a tuple.
+   * @param batch The rows to evaluate the expression against
+   * @param[out] result A value per row of the batch, of which only those of the selected rows are meaningful
+   */
+  virtual void EvaluateBatch(const TupleBatch &batch, std::vector<Value> *result) const {
+    result->resize(batch.GetNumRows());
+    for (uint32_t row : batch.GetSelection()) {
+      Tuple tuple = batch.ToTuple(row);
+      (*result)[row] = Evaluate(&tuple, batch.GetSchema());
+    }
+  }
+
   /**
    * Returns the value obtained by evaluating a JOIN.
    * @param left_tuple The left tuple
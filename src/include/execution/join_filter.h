@@ -0,0 +1,59 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// join_filter.h
+//
+// Identification: src/include/execution/join_filter.h
+//
+// Copyright (c) 2015-2021, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+#include "common/macros.h"
+#include "common/util/hash_util.h"
+#include "container/hash/counting_bloom_filter.h"
+#include "type/value.h"
+
+namespace bustub {
+
+/**
+ * JoinFilter is a runtime filter over the join keys of a hash join's build side. The join pushes it down into the
+ * scan of its probe side, which drops the rows whose key the filter rules out before copying them out of the page:
+ * such a row cannot find a match anyway.
+ *
+ * A key is ruled out if it falls outside the range of the build keys, when they are all integers, or if a Bloom
+ * filter over the hashes of the build keys never saw its hash. Either way the answer is only "maybe" for a key that
+ * passes, so the join still looks up every row it gets.
+ *
+ * MayContain is thread-safe, so the scans of all workers of a parallel query can share one filter.
+ */
+class JoinFilter {
+ public:
+  /**
+   * Creates a filter over the given build keys, none of them null.
+   * @param keys the build keys
+   * @param hashes the hash of every build key
+   */
+  JoinFilter(const std::vector<Value> &keys, const std::vector<hash_t> &hashes);
+
+  DISALLOW_COPY_AND_MOVE(JoinFilter);
+
+  /** @return false if no build key can equal the key */
+  bool MayContain(const Value &key) const;
+
+ private:
+  /** The hashes of the build keys. */
+  CountingBloomFilter bloom_;
+  /** Whether every build key is an integer, and the smallest and largest of them if so. */
+  bool has_range_{true};
+  int64_t min_key_;
+  int64_t max_key_;
+};
+
+}  // namespace bustub
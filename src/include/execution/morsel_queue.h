@@ -0,0 +1,62 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// morsel_queue.h
+//
+// Identification: src/include/execution/morsel_queue.h
+//
+// Copyright (c) 2015-2021, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <atomic>
+#include <vector>
+
+#include "common/config.h"
+#include "execution/parallel_state.h"
+#include "storage/table/table_heap.h"
+
+namespace bustub {
+
+/**
+ * MorselQueue splits the pages of a table into morsels, runs of consecutive pages, and hands them out to the scans
+ * that read the table, one at a time. The scans of a parallel query share the queue, so each morsel is read by
+ * whichever worker asks first, and faster workers simply take more of them.
+ *
+ * The morsels are ranges of the table's page directory, so taking one is a counter increment and a copy; the pages
+ * the table grows by after the queue is created are not handed out.
+ */
+class MorselQueue : public SharedOperatorState {
+ public:
+  /** The number of pages in a morsel by default. */
+  static constexpr uint32_t DEFAULT_MORSEL_SIZE = 16;
+
+  /**
+   * Creates a queue of the morsels of a table.
+   * @param table_heap the table to split
+   * @param morsel_size the number of pages in a morsel
+   */
+  explicit MorselQueue(TableHeap *table_heap, uint32_t morsel_size = DEFAULT_MORSEL_SIZE);
+
+  /**
+   * Takes the next morsel off the queue.
+   * @param[out] page_ids the pages of the morsel
+   * @return false once every page has been handed out
+   */
+  bool Next(std::vector<page_id_t> *page_ids);
+
+ private:
+  /** The table being split. */
+  TableHeap *table_heap_;
+  /** The number of pages in a morsel. */
+  const size_t morsel_size_;
+  /** The number of pages of the table when the queue was created. */
+  const size_t num_pages_;
+  /** The position in the page directory of the first page of the next morsel. */
+  std::atomic<size_t> next_position_{0};
+};
+
+}  // namespace bustub
@@ -0,0 +1,97 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// parallel_state.h
+//
+// Identification: src/include/execution/parallel_state.h
+//
+// Copyright (c) 2015-2021, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <condition_variable>  // NOLINT
+#include <memory>
+#include <mutex>  // NOLINT
+#include <unordered_map>
+#include <utility>
+
+#include "common/config.h"
+#include "common/macros.h"
+#include "execution/plans/abstract_plan.h"
+
+namespace bustub {
+
+/** The base class of the state that the workers of a parallel query share for one plan node. */
+class SharedOperatorState {
+ public:
+  virtual ~SharedOperatorState() = default;
+};
+
+/**
+ * ParallelState is what the workers of a query executed with morsel-driven parallelism share.
+ *
+ * Every worker runs its own executor tree for the same plan, and each tree produces a disjoint share of the plan's
+ * output. Sequential scans split their table into morsels, runs of pages that the scans of all workers take from one
+ * shared queue. Pipeline breakers build thread-local state over their worker's share of the input, merge it into
+ * state shared by all workers, and wait at a barrier until every worker has merged before they go on.
+ */
+class ParallelState {
+ public:
+  /**
+   * Creates the state for one parallel query.
+   * @param num_workers the number of workers that run the query
+   * @param morsel_size the number of pages in a morsel
+   */
+  ParallelState(uint32_t num_workers, uint32_t morsel_size) : num_workers_(num_workers), morsel_size_(morsel_size) {}
+
+  DISALLOW_COPY_AND_MOVE(ParallelState);
+
+  /** @return true if every plan node in the tree supports running in parallel workers */
+  static bool CanParallelize(const AbstractPlanNode *plan);
+
+  uint32_t GetNumWorkers() const { return num_workers_; }
+  uint32_t GetMorselSize() const { return morsel_size_; }
+
+  /**
+   * @return the state the workers share for the plan node, created from the arguments by the first worker to ask
+   * for it
+   */
+  template <typename State, typename... Args>
+  State *GetSharedState(const AbstractPlanNode *plan, Args &&...args) {
+    std::scoped_lock lock(latch_);
+    auto &state = shared_states_[plan];
+    if (state == nullptr) {
+      state = std::make_unique<State>(std::forward<Args>(args)...);
+    }
+    return dynamic_cast<State *>(state.get());
+  }
+
+  /**
+   * Blocks until every worker has arrived at the barrier of the plan node.
+   * @throws Exception if another worker failed, and will never arrive
+   */
+  void ArriveAndWait(const AbstractPlanNode *plan);
+
+  /** Releases the workers waiting at barriers, after a worker failed. */
+  void Abort();
+
+ private:
+  /** The number of workers that run the query. */
+  const uint32_t num_workers_;
+  /** The number of pages in a morsel. */
+  const uint32_t morsel_size_;
+  /** Protects everything below, and signals arrivals at barriers. */
+  std::mutex latch_;
+  std::condition_variable arrived_;
+  /** The shared state of each plan node that has some. */
+  std::unordered_map<const AbstractPlanNode *, std::unique_ptr<SharedOperatorState>> shared_states_;
+  /** The number of workers that arrived at the barrier of each plan node. */
+  std::unordered_map<const AbstractPlanNode *, uint32_t> arrivals_;
+  /** Whether a worker failed. */
+  bool aborted_{false};
+};
+
+}  // namespace bustub
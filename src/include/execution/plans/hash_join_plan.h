@@ -12,6 +12,7 @@
 
 #pragma once
 
+#include <limits>
 #include <utility>
 #include <vector>
 
@@ -24,18 +25,24 @@ namespace bustub {
  */
 class HashJoinPlanNode : public AbstractPlanNode {
  public:
+  /** The memory budget of a join that keeps its whole build side in memory */
+  static constexpr size_t NO_MEMORY_BUDGET = std::numeric_limits<size_t>::max();
+
   /**
    * Construct a new HashJoinPlanNode instance.
    * @param output_schema The output schema for the JOIN
    * @param children The child plans from which tuples are obtained
    * @param left_key_expression The expression for the left JOIN key
    * @param right_key_expression The expression for the right JOIN key
+   * @param memory_budget The number of bytes of build rows the JOIN holds in memory, spilling the rest to disk
    */
   HashJoinPlanNode(const Schema *output_schema, std::vector<const AbstractPlanNode *> &&children,
-                   const AbstractExpression *left_key_expression, const AbstractExpression *right_key_expression)
+                   const AbstractExpression *left_key_expression, const AbstractExpression *right_key_expression,
+                   size_t memory_budget = NO_MEMORY_BUDGET)
       : AbstractPlanNode(output_schema, std::move(children)),
         left_key_expression_{left_key_expression},
-        right_key_expression_{right_key_expression} {}
+        right_key_expression_{right_key_expression},
+        memory_budget_{memory_budget} {}
 
   /** @return The type of the plan node */
   PlanType GetType() const override { return PlanType::HashJoin; }
@@ -46,6 +53,9 @@ class HashJoinPlanNode : public AbstractPlanNode {
   /** @return The expression to compute the right join key */
   const AbstractExpression *RightJoinKeyExpression() const { return right_key_expression_; }
 
+  /** @return The number of bytes of build rows the JOIN holds in memory */
+  size_t GetMemoryBudget() const { return memory_budget_; }
+
   /** @return The left plan node of the hash join */
   const AbstractPlanNode *GetLeftPlan() const {
     BUSTUB_ASSERT(GetChildren().size() == 2, "Hash joins should have exactly two children plans.");
@@ -63,6 +73,8 @@ class HashJoinPlanNode : public AbstractPlanNode {
   const AbstractExpression *left_key_expression_;
   /** The expression to compute the right JOIN key */
   const AbstractExpression *right_key_expression_;
+  /** The number of bytes of build rows the JOIN holds in memory */
+  size_t memory_budget_;
 };
 
 }  // namespace bustub
@@ -0,0 +1,92 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// merge_join_plan.h
+//
+// Identification: src/include/execution/plans/merge_join_plan.h
+//
+// Copyright (c) 2015-2021, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <utility>
+#include <vector>
+
+#include "execution/expressions/comparison_expression.h"
+#include "execution/plans/abstract_plan.h"
+
+namespace bustub {
+
+/**
+ * MergeJoinPlanNode joins two children that both produce their tuples in ascending order of their join keys, such
+ * as index scans or sorts, by merging them. A pair of tuples joins if their keys compare as the key comparison says,
+ * left key first, and the predicate holds on them. A null key joins nothing.
+ *
+ * The key comparison is an equality, or an inequality for a band or range join; it cannot be NotEqual. The output
+ * comes in the order of the left child.
+ */
+class MergeJoinPlanNode : public AbstractPlanNode {
+ public:
+  /**
+   * Construct a new MergeJoinPlanNode instance.
+   * @param output_schema The output schema for the JOIN
+   * @param children The child plans, both ordered on their join keys
+   * @param left_key_expression The expression for the left JOIN key
+   * @param right_key_expression The expression for the right JOIN key
+   * @param key_comparison How the left key must compare with the right key
+   * @param predicate The predicate the joined tuples must also satisfy, or `nullptr`
+   */
+  MergeJoinPlanNode(const Schema *output_schema, std::vector<const AbstractPlanNode *> &&children,
+                    const AbstractExpression *left_key_expression, const AbstractExpression *right_key_expression,
+                    ComparisonType key_comparison = ComparisonType::Equal,
+                    const AbstractExpression *predicate = nullptr)
+      : AbstractPlanNode(output_schema, std::move(children)),
+        left_key_expression_{left_key_expression},
+        right_key_expression_{right_key_expression},
+        key_comparison_{key_comparison},
+        predicate_{predicate} {
+    BUSTUB_ASSERT(key_comparison != ComparisonType::NotEqual, "Merge joins cannot join on NotEqual keys.");
+  }
+
+  /** @return The type of the plan node */
+  PlanType GetType() const override { return PlanType::MergeJoin; }
+
+  /** @return The expression to compute the left join key */
+  const AbstractExpression *LeftJoinKeyExpression() const { return left_key_expression_; }
+
+  /** @return The expression to compute the right join key */
+  const AbstractExpression *RightJoinKeyExpression() const { return right_key_expression_; }
+
+  /** @return How the left join key must compare with the right join key */
+  ComparisonType GetKeyComparison() const { return key_comparison_; }
+
+  /** @return The predicate the joined tuples must also satisfy, or `nullptr` */
+  const AbstractExpression *Predicate() const { return predicate_; }
+
+  /** @return The left plan node of the merge join */
+  const AbstractPlanNode *GetLeftPlan() const {
+    BUSTUB_ASSERT(GetChildren().size() == 2, "Merge joins should have exactly two children plans.");
+    return GetChildAt(0);
+  }
+
+  /** @return The right plan node of the merge join */
+  const AbstractPlanNode *GetRightPlan() const {
+    BUSTUB_ASSERT(GetChildren().size() == 2, "Merge joins should have exactly two children plans.");
+    return GetChildAt(1);
+  }
+
+ private:
+  /** The expression to compute the left JOIN key */
+  const AbstractExpression *left_key_expression_;
+  /** The expression to compute the right JOIN key */
+  const AbstractExpression *right_key_expression_;
+  /** How the left JOIN key must compare with the right one */
+  ComparisonType key_comparison_;
+  /** The predicate the joined tuples must also satisfy */
+  const AbstractExpression *predicate_;
+};
+
+}  // namespace bustub
@@ -23,19 +23,28 @@ namespace bustub {
 
 /**
  * NestedLoopJoinPlanNode joins tuples from two child plan nodes.
+ *
+ * The join runs as a block nested loop: it buffers a block of left tuples at a time, and scans the right child once
+ * per block, so the right child is scanned ceil(|left| / block size) times rather than once per left tuple.
  */
 class NestedLoopJoinPlanNode : public AbstractPlanNode {
  public:
+  /** The number of left tuples a join buffers per block, by default */
+  static constexpr size_t DEFAULT_BLOCK_SIZE = 4096;
+
   /**
    * Construct a new NestedLoopJoinPlanNode instance.
    * @param output The output format of this nested loop join node
    * @param children Two sequential scan children plans
    * @param predicate The predicate to join with, the tuples are joined
    * if predicate(tuple) = true or predicate = `nullptr`
+   * @param block_size The number of left tuples buffered per scan of the right child
    */
   NestedLoopJoinPlanNode(const Schema *output_schema, std::vector<const AbstractPlanNode *> &&children,
-                         const AbstractExpression *predicate)
-      : AbstractPlanNode(output_schema, std::move(children)), predicate_(predicate) {}
+                         const AbstractExpression *predicate, size_t block_size = DEFAULT_BLOCK_SIZE)
+      : AbstractPlanNode(output_schema, std::move(children)), predicate_(predicate), block_size_(block_size) {
+    BUSTUB_ASSERT(block_size > 0, "Nested loop joins need room for at least one left tuple per block.");
+  }
 
   /** @return The type of the plan node */
   PlanType GetType() const override { return PlanType::NestedLoopJoin; }
@@ -43,6 +52,9 @@ class NestedLoopJoinPlanNode : public AbstractPlanNode {
   /** @return The predicate to be used in the nested loop join */
   const AbstractExpression *Predicate() const { return predicate_; }
 
+  /** @return The number of left tuples buffered per scan of the right child */
+  size_t GetBlockSize() const { return block_size_; }
+
   /** @return The left plan node of the nested loop join, by convention it should be the smaller table */
   const AbstractPlanNode *GetLeftPlan() const {
     BUSTUB_ASSERT(GetChildren().size() == 2, "Nested loop joins should have exactly two children plans.");
@@ -58,6 +70,8 @@ class NestedLoopJoinPlanNode : public AbstractPlanNode {
  private:
   /** The join predicate */
   const AbstractExpression *predicate_;
+  /** The number of left tuples buffered per scan of the right child */
+  size_t block_size_;
 };
 
 }  // namespace bustub
@@ -29,9 +29,11 @@ class SeqScanPlanNode : public AbstractPlanNode {
    * @param output The output schema of this sequential scan plan node
    * @param predicate The predicate applied during the scan operation
    * @param table_oid The identifier of table to be scanned
+   * @param num_threads The number of threads the table is scanned with
    */
-  SeqScanPlanNode(const Schema *output, const AbstractExpression *predicate, table_oid_t table_oid)
-      : AbstractPlanNode(output, {}), predicate_{predicate}, table_oid_{table_oid} {}
+  SeqScanPlanNode(const Schema *output, const AbstractExpression *predicate, table_oid_t table_oid,
+                  uint32_t num_threads = 1)
+      : AbstractPlanNode(output, {}), predicate_{predicate}, table_oid_{table_oid}, num_threads_{num_threads} {}
 
   /** @return The type of the plan node */
   PlanType GetType() const override { return PlanType::SeqScan; }
@@ -42,11 +44,16 @@ class SeqScanPlanNode : public AbstractPlanNode {
   /** @return The identifier of the table that should be scanned */
   table_oid_t GetTableOid() const { return table_oid_; }
 
+  /** @return The number of threads the table is scanned with, each of them filtering and projecting its own pages */
+  uint32_t GetNumThreads() const { return num_threads_; }
+
  private:
   /** The predicate that all returned tuples must satisfy */
   const AbstractExpression *predicate_;
   /** The table whose tuples should be scanned */
   table_oid_t table_oid_;
+  /** The number of threads the table is scanned with */
+  uint32_t num_threads_;
 };
 
 }  // namespace bustub
@@ -0,0 +1,72 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// sort_plan.h
+//
+// Identification: src/include/execution/plans/sort_plan.h
+//
+// Copyright (c) 2015-2021, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <limits>
+#include <utility>
+#include <vector>
+
+#include "execution/plans/abstract_plan.h"
+
+namespace bustub {
+
+/** OrderByType is the direction a sort key is ordered in. */
+enum class OrderByType { Asc, Desc };
+
+/** An ORDER BY term: a direction, and the expression of the key, evaluated over the tuples of the child. */
+using OrderBy = std::pair<OrderByType, const AbstractExpression *>;
+
+/**
+ * SortPlanNode orders the tuples of its child on one or more keys (ORDER BY). Tuples with equal keys keep the order
+ * the child produced them in. The output tuples are those of the child, unchanged, so the output schema must be the
+ * child's.
+ */
+class SortPlanNode : public AbstractPlanNode {
+ public:
+  /** The memory budget of a sort that keeps its whole input in memory */
+  static constexpr size_t NO_MEMORY_BUDGET = std::numeric_limits<size_t>::max();
+
+  /**
+   * Construct a new SortPlanNode instance.
+   * @param output_schema The output schema, that of the child
+   * @param child The child plan whose tuples are sorted
+   * @param order_bys The sort keys, most significant first
+   * @param memory_budget The number of bytes of tuples the sort holds in memory, spilling the rest to disk
+   */
+  SortPlanNode(const Schema *output_schema, const AbstractPlanNode *child, std::vector<OrderBy> &&order_bys,
+               size_t memory_budget = NO_MEMORY_BUDGET)
+      : AbstractPlanNode(output_schema, {child}), order_bys_(std::move(order_bys)), memory_budget_(memory_budget) {}
+
+  /** @return The type of the plan node */
+  PlanType GetType() const override { return PlanType::Sort; }
+
+  /** @return The child plan node */
+  const AbstractPlanNode *GetChildPlan() const {
+    BUSTUB_ASSERT(GetChildren().size() == 1, "Sort should have exactly one child plan.");
+    return GetChildAt(0);
+  }
+
+  /** @return The sort keys */
+  const std::vector<OrderBy> &GetOrderBys() const { return order_bys_; }
+
+  /** @return The number of bytes of tuples the sort holds in memory */
+  size_t GetMemoryBudget() const { return memory_budget_; }
+
+ private:
+  /** The sort keys, most significant first */
+  std::vector<OrderBy> order_bys_;
+  /** The number of bytes of tuples the sort holds in memory */
+  size_t memory_budget_;
+};
+
+}  // namespace bustub
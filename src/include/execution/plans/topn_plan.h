@@ -0,0 +1,61 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// topn_plan.h
+//
+// Identification: src/include/execution/plans/topn_plan.h
+//
+// Copyright (c) 2015-2021, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <utility>
+#include <vector>
+
+#include "execution/plans/abstract_plan.h"
+#include "execution/plans/sort_plan.h"
+
+namespace bustub {
+
+/**
+ * TopNPlanNode produces the first n tuples of its child in the order of one or more keys (ORDER BY ... LIMIT n),
+ * ordered the way SortPlanNode orders them. The output schema must be the child's.
+ */
+class TopNPlanNode : public AbstractPlanNode {
+ public:
+  /**
+   * Construct a new TopNPlanNode instance.
+   * @param output_schema The output schema, that of the child
+   * @param child The child plan whose tuples are sorted
+   * @param order_bys The sort keys, most significant first
+   * @param n The number of tuples to produce at most
+   */
+  TopNPlanNode(const Schema *output_schema, const AbstractPlanNode *child, std::vector<OrderBy> &&order_bys, size_t n)
+      : AbstractPlanNode(output_schema, {child}), order_bys_(std::move(order_bys)), n_(n) {}
+
+  /** @return The type of the plan node */
+  PlanType GetType() const override { return PlanType::TopN; }
+
+  /** @return The child plan node */
+  const AbstractPlanNode *GetChildPlan() const {
+    BUSTUB_ASSERT(GetChildren().size() == 1, "TopN should have exactly one child plan.");
+    return GetChildAt(0);
+  }
+
+  /** @return The sort keys */
+  const std::vector<OrderBy> &GetOrderBys() const { return order_bys_; }
+
+  /** @return The number of tuples to produce at most */
+  size_t GetN() const { return n_; }
+
+ private:
+  /** The sort keys, most significant first */
+  std::vector<OrderBy> order_bys_;
+  /** The number of tuples to produce at most */
+  size_t n_;
+};
+
+}  // namespace bustub
@@ -0,0 +1,50 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// sort_key_encoder.h
+//
+// Identification: src/include/execution/sort_key_encoder.h
+//
+// Copyright (c) 2015-2021, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <string>
+#include <vector>
+
+#include "execution/plans/sort_plan.h"
+#include "execution/tuple_batch.h"
+#include "type/value.h"
+
+namespace bustub {
+
+/**
+ * SortKeyEncoder normalizes the ORDER BY keys of rows into byte strings whose memcmp order is the order of the rows,
+ * so that sorting compares plain strings instead of going through Value's virtual comparisons for every key.
+ *
+ * Each key is encoded by KeyEncoder, which puts NULL first, and the bytes of a descending key are inverted. No key's
+ * encoding is a prefix of another's, so two keys differ at some byte and the inversion exactly reverses their order,
+ * which puts NULL last.
+ */
+class SortKeyEncoder {
+ public:
+  /** @param order_bys the sort keys, most significant first */
+  explicit SortKeyEncoder(const std::vector<OrderBy> &order_bys) : order_bys_(order_bys) {}
+
+  /**
+   * Encode the sort key of every row of a batch, selected or not, a key at a time.
+   * @param[out] keys the encoded key of every row, by position
+   */
+  void EncodeBatch(const TupleBatch &batch, std::vector<std::string> *keys);
+
+ private:
+  /** The sort keys. */
+  const std::vector<OrderBy> &order_bys_;
+  /** The values of the key being encoded, kept to allocate only once. */
+  std::vector<Value> values_;
+};
+
+}  // namespace bustub
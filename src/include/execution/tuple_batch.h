@@ -0,0 +1,91 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// tuple_batch.h
+//
+// Identification: src/include/execution/tuple_batch.h
+//
+// Copyright (c) 2015-2021, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <vector>
+
+#include "catalog/schema.h"
+#include "common/rid.h"
+#include "storage/table/tuple.h"
+#include "type/value.h"
+
+namespace bustub {
+
+class AbstractExpression;
+
+/**
+ * TupleBatch holds up to a fixed number of rows of one schema, stored column by column, for batch-at-a-time
+ * execution. Which rows are part of the batch is decided by the selection vector, the ascending positions of the
+ * selected rows: a filter only shrinks the selection and never moves the columns around, and the rows it drops are
+ * skipped by everything that reads the batch afterwards.
+ */
+class TupleBatch {
+ public:
+  /** The number of rows a batch holds by default: enough to amortize a virtual call, small enough to stay in cache. */
+  static constexpr uint32_t DEFAULT_CAPACITY = 1024;
+
+  explicit TupleBatch(uint32_t capacity = DEFAULT_CAPACITY) : capacity_(capacity) {}
+
+  /** Empties the batch and sets the schema of the rows it will hold. */
+  void Reset(const Schema *schema);
+
+  /** Appends a row made of the values of a tuple in the batch's schema, and selects it. */
+  void AppendTuple(const Tuple &tuple, const RID &rid);
+
+  /** Appends a row with one value per column, and selects it. */
+  void AppendRow(const std::vector<Value> &values, const RID &rid);
+
+  /**
+   * Sets the number of rows, all of them selected. Columns the batch grows by hold invalid values until the caller
+   * fills them in through GetMutableColumn.
+   */
+  void Resize(uint32_t num_rows);
+
+  /** Drops the selected rows for which the predicate is not true. */
+  void Select(const AbstractExpression *predicate);
+
+  /**
+   * Fills the batch with the rows of another one, projected onto the given schema: every column is computed by the
+   * expression of the schema's column, evaluated against the input. The selection is carried over.
+   */
+  void Project(const TupleBatch &input, const Schema *schema);
+
+  /** @return the row as a tuple of the batch's schema */
+  Tuple ToTuple(uint32_t row) const;
+
+  const Schema *GetSchema() const { return schema_; }
+  uint32_t GetCapacity() const { return capacity_; }
+  /** @return the number of rows, selected or not */
+  uint32_t GetNumRows() const { return static_cast<uint32_t>(rids_.size()); }
+  bool IsFull() const { return GetNumRows() >= capacity_; }
+  const std::vector<uint32_t> &GetSelection() const { return selection_; }
+  uint32_t GetNumSelected() const { return static_cast<uint32_t>(selection_.size()); }
+  const std::vector<Value> &GetColumn(uint32_t col_idx) const { return columns_[col_idx]; }
+  std::vector<Value> *GetMutableColumn(uint32_t col_idx) { return &columns_[col_idx]; }
+  const Value &GetValue(uint32_t col_idx, uint32_t row) const { return columns_[col_idx][row]; }
+  const RID &GetRid(uint32_t row) const { return rids_[row]; }
+
+ private:
+  /** The schema of the rows. */
+  const Schema *schema_{nullptr};
+  /** The number of rows the batch fills up at. */
+  uint32_t capacity_;
+  /** One vector per column of the schema, each with a value per row. */
+  std::vector<std::vector<Value>> columns_;
+  /** The RID of every row. */
+  std::vector<RID> rids_;
+  /** The positions of the selected rows, ascending. */
+  std::vector<uint32_t> selection_;
+};
+
+}  // namespace bustub
@@ -0,0 +1,66 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// adaptive_radix_tree.h
+//
+// Identification: src/include/storage/index/adaptive_radix_tree.h
+//
+// Copyright (c) 2015-2021, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "common/macros.h"
+#include "common/rid.h"
+#include "common/rwlatch.h"
+
+namespace bustub {
+
+struct ArtNode;
+
+/**
+ * An adaptive radix tree (ART) mapping byte string keys to RIDs, held entirely in memory.
+ *
+ * Each inner node branches on one byte of the key and comes in four sizes, with room for 4, 16, 48 and 256 children,
+ * grown and shrunk as children come and go, so sparse nodes stay small while dense ones are a single array lookup.
+ * Bytes that every key below a node shares are kept in the node as a prefix instead of a chain of one-child nodes.
+ * A leaf holds its whole key and the key's RIDs in ascending order, so a key may have any number of RIDs.
+ *
+ * No key may be a proper prefix of another, which holds for the keys KeyEncoder produces for one key schema. The whole
+ * tree is protected by one reader-writer latch.
+ */
+class AdaptiveRadixTree {
+ public:
+  AdaptiveRadixTree();
+  ~AdaptiveRadixTree();
+
+  DISALLOW_COPY_AND_MOVE(AdaptiveRadixTree);
+
+  // Add a RID to a key. Returns false if the key already has it.
+  bool Insert(const std::string &key, const RID &rid);
+
+  // Remove a RID from a key. Returns false if the key does not have it.
+  bool Remove(const std::string &key, const RID &rid);
+
+  // Append the RIDs of a key to result, in ascending order.
+  bool GetValue(const std::string &key, std::vector<RID> *result);
+
+  // Remove every entry.
+  void Clear();
+
+  // Number of (key, RID) entries.
+  size_t GetSize();
+
+ private:
+  std::unique_ptr<ArtNode> root_;
+  size_t size_{0};
+  ReaderWriterLatch latch_;
+};
+
+}  // namespace bustub
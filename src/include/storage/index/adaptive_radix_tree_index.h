@@ -0,0 +1,51 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// adaptive_radix_tree_index.h
+//
+// Identification: src/include/storage/index/adaptive_radix_tree_index.h
+//
+// Copyright (c) 2015-2021, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <memory>
+#include <vector>
+
+#include "storage/index/adaptive_radix_tree.h"
+#include "storage/index/index.h"
+#include "storage/index/key_encoder.h"
+
+namespace bustub {
+
+/**
+ * In-memory index on an AdaptiveRadixTree over the memcmp-ordered encoding of the key (see KeyEncoder), for hot
+ * tables that are cached anyway: lookups touch no pages and take no buffer pool latches. Keys are not unique.
+ *
+ * Nothing is written to disk, so the index is rebuilt from the table heap whenever it is built, e.g. by
+ * Catalog::CreateIndex when the catalog is set up again on startup.
+ */
+class AdaptiveRadixTreeIndex : public Index {
+ public:
+  explicit AdaptiveRadixTreeIndex(std::unique_ptr<IndexMetadata> &&metadata);
+
+  void InsertEntry(const Tuple &key, RID rid, Transaction *transaction) override;
+
+  void DeleteEntry(const Tuple &key, RID rid, Transaction *transaction) override;
+
+  void ScanKey(const Tuple &key, std::vector<RID> *result, Transaction *transaction) override;
+
+  // drop whatever the index holds and add an entry for every tuple of the table
+  void BuildFromTable(TableHeap *table_heap, const Schema &table_schema, Transaction *transaction) override;
+
+ protected:
+  // turns key tuples into byte strings
+  KeyEncoder encoder_;
+  // container
+  AdaptiveRadixTree container_;
+};
+
+}  // namespace bustub
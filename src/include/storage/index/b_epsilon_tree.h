@@ -0,0 +1,110 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// b_epsilon_tree.h
+//
+// Identification: src/include/storage/index/b_epsilon_tree.h
+//
+// Copyright (c) 2015-2021, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <string>
+#include <unordered_set>
+#include <vector>
+
+#include "buffer/buffer_pool_manager.h"
+#include "common/rid.h"
+#include "common/rwlatch.h"
+#include "storage/page/b_epsilon_tree_internal_page.h"
+#include "storage/page/b_epsilon_tree_leaf_page.h"
+
+namespace bustub {
+
+#define BEPSILONTREE_TYPE BEpsilonTree<KeyType, ValueType, KeyComparator>
+
+/**
+ * A write-optimized B-epsilon tree of (key, value) entries, where a key may have any number of values (RIDs).
+ *
+ * Inserts and removes do not go down to a leaf. They become messages in the root's buffer, and only when a buffer is
+ * full are messages flushed one level down, to the child that has the most of them, as a single batch. Each node
+ * then spends its page on a small fanout plus a large buffer, so a page written during a flush carries many updates
+ * at once, where a B+ tree writes one leaf per update. A flush into a leaf moves at most half a leaf's worth of
+ * messages, so that it splits the leaf at most once; a node therefore gains at most one child per flush and is split
+ * right after, top-down, without parent pointers.
+ *
+ * Lookups pay for this: they read the buffers on the way down, where the first message found on an entry, i.e. the
+ * newest one, overrides whatever lies below it. Leaves emptied by removes are not merged.
+ *
+ * One tree-wide latch serializes writers against everything else; readers share it.
+ */
+INDEX_TEMPLATE_ARGUMENTS
+class BEpsilonTree {
+  using InternalPage = BEpsilonTreeInternalPage<KeyType, ValueType, KeyComparator>;
+  using LeafPage = BEpsilonTreeLeafPage<KeyType, ValueType, KeyComparator>;
+  using Message = BEpsilonMessage<KeyType, ValueType>;
+
+ public:
+  /**
+   * @param fanout the number of children an internal page may have, at most B_EPSILON_MAX_FANOUT
+   * @param buffer_max_size the number of messages an internal page buffers, at most B_EPSILON_MESSAGE_CAPACITY
+   */
+  explicit BEpsilonTree(std::string name, BufferPoolManager *buffer_pool_manager, const KeyComparator &comparator,
+                        int leaf_max_size = B_EPSILON_LEAF_PAGE_SIZE, int fanout = B_EPSILON_MAX_FANOUT,
+                        int buffer_max_size = B_EPSILON_MESSAGE_CAPACITY);
+
+  // Returns true if this tree has never had an entry.
+  bool IsEmpty() const { return root_page_id_ == INVALID_PAGE_ID; }
+
+  // Add an entry; adding one that is already there has no effect.
+  void Insert(const KeyType &key, const ValueType &value);
+
+  // Remove an entry, if it is there.
+  void Remove(const KeyType &key, const ValueType &value);
+
+  // Append the values of a key to result, ordered by RID.
+  bool GetValue(const KeyType &key, std::vector<ValueType> *result);
+
+  // Number of pages the tree is made of, for tests.
+  size_t GetNumPages();
+
+ private:
+  // add a message to the root buffer, flushing first if it is full
+  void Upsert(const Message &message);
+
+  // flush one batch of messages from the node to its child with the most of them; splits the child if it has to
+  void FlushStep(InternalPage *node);
+
+  // split a node that grew one child over its fanout, adding the new page to its parent after child_index
+  void SplitChild(InternalPage *parent, int child_index, InternalPage *node);
+
+  // put a new root over the old root and the page split off it
+  void GrowRoot(page_id_t left, const MappingType &separator, page_id_t right);
+
+  // append the values of key in the subtree that no message above it has decided on yet
+  void CollectValues(page_id_t page_id, const KeyType &key, std::unordered_set<int64_t> *decided,
+                     std::vector<ValueType> *result);
+
+  size_t CountPages(page_id_t page_id);
+
+  Page *FetchPage(page_id_t page_id);
+  Page *NewPage(page_id_t *page_id);
+
+  void UpdateRootPageId(int insert_record = 0);
+
+  std::string index_name_;
+  page_id_t root_page_id_;
+  // where the header page keeps root_page_id_, once known
+  RID header_record_;
+  BufferPoolManager *buffer_pool_manager_;
+  KeyComparator comparator_;
+  int leaf_max_size_;
+  int fanout_;
+  int buffer_max_size_;
+  ReaderWriterLatch latch_;
+};
+
+}  // namespace bustub
@@ -10,12 +10,25 @@
 //===----------------------------------------------------------------------===//
 #pragma once
 
+#include <atomic>
+#include <chrono>              // NOLINT
+#include <condition_variable>  // NOLINT
+#include <mutex>               // NOLINT
+#include <optional>
 #include <queue>
 #include <string>
+#include <thread>  // NOLINT
+#include <unordered_map>
 #include <vector>
 
+#include "common/config.h"
+#include "common/exception.h"
+#include "common/rwlatch.h"
 #include "concurrency/transaction.h"
 #include "storage/index/index_iterator.h"
+#include "storage/index/index_range_scan.h"
+#include "storage/index/key_range.h"
+#include "storage/index/posting_list.h"
 #include "storage/page/b_plus_tree_internal_page.h"
 #include "storage/page/b_plus_tree_leaf_page.h"
 
@@ -23,42 +36,118 @@ namespace bustub {
 
 #define BPLUSTREE_TYPE BPlusTree<KeyType, ValueType, KeyComparator>
 
+/** The kind of operation a descent is for; decides which latches are taken and when a page counts as safe. */
+enum class Operation { FIND, INSERT, REMOVE };
+
+/**
+ * What Remove does when a leaf drops below its minimum size. EAGER merges or redistributes it right away, which keeps
+ * its ancestors write-latched. LAZY only takes the entry out of the leaf, under the leaf's latch alone, and leaves the
+ * underfull leaf to MergeUnderfullPages.
+ */
+enum class RemoveMode { EAGER, LAZY };
+
 /**
  * Main class providing the API for the Interactive B+ Tree.
  *
  * Implementation of simple b+ tree data structure where internal pages direct
  * the search and leaf pages contain actual data.
- * (1) We only support unique key
+ * (1) Keys are unique, unless the tree is created with unique_keys = false: then a key with several values keeps
+ *     them in a posting list (see PostingList), which requires ValueType = RID
  * (2) support insert & remove
  * (3) The structure should shrink and grow dynamically
  * (4) Implement index iterator for range scan
+ *
+ * Concurrency uses latch crabbing. Writers first descend optimistically with read latches, write-latching only the
+ * leaf, and finish there if the leaf absorbs the change without a split or merge. Otherwise they restart and descend
+ * with write latches, releasing every latched ancestor as soon as a child is safe. The root page id is guarded by
+ * root_latch_, which a pessimistic descent holds like an extra ancestor (a nullptr entry in the page set).
+ *
+ * With RemoveMode::LAZY, removes never go pessimistic: underfull leaves (even empty ones) are recorded and merged
+ * later by MergeUnderfullPages, typically on the background thread started by StartMergeThread. Until then lookups and
+ * scans simply find fewer entries in those leaves.
+ *
+ * The root page id lives in root_page_id_; the header page only keeps a persistent copy. The first write finds the
+ * index's record there once and remembers its location, so later root changes rewrite that record's bucket page
+ * without fetching or latching the header page itself.
+ *
+ * Point lookups take no latches at all: they validate each page's version counter instead (see BPlusTreePage) and
+ * restart if a writer touched the path, falling back to read-latch crabbing after OPTIMISTIC_READ_ATTEMPTS tries.
  */
 INDEX_TEMPLATE_ARGUMENTS
 class BPlusTree {
   using InternalPage = BPlusTreeInternalPage<KeyType, page_id_t, KeyComparator>;
   using LeafPage = BPlusTreeLeafPage<KeyType, ValueType, KeyComparator>;
+  friend class IndexRangeScan<KeyType, ValueType, KeyComparator>;
 
  public:
   explicit BPlusTree(std::string name, BufferPoolManager *buffer_pool_manager, const KeyComparator &comparator,
-                     int leaf_max_size = LEAF_PAGE_SIZE, int internal_max_size = INTERNAL_PAGE_SIZE);
+                     int leaf_max_size = LEAF_PAGE_SIZE, int internal_max_size = INTERNAL_PAGE_SIZE,
+                     bool unique_keys = true);
+
+  ~BPlusTree();
+
+  DISALLOW_COPY_AND_MOVE(BPlusTree);
 
   // Returns true if this B+ tree has no keys and values.
   bool IsEmpty() const;
 
+  page_id_t GetRootPageId() const { return root_page_id_; }
+
   // Insert a key-value pair into this B+ tree.
   bool Insert(const KeyType &key, const ValueType &value, Transaction *transaction = nullptr);
 
-  // Remove a key and its value from this B+ tree.
+  // Remove a key and all of its values from this B+ tree.
   void Remove(const KeyType &key, Transaction *transaction = nullptr);
 
-  // return the value associated with a given key
+  // Remove one value of a key, and the key itself if that was its only value.
+  void Remove(const KeyType &key, const ValueType &value, Transaction *transaction = nullptr);
+
+  // Choose how removes deal with underfull leaves; see RemoveMode.
+  void SetRemoveMode(RemoveMode mode) { remove_mode_ = mode; }
+
+  /*
+   * Merge or redistribute the leaves that lazy removes left underfull, freeing the pages that merges empty. Leaves
+   * that have filled up again in the meantime are left alone.
+   * @return the number of merges and redistributions done
+   */
+  size_t MergeUnderfullPages(Transaction *transaction = nullptr);
+
+  // Run MergeUnderfullPages every "interval" on a background thread, until StopMergeThread or the tree is destroyed.
+  void StartMergeThread(std::chrono::milliseconds interval = index_merge_interval);
+  void StopMergeThread();
+
+  // return the values associated with a given key
   bool GetValue(const KeyType &key, std::vector<ValueType> *result, Transaction *transaction = nullptr);
 
+  /**
+   * Build the tree bottom-up from entries sorted by strictly increasing key. Unlike repeated inserts, which leave
+   * pages half full after every split, each page is filled to fill_factor of its capacity (but at least to its
+   * minimum size). All levels are written left to right at once, keeping one page per level pinned, and every page
+   * is written exactly once. Throws if the input is not sorted or does not hold exactly num_entries entries.
+   * @param num_entries the number of entries between begin and end; it decides how many pages each level gets
+   * @return false, without reading the input, if the tree is not empty
+   */
+  template <typename Iterator>
+  bool BulkLoad(Iterator begin, Iterator end, size_t num_entries, double fill_factor = 1.0) {
+    BulkLoadState state;
+    if (!BeginBulkLoad(&state, num_entries, fill_factor)) {
+      return false;
+    }
+    for (; begin != end; ++begin) {
+      AppendBulkLoad(&state, begin->first, begin->second);
+    }
+    FinishBulkLoad(&state);
+    return true;
+  }
+
   // index iterator
   INDEXITERATOR_TYPE Begin();
   INDEXITERATOR_TYPE Begin(const KeyType &key);
   INDEXITERATOR_TYPE End();
 
+  // range scan, a leaf's worth of entries at a time
+  INDEXRANGESCAN_TYPE Scan(const KeyRange<KeyType> &range);
+
   void Print(BufferPoolManager *bpm) {
     ToString(reinterpret_cast<BPlusTreePage *>(bpm->FetchPage(root_page_id_)->GetData()), bpm);
   }
@@ -76,14 +165,74 @@ class BPlusTree {
 
   // read data from file and remove one by one
   void RemoveFromFile(const std::string &file_name, Transaction *transaction = nullptr);
-  // expose for test purpose
+  // expose for test purpose; the returned leaf is pinned and read-latched, or nullptr if the tree is empty
   Page *FindLeafPage(const KeyType &key, bool leftMost = false);
 
  private:
   void StartNewTree(const KeyType &key, const ValueType &value);
 
+  // number of latch-free attempts GetValue makes before falling back to read-latch crabbing
+  static constexpr int OPTIMISTIC_READ_ATTEMPTS = 8;
+
+  // latch-free lookup; returns false if it raced with a writer and has to be retried
+  bool GetValueOptimistic(const KeyType &key, ValueType *value, bool *found);
+
+  /*
+   * Crab down from the root with read latches. The leaf is write-latched if write_leaf is set. Returns the pinned,
+   * latched leaf, or nullptr if the tree is empty.
+   */
+  Page *FindLeafPageLatched(const KeyType &key, bool left_most, bool write_leaf);
+
+  /*
+   * Crab down with read latches to the last leaf holding keys <= key (< key if inclusive is not set), or to the right
+   * most leaf if key is nullptr. Also returns the leaf's lower fence, the separator every key to its left is below,
+   * which is unset for the left most leaf. Returns the pinned, read-latched leaf, or nullptr if the tree is empty.
+   */
+  Page *FindLeafPageReverse(const KeyType *key, bool inclusive, std::optional<KeyType> *lower_fence);
+
+  /*
+   * Crab down from the root with write latches, keeping only the unsafe suffix of the path latched in the
+   * transaction's page set. The caller must hold root_latch_ in write mode and have recorded it in the page set.
+   */
+  Page *FindLeafPagePessimistic(const KeyType &key, Operation op, Transaction *transaction);
+
+  // whether "node" can absorb "op" without a split or merge reaching its parent
+  bool IsSafe(BPlusTreePage *node, Operation op) const;
+
+  // unlatch and unpin every page in the transaction's page set (unlocking root_latch_ for the nullptr entry)
+  void ReleaseLatchedPages(Transaction *transaction, bool is_dirty);
+
+  // release the page set of a pessimistic pass that threw, keeping the pages it was about to delete
+  void AbortLatchedPages(Transaction *transaction);
+
+  // write-latch a tree page and make its version odd so that latch-free readers of it restart
+  void WLatchNode(Page *page);
+
+  // bump the page's version if it was modified (restore it otherwise) and release its write latch
+  void WUnlatchNode(Page *page, bool modified);
+
+  // delete the pages collected in the transaction's deleted page set; call after ReleaseLatchedPages
+  void DeletePages(Transaction *transaction);
+
   bool InsertIntoLeaf(const KeyType &key, const ValueType &value, Transaction *transaction = nullptr);
 
+  // add another value to the key at "index" of a write-latched leaf; returns false if the key already has it
+  bool InsertDuplicate(LeafPage *leaf, int index, const ValueType &value);
+
+  // remove "value" of the key, or every value if it is nullptr
+  void RemoveValues(const KeyType &key, const ValueType *value, Transaction *transaction);
+
+  /*
+   * Take "value" (every value if nullptr) out of the key's entry in a write-latched leaf. A value in a posting list is
+   * removed right away, and a list down to one value is folded back into the leaf, setting "modified". Removing the
+   * entry itself is left to the caller, since it may need a merge.
+   * @return true if the whole entry has to go
+   */
+  bool TrimEntry(LeafPage *leaf, const KeyType &key, const ValueType *value, bool *modified);
+
+  // remove the key's entry from a write-latched leaf, freeing its posting list if it has one
+  void RemoveEntry(LeafPage *leaf, const KeyType &key);
+
   void InsertIntoParent(BPlusTreePage *old_node, const KeyType &key, BPlusTreePage *new_node,
                         Transaction *transaction = nullptr);
 
@@ -104,6 +253,42 @@ class BPlusTree {
 
   void UpdateRootPageId(int insert_record = 0);
 
+  // fetch a tree page, or throw OUT_OF_MEMORY if the buffer pool has no frame for it
+  Page *FetchPage(page_id_t page_id);
+
+  // one level of a bulk load; pages are numbered left to right and the one being filled stays pinned
+  struct BulkLoadLevel {
+    size_t num_pages_;
+    // entries (or children) over the whole level, spread evenly over its pages
+    size_t num_entries_;
+    size_t pages_started_{0};
+    Page *page_{nullptr};
+    int target_size_{0};
+  };
+
+  struct BulkLoadState {
+    // leaves first, root last
+    std::vector<BulkLoadLevel> levels_;
+    size_t num_appended_{0};
+    KeyType last_key_;
+  };
+
+  // number of pages a level of num_entries entries gets: about fill entries each, but at least min_size
+  static size_t BulkLoadPages(size_t num_entries, int fill, int min_size);
+
+  // plan the levels and take root_latch_; returns false if the tree is not empty
+  bool BeginBulkLoad(BulkLoadState *state, size_t num_entries, double fill_factor);
+  void AppendBulkLoad(BulkLoadState *state, const KeyType &key, const ValueType &value);
+  // make the top page the root and release root_latch_
+  void FinishBulkLoad(BulkLoadState *state);
+  // unpin the open pages and release root_latch_, then throw; pages already written are leaked
+  [[noreturn]] void AbortBulkLoad(BulkLoadState *state, ExceptionType type, const std::string &message);
+
+  // start the next page of a level, whose first key is key; returns it pinned after linking it into its parent
+  Page *StartBulkLoadPage(BulkLoadState *state, size_t level, const KeyType &key);
+  // add a child to the open page of a level, starting a new page when it is full; returns the parent's page id
+  page_id_t AppendBulkLoadChild(BulkLoadState *state, size_t level, const KeyType &key, page_id_t child_page_id);
+
   /* Debug Routines for FREE!! */
   void ToGraph(BPlusTreePage *page, BufferPoolManager *bpm, std::ofstream &out) const;
 
@@ -111,11 +296,25 @@ class BPlusTree {
 
   // member variable
   std::string index_name_;
-  page_id_t root_page_id_;
+  // written under root_latch_; read without it by latch-free lookups
+  std::atomic<page_id_t> root_page_id_;
+  ReaderWriterLatch root_latch_;
+  // where the header page keeps root_page_id_, once known; written under root_latch_
+  RID header_record_;
   BufferPoolManager *buffer_pool_manager_;
   KeyComparator comparator_;
   int leaf_max_size_;
   int internal_max_size_;
+  bool unique_keys_;
+
+  std::atomic<RemoveMode> remove_mode_{RemoveMode::EAGER};
+  // leaves lazy removes left underfull, each with the last key removed from it
+  std::unordered_map<page_id_t, KeyType> underfull_leaves_;
+  std::mutex underfull_latch_;
+  std::thread merge_thread_;
+  bool stop_merge_thread_{false};
+  std::mutex merge_thread_latch_;
+  std::condition_variable merge_thread_cv_;
 };
 
 }  // namespace bustub
@@ -14,6 +14,7 @@
 #include <map>
 #include <memory>
 #include <string>
+#include <utility>
 #include <vector>
 
 #include "storage/index/b_plus_tree.h"
@@ -26,7 +27,13 @@ namespace bustub {
 INDEX_TEMPLATE_ARGUMENTS
 class BPlusTreeIndex : public Index {
  public:
-  BPlusTreeIndex(std::unique_ptr<IndexMetadata> &&metadata, BufferPoolManager *buffer_pool_manager);
+  /**
+   * @param unique_keys if false, a key may have any number of RIDs, kept in a posting list once it has more than one;
+   * otherwise inserting a key that is already there has no effect. An index with included columns stores them in the
+   * leaf entry after the key, which takes unique keys; the key and included columns together must fit in KeyType.
+   */
+  BPlusTreeIndex(std::unique_ptr<IndexMetadata> &&metadata, BufferPoolManager *buffer_pool_manager,
+                 bool unique_keys = true);
 
   void InsertEntry(const Tuple &key, RID rid, Transaction *transaction) override;
 
@@ -34,13 +41,51 @@ class BPlusTreeIndex : public Index {
 
   void ScanKey(const Tuple &key, std::vector<RID> *result, Transaction *transaction) override;
 
+  // sort the table's keys externally and bulk load them, unless the tree already has entries
+  void BuildFromTable(TableHeap *table_heap, const Schema &table_schema, Transaction *transaction) override;
+
+  bool IsUnique() const { return unique_keys_; }
+
   INDEXITERATOR_TYPE GetBeginIterator();
 
   INDEXITERATOR_TYPE GetBeginIterator(const KeyType &key);
 
   INDEXITERATOR_TYPE GetEndIterator();
 
+  bool SupportsRangeScan() const override { return true; }
+
+  std::unique_ptr<IndexRangeCursor> ScanRange(const KeyRange<Tuple> &range, Transaction *transaction) override;
+
+  bool SupportsIndexOnlyScan() const override { return true; }
+
+  INDEXRANGESCAN_TYPE GetRangeScan(const KeyRange<KeyType> &range);
+
  protected:
+  /*
+   * Bulk load a non-unique tree from entries sorted by key, writing out the posting list of every key with several
+   * RIDs first. Returns false without consuming the input if the tree is not empty.
+   */
+  template <typename Iterator>
+  bool BulkLoadGrouped(Iterator *begin, Iterator end);
+
+  // hands out the RIDs of a range scan over the tree, and the leaf entries they were found under
+  class RangeCursor : public IndexRangeCursor {
+   public:
+    RangeCursor(INDEXRANGESCAN_TYPE &&scan, Schema *entry_schema)
+        : scan_(std::move(scan)), entry_schema_(entry_schema) {}
+
+    bool NextBatch(std::vector<RID> *rids) override;
+
+    bool NextEntryBatch(std::vector<RID> *rids, std::vector<Tuple> *entries) override;
+
+   private:
+    INDEXRANGESCAN_TYPE scan_;
+    Schema *entry_schema_;
+    std::vector<MappingType> entries_;
+  };
+
+  BufferPoolManager *buffer_pool_manager_;
+  bool unique_keys_;
   // comparator for key
   KeyComparator comparator_;
   // container
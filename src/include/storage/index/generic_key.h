@@ -14,6 +14,7 @@
 
 #include <cstring>
 
+#include "common/macros.h"
 #include "storage/table/tuple.h"
 #include "type/value.h"
 
@@ -103,4 +104,36 @@ class GenericComparator {
   Schema *key_schema_;
 };
 
+/**
+ * Function object for keys whose only column is a BIGINT, which GenericKey stores as a native int64_t in its first
+ * 8 bytes. It compares the raw integers instead of going through Value, and because the key type is known at compile
+ * time the B+ tree pages can search it with SIMD instructions (see b_plus_tree_key_search.h).
+ * Unlike GenericComparator it orders NULL (the smallest int64_t) before every other value.
+ */
+template <size_t KeySize>
+class IntegerComparator {
+  static_assert(KeySize >= sizeof(int64_t), "integer keys need at least 8 bytes");
+
+ public:
+  inline int operator()(const GenericKey<KeySize> &lhs, const GenericKey<KeySize> &rhs) const {
+    int64_t lhs_value = ToInteger(lhs);
+    int64_t rhs_value = ToInteger(rhs);
+    return static_cast<int>(lhs_value > rhs_value) - static_cast<int>(lhs_value < rhs_value);
+  }
+
+  static inline int64_t ToInteger(const GenericKey<KeySize> &key) {
+    int64_t value;
+    memcpy(&value, key.data_, sizeof(value));
+    return value;
+  }
+
+  IntegerComparator() = default;
+
+  // constructor, taking the key schema to be interchangeable with GenericComparator
+  explicit IntegerComparator(Schema *key_schema) {
+    BUSTUB_ASSERT(key_schema->GetColumnCount() == 1 && key_schema->GetColumn(0).GetType() == TypeId::BIGINT,
+                  "IntegerComparator requires a single BIGINT key column");
+  }
+};
+
 }  // namespace bustub
@@ -18,6 +18,9 @@
 #include <vector>
 
 #include "catalog/schema.h"
+#include "common/exception.h"
+#include "storage/index/key_range.h"
+#include "storage/table/table_heap.h"
 #include "storage/table/tuple.h"
 #include "type/value.h"
 
@@ -43,14 +46,26 @@ class IndexMetadata {
    * @param table_name The name of the table on which the index is created
    * @param tuple_schema The schema of the indexed key
    * @param key_attrs The mapping from indexed columns to base table columns
+   * @param include_attrs The base table columns stored alongside the key without being part of it (INCLUDE columns)
    */
   IndexMetadata(std::string index_name, std::string table_name, const Schema *tuple_schema,
-                std::vector<uint32_t> key_attrs)
-      : name_(std::move(index_name)), table_name_(std::move(table_name)), key_attrs_(std::move(key_attrs)) {
+                std::vector<uint32_t> key_attrs, std::vector<uint32_t> include_attrs = {})
+      : name_(std::move(index_name)),
+        table_name_(std::move(table_name)),
+        key_attrs_(std::move(key_attrs)),
+        include_attrs_(std::move(include_attrs)) {
     key_schema_ = Schema::CopySchema(tuple_schema, key_attrs_);
+    entry_attrs_ = key_attrs_;
+    entry_attrs_.insert(entry_attrs_.end(), include_attrs_.begin(), include_attrs_.end());
+    entry_schema_ = include_attrs_.empty() ? key_schema_ : Schema::CopySchema(tuple_schema, entry_attrs_);
   }
 
-  ~IndexMetadata() { delete key_schema_; }
+  ~IndexMetadata() {
+    if (entry_schema_ != key_schema_) {
+      delete entry_schema_;
+    }
+    delete key_schema_;
+  }
 
   /** @return The name of the index */
   inline const std::string &GetName() const { return name_; }
@@ -72,6 +87,18 @@ class IndexMetadata {
   /** @return The mapping relation between indexed columns and base table columns */
   inline const std::vector<uint32_t> &GetKeyAttrs() const { return key_attrs_; }
 
+  /** @return The base table columns stored alongside the key */
+  inline const std::vector<uint32_t> &GetIncludeAttrs() const { return include_attrs_; }
+
+  /** @return The key columns followed by the included columns, as base table columns */
+  inline const std::vector<uint32_t> &GetEntryAttrs() const { return entry_attrs_; }
+
+  /**
+   * @return A schema object pointer that represents an index entry: the key columns followed by the included ones. Its
+   * key columns lie where they lie in the key schema, so an entry can be compared as a key.
+   */
+  inline Schema *GetEntrySchema() const { return entry_schema_; }
+
   /** @return A string representation for debugging */
   std::string ToString() const {
     std::stringstream os;
@@ -81,6 +108,14 @@ class IndexMetadata {
        << "Type = B+Tree, "
        << "Table name = " << table_name_ << "] :: ";
     os << key_schema_->ToString();
+    if (!include_attrs_.empty()) {
+      // the entry schema repeats the key columns first
+      os << " INCLUDE (";
+      for (uint32_t i = key_attrs_.size(); i < entry_schema_->GetColumnCount(); i++) {
+        os << (i == key_attrs_.size() ? "" : ", ") << entry_schema_->GetColumn(i).ToString();
+      }
+      os << ")";
+    }
 
     return os.str();
   }
@@ -92,14 +127,42 @@ class IndexMetadata {
   std::string table_name_;
   /** The mapping relation between key schema and tuple schema */
   const std::vector<uint32_t> key_attrs_;
+  /** The base table columns stored alongside the key, and the key columns followed by them */
+  const std::vector<uint32_t> include_attrs_;
+  std::vector<uint32_t> entry_attrs_;
   /** The schema of the indexed key */
   Schema *key_schema_;
+  /** The schema of an index entry; the key schema itself if there are no included columns */
+  Schema *entry_schema_;
 };
 
 /////////////////////////////////////////////////////////////////////
 // Index class definition
 /////////////////////////////////////////////////////////////////////
 
+/**
+ * A range scan over an index, started by Index::ScanRange. Hands out the RIDs of the matching entries in key order,
+ * a batch at a time.
+ */
+class IndexRangeCursor {
+ public:
+  virtual ~IndexRangeCursor() = default;
+
+  /**
+   * Replaces the contents of rids with the next batch of RIDs. A batch is never empty.
+   * @return false once the scan is exhausted
+   */
+  virtual bool NextBatch(std::vector<RID> *rids) = 0;
+
+  /**
+   * Like NextBatch, but also fills entries with the entry each RID was found under, over the index's entry schema.
+   * Only cursors of indexes that support index-only scans implement this.
+   */
+  virtual bool NextEntryBatch(std::vector<RID> *rids, std::vector<Tuple> *entries) {
+    throw Exception(ExceptionType::NOT_IMPLEMENTED, "Index does not store its entries");
+  }
+};
+
 /**
  * class Index - Base class for derived indices of different types
  *
@@ -139,6 +202,20 @@ class Index {
   /** @return The index key attributes */
   const std::vector<uint32_t> &GetKeyAttrs() const { return metadata_->GetKeyAttrs(); }
 
+  /** @return The schema of an index entry, the key columns followed by the included ones */
+  Schema *GetEntrySchema() const { return metadata_->GetEntrySchema(); }
+
+  /** @return The base table columns of an index entry */
+  const std::vector<uint32_t> &GetEntryAttrs() const { return metadata_->GetEntryAttrs(); }
+
+  /**
+   * Build the tuple InsertEntry and DeleteEntry take for a table tuple: its key columns, followed by the included
+   * columns if the index has any. Lookups only need the key columns.
+   */
+  Tuple EntryFromTuple(const Tuple &tuple, const Schema &table_schema) const {
+    return tuple.KeyFromTuple(table_schema, *GetEntrySchema(), GetEntryAttrs());
+  }
+
   /** @return A string representation for debugging */
   std::string ToString() const {
     std::stringstream os;
@@ -153,7 +230,7 @@ class Index {
 
   /**
    * Insert an entry into the index.
-   * @param key The index key
+   * @param key The index entry, see EntryFromTuple
    * @param rid The RID associated with the key (unused)
    * @param transaction The transaction context
    */
@@ -161,7 +238,7 @@ class Index {
 
   /**
    * Delete an index entry by key.
-   * @param key The index key
+   * @param key The index key; included columns, if any, are ignored
    * @param rid The RID associated with the key (unused)
    * @param transaction The transaction context
    */
@@ -175,6 +252,45 @@ class Index {
    */
   virtual void ScanKey(const Tuple &key, std::vector<RID> *result, Transaction *transaction) = 0;
 
+  ///////////////////////////////////////////////////////////////////
+  // Range Scan
+  ///////////////////////////////////////////////////////////////////
+
+  /** @return true if the index keeps its keys ordered and implements ScanRange */
+  virtual bool SupportsRangeScan() const { return false; }
+
+  /**
+   * Scan the entries whose keys lie in a range.
+   * @param range The key tuples bounding the scan, and its direction
+   * @param transaction The transaction context
+   * @return A cursor over the RIDs of the matching entries
+   */
+  virtual std::unique_ptr<IndexRangeCursor> ScanRange(const KeyRange<Tuple> &range, Transaction *transaction) {
+    throw Exception(ExceptionType::NOT_IMPLEMENTED, "Index " + GetName() + " does not support range scans");
+  }
+
+  /**
+   * @return true if the ScanRange cursors implement NextEntryBatch, which lets queries that only need the entry's
+   * columns skip the table
+   */
+  virtual bool SupportsIndexOnlyScan() const { return false; }
+
+  ///////////////////////////////////////////////////////////////////
+  // Bulk Construction
+  ///////////////////////////////////////////////////////////////////
+
+  /**
+   * Add an entry for every tuple of a table. Indexes that can do better than one insert per tuple override this.
+   * @param table_heap The table to index
+   * @param table_schema The schema of the table's tuples
+   * @param transaction The transaction context
+   */
+  virtual void BuildFromTable(TableHeap *table_heap, const Schema &table_schema, Transaction *transaction) {
+    for (auto tuple = table_heap->Begin(transaction); tuple != table_heap->End(); ++tuple) {
+      InsertEntry(EntryFromTuple(*tuple, table_schema), tuple->GetRid(), transaction);
+    }
+  }
+
  private:
   /** The Index structure owns its metadata */
   std::unique_ptr<IndexMetadata> metadata_;
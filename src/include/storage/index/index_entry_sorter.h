@@ -0,0 +1,163 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// index_entry_sorter.h
+//
+// Identification: src/include/storage/index/index_entry_sorter.h
+//
+// Copyright (c) 2015-2021, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <iterator>
+#include <memory>
+#include <utility>
+#include <vector>
+
+#include "buffer/buffer_pool_manager.h"
+#include "common/macros.h"
+#include "common/run_merger.h"
+#include "storage/page/b_plus_tree_page.h"
+
+namespace bustub {
+
+#define INDEX_ENTRY_SORTER_TYPE IndexEntrySorter<KeyType, ValueType, KeyComparator>
+
+/**
+ * External merge sort of (key, value) index entries, used to bulk load an index from a table that does not fit in
+ * memory.
+ *
+ * Added entries are buffered up to run_size; every full buffer is sorted and written out through the buffer pool as a
+ * run of consecutive pages. Finish() merges runs fan_in at a time until at most fan_in are left, and the last merge
+ * happens on the fly as the sorted entries are read back with Next() or the iterator; see RunMerger. Run pages are
+ * deleted as soon as they have been consumed. If everything fits in one buffer, nothing is written at all.
+ *
+ * With unique_keys set, only the first added entry of each key is kept, as if the entries had been inserted one by
+ * one into a unique index. GetSize() must then be exact before the first entry is read, so Finish() merges all the
+ * way down to a single run, which costs one more pass when the entries spilled.
+ */
+INDEX_TEMPLATE_ARGUMENTS
+class IndexEntrySorter {
+ public:
+  /** Default number of entries sorted in memory at a time. */
+  static constexpr size_t DEFAULT_RUN_SIZE = 1 << 16;
+  /** Default number of runs merged at once; each pins one page while it is merged. */
+  static constexpr size_t DEFAULT_FAN_IN = 16;
+
+  IndexEntrySorter(BufferPoolManager *buffer_pool_manager, const KeyComparator &comparator,
+                   bool unique_keys = false, size_t run_size = DEFAULT_RUN_SIZE, size_t fan_in = DEFAULT_FAN_IN);
+  ~IndexEntrySorter();
+
+  DISALLOW_COPY_AND_MOVE(IndexEntrySorter);
+
+  /** Adds an entry. Must not be called after Finish(). */
+  void Add(const KeyType &key, const ValueType &value);
+
+  /** Sorts everything added so far; afterwards the entries can be read back in key order. */
+  void Finish();
+
+  /**
+   * Reads the next entry in key order.
+   * @return false once every entry has been read
+   */
+  bool Next(MappingType *entry);
+
+  /** @return the number of entries that will be read back; only final for unique keys after Finish() */
+  size_t GetSize() const { return size_; }
+
+  /** @return the number of runs that were written out (0 if the sort stayed in memory) */
+  size_t GetNumRuns() const { return num_runs_; }
+
+  /** Single-pass input iterator over the sorted entries, driven by Next(). */
+  class Iterator {
+   public:
+    using iterator_category = std::input_iterator_tag;
+    using value_type = MappingType;
+    using difference_type = std::ptrdiff_t;
+    using pointer = const MappingType *;
+    using reference = const MappingType &;
+
+    explicit Iterator(IndexEntrySorter *sorter) : sorter_(sorter) { ++(*this); }
+    Iterator() = default;
+
+    const MappingType &operator*() const { return entry_; }
+    const MappingType *operator->() const { return &entry_; }
+    Iterator &operator++() {
+      if (!sorter_->Next(&entry_)) {
+        sorter_ = nullptr;
+      }
+      return *this;
+    }
+    bool operator==(const Iterator &other) const { return sorter_ == other.sorter_; }
+    bool operator!=(const Iterator &other) const { return !(*this == other); }
+
+   private:
+    IndexEntrySorter *sorter_{nullptr};
+    MappingType entry_;
+  };
+
+  /** @return an iterator at the first sorted entry; call after Finish(), and only once */
+  Iterator Begin() { return Iterator(this); }
+  Iterator End() { return Iterator(); }
+
+ private:
+  friend class RunMerger<IndexEntrySorter>;
+
+  // a sorted run stored in consecutive pages, written and then read through a cursor holding at most one pinned page
+  struct Run {
+    std::vector<page_id_t> page_ids_;
+    size_t size_{0};
+    size_t next_page_{0};
+    Page *page_{nullptr};
+    uint32_t index_{0};
+  };
+
+  static constexpr size_t ENTRIES_PER_PAGE = (PAGE_SIZE - sizeof(uint64_t)) / sizeof(MappingType);
+
+  // sort the buffer stably and drop repeated keys if they have to be unique
+  void SortBuffer();
+
+  // sort the buffer and write it out as a new run
+  void SpillBuffer();
+
+  // append one entry to a run being written, whose last page is pinned
+  void AppendEntry(Run *run, const MappingType &entry);
+
+  // the run store of merger_, see RunMerger
+  Run NewRun() { return Run{}; }
+  void AppendToRun(Run *run, const Run &from) { AppendEntry(run, CurrentEntry(from)); }
+  void SealRun(Run *run);
+  bool FillRun(Run *run);
+  void AdvanceRun(Run *run);
+  int CompareRuns(const Run &a, const Run &b) const {
+    return comparator_(CurrentEntry(a).first, CurrentEntry(b).first);
+  }
+  static const MappingType &CurrentEntry(const Run &run) { return PageEntries(run.page_)[run.index_]; }
+
+  // unpin and delete whatever is left of a run
+  void DropRun(Run *run);
+
+  static uint32_t &PageCount(Page *page) { return *reinterpret_cast<uint32_t *>(page->GetData()); }
+  static MappingType *PageEntries(Page *page) {
+    return reinterpret_cast<MappingType *>(page->GetData() + sizeof(uint64_t));
+  }
+
+  BufferPoolManager *buffer_pool_manager_;
+  KeyComparator comparator_;
+  bool unique_keys_;
+  size_t run_size_;
+  size_t fan_in_;
+  size_t size_{0};
+  size_t num_runs_{0};
+  bool finished_{false};
+
+  std::vector<MappingType> buffer_;
+  size_t buffer_next_{0};
+  // the runs written out, merged on the fly by Next()
+  RunMerger<IndexEntrySorter> merger_;
+};
+
+}  // namespace bustub
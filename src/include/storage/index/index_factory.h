@@ -0,0 +1,69 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// index_factory.h
+//
+// Identification: src/include/storage/index/index_factory.h
+//
+// Copyright (c) 2015-2021, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <memory>
+
+#include "buffer/buffer_pool_manager.h"
+#include "storage/index/index.h"
+
+namespace bustub {
+
+/** IndexType names the index implementations that can be created through the catalog. */
+enum class IndexType {
+  ExtendibleHash,
+  LinearProbeHash,
+  BPlusTree,
+  BEpsilonTree,
+  AdaptiveRadixTree
+};
+
+/**
+ * IndexFactory builds an index of a given type for the key described by its metadata. Fixed-size indexes get the
+ * smallest GenericKey<N> that holds the key, or for a B+ tree with included columns, the whole entry. A B+ tree on a
+ * single BIGINT column compares its keys as integers, and one on a VARCHAR key stores them as variable-length bytes.
+ */
+class IndexFactory {
+ public:
+  /** The size of the largest GenericKey that fixed-size indexes are instantiated for. */
+  static constexpr size_t MAX_KEY_SIZE = 64;
+
+  /** The number of buckets a linear probe hash index starts out with. */
+  static constexpr size_t LINEAR_PROBE_NUM_BUCKETS = 1024;
+
+  /**
+   * @param unique_keys whether a key may have only one RID; only B+ tree indexes can be unique, every other type keeps
+   * all RIDs of a key
+   * @return the new, empty index
+   * @throws OUT_OF_RANGE if a fixed-size index cannot hold the key, as for any hash or B-epsilon tree key with a
+   * VARCHAR column
+   * @throws NOT_IMPLEMENTED if an index other than a B+ tree is given included columns, or a B+ tree on a VARCHAR key
+   * is not unique or has included columns
+   */
+  static std::unique_ptr<Index> Create(IndexType index_type, std::unique_ptr<IndexMetadata> &&metadata,
+                                       BufferPoolManager *buffer_pool_manager, bool unique_keys = true);
+
+  /**
+   * @return the N of the GenericKey<N> an index of the type stores the key in, or for indexes that store keys as
+   * variable-length bytes, the length of the key tuple
+   * @throws OUT_OF_RANGE if a fixed-size index cannot hold the key, as for any hash or B-epsilon tree key with a
+   * VARCHAR column
+   */
+  static size_t KeySize(IndexType index_type, const IndexMetadata &metadata);
+
+ private:
+  // the N of the smallest GenericKey<N> that holds tuples of the schema
+  static size_t FixedKeySize(const Schema &schema);
+};
+
+}  // namespace bustub
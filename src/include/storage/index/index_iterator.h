@@ -13,6 +13,10 @@
  * For range scan of b+ tree
  */
 #pragma once
+#include <vector>
+
+#include "common/macros.h"
+#include "storage/index/posting_list.h"
 #include "storage/page/b_plus_tree_leaf_page.h"
 
 namespace bustub {
@@ -21,9 +25,24 @@ namespace bustub {
 
 INDEX_TEMPLATE_ARGUMENTS
 class IndexIterator {
+  using LeafPage = BPlusTreeLeafPage<KeyType, ValueType, KeyComparator>;
+
  public:
-  // you may define your own constructor based on your member variables
+  /** Creates the end iterator. */
   IndexIterator();
+
+  /**
+   * Creates an iterator positioned at entry "index" of a pinned leaf page. The iterator takes over the pin.
+   * Only the pin is held between calls; the leaf's read latch is taken just long enough to copy out the current entry
+   * and the posting list of a key with several values, which the iterator then steps through one by one, or to follow
+   * the leaf's next pointer.
+   */
+  IndexIterator(BufferPoolManager *buffer_pool_manager, Page *page, int index);
+
+  IndexIterator(IndexIterator &&other) noexcept;
+  IndexIterator &operator=(IndexIterator &&other) noexcept;
+  DISALLOW_COPY(IndexIterator);
+
   ~IndexIterator();
 
   bool IsEnd();
@@ -32,12 +51,28 @@ class IndexIterator {
 
   IndexIterator &operator++();
 
-  bool operator==(const IndexIterator &itr) const { throw std::runtime_error("unimplemented"); }
+  bool operator==(const IndexIterator &itr) const { return page_ == itr.page_ && index_ == itr.index_; }
 
-  bool operator!=(const IndexIterator &itr) const { throw std::runtime_error("unimplemented"); }
+  bool operator!=(const IndexIterator &itr) const { return !(*this == itr); }
 
  private:
-  // add your own private member variables here
+  /**
+   * Copies out the entry at the current position, moving on to the next leaf while the position is past the end of
+   * the current one, and reads the entry's posting list if it refers to one.
+   */
+  void LoadEntry();
+
+  /** Drops the pin on the current leaf, if any. */
+  void Release();
+
+  BufferPoolManager *buffer_pool_manager_{nullptr};
+  Page *page_{nullptr};
+  LeafPage *leaf_{nullptr};
+  int index_{0};
+  // the current entry, copied out of the leaf; with a posting list, its value is postings_[posting_index_]
+  MappingType entry_;
+  std::vector<ValueType> postings_;
+  size_t posting_index_{0};
 };
 
 }  // namespace bustub
@@ -0,0 +1,94 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// index_range_scan.h
+//
+// Identification: src/include/storage/index/index_range_scan.h
+//
+// Copyright (c) 2015-2021, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <optional>
+#include <vector>
+
+#include "buffer/buffer_pool_manager.h"
+#include "common/macros.h"
+#include "storage/index/key_range.h"
+#include "storage/page/b_plus_tree_leaf_page.h"
+
+namespace bustub {
+
+#define INDEXRANGESCAN_TYPE IndexRangeScan<KeyType, ValueType, KeyComparator>
+
+INDEX_TEMPLATE_ARGUMENTS
+class BPlusTree;
+
+/**
+ * A range scan over a B+ tree, handed out by BPlusTree::Scan.
+ *
+ * Entries come out one leaf at a time: NextBatch copies every entry of a leaf that lies in the range while holding
+ * the leaf's read latch once, where IndexIterator goes back to the page for every entry. Before returning a batch
+ * the scan already pins the leaf it will read next, so that fetching it is off the path of the following call.
+ *
+ * Forward scans follow the leaves' next page ids, noting the version of the next leaf while the current one is still
+ * latched. Leaves have no back links, so a reverse scan descends from the root again for each leaf, looking for the
+ * keys below the lower fence of the leaf it just read. Either way, a prefetched leaf whose version changed before it
+ * was read is looked up again, so entries moved by a split, merge or redistribution are neither skipped nor repeated.
+ *
+ * In a non-unique tree, a key's posting list is read while its leaf is latched and each of its values comes out as an
+ * entry of its own, in ascending order (descending for reverse scans). Such a batch can hold more than a leaf's worth.
+ */
+INDEX_TEMPLATE_ARGUMENTS
+class IndexRangeScan {
+  using Tree = BPlusTree<KeyType, ValueType, KeyComparator>;
+  using LeafPage = BPlusTreeLeafPage<KeyType, ValueType, KeyComparator>;
+
+ public:
+  IndexRangeScan(Tree *tree, BufferPoolManager *buffer_pool_manager, const KeyComparator &comparator,
+                 KeyRange<KeyType> range);
+
+  IndexRangeScan(IndexRangeScan &&other) noexcept;
+  DISALLOW_COPY(IndexRangeScan);
+  IndexRangeScan &operator=(IndexRangeScan &&other) = delete;
+
+  ~IndexRangeScan();
+
+  /**
+   * Replaces the contents of batch with the next entries of the range, in scan order. A batch is never empty.
+   * @return false once the scan is exhausted
+   */
+  bool NextBatch(std::vector<MappingType> *batch);
+
+ private:
+  // copy the matching entries of the next leaf; sets done_ when no later leaf can match
+  void ScanForward(std::vector<MappingType> *batch);
+  void ScanReverse(std::vector<MappingType> *batch);
+
+  // replace each entry that refers to a posting list by one entry per value; the leaf must be latched
+  void ExpandPostingLists(std::vector<MappingType> *batch, bool reverse);
+
+  // pin the leaf a reverse scan reads next, the last one holding keys below next_bound_
+  void PrefetchReverse();
+
+  Tree *tree_;
+  BufferPoolManager *buffer_pool_manager_;
+  KeyComparator comparator_;
+  KeyRange<KeyType> range_;
+  bool started_{false};
+  bool done_{false};
+
+  // the leaf to read next: pinned, but not latched
+  Page *next_page_{nullptr};
+  // next_page_ had next_version_ when it was found. Keys of the next leaf must be below next_bound_ for reverse scans
+  // and above it for forward scans, once has_next_bound_; the lower fence of a reverse scan's next leaf is next_fence_.
+  KeyType next_bound_;
+  bool has_next_bound_{false};
+  uint64_t next_version_{0};
+  std::optional<KeyType> next_fence_;
+};
+
+}  // namespace bustub
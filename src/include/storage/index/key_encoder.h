@@ -0,0 +1,49 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// key_encoder.h
+//
+// Identification: src/include/storage/index/key_encoder.h
+//
+// Copyright (c) 2015-2021, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <string>
+
+#include "catalog/schema.h"
+#include "storage/table/tuple.h"
+#include "type/value.h"
+
+namespace bustub {
+
+/**
+ * KeyEncoder turns a key tuple into a byte string whose memcmp order is the order of the key's columns, so that
+ * indexes can store and compare keys as plain variable-length bytes.
+ *
+ * Each column is encoded as a one byte NULL marker (NULL sorts first) followed, for non-NULL values, by:
+ * - integers: big-endian with the sign bit flipped, at the column's width
+ * - DECIMAL: the IEEE-754 bits, with the sign bit flipped for positive values and every bit flipped for negative ones
+ * - TIMESTAMP: big-endian
+ * - VARCHAR: the bytes with 0x00 escaped as 0x00 0xFF, terminated by 0x00 0x00, so shorter strings sort first and no
+ *   encoded column is a prefix of another
+ */
+class KeyEncoder {
+ public:
+  /** @param key_schema the schema of the key tuples to encode */
+  explicit KeyEncoder(const Schema *key_schema) : key_schema_(key_schema) {}
+
+  /** @return the encoding of a key tuple */
+  std::string Encode(const Tuple &key) const;
+
+  /** Appends the encoding of a single value to out. */
+  static void AppendValue(const Value &value, std::string *out);
+
+ private:
+  const Schema *key_schema_;
+};
+
+}  // namespace bustub
@@ -0,0 +1,33 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// key_range.h
+//
+// Identification: src/include/storage/index/key_range.h
+//
+// Copyright (c) 2015-2021, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <optional>
+
+namespace bustub {
+
+/**
+ * The keys a range scan visits, and in which direction. An unset bound leaves that side of the range open.
+ * KeyType is an index key for the B+ tree itself, or a key Tuple at the Index interface.
+ */
+template <typename KeyType>
+struct KeyRange {
+  std::optional<KeyType> lower_;
+  bool lower_inclusive_{true};
+  std::optional<KeyType> upper_;
+  bool upper_inclusive_{true};
+  /** Visit the keys from the largest to the smallest. */
+  bool reverse_{false};
+};
+
+}  // namespace bustub
@@ -0,0 +1,71 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// posting_list.h
+//
+// Identification: src/include/storage/index/posting_list.h
+//
+// Copyright (c) 2015-2021, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <limits>
+#include <optional>
+#include <vector>
+
+#include "buffer/buffer_pool_manager.h"
+#include "common/rid.h"
+#include "storage/page/b_plus_tree_posting_page.h"
+
+namespace bustub {
+
+/**
+ * The RIDs of a key that occurs more than once in a non-unique B+ tree. A leaf keeps a single RID inline; once a key
+ * gets a second one, its leaf entry is replaced by a reference to a posting list, a chain of BPlusTreePostingPages
+ * holding all of the key's RIDs in ascending order. Each page is delta-encoded on its own, so an insert or removal
+ * only rewrites the page it lands on. A full page is split in half, except when the RID goes to the end of the list,
+ * where a new page is started instead so that RIDs appended in table order pack pages fully.
+ *
+ * The first page of a list never moves, so the leaf entry stays valid as the list grows and shrinks. Posting pages
+ * have no latches of their own: they are protected by the latch of the leaf that references them.
+ */
+class PostingList {
+ public:
+  /** Slot number that marks a leaf value as a reference to a posting list; no table page has that many slots. */
+  static constexpr uint32_t REFERENCE_SLOT_NUM = std::numeric_limits<uint32_t>::max();
+
+  static bool IsReference(const RID &rid) { return rid.GetSlotNum() == REFERENCE_SLOT_NUM; }
+  static RID MakeReference(page_id_t head_page_id) { return RID(head_page_id, REFERENCE_SLOT_NUM); }
+
+  /**
+   * Writes sorted, distinct RIDs out as a new posting list.
+   * @return the reference to store in the leaf
+   */
+  static RID Create(BufferPoolManager *buffer_pool_manager, const std::vector<RID> &rids);
+
+  /** @return false if the RID is already in the list */
+  static bool Insert(BufferPoolManager *buffer_pool_manager, const RID &reference, const RID &rid);
+
+  /**
+   * Removes a RID from the list. If only one RID is left afterwards, the list is freed and that RID is returned in
+   * "only_rid", to be stored inline in the leaf again.
+   * @return false if the RID is not in the list
+   */
+  static bool Remove(BufferPoolManager *buffer_pool_manager, const RID &reference, const RID &rid,
+                     std::optional<RID> *only_rid);
+
+  /** Appends every RID of the list to "rids", in ascending order. */
+  static void Read(BufferPoolManager *buffer_pool_manager, const RID &reference, std::vector<RID> *rids);
+
+  /** Deletes every page of the list. */
+  static void Free(BufferPoolManager *buffer_pool_manager, const RID &reference);
+
+ private:
+  static Page *FetchPage(BufferPoolManager *buffer_pool_manager, page_id_t page_id);
+  static Page *NewPage(BufferPoolManager *buffer_pool_manager, page_id_t *page_id);
+};
+
+}  // namespace bustub
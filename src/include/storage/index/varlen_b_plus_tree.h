@@ -0,0 +1,101 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// varlen_b_plus_tree.h
+//
+// Identification: src/include/storage/index/varlen_b_plus_tree.h
+//
+// Copyright (c) 2015-2021, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <functional>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+#include "buffer/buffer_pool_manager.h"
+#include "common/rid.h"
+#include "common/rwlatch.h"
+#include "storage/page/b_plus_tree_varlen_page.h"
+
+namespace bustub {
+
+/**
+ * B+ tree over variable-length byte string keys compared with memcmp (see KeyEncoder), built from
+ * BPlusTreeVarlenPage. Only the bytes a key actually needs are stored, minus the prefix every key of its page shares.
+ *
+ * Separators are suffix-truncated: a leaf split pushes up the shortest prefix of the right half's first key that is
+ * still greater than the left half's last key, so internal pages hold short separators and have a high fanout.
+ * Pages split and merge by bytes rather than by entry count. A page that has dropped below a quarter full is merged
+ * with a sibling when the result fits in one page; otherwise it is left as is, possibly empty.
+ *
+ * Unique keys only. The whole tree is protected by one reader-writer latch.
+ */
+class VarlenBPlusTree {
+  using LeafPage = BPlusTreeVarlenPage<RID>;
+  using InternalPage = BPlusTreeVarlenPage<page_id_t>;
+
+ public:
+  VarlenBPlusTree(std::string name, BufferPoolManager *buffer_pool_manager);
+
+  // Returns true if this B+ tree has no keys and values.
+  bool IsEmpty() const;
+
+  // Insert a key-value pair into this B+ tree. Returns false for a duplicate key; throws if the key is too long.
+  bool Insert(std::string_view key, const RID &value);
+
+  // Remove a key and its value from this B+ tree.
+  void Remove(std::string_view key);
+
+  // return the value associated with a given key
+  bool GetValue(std::string_view key, std::vector<RID> *result);
+
+  /**
+   * Visits the entries with keys >= begin_key in key order until the callback returns false.
+   */
+  void Scan(std::string_view begin_key, const std::function<bool(std::string_view key, const RID &value)> &callback);
+
+  // number of levels, 0 for an empty tree
+  int GetHeight();
+
+ private:
+  // an internal page on the path to a leaf, and the index of the child that was followed
+  struct PathEntry {
+    Page *page_;
+    int child_index_;
+  };
+
+  // descend to the leaf for key; returns it pinned, along with the pinned internal pages on the way if path is set
+  Page *FindLeafPage(std::string_view key, std::vector<PathEntry> *path);
+
+  bool InsertLocked(std::string_view key, const RID &value);
+
+  // split a full leaf in half by bytes; returns the separator and the new, pinned right page
+  std::pair<std::string, Page *> SplitLeaf(Page *page);
+
+  // add a separator for the new page "right" next to "left", the child at path[level]
+  void InsertIntoParent(const std::vector<PathEntry> &path, size_t level, Page *left, const std::string &separator,
+                        Page *right);
+
+  // merge the node at path depth "level" with a sibling if it has become too empty
+  void HandleUnderflow(const std::vector<PathEntry> &path, size_t level, Page *page, std::vector<page_id_t> *deleted);
+
+  void UnpinPath(const std::vector<PathEntry> &path, bool is_dirty);
+
+  void UpdateRootPageId(int insert_record = 0);
+
+  // member variable
+  std::string index_name_;
+  page_id_t root_page_id_;
+  // where the header page keeps root_page_id_, once known
+  RID header_record_;
+  BufferPoolManager *buffer_pool_manager_;
+  ReaderWriterLatch latch_;
+};
+
+}  // namespace bustub
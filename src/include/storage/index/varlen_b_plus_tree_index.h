@@ -0,0 +1,46 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// varlen_b_plus_tree_index.h
+//
+// Identification: src/include/storage/index/varlen_b_plus_tree_index.h
+//
+// Copyright (c) 2015-2021, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "storage/index/index.h"
+#include "storage/index/key_encoder.h"
+#include "storage/index/varlen_b_plus_tree.h"
+
+namespace bustub {
+
+/**
+ * B+ tree index storing keys in their memcmp-ordered encoding (see KeyEncoder) instead of a fixed-size GenericKey,
+ * so short VARCHAR and composite keys take only the space they need.
+ */
+class VarlenBPlusTreeIndex : public Index {
+ public:
+  VarlenBPlusTreeIndex(std::unique_ptr<IndexMetadata> &&metadata, BufferPoolManager *buffer_pool_manager);
+
+  void InsertEntry(const Tuple &key, RID rid, Transaction *transaction) override;
+
+  void DeleteEntry(const Tuple &key, RID rid, Transaction *transaction) override;
+
+  void ScanKey(const Tuple &key, std::vector<RID> *result, Transaction *transaction) override;
+
+ protected:
+  // turns key tuples into byte strings
+  KeyEncoder encoder_;
+  // container
+  VarlenBPlusTree container_;
+};
+
+}  // namespace bustub
@@ -0,0 +1,104 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// b_epsilon_tree_internal_page.h
+//
+// Identification: src/include/storage/page/b_epsilon_tree_internal_page.h
+//
+// Copyright (c) 2015-2021, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <utility>
+
+#include "storage/page/b_epsilon_tree_message.h"
+#include "storage/page/b_plus_tree_page.h"
+
+namespace bustub {
+
+#define B_EPSILON_TREE_INTERNAL_PAGE_TYPE BEpsilonTreeInternalPage<KeyType, ValueType, KeyComparator>
+#define B_EPSILON_INTERNAL_PAGE_HEADER_SIZE 40
+#define B_EPSILON_MAX_FANOUT 32
+// the children take room for one more than the fanout: a flush may leave a node one child over until it is split
+#define B_EPSILON_MESSAGE_CAPACITY                                                                                 \
+  ((PAGE_SIZE - B_EPSILON_INTERNAL_PAGE_HEADER_SIZE -                                                              \
+    (B_EPSILON_MAX_FANOUT + 1) * sizeof(std::pair<MappingType, page_id_t>)) /                                      \
+   sizeof(BEpsilonMessage<KeyType, ValueType>))
+
+/**
+ * Internal page of a B-epsilon tree: a small array of children, like a B+ tree internal page, and a buffer of
+ * pending messages that fills the rest of the page.
+ *
+ * Child i holds the entries from pivot i (inclusive) up to pivot i + 1; pivot 0 is unused. Pivots are whole (key,
+ * value) entries, ordered by CompareEntries, so the entries of one key may spread over several children. Messages are
+ * kept in the same order, at most one per entry: a newer message on an entry replaces the older one. The messages of
+ * a child are therefore contiguous, and a flush moves them down as a single run.
+ *
+ * Internal page format:
+ *  ---------------------------------------------------------------------------------------------
+ * | HEADER | PIVOT(1) + CHILD(1) | ... | PIVOT(MAX + 1) + CHILD(MAX + 1) | MESSAGE(1) | ... |
+ *  ---------------------------------------------------------------------------------------------
+ *
+ *  Header format (size in byte, 40 bytes in total): the BPlusTreePage header, followed by
+ *  ---------------------------------------
+ * | NumMessages (4) | MaxNumMessages (4) |
+ *  ---------------------------------------
+ */
+INDEX_TEMPLATE_ARGUMENTS
+class BEpsilonTreeInternalPage : public BPlusTreePage {
+  using Message = BEpsilonMessage<KeyType, ValueType>;
+
+ public:
+  // After creating a new internal page from buffer pool, must call initialize method to set default values
+  void Init(page_id_t page_id, int max_size = B_EPSILON_MAX_FANOUT, int max_messages = B_EPSILON_MESSAGE_CAPACITY);
+
+  /*
+   * Children
+   */
+  page_id_t ChildAt(int index) const { return children_[index].second; }
+  const MappingType &PivotAt(int index) const { return children_[index].first; }
+  /** @return the child whose range holds the entry (key, value) */
+  int ChildIndex(const KeyType &key, const ValueType &value, const KeyComparator &comparator) const;
+  /** @return the first and the last child whose ranges may hold entries of key */
+  std::pair<int, int> ChildRange(const KeyType &key, const KeyComparator &comparator) const;
+  void PopulateNewRoot(page_id_t left, const MappingType &pivot, page_id_t right);
+  void InsertChildAfter(int index, const MappingType &pivot, page_id_t child);
+  bool IsOverflowing() const { return GetSize() > GetMaxSize(); }
+
+  /*
+   * Message buffer
+   */
+  int GetNumMessages() const { return num_messages_; }
+  bool IsBufferFull() const { return num_messages_ >= max_messages_; }
+  int GetFreeMessages() const { return max_messages_ - num_messages_; }
+  const Message &MessageAt(int index) const { return messages_[index]; }
+  /** @return the index of the first message whose key is not smaller than key */
+  int MessageKeyIndex(const KeyType &key, const KeyComparator &comparator) const;
+  /** @return the range [first, second) of the messages that belong to a child */
+  std::pair<int, int> MessageRange(int child_index, const KeyComparator &comparator) const;
+  /**
+   * Adds a message, replacing an older message on the same entry. The buffer must not be full.
+   */
+  void AddMessage(const Message &message, const KeyComparator &comparator);
+  void RemoveMessages(int begin, int count);
+
+  /**
+   * Moves the upper half of the children, with their messages, into an empty recipient. The recipient's pivot 0 is
+   * the separator to add to the parent.
+   */
+  void MoveHalfTo(BEpsilonTreeInternalPage *recipient, const KeyComparator &comparator);
+
+ private:
+  // index of the first message not smaller than the entry
+  int MessageIndex(const MappingType &entry, const KeyComparator &comparator) const;
+
+  int32_t num_messages_;
+  int32_t max_messages_;
+  std::pair<MappingType, page_id_t> children_[B_EPSILON_MAX_FANOUT + 1];
+  Message messages_[0];
+};
+
+}  // namespace bustub
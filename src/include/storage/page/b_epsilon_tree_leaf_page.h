@@ -0,0 +1,69 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// b_epsilon_tree_leaf_page.h
+//
+// Identification: src/include/storage/page/b_epsilon_tree_leaf_page.h
+//
+// Copyright (c) 2015-2021, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <utility>
+
+#include "storage/page/b_epsilon_tree_message.h"
+#include "storage/page/b_plus_tree_page.h"
+
+namespace bustub {
+
+#define B_EPSILON_TREE_LEAF_PAGE_TYPE BEpsilonTreeLeafPage<KeyType, ValueType, KeyComparator>
+#define B_EPSILON_LEAF_PAGE_HEADER_SIZE 36
+#define B_EPSILON_LEAF_PAGE_SIZE ((PAGE_SIZE - B_EPSILON_LEAF_PAGE_HEADER_SIZE) / sizeof(MappingType))
+
+/**
+ * Leaf page of a B-epsilon tree. Unlike a B+ tree leaf, it stores (key, value) entries, ordered by CompareEntries,
+ * so a key may appear once per value. Entries only change when buffered messages are flushed into the leaf.
+ *
+ * Leaf page format (entries are stored in order):
+ *  ----------------------------------------------------------------------
+ * | HEADER | KEY(1) + RID(1) | KEY(2) + RID(2) | ... | KEY(n) + RID(n)
+ *  ----------------------------------------------------------------------
+ *
+ *  Header format (size in byte, 36 bytes in total): the BPlusTreePage header, followed by NextPageId (4)
+ */
+INDEX_TEMPLATE_ARGUMENTS
+class BEpsilonTreeLeafPage : public BPlusTreePage {
+  using Message = BEpsilonMessage<KeyType, ValueType>;
+
+ public:
+  // After creating a new leaf page from buffer pool, must call initialize method to set default values
+  void Init(page_id_t page_id, int max_size = B_EPSILON_LEAF_PAGE_SIZE);
+
+  page_id_t GetNextPageId() const { return next_page_id_; }
+  void SetNextPageId(page_id_t next_page_id) { next_page_id_ = next_page_id; }
+  KeyType KeyAt(int index) const { return array_[index].first; }
+  ValueType ValueAt(int index) const { return array_[index].second; }
+
+  /** @return the index of the first entry whose key is not smaller than key */
+  int KeyIndex(const KeyType &key, const KeyComparator &comparator) const;
+  /** @return the index of the first entry not smaller than (key, value) */
+  int EntryIndex(const KeyType &key, const ValueType &value, const KeyComparator &comparator) const;
+
+  /**
+   * Inserts or deletes the message's entry; inserting an entry that is there, or deleting one that is not, does
+   * nothing. The page must have room for one more entry.
+   */
+  void Apply(const Message &message, const KeyComparator &comparator);
+
+  /** Moves the upper half of the entries into an empty recipient, which becomes the next leaf. */
+  void MoveHalfTo(BEpsilonTreeLeafPage *recipient);
+
+ private:
+  page_id_t next_page_id_;
+  MappingType array_[0];
+};
+
+}  // namespace bustub
@@ -0,0 +1,47 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// b_epsilon_tree_message.h
+//
+// Identification: src/include/storage/page/b_epsilon_tree_message.h
+//
+// Copyright (c) 2015-2021, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <cstdint>
+
+namespace bustub {
+
+/** What a buffered message does to its entry once it reaches a leaf. */
+enum class BEpsilonOp : int32_t { INSERT = 0, DELETE };
+
+/** An insert or delete of a single entry, waiting in the buffer of a BEpsilonTreeInternalPage. */
+template <typename KeyType, typename ValueType>
+struct BEpsilonMessage {
+  KeyType key_;
+  ValueType value_;
+  BEpsilonOp op_;
+};
+
+/**
+ * Orders the entries of a B-epsilon tree: by key, then by value, so that a key can have several values. Values are
+ * RIDs.
+ */
+template <typename KeyType, typename ValueType, typename KeyComparator>
+int CompareEntries(const KeyType &lhs_key, const ValueType &lhs_value, const KeyType &rhs_key,
+                   const ValueType &rhs_value, const KeyComparator &comparator) {
+  int cmp = comparator(lhs_key, rhs_key);
+  if (cmp != 0) {
+    return cmp;
+  }
+  if (lhs_value.Get() != rhs_value.Get()) {
+    return lhs_value.Get() < rhs_value.Get() ? -1 : 1;
+  }
+  return 0;
+}
+
+}  // namespace bustub
@@ -0,0 +1,164 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// b_plus_tree_key_search.h
+//
+// Identification: src/include/storage/page/b_plus_tree_key_search.h
+//
+// Copyright (c) 2015-2021, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <cstdint>
+#include <cstring>
+#include <utility>
+
+#ifdef __AVX2__
+#include <immintrin.h>
+#endif
+
+#include "storage/index/generic_key.h"
+
+namespace bustub {
+
+/*
+ * Search strategies over the sorted (key, value) array of a B+ tree page.
+ *
+ * Each one returns the partition point of array[begin, end) under a predicate that holds for a prefix of the array,
+ * i.e. the first index for which it is false (or end). With "key < search key" that is the lower bound, with
+ * "key <= search key" the upper bound. The pages only use KeySearch below; the individual strategies are exposed so
+ * they can be benchmarked against each other.
+ */
+
+/** Textbook binary search. The branch on every comparison is taken about half the time, at random. */
+template <typename Entry, typename Predicate>
+int BranchingPartitionPoint(const Entry *array, int begin, int end, Predicate pred) {
+  while (begin < end) {
+    int mid = begin + (end - begin) / 2;
+    if (pred(array[mid])) {
+      begin = mid + 1;
+    } else {
+      end = mid;
+    }
+  }
+  return begin;
+}
+
+/** Linear scan, the cost a naive search pays on a full page. */
+template <typename Entry, typename Predicate>
+int LinearPartitionPoint(const Entry *array, int begin, int end, Predicate pred) {
+  while (begin < end && pred(array[begin])) {
+    begin++;
+  }
+  return begin;
+}
+
+/**
+ * Binary search without a data-dependent branch. The window [base, base + n) only shrinks from the top and whether
+ * its base moves up is a conditional move, so the loop always runs ceil(log2(n)) times and never mispredicts.
+ */
+template <typename Entry, typename Predicate>
+int BranchFreePartitionPoint(const Entry *array, int begin, int end, Predicate pred) {
+  int n = end - begin;
+  if (n <= 0) {
+    return begin;
+  }
+  const Entry *base = array + begin;
+  while (n > 1) {
+    int half = n / 2;
+    base = pred(base[half]) ? base + half : base;
+    n -= half;
+  }
+  return static_cast<int>(base - array) + static_cast<int>(pred(*base));
+}
+
+/**
+ * Search over keys that are native int64_t values stored at the start of each entry's key (see IntegerComparator).
+ * Branch-free halving narrows the window to a few cache lines, then the entries in it that satisfy the predicate are
+ * counted four at a time with AVX2 compares; since the array is sorted, that count is the offset of the answer.
+ * @param or_equal false to find the lower bound of key, true for the upper bound
+ */
+template <typename Entry>
+int IntegerPartitionPoint(const Entry *array, int begin, int end, int64_t key, bool or_equal) {
+  static constexpr int SCAN_WINDOW = 16;
+  auto key_at = [](const Entry &entry) {
+    int64_t value;
+    memcpy(&value, &entry.first, sizeof(value));
+    return value;
+  };
+
+  int n = end - begin;
+  if (n <= 0) {
+    return begin;
+  }
+  const Entry *base = array + begin;
+  while (n > SCAN_WINDOW) {
+    int half = n / 2;
+    int64_t probe = key_at(base[half]);
+    base = (or_equal ? probe <= key : probe < key) ? base + half : base;
+    n -= half;
+  }
+
+  int count = 0;
+  int i = 0;
+#ifdef __AVX2__
+  static constexpr int STRIDE = sizeof(Entry);
+  const __m128i offsets = _mm_setr_epi32(0, STRIDE, 2 * STRIDE, 3 * STRIDE);
+  const __m256i needle = _mm256_set1_epi64x(key);
+  int greater = 0;
+  for (; i + 4 <= n; i += 4) {
+    const auto *first = reinterpret_cast<const long long *>(&base[i].first);  // NOLINT
+    __m256i keys = _mm256_i32gather_epi64(first, offsets, 1);
+    // lower bound counts entries below the key, upper bound counts entries above it and takes the complement
+    __m256i mask = or_equal ? _mm256_cmpgt_epi64(keys, needle) : _mm256_cmpgt_epi64(needle, keys);
+    greater += __builtin_popcount(_mm256_movemask_pd(_mm256_castsi256_pd(mask)));
+  }
+  count = or_equal ? i - greater : greater;
+#endif
+  for (; i < n; i++) {
+    int64_t value = key_at(base[i]);
+    count += static_cast<int>(or_equal ? value <= key : value < key);
+  }
+  return static_cast<int>(base - array) + count;
+}
+
+/**
+ * The search the B+ tree pages use for a key type, chosen at compile time from the comparator: a branch-free binary
+ * search for arbitrary comparators, and the integer search above for IntegerComparator keys.
+ */
+template <typename KeyType, typename ValueType, typename KeyComparator>
+struct KeySearch {
+  using Entry = std::pair<KeyType, ValueType>;
+
+  /** @return the first index in [begin, end) whose key is >= key, or end */
+  static int LowerBound(const Entry *array, int begin, int end, const KeyType &key, const KeyComparator &comparator) {
+    return BranchFreePartitionPoint(array, begin, end,
+                                    [&](const Entry &entry) { return comparator(entry.first, key) < 0; });
+  }
+
+  /** @return the first index in [begin, end) whose key is > key, or end */
+  static int UpperBound(const Entry *array, int begin, int end, const KeyType &key, const KeyComparator &comparator) {
+    return BranchFreePartitionPoint(array, begin, end,
+                                    [&](const Entry &entry) { return comparator(entry.first, key) <= 0; });
+  }
+};
+
+template <size_t KeySize, typename ValueType>
+struct KeySearch<GenericKey<KeySize>, ValueType, IntegerComparator<KeySize>> {
+  using Entry = std::pair<GenericKey<KeySize>, ValueType>;
+
+  static int LowerBound(const Entry *array, int begin, int end, const GenericKey<KeySize> &key,
+                        const IntegerComparator<KeySize> &comparator) {
+    return IntegerPartitionPoint(array, begin, end, IntegerComparator<KeySize>::ToInteger(key), false);
+  }
+
+  static int UpperBound(const Entry *array, int begin, int end, const GenericKey<KeySize> &key,
+                        const IntegerComparator<KeySize> &comparator) {
+    return IntegerPartitionPoint(array, begin, end, IntegerComparator<KeySize>::ToInteger(key), true);
+  }
+};
+
+}  // namespace bustub
@@ -10,6 +10,7 @@
 //===----------------------------------------------------------------------===//
 #pragma once
 
+#include <atomic>
 #include <cassert>
 #include <climits>
 #include <cstdlib>
@@ -33,12 +34,16 @@ enum class IndexPageType { INVALID_INDEX_PAGE = 0, LEAF_PAGE, INTERNAL_PAGE };
  * It actually serves as a header part for each B+ tree page and
  * contains information shared by both leaf page and internal page.
  *
- * Header format (size in byte, 24 bytes in total):
+ * Header format (size in byte, 32 bytes in total):
  * ----------------------------------------------------------------------------
  * | PageType (4) | LSN (4) | CurrentSize (4) | MaxSize (4) |
  * ----------------------------------------------------------------------------
- * | ParentPageId (4) | PageId(4) |
+ * | ParentPageId (4) | PageId(4) | Version (8) |
  * ----------------------------------------------------------------------------
+ *
+ * Version supports optimistic lock coupling: readers traverse without latching, remember each page's version and
+ * restart if it changed by the time they are done. A writer holding the page's write latch makes the version odd
+ * before modifying the page and even again afterwards.
  */
 class BPlusTreePage {
  public:
@@ -62,6 +67,16 @@ class BPlusTreePage {
 
   void SetLSN(lsn_t lsn = INVALID_LSN);
 
+  // Returns the current version. An odd version means a writer is modifying the page.
+  uint64_t ReadVersion() const;
+  // Returns true if the version is still "version", i.e. nothing read since ReadVersion() was torn.
+  bool ValidateVersion(uint64_t version) const;
+  // Called with the page write-latched, before it is modified.
+  void BeginWrite();
+  // Called before releasing the write latch. If the page was not modified, the old version is restored so that
+  // optimistic readers that overlapped the latch do not have to restart.
+  void EndWrite(bool modified);
+
  private:
   // member variable, attributes that both internal and leaf page share
   IndexPageType page_type_ __attribute__((__unused__));
@@ -70,6 +85,7 @@ class BPlusTreePage {
   int max_size_ __attribute__((__unused__));
   page_id_t parent_page_id_ __attribute__((__unused__));
   page_id_t page_id_ __attribute__((__unused__));
+  std::atomic<uint64_t> version_;
 };
 
 }  // namespace bustub
@@ -0,0 +1,77 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// b_plus_tree_posting_page.h
+//
+// Identification: src/include/storage/page/b_plus_tree_posting_page.h
+//
+// Copyright (c) 2015-2021, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+#include "common/config.h"
+#include "common/rid.h"
+
+namespace bustub {
+
+/**
+ * One page of a posting list: the RIDs of a key in a non-unique B+ tree that has more than one of them (see
+ * PostingList). RIDs are kept sorted by RID::Get() and stored as LEB128 varints, the first one in full and every
+ * other one as the difference to its predecessor. RIDs of the same table page differ only in their slot number, so
+ * most of them take a single byte.
+ *
+ * Page format:
+ *  ----------------------------------------------------------------------------
+ * | HEADER | RID(1) | RID(2) - RID(1) | ... | RID(n) - RID(n-1) | free space |
+ *  ----------------------------------------------------------------------------
+ *
+ * Header format (size in byte, 24 bytes in total):
+ *  ---------------------------------------------------------------------------
+ * | NextPageId (4) | CurrentSize (4) | NumBytes (4) | ListSize (4) | Last (8) |
+ *  ---------------------------------------------------------------------------
+ * ListSize is the number of RIDs in the whole list and is only kept up to date on its first page.
+ */
+class BPlusTreePostingPage {
+ public:
+  /** Number of bytes the encoded RIDs may take. */
+  static constexpr size_t CAPACITY = PAGE_SIZE - 24;
+
+  // After creating a new posting page from buffer pool, must call initialize method to set default values
+  void Init();
+
+  page_id_t GetNextPageId() const { return next_page_id_; }
+  void SetNextPageId(page_id_t next_page_id) { next_page_id_ = next_page_id; }
+  int GetSize() const { return size_; }
+  uint32_t GetListSize() const { return list_size_; }
+  void SetListSize(uint32_t list_size) { list_size_ = list_size; }
+  /** @return the largest RID in the page; the page must not be empty */
+  RID GetLast() const { return RID(last_); }
+
+  /** Appends the RIDs of the page to "rids", in ascending order. */
+  void Decode(std::vector<RID> *rids) const;
+
+  /**
+   * Replaces the contents of the page with the longest prefix of [begin, end) that fits. The RIDs must be sorted and
+   * distinct.
+   * @return the number of RIDs written
+   */
+  size_t Encode(const RID *begin, const RID *end);
+
+ private:
+  page_id_t next_page_id_;
+  int32_t size_;
+  uint32_t num_bytes_;
+  uint32_t list_size_;
+  int64_t last_;
+  uint8_t data_[CAPACITY];
+};
+
+static_assert(sizeof(BPlusTreePostingPage) == PAGE_SIZE);
+
+}  // namespace bustub
@@ -0,0 +1,135 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// b_plus_tree_varlen_page.h
+//
+// Identification: src/include/storage/page/b_plus_tree_varlen_page.h
+//
+// Copyright (c) 2015-2021, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <optional>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+#include "storage/page/b_plus_tree_page.h"
+
+namespace bustub {
+
+/**
+ * Slotted B+ tree page holding variable-length, memcmp-ordered keys (see KeyEncoder). Used for both leaf pages
+ * (ValueType = RID) and internal pages (ValueType = page_id_t); as in BPlusTreeInternalPage, the key of an internal
+ * page's first slot is unused.
+ *
+ * Page format:
+ *  ---------------------------------------------------------------------------------------
+ * | HEADER | SLOT(1) | SLOT(2) | ... | SLOT(n) | free space | key heap (grows downwards) |
+ *  ---------------------------------------------------------------------------------------
+ * Each slot holds its value and the offset and length of its key in the heap.
+ *
+ * Header format (size in byte, 52 bytes in total):
+ *  ---------------------------------------------------------------------
+ * | PageType (4) | LSN (4) | CurrentSize (4) | MaxSize (4) |
+ *  ---------------------------------------------------------------------
+ * | ParentPageId (4) | PageId (4) | Version (8) | NextPageId (4) |
+ *  ---------------------------------------------------------------------
+ * | HeapBegin (2) | Garbage (2) | LowerFence (2 + 2) | UpperFence (2 + 2) | PrefixLength (2) | HasUpperFence (2) |
+ *  ---------------------------------------------------------------------
+ *
+ * Every key in the page lies in [lower fence, upper fence), the separators around the page in its parent; an empty
+ * lower fence and a missing upper fence stand for -inf and +inf. Under memcmp order all such keys share the common
+ * prefix of the two fences, so it is stored once (as the start of the lower fence) and only the remaining suffix of
+ * each key goes into the heap. The prefix only depends on the fences, so inserts never have to grow existing keys.
+ */
+template <typename ValueType>
+class BPlusTreeVarlenPage : public BPlusTreePage {
+ public:
+  using Entries = std::vector<std::pair<std::string, ValueType>>;
+
+  /** Longest key the page accepts; small enough that a split always leaves room for one more key. */
+  static constexpr size_t MAX_KEY_SIZE = 256;
+
+  // After creating a new page from buffer pool, must call initialize method to set default values. The new page is
+  // empty and covers (-inf, +inf).
+  void Init(page_id_t page_id, IndexPageType page_type);
+
+  page_id_t GetNextPageId() const { return next_page_id_; }
+  void SetNextPageId(page_id_t next_page_id) { next_page_id_ = next_page_id; }
+
+  /** @return the full key at "index", i.e. the page prefix followed by the stored suffix */
+  std::string KeyAt(int index) const;
+  ValueType ValueAt(int index) const { return slots_[index].value_; }
+  void SetValueAt(int index, const ValueType &value) { slots_[index].value_ = value; }
+  /** @return all entries with their full keys */
+  Entries GetEntries() const;
+
+  std::string GetLowerFence() const;
+  /** @return the upper fence, or nullopt if the page extends to +inf */
+  std::optional<std::string> GetUpperFence() const;
+  int GetPrefixLength() const { return prefix_length_; }
+
+  /** @return the first index in [begin, size) whose key is >= key, or size */
+  int LowerBound(std::string_view key, int begin = 0) const;
+  /** @return the first index in [begin, size) whose key is > key, or size */
+  int UpperBound(std::string_view key, int begin = 0) const;
+
+  /**
+   * Inserts an entry at "index". The key must lie within the page's fences.
+   * @return false (leaving the page unchanged) if the page does not have room for it
+   */
+  bool Insert(int index, std::string_view key, const ValueType &value);
+  void Remove(int index);
+
+  /** Replaces the page's fences and contents. The caller checks with BytesNeeded that they fit. */
+  void Rebuild(std::string_view lower_fence, const std::optional<std::string> &upper_fence, const Entries &entries);
+
+  /** @return the number of bytes the page is using, header included */
+  size_t GetUsedBytes() const;
+  /** @return the number of bytes a page rebuilt with these fences and entries would use */
+  static size_t BytesNeeded(std::string_view lower_fence, const std::optional<std::string> &upper_fence,
+                            const Entries &entries);
+
+ private:
+  struct Slot {
+    uint16_t offset_;
+    uint16_t length_;
+    ValueType value_;
+  };
+
+  /** @return the key suffix stored for "index" */
+  std::string_view SuffixAt(int index) const;
+  /** @return the bytes from the heap starting at "offset" */
+  std::string_view HeapAt(uint16_t offset, uint16_t length) const;
+  /** Copies bytes into the heap and returns their offset; the caller made sure they fit. */
+  uint16_t AllocateInHeap(std::string_view bytes);
+  /** Rewrites the heap without the garbage left by removed keys. */
+  void Compact();
+  size_t ContiguousFreeSpace() const;
+  /**
+   * Compares key with the page prefix. Returns 0 if key starts with it, otherwise the sign of the comparison; a key
+   * that is not in the page's range must sort before or after every entry.
+   */
+  int ComparePrefix(std::string_view key) const;
+  template <bool OrEqual>
+  int PartitionPoint(std::string_view key, int begin) const;
+
+  page_id_t next_page_id_;
+  uint16_t heap_begin_;
+  uint16_t garbage_;
+  uint16_t lower_fence_offset_;
+  uint16_t lower_fence_length_;
+  uint16_t upper_fence_offset_;
+  uint16_t upper_fence_length_;
+  uint16_t prefix_length_;
+  uint16_t has_upper_fence_;
+  // Flexible array member for the slots
+  Slot slots_[0];
+};
+
+}  // namespace bustub
@@ -0,0 +1,74 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// header_bucket_page.h
+//
+// Identification: src/include/storage/page/header_bucket_page.h
+//
+// Copyright (c) 2015-2021, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <cstdint>
+#include <string>
+
+#include "common/config.h"
+
+namespace bustub {
+
+/**
+ * One bucket of the header page's name -> root id table (see HeaderPage). Records never move once written, so a
+ * slot number stays valid for as long as its record exists. A slot whose name is empty is free. A full bucket
+ * continues in an overflow page.
+ *
+ * Page format (size in byte):
+ *  -----------------------------------------------------------------------------------------------
+ * | NextPageId (4) | RecordCount (4) | Record_1 name (32) | Record_1 root_id (4) | ... | free ... |
+ *  -----------------------------------------------------------------------------------------------
+ */
+class HeaderBucketPage {
+ public:
+  /** Longest name, plus its terminating NUL. */
+  static constexpr size_t NAME_SIZE = 32;
+  static constexpr int CAPACITY = (PAGE_SIZE - 2 * sizeof(int32_t)) / (NAME_SIZE + sizeof(page_id_t));
+
+  // After creating a new bucket page from buffer pool, must call initialize method to set default values
+  void Init();
+
+  page_id_t GetNextPageId() const { return next_page_id_; }
+  void SetNextPageId(page_id_t next_page_id) { next_page_id_ = next_page_id; }
+  int GetRecordCount() const { return record_count_; }
+  bool IsFull() const { return record_count_ == CAPACITY; }
+
+  /** @return the slot holding "name", or -1 */
+  int FindRecord(const std::string &name) const;
+  /** @return whether "slot" holds the record of "name" */
+  bool IsRecordAt(int slot, const std::string &name) const;
+
+  /**
+   * Writes a record into the first free slot. The page must not be full and must not hold the name already.
+   * @return the slot
+   */
+  int InsertRecord(const std::string &name, page_id_t root_id);
+  void DeleteRecord(int slot);
+
+  page_id_t GetRootId(int slot) const { return records_[slot].root_id_; }
+  void SetRootId(int slot, page_id_t root_id) { records_[slot].root_id_ = root_id; }
+
+ private:
+  struct Record {
+    char name_[NAME_SIZE];
+    page_id_t root_id_;
+  };
+
+  page_id_t next_page_id_;
+  int32_t record_count_;
+  Record records_[CAPACITY];
+};
+
+static_assert(sizeof(HeaderBucketPage) <= PAGE_SIZE);
+
+}  // namespace bustub
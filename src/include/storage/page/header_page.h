@@ -12,6 +12,10 @@
 
 #include <cstring>
 #include <string>
+
+#include "buffer/buffer_pool_manager.h"
+#include "common/rid.h"
+#include "storage/page/header_bucket_page.h"
 #include "storage/page/page.h"
 
 namespace bustub {
@@ -21,31 +25,55 @@ namespace bustub {
  * our case, we will contain information about table/index name (length less than
  * 32 bytes) and their corresponding root_id
  *
+ * The header page is the directory of a hash table: a name hashes to one of its
+ * buckets, a chain of HeaderBucketPages holding the records, so a lookup reads two
+ * pages no matter how many indexes there are. A bucket page id of 0 means the bucket
+ * has no page yet, which makes a freshly allocated, zeroed page an empty header.
+ *
  * Format (size in byte):
- *  -----------------------------------------------------------------
- * | RecordCount (4) | Entry_1 name (32) | Entry_1 root_id (4) | ... |
- *  -----------------------------------------------------------------
+ *  -------------------------------------------------------------------
+ * | RecordCount (4) | Bucket_1 page_id (4) | Bucket_2 page_id (4) | ... |
+ *  -------------------------------------------------------------------
+ *
+ * Callers latch the header page itself: InsertRecord and DeleteRecord need the
+ * write latch, lookups and updates the read latch. Bucket pages are latched inside.
+ * A record found once can also be updated through its location alone, without
+ * touching the header page, see UpdateRecordAt.
  */
 class HeaderPage : public Page {
  public:
-  void Init() { SetRecordCount(0); }
+  static constexpr size_t NUM_BUCKETS = (PAGE_SIZE - sizeof(int32_t)) / sizeof(page_id_t);
+
+  void Init() { memset(GetData(), 0, PAGE_SIZE); }
   /**
-   * Record related
+   * Record related; "location" receives the bucket page and slot of the record
    */
-  bool InsertRecord(const std::string &name, page_id_t root_id);
-  bool DeleteRecord(const std::string &name);
-  bool UpdateRecord(const std::string &name, page_id_t root_id);
+  bool InsertRecord(BufferPoolManager *bpm, const std::string &name, page_id_t root_id, RID *location = nullptr);
+  bool DeleteRecord(BufferPoolManager *bpm, const std::string &name);
+  bool UpdateRecord(BufferPoolManager *bpm, const std::string &name, page_id_t root_id, RID *location = nullptr);
 
   // return root_id if success
-  bool GetRootId(const std::string &name, page_id_t *root_id);
+  bool GetRootId(BufferPoolManager *bpm, const std::string &name, page_id_t *root_id);
   int GetRecordCount();
 
+  /**
+   * Updates the record at a location an earlier call returned.
+   * @return false if the record of "name" is no longer there
+   */
+  static bool UpdateRecordAt(BufferPoolManager *bpm, const RID &location, const std::string &name, page_id_t root_id);
+
  private:
   /**
    * helper functions
    */
-  int FindRecord(const std::string &name);
+  bool FindRecord(BufferPoolManager *bpm, const std::string &name, RID *location);
 
   void SetRecordCount(int record_count);
+
+  static size_t BucketIndex(const std::string &name);
+  page_id_t *BucketPageIds() { return reinterpret_cast<page_id_t *>(GetData() + sizeof(int32_t)); }
+
+  static Page *FetchPage(BufferPoolManager *bpm, page_id_t page_id);
+  static Page *NewPage(BufferPoolManager *bpm, page_id_t *page_id);
 };
 }  // namespace bustub
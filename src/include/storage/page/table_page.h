@@ -122,6 +122,15 @@ class TablePage : public Page {
    */
   bool GetTuple(const RID &rid, Tuple *tuple, Transaction *txn, LockManager *lock_manager);
 
+  /**
+   * Read a tuple in place, without copying it out of the page or locking it. The tuple points into the page, so it is
+   * only valid while the page stays latched and pinned.
+   * @param rid rid of the tuple to read
+   * @param[out] tuple the tuple that was read, which does not own its data
+   * @return true if the tuple exists
+   */
+  bool PeekTuple(const RID &rid, Tuple *tuple);
+
   /** @return the rid of the first tuple in this page */
 
   /**
@@ -1,15 +1,14 @@
 #pragma once
 
+#include <cstring>
+#include <vector>
+
 #include "storage/page/page.h"
 #include "storage/table/tmp_tuple.h"
 #include "storage/table/tuple.h"
 
 namespace bustub {
 
-// To pass the test cases for this class, you must follow the existing TmpTuplePage format and implement the
-// existing functions exactly as they are! It may be helpful to look at TablePage.
-// Remember that this task is optional, you get full credit if you finish the next task.
-
 /**
  * TmpTuplePage format:
  *
@@ -17,20 +16,66 @@ namespace bustub {
  * | PageId (4) | LSN (4) | FreeSpace (4) | (free space) | TupleSize2 | TupleData2 | TupleSize1 | TupleData1 |
  *
  * We choose this format because DeserializeExpression expects to read Size followed by Data.
+ *
+ * A TmpTuplePage holds tuples an operator spills out of memory, e.g. the partitions of a hash join that do not fit in
+ * its memory budget. Tuples are only ever appended, from the end of the page towards its header, and are never
+ * updated or deleted one by one: the whole page is dropped once the operator has read them back.
  */
 class TmpTuplePage : public Page {
  public:
   void Init(page_id_t page_id, uint32_t page_size) {
     memcpy(GetData(), &page_id, sizeof(page_id_t));
-    memcpy(GetData() + sizeof(page_id_t), &page_size, sizeof(uint32_t));
+    SetLSN(INVALID_LSN);
+    SetFreeSpacePointer(page_size);
+  }
+
+  page_id_t GetTablePageId() { return *reinterpret_cast<page_id_t *>(GetData()); }
+
+  /**
+   * Append a tuple to the page.
+   * @param tuple the tuple to append
+   * @param[out] out where the tuple is stored
+   * @return false if the page does not have enough space left
+   */
+  bool Insert(const Tuple &tuple, TmpTuple *out) {
+    uint32_t size = sizeof(uint32_t) + tuple.GetLength();
+    uint32_t free_space_pointer = GetFreeSpacePointer();
+    if (free_space_pointer < SIZE_TMP_PAGE_HEADER + size) {
+      return false;
+    }
+    free_space_pointer -= size;
+    tuple.SerializeTo(GetData() + free_space_pointer);
+    SetFreeSpacePointer(free_space_pointer);
+    *out = TmpTuple(GetTablePageId(), free_space_pointer);
+    return true;
   }
 
-  page_id_t GetTablePageId() { return INVALID_PAGE_ID; }
+  /** Read back the tuple stored at the given place of the page. */
+  void Get(const TmpTuple &tmp_tuple, Tuple *tuple) { tuple->DeserializeFrom(GetData() + tmp_tuple.GetOffset()); }
 
-  bool Insert(const Tuple &tuple, TmpTuple *out) { return false; }
+  /** Read back every tuple of the page, the most recently appended first. */
+  void GetTuples(std::vector<Tuple> *tuples) {
+    for (uint32_t offset = GetFreeSpacePointer(); offset < PAGE_SIZE;) {
+      tuples->emplace_back();
+      tuples->back().DeserializeFrom(GetData() + offset);
+      offset += sizeof(uint32_t) + tuples->back().GetLength();
+    }
+  }
+
+  /** @return true if the page holds no tuple */
+  bool IsEmpty() { return GetFreeSpacePointer() == PAGE_SIZE; }
 
  private:
   static_assert(sizeof(page_id_t) == 4);
+
+  static constexpr size_t SIZE_TMP_PAGE_HEADER = 12;
+  static constexpr size_t OFFSET_FREE_SPACE = 8;
+
+  uint32_t GetFreeSpacePointer() { return *reinterpret_cast<uint32_t *>(GetData() + OFFSET_FREE_SPACE); }
+
+  void SetFreeSpacePointer(uint32_t free_space_pointer) {
+    memcpy(GetData() + OFFSET_FREE_SPACE, &free_space_pointer, sizeof(uint32_t));
+  }
 };
 
 }  // namespace bustub
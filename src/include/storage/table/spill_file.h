@@ -0,0 +1,69 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// spill_file.h
+//
+// Identification: src/include/storage/table/spill_file.h
+//
+// Copyright (c) 2015-2021, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <vector>
+
+#include "buffer/buffer_pool_manager.h"
+#include "common/macros.h"
+#include "storage/page/tmp_tuple_page.h"
+#include "storage/table/tuple.h"
+
+namespace bustub {
+
+/**
+ * SpillFile is a sequence of tuples that an operator writes out of memory through the buffer pool, to read them back
+ * later in the order they were written, as many times as it needs to.
+ *
+ * Tuples are appended to a TmpTuplePage kept in memory, and every full page is copied into a new page of the buffer
+ * pool and unpinned right away: the file pins no page while it is written, so an operator can write to many files at
+ * once. The pages of the file are deleted along with it.
+ */
+class SpillFile {
+ public:
+  explicit SpillFile(BufferPoolManager *buffer_pool_manager);
+  ~SpillFile();
+
+  DISALLOW_COPY_AND_MOVE(SpillFile);
+
+  /** Append a tuple to the file. */
+  void Append(const Tuple &tuple);
+
+  /** Go back to the first tuple of the file, writing out the tuples appended since the last full page. */
+  void Rewind();
+
+  /**
+   * Read the tuples of the next page of the file.
+   * @param[out] tuples the tuples of the page, appended in the order they were written
+   * @return false once every page has been read
+   */
+  bool ReadPage(std::vector<Tuple> *tuples);
+
+  /** @return the number of tuples appended to the file */
+  size_t GetNumTuples() const { return num_tuples_; }
+
+ private:
+  /** Write the in-memory page out to a new page of the buffer pool, and empty it. */
+  void Flush();
+
+  BufferPoolManager *buffer_pool_manager_;
+  /** The page the tuples are appended to. */
+  TmpTuplePage buffer_;
+  /** The pages written out, in order. */
+  std::vector<page_id_t> page_ids_;
+  /** The position in page_ids_ of the next page to read. */
+  size_t next_page_{0};
+  size_t num_tuples_{0};
+};
+
+}  // namespace bustub
@@ -12,6 +12,10 @@
 
 #pragma once
 
+#include <functional>
+#include <mutex>  // NOLINT
+#include <vector>
+
 #include "buffer/buffer_pool_manager.h"
 #include "recovery/log_manager.h"
 #include "storage/page/table_page.h"
@@ -23,6 +27,9 @@ namespace bustub {
 /**
  * TableHeap represents a physical table on disk.
  * This is just a doubly-linked list of pages.
+ *
+ * Alongside the list, the table keeps a page directory in memory: the ids of its pages, in the order they are linked
+ * in. A scan uses it to split the table into independent ranges of pages without walking the list first.
  */
 class TableHeap {
   friend class TableIterator;
@@ -32,6 +39,7 @@ class TableHeap {
 
   /**
    * Create a table heap without a transaction. (open table)
+   * The page directory is rebuilt by walking the pages of the table once.
    * @param buffer_pool_manager the buffer pool manager
    * @param lock_manager the lock manager
    * @param log_manager the log manager
@@ -99,6 +107,30 @@ class TableHeap {
    */
   bool GetTuple(const RID &rid, Tuple *tuple, Transaction *txn);
 
+  /**
+   * Read every tuple of one page of the table, latching the page once for all of them.
+   * @param page_id the page to read
+   * @param[out] tuples the tuples of the page, appended in slot order
+   * @param txn the transaction performing the read
+   * @param filter if set, only the tuples it accepts are read; it sees each tuple in place, before it is copied out
+   * of the page or locked
+   * @return the id of the page that follows in the table, INVALID_PAGE_ID after the last one
+   * @throws OUT_OF_MEMORY if the page cannot be fetched
+   */
+  page_id_t GetPageTuples(page_id_t page_id, std::vector<Tuple> *tuples, Transaction *txn,
+                          const std::function<bool(const Tuple &)> &filter = nullptr);
+
+  /** @return the number of pages in this table */
+  size_t GetNumPages();
+
+  /**
+   * Read a range of the page directory.
+   * @param begin the position of the first page of the range
+   * @param end the position past the last page of the range, at most GetNumPages()
+   * @param[out] page_ids the ids of the pages of the range, in the order they are linked in
+   */
+  void GetPageIds(size_t begin, size_t end, std::vector<page_id_t> *page_ids);
+
   /** @return the begin iterator of this table */
   TableIterator Begin(Transaction *txn);
 
@@ -113,6 +145,10 @@ class TableHeap {
   LockManager *lock_manager_;
   LogManager *log_manager_;
   page_id_t first_page_id_{};
+  /** Protects page_ids_. */
+  std::mutex page_ids_latch_;
+  /** The page directory. Pages are only ever appended to the table, so it only ever grows at the end. */
+  std::vector<page_id_t> page_ids_;
 };
 
 }  // namespace bustub
@@ -0,0 +1,456 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// adaptive_radix_tree.cpp
+//
+// Identification: src/storage/index/adaptive_radix_tree.cpp
+//
+// Copyright (c) 2015-2021, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "storage/index/adaptive_radix_tree.h"
+
+#include <algorithm>
+#include <utility>
+
+namespace bustub {
+
+struct ArtNode {
+  enum class Type : uint8_t { LEAF, NODE4, NODE16, NODE48, NODE256 };
+
+  explicit ArtNode(Type type) : type_(type) {}
+  virtual ~ArtNode() = default;
+
+  const Type type_;
+};
+
+namespace {
+
+using NodePtr = std::unique_ptr<ArtNode>;
+
+struct Leaf : ArtNode {
+  explicit Leaf(std::string key) : ArtNode(Type::LEAF), key_(std::move(key)) {}
+
+  std::string key_;
+  // ascending
+  std::vector<RID> rids_;
+};
+
+struct InnerNode : ArtNode {
+  using ArtNode::ArtNode;
+
+  // the key bytes that every key below this node has after the byte that led here
+  std::string prefix_;
+  int num_children_{0};
+};
+
+// Node4 and Node16 keep their key bytes sorted, with the children in the same order
+template <int N, ArtNode::Type T>
+struct SmallNode : InnerNode {
+  static constexpr int CAPACITY = N;
+
+  SmallNode() : InnerNode(T) {}
+
+  uint8_t keys_[N]{};
+  NodePtr children_[N];
+};
+
+using Node4 = SmallNode<4, ArtNode::Type::NODE4>;
+using Node16 = SmallNode<16, ArtNode::Type::NODE16>;
+
+struct Node48 : InnerNode {
+  static constexpr int CAPACITY = 48;
+
+  Node48() : InnerNode(Type::NODE48) {}
+
+  // for each key byte, one plus the index of its child in children_, or 0 if it has none
+  uint8_t slots_[256]{};
+  NodePtr children_[CAPACITY];
+};
+
+struct Node256 : InnerNode {
+  Node256() : InnerNode(Type::NODE256) {}
+
+  NodePtr children_[256];
+};
+
+// A node shrinks once it is down to three quarters of the next smaller size's capacity, not as soon as it would fit,
+// so that a key inserted and removed over and over at the boundary does not resize it every time.
+constexpr int ShrinkThreshold(int smaller_capacity) { return smaller_capacity * 3 / 4; }
+
+NodePtr NewLeaf(const std::string &key, const RID &rid) {
+  auto leaf = std::make_unique<Leaf>(key);
+  leaf->rids_.push_back(rid);
+  return leaf;
+}
+
+bool RidLess(const RID &lhs, const RID &rhs) { return lhs.Get() < rhs.Get(); }
+
+template <typename Small>
+NodePtr *FindSmallChild(Small *node, uint8_t byte) {
+  uint8_t *end = node->keys_ + node->num_children_;
+  uint8_t *position = std::lower_bound(node->keys_, end, byte);
+  return position != end && *position == byte ? &node->children_[position - node->keys_] : nullptr;
+}
+
+NodePtr *FindChild(InnerNode *node, uint8_t byte) {
+  switch (node->type_) {
+    case ArtNode::Type::NODE4:
+      return FindSmallChild(static_cast<Node4 *>(node), byte);
+    case ArtNode::Type::NODE16:
+      return FindSmallChild(static_cast<Node16 *>(node), byte);
+    case ArtNode::Type::NODE48: {
+      auto *node48 = static_cast<Node48 *>(node);
+      return node48->slots_[byte] == 0 ? nullptr : &node48->children_[node48->slots_[byte] - 1];
+    }
+    default: {
+      auto *node256 = static_cast<Node256 *>(node);
+      return node256->children_[byte] == nullptr ? nullptr : &node256->children_[byte];
+    }
+  }
+}
+
+// the node must have room, and no child for byte yet
+template <typename Small>
+void InsertSmallChild(Small *node, uint8_t byte, NodePtr child) {
+  int index = static_cast<int>(std::lower_bound(node->keys_, node->keys_ + node->num_children_, byte) - node->keys_);
+  for (int i = node->num_children_; i > index; i--) {
+    node->keys_[i] = node->keys_[i - 1];
+    node->children_[i] = std::move(node->children_[i - 1]);
+  }
+  node->keys_[index] = byte;
+  node->children_[index] = std::move(child);
+  node->num_children_++;
+}
+
+template <typename Small>
+void RemoveSmallChild(Small *node, uint8_t byte) {
+  int index = static_cast<int>(std::lower_bound(node->keys_, node->keys_ + node->num_children_, byte) - node->keys_);
+  for (int i = index; i + 1 < node->num_children_; i++) {
+    node->keys_[i] = node->keys_[i + 1];
+    node->children_[i] = std::move(node->children_[i + 1]);
+  }
+  node->num_children_--;
+  node->children_[node->num_children_].reset();
+}
+
+void InsertNode48Child(Node48 *node, uint8_t byte, NodePtr child) {
+  int index = 0;
+  while (node->children_[index] != nullptr) {
+    index++;
+  }
+  node->children_[index] = std::move(child);
+  node->slots_[byte] = static_cast<uint8_t>(index + 1);
+  node->num_children_++;
+}
+
+// move the children of a Node4 or Node16 into a bigger or smaller one, in order
+template <typename From, typename To>
+std::unique_ptr<To> ResizeSmall(From *node) {
+  auto resized = std::make_unique<To>();
+  resized->prefix_ = std::move(node->prefix_);
+  for (int i = 0; i < node->num_children_; i++) {
+    resized->keys_[i] = node->keys_[i];
+    resized->children_[i] = std::move(node->children_[i]);
+  }
+  resized->num_children_ = node->num_children_;
+  return resized;
+}
+
+std::unique_ptr<Node48> GrowToNode48(Node16 *node) {
+  auto grown = std::make_unique<Node48>();
+  grown->prefix_ = std::move(node->prefix_);
+  for (int i = 0; i < node->num_children_; i++) {
+    InsertNode48Child(grown.get(), node->keys_[i], std::move(node->children_[i]));
+  }
+  return grown;
+}
+
+std::unique_ptr<Node256> GrowToNode256(Node48 *node) {
+  auto grown = std::make_unique<Node256>();
+  grown->prefix_ = std::move(node->prefix_);
+  for (int byte = 0; byte < 256; byte++) {
+    if (node->slots_[byte] != 0) {
+      grown->children_[byte] = std::move(node->children_[node->slots_[byte] - 1]);
+    }
+  }
+  grown->num_children_ = node->num_children_;
+  return grown;
+}
+
+std::unique_ptr<Node16> ShrinkToNode16(Node48 *node) {
+  auto shrunk = std::make_unique<Node16>();
+  shrunk->prefix_ = std::move(node->prefix_);
+  for (int byte = 0; byte < 256; byte++) {
+    if (node->slots_[byte] != 0) {
+      shrunk->keys_[shrunk->num_children_] = static_cast<uint8_t>(byte);
+      shrunk->children_[shrunk->num_children_++] = std::move(node->children_[node->slots_[byte] - 1]);
+    }
+  }
+  return shrunk;
+}
+
+std::unique_ptr<Node48> ShrinkToNode48(Node256 *node) {
+  auto shrunk = std::make_unique<Node48>();
+  shrunk->prefix_ = std::move(node->prefix_);
+  for (int byte = 0; byte < 256; byte++) {
+    if (node->children_[byte] != nullptr) {
+      InsertNode48Child(shrunk.get(), static_cast<uint8_t>(byte), std::move(node->children_[byte]));
+    }
+  }
+  return shrunk;
+}
+
+// add a child for a byte the node has no child for, replacing the node by a bigger one if it is full
+void AddChild(NodePtr *ref, uint8_t byte, NodePtr child) {
+  auto *node = static_cast<InnerNode *>(ref->get());
+  switch (node->type_) {
+    case ArtNode::Type::NODE4:
+      if (node->num_children_ == Node4::CAPACITY) {
+        *ref = ResizeSmall<Node4, Node16>(static_cast<Node4 *>(node));
+        InsertSmallChild(static_cast<Node16 *>(ref->get()), byte, std::move(child));
+      } else {
+        InsertSmallChild(static_cast<Node4 *>(node), byte, std::move(child));
+      }
+      break;
+    case ArtNode::Type::NODE16:
+      if (node->num_children_ == Node16::CAPACITY) {
+        *ref = GrowToNode48(static_cast<Node16 *>(node));
+        InsertNode48Child(static_cast<Node48 *>(ref->get()), byte, std::move(child));
+      } else {
+        InsertSmallChild(static_cast<Node16 *>(node), byte, std::move(child));
+      }
+      break;
+    case ArtNode::Type::NODE48:
+      if (node->num_children_ == Node48::CAPACITY) {
+        *ref = GrowToNode256(static_cast<Node48 *>(node));
+        static_cast<Node256 *>(ref->get())->children_[byte] = std::move(child);
+        static_cast<Node256 *>(ref->get())->num_children_++;
+      } else {
+        InsertNode48Child(static_cast<Node48 *>(node), byte, std::move(child));
+      }
+      break;
+    default:
+      static_cast<Node256 *>(node)->children_[byte] = std::move(child);
+      node->num_children_++;
+      break;
+  }
+}
+
+// drop the child of a byte, replacing the node by a smaller one, or by its only remaining child
+void RemoveChild(NodePtr *ref, uint8_t byte) {
+  auto *node = static_cast<InnerNode *>(ref->get());
+  switch (node->type_) {
+    case ArtNode::Type::NODE4: {
+      auto *node4 = static_cast<Node4 *>(node);
+      RemoveSmallChild(node4, byte);
+      if (node4->num_children_ == 1) {
+        // fold the node into its child: an inner child takes over the node's prefix and the byte leading to it
+        NodePtr child = std::move(node4->children_[0]);
+        if (child->type_ != ArtNode::Type::LEAF) {
+          auto *inner = static_cast<InnerNode *>(child.get());
+          inner->prefix_ = node4->prefix_ + static_cast<char>(node4->keys_[0]) + inner->prefix_;
+        }
+        *ref = std::move(child);
+      }
+      break;
+    }
+    case ArtNode::Type::NODE16:
+      RemoveSmallChild(static_cast<Node16 *>(node), byte);
+      if (node->num_children_ == ShrinkThreshold(Node4::CAPACITY)) {
+        *ref = ResizeSmall<Node16, Node4>(static_cast<Node16 *>(node));
+      }
+      break;
+    case ArtNode::Type::NODE48: {
+      auto *node48 = static_cast<Node48 *>(node);
+      node48->children_[node48->slots_[byte] - 1].reset();
+      node48->slots_[byte] = 0;
+      node48->num_children_--;
+      if (node48->num_children_ == ShrinkThreshold(Node16::CAPACITY)) {
+        *ref = ShrinkToNode16(node48);
+      }
+      break;
+    }
+    default:
+      static_cast<Node256 *>(node)->children_[byte].reset();
+      node->num_children_--;
+      if (node->num_children_ == ShrinkThreshold(Node48::CAPACITY)) {
+        *ref = ShrinkToNode48(static_cast<Node256 *>(node));
+      }
+      break;
+  }
+}
+
+// number of leading bytes of the node's prefix that the key has at depth
+size_t MatchPrefix(const InnerNode *node, const std::string &key, size_t depth) {
+  size_t matched = 0;
+  while (matched < node->prefix_.size() && depth + matched < key.size() &&
+         node->prefix_[matched] == key[depth + matched]) {
+    matched++;
+  }
+  return matched;
+}
+
+uint8_t KeyByte(const std::string &key, size_t depth) { return static_cast<uint8_t>(key[depth]); }
+
+bool InsertAt(NodePtr *ref, const std::string &key, const RID &rid) {
+  size_t depth = 0;
+  while (true) {
+    if (*ref == nullptr) {
+      *ref = NewLeaf(key, rid);
+      return true;
+    }
+    if ((*ref)->type_ == ArtNode::Type::LEAF) {
+      auto *leaf = static_cast<Leaf *>(ref->get());
+      if (leaf->key_ == key) {
+        auto position = std::lower_bound(leaf->rids_.begin(), leaf->rids_.end(), rid, RidLess);
+        if (position != leaf->rids_.end() && *position == rid) {
+          return false;
+        }
+        leaf->rids_.insert(position, rid);
+        return true;
+      }
+      // put a node over both leaves at the first byte where their keys differ; neither key is a prefix of the other
+      size_t common = depth;
+      while (common < key.size() && common < leaf->key_.size() && leaf->key_[common] == key[common]) {
+        common++;
+      }
+      BUSTUB_ASSERT(common < key.size() && common < leaf->key_.size(), "ART key is a prefix of another key");
+      auto node = std::make_unique<Node4>();
+      node->prefix_ = key.substr(depth, common - depth);
+      uint8_t leaf_byte = KeyByte(leaf->key_, common);
+      InsertSmallChild(node.get(), leaf_byte, std::move(*ref));
+      InsertSmallChild(node.get(), KeyByte(key, common), NewLeaf(key, rid));
+      *ref = std::move(node);
+      return true;
+    }
+
+    auto *node = static_cast<InnerNode *>(ref->get());
+    size_t matched = MatchPrefix(node, key, depth);
+    if (matched < node->prefix_.size()) {
+      // the key leaves the prefix part way: split the prefix with a new node above this one
+      auto parent = std::make_unique<Node4>();
+      parent->prefix_ = node->prefix_.substr(0, matched);
+      auto node_byte = static_cast<uint8_t>(node->prefix_[matched]);
+      node->prefix_.erase(0, matched + 1);
+      InsertSmallChild(parent.get(), node_byte, std::move(*ref));
+      InsertSmallChild(parent.get(), KeyByte(key, depth + matched), NewLeaf(key, rid));
+      *ref = std::move(parent);
+      return true;
+    }
+    depth += matched;
+    NodePtr *child = FindChild(node, KeyByte(key, depth));
+    if (child == nullptr) {
+      AddChild(ref, KeyByte(key, depth), NewLeaf(key, rid));
+      return true;
+    }
+    ref = child;
+    depth++;
+  }
+}
+
+bool RemoveAt(NodePtr *ref, const std::string &key, size_t depth, const RID &rid) {
+  if (*ref == nullptr) {
+    return false;
+  }
+  if ((*ref)->type_ == ArtNode::Type::LEAF) {
+    auto *leaf = static_cast<Leaf *>(ref->get());
+    if (leaf->key_ != key) {
+      return false;
+    }
+    auto position = std::lower_bound(leaf->rids_.begin(), leaf->rids_.end(), rid, RidLess);
+    if (position == leaf->rids_.end() || !(*position == rid)) {
+      return false;
+    }
+    leaf->rids_.erase(position);
+    if (leaf->rids_.empty()) {
+      ref->reset();
+    }
+    return true;
+  }
+
+  auto *node = static_cast<InnerNode *>(ref->get());
+  if (MatchPrefix(node, key, depth) < node->prefix_.size()) {
+    return false;
+  }
+  depth += node->prefix_.size();
+  if (depth >= key.size()) {
+    return false;
+  }
+  NodePtr *child = FindChild(node, KeyByte(key, depth));
+  if (child == nullptr || !RemoveAt(child, key, depth + 1, rid)) {
+    return false;
+  }
+  if (*child == nullptr) {
+    RemoveChild(ref, KeyByte(key, depth));
+  }
+  return true;
+}
+
+}  // namespace
+
+AdaptiveRadixTree::AdaptiveRadixTree() = default;
+
+AdaptiveRadixTree::~AdaptiveRadixTree() = default;
+
+bool AdaptiveRadixTree::Insert(const std::string &key, const RID &rid) {
+  latch_.WLock();
+  bool inserted = InsertAt(&root_, key, rid);
+  size_ += inserted ? 1 : 0;
+  latch_.WUnlock();
+  return inserted;
+}
+
+bool AdaptiveRadixTree::Remove(const std::string &key, const RID &rid) {
+  latch_.WLock();
+  bool removed = RemoveAt(&root_, key, 0, rid);
+  size_ -= removed ? 1 : 0;
+  latch_.WUnlock();
+  return removed;
+}
+
+bool AdaptiveRadixTree::GetValue(const std::string &key, std::vector<RID> *result) {
+  latch_.RLock();
+  ArtNode *node = root_.get();
+  size_t depth = 0;
+  while (node != nullptr && node->type_ != ArtNode::Type::LEAF) {
+    auto *inner = static_cast<InnerNode *>(node);
+    if (MatchPrefix(inner, key, depth) < inner->prefix_.size()) {
+      node = nullptr;
+      break;
+    }
+    depth += inner->prefix_.size();
+    if (depth >= key.size()) {
+      node = nullptr;
+      break;
+    }
+    NodePtr *child = FindChild(inner, KeyByte(key, depth++));
+    node = child == nullptr ? nullptr : child->get();
+  }
+  bool found = false;
+  if (node != nullptr && static_cast<const Leaf *>(node)->key_ == key) {
+    const auto &rids = static_cast<const Leaf *>(node)->rids_;
+    result->insert(result->end(), rids.begin(), rids.end());
+    found = true;
+  }
+  latch_.RUnlock();
+  return found;
+}
+
+void AdaptiveRadixTree::Clear() {
+  latch_.WLock();
+  root_.reset();
+  size_ = 0;
+  latch_.WUnlock();
+}
+
+size_t AdaptiveRadixTree::GetSize() {
+  latch_.RLock();
+  size_t size = size_;
+  latch_.RUnlock();
+  return size;
+}
+
+}  // namespace bustub
@@ -0,0 +1,38 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// adaptive_radix_tree_index.cpp
+//
+// Identification: src/storage/index/adaptive_radix_tree_index.cpp
+//
+// Copyright (c) 2015-2021, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "storage/index/adaptive_radix_tree_index.h"
+
+namespace bustub {
+
+AdaptiveRadixTreeIndex::AdaptiveRadixTreeIndex(std::unique_ptr<IndexMetadata> &&metadata)
+    : Index(std::move(metadata)), encoder_(GetMetadata()->GetKeySchema()) {}
+
+void AdaptiveRadixTreeIndex::InsertEntry(const Tuple &key, RID rid, Transaction *transaction) {
+  container_.Insert(encoder_.Encode(key), rid);
+}
+
+void AdaptiveRadixTreeIndex::DeleteEntry(const Tuple &key, RID rid, Transaction *transaction) {
+  container_.Remove(encoder_.Encode(key), rid);
+}
+
+void AdaptiveRadixTreeIndex::ScanKey(const Tuple &key, std::vector<RID> *result, Transaction *transaction) {
+  container_.GetValue(encoder_.Encode(key), result);
+}
+
+void AdaptiveRadixTreeIndex::BuildFromTable(TableHeap *table_heap, const Schema &table_schema,
+                                            Transaction *transaction) {
+  container_.Clear();
+  Index::BuildFromTable(table_heap, table_schema, transaction);
+}
+
+}  // namespace bustub
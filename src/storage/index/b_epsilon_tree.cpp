@@ -0,0 +1,307 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// b_epsilon_tree.cpp
+//
+// Identification: src/storage/index/b_epsilon_tree.cpp
+//
+// Copyright (c) 2015-2021, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "storage/index/b_epsilon_tree.h"
+
+#include <algorithm>
+#include <utility>
+
+#include "common/exception.h"
+#include "storage/index/generic_key.h"
+#include "storage/page/header_page.h"
+
+namespace bustub {
+
+INDEX_TEMPLATE_ARGUMENTS
+BEPSILONTREE_TYPE::BEpsilonTree(std::string name, BufferPoolManager *buffer_pool_manager,
+                                const KeyComparator &comparator, int leaf_max_size, int fanout, int buffer_max_size)
+    : index_name_(std::move(name)),
+      root_page_id_(INVALID_PAGE_ID),
+      buffer_pool_manager_(buffer_pool_manager),
+      comparator_(comparator),
+      leaf_max_size_(std::clamp<int>(leaf_max_size, 2, B_EPSILON_LEAF_PAGE_SIZE)),
+      fanout_(std::clamp<int>(fanout, 3, B_EPSILON_MAX_FANOUT)),
+      buffer_max_size_(std::clamp<int>(buffer_max_size, 1, B_EPSILON_MESSAGE_CAPACITY)) {}
+
+INDEX_TEMPLATE_ARGUMENTS
+void BEPSILONTREE_TYPE::Insert(const KeyType &key, const ValueType &value) {
+  Upsert(Message{key, value, BEpsilonOp::INSERT});
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+void BEPSILONTREE_TYPE::Remove(const KeyType &key, const ValueType &value) {
+  Upsert(Message{key, value, BEpsilonOp::DELETE});
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+void BEPSILONTREE_TYPE::Upsert(const Message &message) {
+  latch_.WLock();
+  if (IsEmpty()) {
+    if (message.op_ == BEpsilonOp::INSERT) {
+      Page *page = NewPage(&root_page_id_);
+      auto *leaf = reinterpret_cast<LeafPage *>(page->GetData());
+      leaf->Init(root_page_id_, leaf_max_size_);
+      leaf->Apply(message, comparator_);
+      buffer_pool_manager_->UnpinPage(root_page_id_, true);
+      UpdateRootPageId(1);
+    }
+    latch_.WUnlock();
+    return;
+  }
+
+  Page *page = FetchPage(root_page_id_);
+  if (reinterpret_cast<BPlusTreePage *>(page->GetData())->IsLeafPage()) {
+    // a single leaf takes updates directly, until it splits
+    auto *leaf = reinterpret_cast<LeafPage *>(page->GetData());
+    leaf->Apply(message, comparator_);
+    if (leaf->GetSize() >= leaf_max_size_) {
+      page_id_t right_page_id;
+      Page *right_page = NewPage(&right_page_id);
+      auto *right = reinterpret_cast<LeafPage *>(right_page->GetData());
+      right->Init(right_page_id, leaf_max_size_);
+      leaf->MoveHalfTo(right);
+      GrowRoot(leaf->GetPageId(), MappingType(right->KeyAt(0), right->ValueAt(0)), right_page_id);
+      buffer_pool_manager_->UnpinPage(right_page_id, true);
+    }
+    buffer_pool_manager_->UnpinPage(page->GetPageId(), true);
+    latch_.WUnlock();
+    return;
+  }
+
+  auto *root = reinterpret_cast<InternalPage *>(page->GetData());
+  while (root->IsBufferFull()) {
+    FlushStep(root);
+    if (root->IsOverflowing()) {
+      page_id_t right_page_id;
+      Page *right_page = NewPage(&right_page_id);
+      auto *right = reinterpret_cast<InternalPage *>(right_page->GetData());
+      right->Init(right_page_id, fanout_, buffer_max_size_);
+      root->MoveHalfTo(right, comparator_);
+      GrowRoot(root->GetPageId(), right->PivotAt(0), right_page_id);
+      buffer_pool_manager_->UnpinPage(right_page_id, true);
+      buffer_pool_manager_->UnpinPage(page->GetPageId(), true);
+      // the new root starts out with an empty buffer
+      page = FetchPage(root_page_id_);
+      root = reinterpret_cast<InternalPage *>(page->GetData());
+    }
+  }
+  root->AddMessage(message, comparator_);
+  buffer_pool_manager_->UnpinPage(page->GetPageId(), true);
+  latch_.WUnlock();
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+void BEPSILONTREE_TYPE::FlushStep(InternalPage *node) {
+  int child_index = 0;
+  std::pair<int, int> messages{0, 0};
+  for (int i = 0; i < node->GetSize(); i++) {
+    auto range = node->MessageRange(i, comparator_);
+    if (range.second - range.first > messages.second - messages.first) {
+      child_index = i;
+      messages = range;
+    }
+  }
+
+  Page *child_page = FetchPage(node->ChildAt(child_index));
+  if (reinterpret_cast<BPlusTreePage *>(child_page->GetData())->IsLeafPage()) {
+    // with at most half a leaf of messages, the leaf splits at most once, and neither half fills up again
+    auto *leaf = reinterpret_cast<LeafPage *>(child_page->GetData());
+    int count = std::min(messages.second - messages.first, leaf_max_size_ / 2);
+    Page *right_page = nullptr;
+    LeafPage *right = nullptr;
+    MappingType separator;
+    for (int i = messages.first; i < messages.first + count; i++) {
+      const Message &message = node->MessageAt(i);
+      bool to_right = right != nullptr && CompareEntries(message.key_, message.value_, separator.first,
+                                                         separator.second, comparator_) >= 0;
+      (to_right ? right : leaf)->Apply(message, comparator_);
+      if (right == nullptr && leaf->GetSize() >= leaf_max_size_) {
+        page_id_t right_page_id;
+        right_page = NewPage(&right_page_id);
+        right = reinterpret_cast<LeafPage *>(right_page->GetData());
+        right->Init(right_page_id, leaf_max_size_);
+        leaf->MoveHalfTo(right);
+        separator = MappingType(right->KeyAt(0), right->ValueAt(0));
+        node->InsertChildAfter(child_index, separator, right_page_id);
+      }
+    }
+    node->RemoveMessages(messages.first, count);
+    if (right_page != nullptr) {
+      buffer_pool_manager_->UnpinPage(right_page->GetPageId(), true);
+    }
+  } else {
+    auto *child = reinterpret_cast<InternalPage *>(child_page->GetData());
+    if (child->IsBufferFull()) {
+      // make room in the child first; this moves nothing out of node
+      FlushStep(child);
+      if (child->IsOverflowing()) {
+        SplitChild(node, child_index, child);
+      }
+    } else {
+      int count = std::min(messages.second - messages.first, child->GetFreeMessages());
+      for (int i = messages.first; i < messages.first + count; i++) {
+        child->AddMessage(node->MessageAt(i), comparator_);
+      }
+      node->RemoveMessages(messages.first, count);
+    }
+  }
+  buffer_pool_manager_->UnpinPage(child_page->GetPageId(), true);
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+void BEPSILONTREE_TYPE::SplitChild(InternalPage *parent, int child_index, InternalPage *node) {
+  page_id_t right_page_id;
+  Page *right_page = NewPage(&right_page_id);
+  auto *right = reinterpret_cast<InternalPage *>(right_page->GetData());
+  right->Init(right_page_id, fanout_, buffer_max_size_);
+  node->MoveHalfTo(right, comparator_);
+  parent->InsertChildAfter(child_index, right->PivotAt(0), right_page_id);
+  buffer_pool_manager_->UnpinPage(right_page_id, true);
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+void BEPSILONTREE_TYPE::GrowRoot(page_id_t left, const MappingType &separator, page_id_t right) {
+  page_id_t root_page_id;
+  Page *page = NewPage(&root_page_id);
+  auto *root = reinterpret_cast<InternalPage *>(page->GetData());
+  root->Init(root_page_id, fanout_, buffer_max_size_);
+  root->PopulateNewRoot(left, separator, right);
+  buffer_pool_manager_->UnpinPage(root_page_id, true);
+  root_page_id_ = root_page_id;
+  UpdateRootPageId(0);
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+bool BEPSILONTREE_TYPE::GetValue(const KeyType &key, std::vector<ValueType> *result) {
+  latch_.RLock();
+  size_t size = result->size();
+  if (!IsEmpty()) {
+    std::unordered_set<int64_t> decided;
+    CollectValues(root_page_id_, key, &decided, result);
+  }
+  latch_.RUnlock();
+  std::sort(result->begin() + size, result->end(),
+            [](const ValueType &lhs, const ValueType &rhs) { return lhs.Get() < rhs.Get(); });
+  return result->size() > size;
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+void BEPSILONTREE_TYPE::CollectValues(page_id_t page_id, const KeyType &key, std::unordered_set<int64_t> *decided,
+                                      std::vector<ValueType> *result) {
+  Page *page = FetchPage(page_id);
+  if (reinterpret_cast<BPlusTreePage *>(page->GetData())->IsLeafPage()) {
+    auto *leaf = reinterpret_cast<LeafPage *>(page->GetData());
+    for (int i = leaf->KeyIndex(key, comparator_); i < leaf->GetSize() && comparator_(leaf->KeyAt(i), key) == 0;
+         i++) {
+      if (decided->count(leaf->ValueAt(i).Get()) == 0) {
+        result->push_back(leaf->ValueAt(i));
+      }
+    }
+    buffer_pool_manager_->UnpinPage(page_id, false);
+    return;
+  }
+
+  // messages higher up are newer, so the first one seen on an entry wins
+  auto *node = reinterpret_cast<InternalPage *>(page->GetData());
+  for (int i = node->MessageKeyIndex(key, comparator_);
+       i < node->GetNumMessages() && comparator_(node->MessageAt(i).key_, key) == 0; i++) {
+    const Message &message = node->MessageAt(i);
+    if (decided->insert(message.value_.Get()).second && message.op_ == BEpsilonOp::INSERT) {
+      result->push_back(message.value_);
+    }
+  }
+  auto children = node->ChildRange(key, comparator_);
+  std::vector<page_id_t> child_page_ids;
+  for (int i = children.first; i <= children.second; i++) {
+    child_page_ids.push_back(node->ChildAt(i));
+  }
+  buffer_pool_manager_->UnpinPage(page_id, false);
+  for (page_id_t child_page_id : child_page_ids) {
+    CollectValues(child_page_id, key, decided, result);
+  }
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+size_t BEPSILONTREE_TYPE::GetNumPages() {
+  latch_.RLock();
+  size_t num_pages = IsEmpty() ? 0 : CountPages(root_page_id_);
+  latch_.RUnlock();
+  return num_pages;
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+size_t BEPSILONTREE_TYPE::CountPages(page_id_t page_id) {
+  Page *page = FetchPage(page_id);
+  std::vector<page_id_t> child_page_ids;
+  if (!reinterpret_cast<BPlusTreePage *>(page->GetData())->IsLeafPage()) {
+    auto *node = reinterpret_cast<InternalPage *>(page->GetData());
+    for (int i = 0; i < node->GetSize(); i++) {
+      child_page_ids.push_back(node->ChildAt(i));
+    }
+  }
+  buffer_pool_manager_->UnpinPage(page_id, false);
+  size_t num_pages = 1;
+  for (page_id_t child_page_id : child_page_ids) {
+    num_pages += CountPages(child_page_id);
+  }
+  return num_pages;
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+Page *BEPSILONTREE_TYPE::FetchPage(page_id_t page_id) {
+  Page *page = buffer_pool_manager_->FetchPage(page_id);
+  if (page == nullptr) {
+    throw Exception(ExceptionType::OUT_OF_MEMORY, "Cannot fetch B-epsilon tree page");
+  }
+  return page;
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+Page *BEPSILONTREE_TYPE::NewPage(page_id_t *page_id) {
+  Page *page = buffer_pool_manager_->NewPage(page_id);
+  if (page == nullptr) {
+    throw Exception(ExceptionType::OUT_OF_MEMORY, "Cannot allocate B-epsilon tree page");
+  }
+  return page;
+}
+
+/*
+ * Update/Insert root page id in header page, like BPlusTree::UpdateRootPageId. Callers hold the tree latch.
+ */
+INDEX_TEMPLATE_ARGUMENTS
+void BEPSILONTREE_TYPE::UpdateRootPageId(int insert_record) {
+  if (header_record_.GetPageId() != INVALID_PAGE_ID &&
+      HeaderPage::UpdateRecordAt(buffer_pool_manager_, header_record_, index_name_, root_page_id_)) {
+    return;
+  }
+  auto *header_page = static_cast<HeaderPage *>(FetchPage(HEADER_PAGE_ID));
+  if (insert_record != 0) {
+    header_page->WLatch();
+    if (!header_page->InsertRecord(buffer_pool_manager_, index_name_, root_page_id_, &header_record_)) {
+      header_page->UpdateRecord(buffer_pool_manager_, index_name_, root_page_id_, &header_record_);
+    }
+    header_page->WUnlatch();
+  } else {
+    header_page->RLatch();
+    header_page->UpdateRecord(buffer_pool_manager_, index_name_, root_page_id_, &header_record_);
+    header_page->RUnlatch();
+  }
+  buffer_pool_manager_->UnpinPage(HEADER_PAGE_ID, insert_record != 0);
+}
+
+template class BEpsilonTree<GenericKey<4>, RID, GenericComparator<4>>;
+template class BEpsilonTree<GenericKey<8>, RID, GenericComparator<8>>;
+template class BEpsilonTree<GenericKey<16>, RID, GenericComparator<16>>;
+template class BEpsilonTree<GenericKey<32>, RID, GenericComparator<32>>;
+template class BEpsilonTree<GenericKey<64>, RID, GenericComparator<64>>;
+
+}  // namespace bustub
@@ -9,7 +9,10 @@
 //
 //===----------------------------------------------------------------------===//
 
+#include <algorithm>
 #include <string>
+#include <type_traits>
+#include <utility>
 
 #include "common/exception.h"
 #include "common/rid.h"
@@ -19,30 +22,126 @@
 namespace bustub {
 INDEX_TEMPLATE_ARGUMENTS
 BPLUSTREE_TYPE::BPlusTree(std::string name, BufferPoolManager *buffer_pool_manager, const KeyComparator &comparator,
-                          int leaf_max_size, int internal_max_size)
+                          int leaf_max_size, int internal_max_size, bool unique_keys)
     : index_name_(std::move(name)),
       root_page_id_(INVALID_PAGE_ID),
       buffer_pool_manager_(buffer_pool_manager),
       comparator_(comparator),
       leaf_max_size_(leaf_max_size),
-      internal_max_size_(internal_max_size) {}
+      // an internal page briefly holds max_size + 1 entries before it splits, so leave room for one more
+      internal_max_size_(std::min<int>(internal_max_size, INTERNAL_PAGE_SIZE - 1)),
+      unique_keys_(unique_keys) {}
+
+INDEX_TEMPLATE_ARGUMENTS
+BPLUSTREE_TYPE::~BPlusTree() { StopMergeThread(); }
 
 /*
  * Helper function to decide whether current b+tree is empty
  */
 INDEX_TEMPLATE_ARGUMENTS
-bool BPLUSTREE_TYPE::IsEmpty() const { return true; }
+bool BPLUSTREE_TYPE::IsEmpty() const { return root_page_id_ == INVALID_PAGE_ID; }
 /*****************************************************************************
  * SEARCH
  *****************************************************************************/
 /*
- * Return the only value that associated with input key
+ * Return the values associated with input key, in ascending order if there
+ * are several
  * This method is used for point query
  * @return : true means key exists
  */
 INDEX_TEMPLATE_ARGUMENTS
 bool BPLUSTREE_TYPE::GetValue(const KeyType &key, std::vector<ValueType> *result, Transaction *transaction) {
-  return false;
+  ValueType value;
+  bool found;
+  for (int attempt = 0; attempt < OPTIMISTIC_READ_ATTEMPTS; attempt++) {
+    if (GetValueOptimistic(key, &value, &found)) {
+      if (!found || unique_keys_ || !PostingList::IsReference(value)) {
+        if (found) {
+          result->push_back(value);
+        }
+        return found;
+      }
+      // a posting list can only be read under the latch of the leaf referencing it
+      break;
+    }
+  }
+
+  // Too much write contention on the path; fall back to read-latch crabbing, which always makes progress.
+  Page *page = FindLeafPageLatched(key, false, false);
+  if (page == nullptr) {
+    return false;
+  }
+  auto *leaf = reinterpret_cast<LeafPage *>(page->GetData());
+  found = leaf->Lookup(key, &value, comparator_);
+  if (found && !unique_keys_ && PostingList::IsReference(value)) {
+    try {
+      PostingList::Read(buffer_pool_manager_, value, result);
+    } catch (const Exception &e) {
+      page->RUnlatch();
+      buffer_pool_manager_->UnpinPage(page->GetPageId(), false);
+      throw;
+    }
+  } else if (found) {
+    result->push_back(value);
+  }
+  page->RUnlatch();
+  buffer_pool_manager_->UnpinPage(page->GetPageId(), false);
+  return found;
+}
+
+/*
+ * Latch-free point lookup (optimistic lock coupling). Every page on the path is
+ * pinned but never latched; its version is read before and validated after
+ * using anything read from it. A child page id is only followed once the parent
+ * is validated, and the parent is validated again after the child's version
+ * has been read, so the child cannot have been unlinked in between.
+ * @return : false if a concurrent writer got in the way and the lookup must be
+ * retried, otherwise true with the outcome in "found"/"value".
+ */
+INDEX_TEMPLATE_ARGUMENTS
+bool BPLUSTREE_TYPE::GetValueOptimistic(const KeyType &key, ValueType *value, bool *found) {
+  page_id_t page_id = root_page_id_.load();
+  if (page_id == INVALID_PAGE_ID) {
+    *found = false;
+    return true;
+  }
+  Page *page = FetchPage(page_id);
+  auto *node = reinterpret_cast<BPlusTreePage *>(page->GetData());
+  uint64_t version = node->ReadVersion();
+  // Page ids are never reused, so if the root id is unchanged after reading the version, this page was the root then.
+  if ((version & 1) != 0 || root_page_id_.load() != page_id) {
+    buffer_pool_manager_->UnpinPage(page_id, false);
+    return false;
+  }
+
+  while (!node->IsLeafPage()) {
+    page_id_t child_page_id = reinterpret_cast<InternalPage *>(node)->Lookup(key, comparator_);
+    if (!node->ValidateVersion(version)) {
+      buffer_pool_manager_->UnpinPage(page_id, false);
+      return false;
+    }
+    Page *child_page = buffer_pool_manager_->FetchPage(child_page_id);
+    if (child_page == nullptr) {
+      buffer_pool_manager_->UnpinPage(page_id, false);
+      throw Exception(ExceptionType::OUT_OF_MEMORY, "Cannot fetch B+ tree page");
+    }
+    auto *child = reinterpret_cast<BPlusTreePage *>(child_page->GetData());
+    uint64_t child_version = child->ReadVersion();
+    bool valid = (child_version & 1) == 0 && node->ValidateVersion(version);
+    buffer_pool_manager_->UnpinPage(page_id, false);
+    if (!valid) {
+      buffer_pool_manager_->UnpinPage(child_page_id, false);
+      return false;
+    }
+    page_id = child_page_id;
+    node = child;
+    version = child_version;
+  }
+
+  *found = reinterpret_cast<LeafPage *>(node)->Lookup(key, value, comparator_);
+  bool valid = node->ValidateVersion(version);
+  buffer_pool_manager_->UnpinPage(page_id, false);
+  return valid;
 }
 
 /*****************************************************************************
@@ -52,11 +151,61 @@ bool BPLUSTREE_TYPE::GetValue(const KeyType &key, std::vector<ValueType> *result
  * Insert constant key & value pair into b+ tree
  * if current tree is empty, start new tree, update root page id and insert
  * entry, otherwise insert into leaf page.
- * @return: since we only support unique key, if user try to insert duplicate
- * keys return false, otherwise return true.
+ * @return: in a unique tree, if user try to insert duplicate keys return
+ * false; in a non-unique one, return false only if the key already has this
+ * value. Otherwise return true.
  */
 INDEX_TEMPLATE_ARGUMENTS
-bool BPLUSTREE_TYPE::Insert(const KeyType &key, const ValueType &value, Transaction *transaction) { return false; }
+bool BPLUSTREE_TYPE::Insert(const KeyType &key, const ValueType &value, Transaction *transaction) {
+  // Optimistic pass: finish in the leaf if it does not have to split. A duplicate key never grows the leaf.
+  Page *page = FindLeafPageLatched(key, false, true);
+  if (page != nullptr) {
+    auto *leaf = reinterpret_cast<LeafPage *>(page->GetData());
+    int index = leaf->KeyIndex(key, comparator_);
+    bool duplicate = index < leaf->GetSize() && comparator_(leaf->KeyAt(index), key) == 0;
+    bool safe = IsSafe(leaf, Operation::INSERT);
+    bool inserted = false;
+    if (duplicate) {
+      try {
+        inserted = !unique_keys_ && InsertDuplicate(leaf, index, value);
+      } catch (const Exception &e) {
+        // the leaf only changes once the posting list is written
+        WUnlatchNode(page, false);
+        buffer_pool_manager_->UnpinPage(page->GetPageId(), false);
+        throw;
+      }
+    } else if (safe) {
+      leaf->Insert(key, value, comparator_);
+      inserted = true;
+    }
+    WUnlatchNode(page, inserted);
+    buffer_pool_manager_->UnpinPage(page->GetPageId(), inserted);
+    if (duplicate || safe) {
+      return inserted;
+    }
+  }
+
+  // Pessimistic pass.
+  Transaction local_transaction(INVALID_TXN_ID);
+  if (transaction == nullptr) {
+    transaction = &local_transaction;
+  }
+  root_latch_.WLock();
+  transaction->AddIntoPageSet(nullptr);
+  bool inserted = true;
+  try {
+    if (IsEmpty()) {
+      StartNewTree(key, value);
+    } else {
+      inserted = InsertIntoLeaf(key, value, transaction);
+    }
+  } catch (const Exception &e) {
+    AbortLatchedPages(transaction);
+    throw;
+  }
+  ReleaseLatchedPages(transaction, true);
+  return inserted;
+}
 /*
  * Insert constant key & value pair into an empty tree
  * User needs to first ask for new page from buffer pool manager(NOTICE: throw
@@ -64,19 +213,78 @@ bool BPLUSTREE_TYPE::Insert(const KeyType &key, const ValueType &value, Transact
  * tree's root page id and insert entry directly into leaf page.
  */
 INDEX_TEMPLATE_ARGUMENTS
-void BPLUSTREE_TYPE::StartNewTree(const KeyType &key, const ValueType &value) {}
+void BPLUSTREE_TYPE::StartNewTree(const KeyType &key, const ValueType &value) {
+  page_id_t root_page_id;
+  Page *page = buffer_pool_manager_->NewPage(&root_page_id);
+  if (page == nullptr) {
+    throw Exception(ExceptionType::OUT_OF_MEMORY, "Cannot allocate new B+ tree root page");
+  }
+  auto *root = reinterpret_cast<LeafPage *>(page->GetData());
+  root->Init(root_page_id, INVALID_PAGE_ID, leaf_max_size_);
+  root->Insert(key, value, comparator_);
+  root_page_id_ = root_page_id;
+  try {
+    UpdateRootPageId(1);
+  } catch (const Exception &e) {
+    root_page_id_ = INVALID_PAGE_ID;
+    buffer_pool_manager_->UnpinPage(root_page_id, false);
+    buffer_pool_manager_->DeletePage(root_page_id);
+    throw;
+  }
+  buffer_pool_manager_->UnpinPage(root_page_id, true);
+}
 
 /*
  * Insert constant key & value pair into leaf page
  * User needs to first find the right leaf page as insertion target, then look
  * through leaf page to see whether insert key exist or not. If exist, return
  * immdiately, otherwise insert entry. Remember to deal with split if necessary.
- * @return: since we only support unique key, if user try to insert duplicate
- * keys return false, otherwise return true.
+ * @return: same as Insert
  */
 INDEX_TEMPLATE_ARGUMENTS
 bool BPLUSTREE_TYPE::InsertIntoLeaf(const KeyType &key, const ValueType &value, Transaction *transaction) {
-  return false;
+  Page *page = FindLeafPagePessimistic(key, Operation::INSERT, transaction);
+  auto *leaf = reinterpret_cast<LeafPage *>(page->GetData());
+  // the key may have been inserted since the optimistic pass
+  int index = leaf->KeyIndex(key, comparator_);
+  if (index < leaf->GetSize() && comparator_(leaf->KeyAt(index), key) == 0) {
+    return !unique_keys_ && InsertDuplicate(leaf, index, value);
+  }
+
+  if (leaf->Insert(key, value, comparator_) >= leaf->GetMaxSize()) {
+    LeafPage *new_leaf = Split(leaf);
+    try {
+      InsertIntoParent(leaf, new_leaf->KeyAt(0), new_leaf, transaction);
+    } catch (const Exception &e) {
+      buffer_pool_manager_->UnpinPage(new_leaf->GetPageId(), true);
+      throw;
+    }
+    buffer_pool_manager_->UnpinPage(new_leaf->GetPageId(), true);
+  }
+  return true;
+}
+
+/*
+ * Add a value to a key that is already in the leaf. Its second value turns
+ * the inline value into a posting list; later ones go into that list. The
+ * leaf keeps its size either way.
+ * @return: false if the key already has this value
+ */
+INDEX_TEMPLATE_ARGUMENTS
+bool BPLUSTREE_TYPE::InsertDuplicate(LeafPage *leaf, int index, const ValueType &value) {
+  ValueType existing = leaf->ValueAt(index);
+  if (PostingList::IsReference(existing)) {
+    return PostingList::Insert(buffer_pool_manager_, existing, value);
+  }
+  if (existing == value) {
+    return false;
+  }
+  std::vector<RID> rids{existing, value};
+  if (value.Get() < existing.Get()) {
+    std::swap(rids[0], rids[1]);
+  }
+  leaf->SetValueAt(index, PostingList::Create(buffer_pool_manager_, rids));
+  return true;
 }
 
 /*
@@ -89,7 +297,22 @@ bool BPLUSTREE_TYPE::InsertIntoLeaf(const KeyType &key, const ValueType &value,
 INDEX_TEMPLATE_ARGUMENTS
 template <typename N>
 N *BPLUSTREE_TYPE::Split(N *node) {
-  return nullptr;
+  page_id_t new_page_id;
+  Page *page = buffer_pool_manager_->NewPage(&new_page_id);
+  if (page == nullptr) {
+    throw Exception(ExceptionType::OUT_OF_MEMORY, "Cannot allocate new B+ tree page for split");
+  }
+  // The new page is only reachable through pages we hold write latches on, so it needs no latch of its own.
+  auto *new_node = reinterpret_cast<N *>(page->GetData());
+  new_node->Init(new_page_id, node->GetParentPageId(), node->GetMaxSize());
+  if constexpr (std::is_same_v<N, LeafPage>) {
+    node->MoveHalfTo(new_node);
+    new_node->SetNextPageId(node->GetNextPageId());
+    node->SetNextPageId(new_page_id);
+  } else {
+    node->MoveHalfTo(new_node, buffer_pool_manager_);
+  }
+  return new_node;
 }
 
 /*
@@ -103,7 +326,205 @@ N *BPLUSTREE_TYPE::Split(N *node) {
  */
 INDEX_TEMPLATE_ARGUMENTS
 void BPLUSTREE_TYPE::InsertIntoParent(BPlusTreePage *old_node, const KeyType &key, BPlusTreePage *new_node,
-                                      Transaction *transaction) {}
+                                      Transaction *transaction) {
+  if (old_node->IsRootPage()) {
+    // The root was unsafe, so root_latch_ is still held.
+    page_id_t root_page_id;
+    Page *page = buffer_pool_manager_->NewPage(&root_page_id);
+    if (page == nullptr) {
+      throw Exception(ExceptionType::OUT_OF_MEMORY, "Cannot allocate new B+ tree root page");
+    }
+    auto *root = reinterpret_cast<InternalPage *>(page->GetData());
+    root->Init(root_page_id, INVALID_PAGE_ID, internal_max_size_);
+    root->PopulateNewRoot(old_node->GetPageId(), key, new_node->GetPageId());
+    old_node->SetParentPageId(root_page_id);
+    new_node->SetParentPageId(root_page_id);
+    root_page_id_ = root_page_id;
+    try {
+      UpdateRootPageId(0);
+    } catch (const Exception &e) {
+      buffer_pool_manager_->UnpinPage(root_page_id, true);
+      throw;
+    }
+    buffer_pool_manager_->UnpinPage(root_page_id, true);
+    return;
+  }
+
+  // The parent was unsafe as well, so it is already write-latched in the page set; this only pins it again.
+  page_id_t parent_page_id = old_node->GetParentPageId();
+  auto *parent = reinterpret_cast<InternalPage *>(FetchPage(parent_page_id)->GetData());
+  new_node->SetParentPageId(parent_page_id);
+  try {
+    if (parent->InsertNodeAfter(old_node->GetPageId(), key, new_node->GetPageId()) > parent->GetMaxSize()) {
+      InternalPage *new_parent = Split(parent);
+      try {
+        InsertIntoParent(parent, new_parent->KeyAt(0), new_parent, transaction);
+      } catch (const Exception &e) {
+        buffer_pool_manager_->UnpinPage(new_parent->GetPageId(), true);
+        throw;
+      }
+      buffer_pool_manager_->UnpinPage(new_parent->GetPageId(), true);
+    }
+  } catch (const Exception &e) {
+    buffer_pool_manager_->UnpinPage(parent_page_id, true);
+    throw;
+  }
+  buffer_pool_manager_->UnpinPage(parent_page_id, true);
+}
+
+/*****************************************************************************
+ * BULK LOAD
+ *****************************************************************************/
+/*
+ * Split num_entries entries into pages of about "fill" entries. If that leaves less than min_size per page, use fewer,
+ * fuller pages instead; with fill <= max size this never overfills a page. Entries are spread evenly, so the pages
+ * of a level differ in size by at most one.
+ */
+INDEX_TEMPLATE_ARGUMENTS
+size_t BPLUSTREE_TYPE::BulkLoadPages(size_t num_entries, int fill, int min_size) {
+  size_t num_pages = (num_entries + fill - 1) / fill;
+  if (num_pages > 1 && num_entries / num_pages < static_cast<size_t>(min_size)) {
+    num_pages = std::max<size_t>(1, num_entries / min_size);
+  }
+  return num_pages;
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+bool BPLUSTREE_TYPE::BeginBulkLoad(BulkLoadState *state, size_t num_entries, double fill_factor) {
+  root_latch_.WLock();
+  if (!IsEmpty()) {
+    root_latch_.WUnlock();
+    return false;
+  }
+
+  // A leaf splits once it reaches max size, so it holds at most max - 1 entries; an internal page holds max.
+  int leaf_capacity = leaf_max_size_ - 1;
+  int leaf_min = std::max(1, leaf_max_size_ / 2);
+  int leaf_fill = std::clamp(static_cast<int>(leaf_capacity * fill_factor), leaf_min, leaf_capacity);
+  int internal_min = std::max(2, (internal_max_size_ + 1) / 2);
+  int internal_fill = std::clamp(static_cast<int>(internal_max_size_ * fill_factor), internal_min, internal_max_size_);
+
+  state->levels_.clear();
+  if (num_entries == 0) {
+    return true;
+  }
+  size_t num_pages = BulkLoadPages(num_entries, leaf_fill, leaf_min);
+  state->levels_.push_back({num_pages, num_entries});
+  while (num_pages > 1) {
+    size_t num_children = num_pages;
+    num_pages = BulkLoadPages(num_children, internal_fill, internal_min);
+    state->levels_.push_back({num_pages, num_children});
+  }
+  return true;
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+void BPLUSTREE_TYPE::AppendBulkLoad(BulkLoadState *state, const KeyType &key, const ValueType &value) {
+  if (state->levels_.empty() || state->num_appended_ == state->levels_[0].num_entries_) {
+    AbortBulkLoad(state, ExceptionType::OUT_OF_RANGE, "Bulk load input has more entries than announced");
+  }
+  if (state->num_appended_ > 0 && comparator_(state->last_key_, key) >= 0) {
+    AbortBulkLoad(state, ExceptionType::INVALID, "Bulk load input is not sorted by strictly increasing key");
+  }
+
+  auto &leaves = state->levels_[0];
+  if (leaves.page_ == nullptr ||
+      reinterpret_cast<LeafPage *>(leaves.page_->GetData())->GetSize() == leaves.target_size_) {
+    StartBulkLoadPage(state, 0, key);
+  }
+  reinterpret_cast<LeafPage *>(leaves.page_->GetData())->Append(key, value);
+  state->last_key_ = key;
+  state->num_appended_++;
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+void BPLUSTREE_TYPE::FinishBulkLoad(BulkLoadState *state) {
+  if (state->levels_.empty()) {
+    root_latch_.WUnlock();
+    return;
+  }
+  if (state->num_appended_ != state->levels_[0].num_entries_) {
+    AbortBulkLoad(state, ExceptionType::OUT_OF_RANGE, "Bulk load input has fewer entries than announced");
+  }
+
+  page_id_t root_page_id = state->levels_.back().page_->GetPageId();
+  for (auto &level : state->levels_) {
+    buffer_pool_manager_->UnpinPage(level.page_->GetPageId(), true);
+    level.page_ = nullptr;
+  }
+  // Nothing could see the new pages before this point: root_latch_ keeps writers out, and readers see no root.
+  root_page_id_ = root_page_id;
+  try {
+    UpdateRootPageId(1);
+  } catch (const Exception &e) {
+    root_latch_.WUnlock();
+    throw;
+  }
+  root_latch_.WUnlock();
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+void BPLUSTREE_TYPE::AbortBulkLoad(BulkLoadState *state, ExceptionType type, const std::string &message) {
+  for (auto &level : state->levels_) {
+    if (level.page_ != nullptr) {
+      buffer_pool_manager_->UnpinPage(level.page_->GetPageId(), true);
+      level.page_ = nullptr;
+    }
+  }
+  state->levels_.clear();
+  root_latch_.WUnlock();
+  throw Exception(type, message);
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+Page *BPLUSTREE_TYPE::StartBulkLoadPage(BulkLoadState *state, size_t level, const KeyType &key) {
+  page_id_t page_id;
+  Page *page = buffer_pool_manager_->NewPage(&page_id);
+  if (page == nullptr) {
+    AbortBulkLoad(state, ExceptionType::OUT_OF_MEMORY, "Cannot allocate new B+ tree page for bulk load");
+  }
+  // the parent gets the new page's first key as its separator, exactly as if the page had been split off
+  page_id_t parent_page_id = INVALID_PAGE_ID;
+  if (level + 1 < state->levels_.size()) {
+    try {
+      parent_page_id = AppendBulkLoadChild(state, level + 1, key, page_id);
+    } catch (const Exception &e) {
+      buffer_pool_manager_->UnpinPage(page_id, false);
+      throw;
+    }
+  }
+
+  auto &current = state->levels_[level];
+  if (level == 0) {
+    reinterpret_cast<LeafPage *>(page->GetData())->Init(page_id, parent_page_id, leaf_max_size_);
+    if (current.page_ != nullptr) {
+      reinterpret_cast<LeafPage *>(current.page_->GetData())->SetNextPageId(page_id);
+    }
+  } else {
+    reinterpret_cast<InternalPage *>(page->GetData())->Init(page_id, parent_page_id, internal_max_size_);
+  }
+  if (current.page_ != nullptr) {
+    buffer_pool_manager_->UnpinPage(current.page_->GetPageId(), true);
+  }
+
+  size_t index = current.pages_started_++;
+  current.page_ = page;
+  current.target_size_ =
+      static_cast<int>(current.num_entries_ / current.num_pages_ + (index < current.num_entries_ % current.num_pages_));
+  return page;
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+page_id_t BPLUSTREE_TYPE::AppendBulkLoadChild(BulkLoadState *state, size_t level, const KeyType &key,
+                                              page_id_t child_page_id) {
+  auto &current = state->levels_[level];
+  if (current.page_ == nullptr ||
+      reinterpret_cast<InternalPage *>(current.page_->GetData())->GetSize() == current.target_size_) {
+    StartBulkLoadPage(state, level, key);
+  }
+  reinterpret_cast<InternalPage *>(current.page_->GetData())->Append(key, child_page_id);
+  return current.page_->GetPageId();
+}
 
 /*****************************************************************************
  * REMOVE
@@ -116,7 +537,181 @@ void BPLUSTREE_TYPE::InsertIntoParent(BPlusTreePage *old_node, const KeyType &ke
  * necessary.
  */
 INDEX_TEMPLATE_ARGUMENTS
-void BPLUSTREE_TYPE::Remove(const KeyType &key, Transaction *transaction) {}
+void BPLUSTREE_TYPE::Remove(const KeyType &key, Transaction *transaction) { RemoveValues(key, nullptr, transaction); }
+
+/*
+ * Delete one value of the key. In a non-unique tree this takes it out of the
+ * key's posting list; the key itself is only removed with its last value.
+ */
+INDEX_TEMPLATE_ARGUMENTS
+void BPLUSTREE_TYPE::Remove(const KeyType &key, const ValueType &value, Transaction *transaction) {
+  RemoveValues(key, &value, transaction);
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+void BPLUSTREE_TYPE::RemoveValues(const KeyType &key, const ValueType *value, Transaction *transaction) {
+  // Optimistic pass: finish in the leaf if it does not underflow, or if underflows are left for later. Trimming a
+  // posting list never shrinks the leaf.
+  Page *page = FindLeafPageLatched(key, false, true);
+  if (page == nullptr) {
+    return;
+  }
+  auto *leaf = reinterpret_cast<LeafPage *>(page->GetData());
+  bool modified;
+  bool remove_entry;
+  bool safe;
+  bool lazy = remove_mode_ == RemoveMode::LAZY;
+  try {
+    remove_entry = TrimEntry(leaf, key, value, &modified);
+    safe = IsSafe(leaf, Operation::REMOVE);
+    if (remove_entry && (safe || lazy)) {
+      RemoveEntry(leaf, key);
+      modified = true;
+      if (!safe) {
+        std::lock_guard<std::mutex> guard(underfull_latch_);
+        // a key recorded before the leaf split may lead to its new sibling now, so the latest key replaces it
+        underfull_leaves_.insert_or_assign(page->GetPageId(), key);
+      }
+    }
+  } catch (const Exception &e) {
+    // a posting list page could not be fetched, possibly after the entry left the leaf
+    WUnlatchNode(page, true);
+    buffer_pool_manager_->UnpinPage(page->GetPageId(), true);
+    throw;
+  }
+  WUnlatchNode(page, modified);
+  buffer_pool_manager_->UnpinPage(page->GetPageId(), modified);
+  if (!remove_entry || safe || lazy) {
+    return;
+  }
+
+  // Pessimistic pass.
+  Transaction local_transaction(INVALID_TXN_ID);
+  if (transaction == nullptr) {
+    transaction = &local_transaction;
+  }
+  root_latch_.WLock();
+  transaction->AddIntoPageSet(nullptr);
+  try {
+    if (!IsEmpty()) {
+      page = FindLeafPagePessimistic(key, Operation::REMOVE, transaction);
+      leaf = reinterpret_cast<LeafPage *>(page->GetData());
+      // the entry may have changed since the optimistic pass
+      if (TrimEntry(leaf, key, value, &modified)) {
+        RemoveEntry(leaf, key);
+        CoalesceOrRedistribute(leaf, transaction);
+      }
+    }
+  } catch (const Exception &e) {
+    AbortLatchedPages(transaction);
+    throw;
+  }
+  ReleaseLatchedPages(transaction, true);
+  DeletePages(transaction);
+}
+
+/*
+ * Background half of lazy removes: descend pessimistically to each recorded
+ * leaf, as an eager remove would have, and merge or redistribute it if it is
+ * still underfull. A leaf may have been merged away or split since it was
+ * recorded; its key then leads to the leaf that holds its range now.
+ */
+INDEX_TEMPLATE_ARGUMENTS
+size_t BPLUSTREE_TYPE::MergeUnderfullPages(Transaction *transaction) {
+  std::unordered_map<page_id_t, KeyType> underfull_leaves;
+  {
+    std::lock_guard<std::mutex> guard(underfull_latch_);
+    underfull_leaves.swap(underfull_leaves_);
+  }
+  Transaction local_transaction(INVALID_TXN_ID);
+  if (transaction == nullptr) {
+    transaction = &local_transaction;
+  }
+
+  size_t num_merged = 0;
+  for (const auto &entry : underfull_leaves) {
+    // Merging two underfull leaves, or borrowing a single entry, may still leave the key's leaf underfull, so repeat
+    // until it is not. Every round either frees a page or grows the leaf.
+    for (bool underfull = true; underfull;) {
+      root_latch_.WLock();
+      transaction->AddIntoPageSet(nullptr);
+      underfull = false;
+      try {
+        if (!IsEmpty()) {
+          Page *page = FindLeafPagePessimistic(entry.second, Operation::REMOVE, transaction);
+          auto *leaf = reinterpret_cast<LeafPage *>(page->GetData());
+          underfull = leaf->IsRootPage() ? leaf->GetSize() == 0 : leaf->GetSize() < leaf->GetMinSize();
+          if (underfull) {
+            CoalesceOrRedistribute(leaf, transaction);
+            num_merged++;
+          }
+        }
+      } catch (const Exception &e) {
+        AbortLatchedPages(transaction);
+        throw;
+      }
+      ReleaseLatchedPages(transaction, true);
+      DeletePages(transaction);
+    }
+  }
+  return num_merged;
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+void BPLUSTREE_TYPE::StartMergeThread(std::chrono::milliseconds interval) {
+  StopMergeThread();
+  stop_merge_thread_ = false;
+  merge_thread_ = std::thread([this, interval] {
+    std::unique_lock<std::mutex> lock(merge_thread_latch_);
+    while (!merge_thread_cv_.wait_for(lock, interval, [this] { return stop_merge_thread_; })) {
+      lock.unlock();
+      MergeUnderfullPages();
+      lock.lock();
+    }
+  });
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+void BPLUSTREE_TYPE::StopMergeThread() {
+  if (!merge_thread_.joinable()) {
+    return;
+  }
+  {
+    std::lock_guard<std::mutex> guard(merge_thread_latch_);
+    stop_merge_thread_ = true;
+  }
+  merge_thread_cv_.notify_all();
+  merge_thread_.join();
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+bool BPLUSTREE_TYPE::TrimEntry(LeafPage *leaf, const KeyType &key, const ValueType *value, bool *modified) {
+  *modified = false;
+  int index = leaf->KeyIndex(key, comparator_);
+  if (index >= leaf->GetSize() || comparator_(leaf->KeyAt(index), key) != 0) {
+    return false;
+  }
+  ValueType existing = leaf->ValueAt(index);
+  if (value == nullptr || unique_keys_ || !PostingList::IsReference(existing)) {
+    return value == nullptr || existing == *value;
+  }
+  std::optional<RID> only_rid;
+  if (PostingList::Remove(buffer_pool_manager_, existing, *value, &only_rid) && only_rid.has_value()) {
+    leaf->SetValueAt(index, *only_rid);
+    *modified = true;
+  }
+  return false;
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+void BPLUSTREE_TYPE::RemoveEntry(LeafPage *leaf, const KeyType &key) {
+  ValueType existing;
+  leaf->Lookup(key, &existing, comparator_);
+  leaf->RemoveAndDeleteRecord(key, comparator_);
+  if (!unique_keys_ && PostingList::IsReference(existing)) {
+    PostingList::Free(buffer_pool_manager_, existing);
+  }
+}
 
 /*
  * User needs to first find the sibling of input page. If sibling's size + input
@@ -128,7 +723,51 @@ void BPLUSTREE_TYPE::Remove(const KeyType &key, Transaction *transaction) {}
 INDEX_TEMPLATE_ARGUMENTS
 template <typename N>
 bool BPLUSTREE_TYPE::CoalesceOrRedistribute(N *node, Transaction *transaction) {
-  return false;
+  if (node->IsRootPage()) {
+    bool delete_root = AdjustRoot(node);
+    if (delete_root) {
+      transaction->AddIntoDeletedPageSet(node->GetPageId());
+    }
+    return delete_root;
+  }
+  if (node->GetSize() >= node->GetMinSize()) {
+    return false;
+  }
+
+  // The parent is write-latched in the page set. The sibling is not on the path and is latched here; a leaf
+  // iterator never holds a latch while it waits for another, so latching it out of key order is safe.
+  page_id_t parent_page_id = node->GetParentPageId();
+  auto *parent = reinterpret_cast<InternalPage *>(FetchPage(parent_page_id)->GetData());
+  int index = parent->ValueIndex(node->GetPageId());
+  page_id_t sibling_page_id = parent->ValueAt(index == 0 ? 1 : index - 1);
+  Page *sibling_page = buffer_pool_manager_->FetchPage(sibling_page_id);
+  if (sibling_page == nullptr) {
+    buffer_pool_manager_->UnpinPage(parent_page_id, false);
+    throw Exception(ExceptionType::OUT_OF_MEMORY, "Cannot fetch B+ tree page");
+  }
+  WLatchNode(sibling_page);
+  auto *sibling = reinterpret_cast<N *>(sibling_page->GetData());
+
+  // A leaf splits when it reaches max size, an internal page only when it exceeds it.
+  int merged_size = sibling->GetSize() + node->GetSize();
+  bool merge = node->IsLeafPage() ? merged_size < node->GetMaxSize() : merged_size <= node->GetMaxSize();
+  try {
+    if (merge) {
+      Coalesce(&sibling, &node, &parent, index, transaction);
+    } else {
+      Redistribute(sibling, node, index);
+    }
+  } catch (const Exception &e) {
+    WUnlatchNode(sibling_page, true);
+    buffer_pool_manager_->UnpinPage(sibling_page_id, true);
+    buffer_pool_manager_->UnpinPage(parent_page_id, true);
+    throw;
+  }
+
+  WUnlatchNode(sibling_page, true);
+  buffer_pool_manager_->UnpinPage(sibling_page_id, true);
+  buffer_pool_manager_->UnpinPage(parent_page_id, true);
+  return merge && index != 0;
 }
 
 /*
@@ -148,7 +787,19 @@ template <typename N>
 bool BPLUSTREE_TYPE::Coalesce(N **neighbor_node, N **node,
                               BPlusTreeInternalPage<KeyType, page_id_t, KeyComparator> **parent, int index,
                               Transaction *transaction) {
-  return false;
+  // Always move the right page into the left one.
+  if (index == 0) {
+    std::swap(*neighbor_node, *node);
+    index = 1;
+  }
+  if constexpr (std::is_same_v<N, LeafPage>) {
+    (*node)->MoveAllTo(*neighbor_node);
+  } else {
+    (*node)->MoveAllTo(*neighbor_node, (*parent)->KeyAt(index), buffer_pool_manager_);
+  }
+  transaction->AddIntoDeletedPageSet((*node)->GetPageId());
+  (*parent)->Remove(index);
+  return CoalesceOrRedistribute(*parent, transaction);
 }
 
 /*
@@ -162,7 +813,26 @@ bool BPLUSTREE_TYPE::Coalesce(N **neighbor_node, N **node,
  */
 INDEX_TEMPLATE_ARGUMENTS
 template <typename N>
-void BPLUSTREE_TYPE::Redistribute(N *neighbor_node, N *node, int index) {}
+void BPLUSTREE_TYPE::Redistribute(N *neighbor_node, N *node, int index) {
+  page_id_t parent_page_id = node->GetParentPageId();
+  auto *parent = reinterpret_cast<InternalPage *>(FetchPage(parent_page_id)->GetData());
+  if (index == 0) {
+    if constexpr (std::is_same_v<N, LeafPage>) {
+      neighbor_node->MoveFirstToEndOf(node);
+    } else {
+      neighbor_node->MoveFirstToEndOf(node, parent->KeyAt(1), buffer_pool_manager_);
+    }
+    parent->SetKeyAt(1, neighbor_node->KeyAt(0));
+  } else {
+    if constexpr (std::is_same_v<N, LeafPage>) {
+      neighbor_node->MoveLastToFrontOf(node);
+    } else {
+      neighbor_node->MoveLastToFrontOf(node, parent->KeyAt(index), buffer_pool_manager_);
+    }
+    parent->SetKeyAt(index, node->KeyAt(0));
+  }
+  buffer_pool_manager_->UnpinPage(parent_page_id, true);
+}
 /*
  * Update root page if necessary
  * NOTE: size of root page can be less than min size and this method is only
@@ -174,7 +844,29 @@ void BPLUSTREE_TYPE::Redistribute(N *neighbor_node, N *node, int index) {}
  * happend
  */
 INDEX_TEMPLATE_ARGUMENTS
-bool BPLUSTREE_TYPE::AdjustRoot(BPlusTreePage *old_root_node) { return false; }
+bool BPLUSTREE_TYPE::AdjustRoot(BPlusTreePage *old_root_node) {
+  // The root was unsafe, so root_latch_ is still held.
+  if (old_root_node->IsLeafPage()) {
+    if (old_root_node->GetSize() > 0) {
+      return false;
+    }
+    root_page_id_ = INVALID_PAGE_ID;
+    UpdateRootPageId(0);
+    return true;
+  }
+
+  if (old_root_node->GetSize() > 1) {
+    return false;
+  }
+  // fetch the only child before anything changes, so that the tree stays as it was if it cannot be fetched
+  auto *old_root = reinterpret_cast<InternalPage *>(old_root_node);
+  auto *new_root = reinterpret_cast<BPlusTreePage *>(FetchPage(old_root->ValueAt(0))->GetData());
+  root_page_id_ = old_root->RemoveAndReturnOnlyChild();
+  new_root->SetParentPageId(INVALID_PAGE_ID);
+  buffer_pool_manager_->UnpinPage(root_page_id_, true);
+  UpdateRootPageId(0);
+  return true;
+}
 
 /*****************************************************************************
  * INDEX ITERATOR
@@ -185,7 +877,14 @@ bool BPLUSTREE_TYPE::AdjustRoot(BPlusTreePage *old_root_node) { return false; }
  * @return : index iterator
  */
 INDEX_TEMPLATE_ARGUMENTS
-INDEXITERATOR_TYPE BPLUSTREE_TYPE::Begin() { return INDEXITERATOR_TYPE(); }
+INDEXITERATOR_TYPE BPLUSTREE_TYPE::Begin() {
+  Page *page = FindLeafPageLatched(KeyType{}, true, false);
+  if (page == nullptr) {
+    return INDEXITERATOR_TYPE();
+  }
+  page->RUnlatch();
+  return INDEXITERATOR_TYPE(buffer_pool_manager_, page, 0);
+}
 
 /*
  * Input parameter is low key, find the leaf page that contains the input key
@@ -193,7 +892,15 @@ INDEXITERATOR_TYPE BPLUSTREE_TYPE::Begin() { return INDEXITERATOR_TYPE(); }
  * @return : index iterator
  */
 INDEX_TEMPLATE_ARGUMENTS
-INDEXITERATOR_TYPE BPLUSTREE_TYPE::Begin(const KeyType &key) { return INDEXITERATOR_TYPE(); }
+INDEXITERATOR_TYPE BPLUSTREE_TYPE::Begin(const KeyType &key) {
+  Page *page = FindLeafPageLatched(key, false, false);
+  if (page == nullptr) {
+    return INDEXITERATOR_TYPE();
+  }
+  int index = reinterpret_cast<LeafPage *>(page->GetData())->KeyIndex(key, comparator_);
+  page->RUnlatch();
+  return INDEXITERATOR_TYPE(buffer_pool_manager_, page, index);
+}
 
 /*
  * Input parameter is void, construct an index iterator representing the end
@@ -203,6 +910,15 @@ INDEXITERATOR_TYPE BPLUSTREE_TYPE::Begin(const KeyType &key) { return INDEXITERA
 INDEX_TEMPLATE_ARGUMENTS
 INDEXITERATOR_TYPE BPLUSTREE_TYPE::End() { return INDEXITERATOR_TYPE(); }
 
+/*
+ * Input parameter is the range to scan, see KeyRange
+ * @return : a scan that hands out the entries in range one leaf at a time
+ */
+INDEX_TEMPLATE_ARGUMENTS
+INDEXRANGESCAN_TYPE BPLUSTREE_TYPE::Scan(const KeyRange<KeyType> &range) {
+  return INDEXRANGESCAN_TYPE(this, buffer_pool_manager_, comparator_, range);
+}
+
 /*****************************************************************************
  * UTILITIES AND DEBUG
  *****************************************************************************/
@@ -212,7 +928,175 @@ INDEXITERATOR_TYPE BPLUSTREE_TYPE::End() { return INDEXITERATOR_TYPE(); }
  */
 INDEX_TEMPLATE_ARGUMENTS
 Page *BPLUSTREE_TYPE::FindLeafPage(const KeyType &key, bool leftMost) {
-  throw Exception(ExceptionType::NOT_IMPLEMENTED, "Implement this for test");
+  return FindLeafPageLatched(key, leftMost, false);
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+Page *BPLUSTREE_TYPE::FindLeafPageLatched(const KeyType &key, bool left_most, bool write_leaf) {
+  root_latch_.RLock();
+  if (IsEmpty()) {
+    root_latch_.RUnlock();
+    return nullptr;
+  }
+  // A page's type only changes if it is freed and reused, which needs a write latch on its parent (or on
+  // root_latch_ for the root), so it can be read before latching the page itself.
+  Page *page = buffer_pool_manager_->FetchPage(root_page_id_);
+  if (page == nullptr) {
+    root_latch_.RUnlock();
+    throw Exception(ExceptionType::OUT_OF_MEMORY, "Cannot fetch B+ tree page");
+  }
+  auto *node = reinterpret_cast<BPlusTreePage *>(page->GetData());
+  if (write_leaf && node->IsLeafPage()) {
+    WLatchNode(page);
+  } else {
+    page->RLatch();
+  }
+  root_latch_.RUnlock();
+
+  while (!node->IsLeafPage()) {
+    auto *internal = reinterpret_cast<InternalPage *>(node);
+    page_id_t child_page_id = left_most ? internal->ValueAt(0) : internal->Lookup(key, comparator_);
+    Page *child_page = buffer_pool_manager_->FetchPage(child_page_id);
+    if (child_page == nullptr) {
+      page->RUnlatch();
+      buffer_pool_manager_->UnpinPage(page->GetPageId(), false);
+      throw Exception(ExceptionType::OUT_OF_MEMORY, "Cannot fetch B+ tree page");
+    }
+    auto *child = reinterpret_cast<BPlusTreePage *>(child_page->GetData());
+    if (write_leaf && child->IsLeafPage()) {
+      WLatchNode(child_page);
+    } else {
+      child_page->RLatch();
+    }
+    page->RUnlatch();
+    buffer_pool_manager_->UnpinPage(page->GetPageId(), false);
+    page = child_page;
+    node = child;
+  }
+  return page;
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+Page *BPLUSTREE_TYPE::FindLeafPageReverse(const KeyType *key, bool inclusive, std::optional<KeyType> *lower_fence) {
+  lower_fence->reset();
+  root_latch_.RLock();
+  if (IsEmpty()) {
+    root_latch_.RUnlock();
+    return nullptr;
+  }
+  Page *page = buffer_pool_manager_->FetchPage(root_page_id_);
+  if (page == nullptr) {
+    root_latch_.RUnlock();
+    throw Exception(ExceptionType::OUT_OF_MEMORY, "Cannot fetch B+ tree page");
+  }
+  page->RLatch();
+  root_latch_.RUnlock();
+
+  auto *node = reinterpret_cast<BPlusTreePage *>(page->GetData());
+  while (!node->IsLeafPage()) {
+    auto *internal = reinterpret_cast<InternalPage *>(node);
+    int index = key == nullptr ? internal->GetSize() - 1 : internal->ChildIndex(*key, comparator_, !inclusive);
+    // the deepest separator left of the path is the tightest fence
+    if (index > 0) {
+      *lower_fence = internal->KeyAt(index);
+    }
+    Page *child_page = buffer_pool_manager_->FetchPage(internal->ValueAt(index));
+    if (child_page == nullptr) {
+      page->RUnlatch();
+      buffer_pool_manager_->UnpinPage(page->GetPageId(), false);
+      throw Exception(ExceptionType::OUT_OF_MEMORY, "Cannot fetch B+ tree page");
+    }
+    child_page->RLatch();
+    page->RUnlatch();
+    buffer_pool_manager_->UnpinPage(page->GetPageId(), false);
+    page = child_page;
+    node = reinterpret_cast<BPlusTreePage *>(child_page->GetData());
+  }
+  return page;
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+Page *BPLUSTREE_TYPE::FindLeafPagePessimistic(const KeyType &key, Operation op, Transaction *transaction) {
+  // a page that cannot be fetched throws; what is latched so far is in the page set, for the caller to release
+  Page *page = FetchPage(root_page_id_);
+  WLatchNode(page);
+  auto *node = reinterpret_cast<BPlusTreePage *>(page->GetData());
+  if (IsSafe(node, op)) {
+    ReleaseLatchedPages(transaction, false);
+  }
+  transaction->AddIntoPageSet(page);
+
+  while (!node->IsLeafPage()) {
+    page_id_t child_page_id = reinterpret_cast<InternalPage *>(node)->Lookup(key, comparator_);
+    page = FetchPage(child_page_id);
+    WLatchNode(page);
+    node = reinterpret_cast<BPlusTreePage *>(page->GetData());
+    if (IsSafe(node, op)) {
+      ReleaseLatchedPages(transaction, false);
+    }
+    transaction->AddIntoPageSet(page);
+  }
+  return page;
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+bool BPLUSTREE_TYPE::IsSafe(BPlusTreePage *node, Operation op) const {
+  switch (op) {
+    case Operation::FIND:
+      return true;
+    case Operation::INSERT:
+      // a leaf splits once it reaches max size, an internal page once it exceeds it
+      return node->IsLeafPage() ? node->GetSize() + 1 < node->GetMaxSize() : node->GetSize() < node->GetMaxSize();
+    case Operation::REMOVE:
+      if (node->IsRootPage()) {
+        // a root leaf may shrink down to one entry, a root internal page down to two children
+        return node->GetSize() > (node->IsLeafPage() ? 1 : 2);
+      }
+      return node->GetSize() > node->GetMinSize();
+  }
+  return false;
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+void BPLUSTREE_TYPE::ReleaseLatchedPages(Transaction *transaction, bool is_dirty) {
+  auto page_set = transaction->GetPageSet();
+  for (Page *page : *page_set) {
+    if (page == nullptr) {
+      root_latch_.WUnlock();
+    } else {
+      WUnlatchNode(page, is_dirty);
+      buffer_pool_manager_->UnpinPage(page->GetPageId(), is_dirty);
+    }
+  }
+  page_set->clear();
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+void BPLUSTREE_TYPE::AbortLatchedPages(Transaction *transaction) {
+  // pages already modified must be written back, so everything counts as dirty
+  ReleaseLatchedPages(transaction, true);
+  transaction->GetDeletedPageSet()->clear();
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+void BPLUSTREE_TYPE::WLatchNode(Page *page) {
+  page->WLatch();
+  reinterpret_cast<BPlusTreePage *>(page->GetData())->BeginWrite();
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+void BPLUSTREE_TYPE::WUnlatchNode(Page *page, bool modified) {
+  reinterpret_cast<BPlusTreePage *>(page->GetData())->EndWrite(modified);
+  page->WUnlatch();
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+void BPLUSTREE_TYPE::DeletePages(Transaction *transaction) {
+  auto deleted_page_set = transaction->GetDeletedPageSet();
+  for (page_id_t page_id : *deleted_page_set) {
+    buffer_pool_manager_->DeletePage(page_id);
+  }
+  deleted_page_set->clear();
 }
 
 /*
@@ -225,15 +1109,36 @@ Page *BPLUSTREE_TYPE::FindLeafPage(const KeyType &key, bool leftMost) {
  */
 INDEX_TEMPLATE_ARGUMENTS
 void BPLUSTREE_TYPE::UpdateRootPageId(int insert_record) {
-  HeaderPage *header_page = static_cast<HeaderPage *>(buffer_pool_manager_->FetchPage(HEADER_PAGE_ID));
+  // Callers hold root_latch_, so root changes of this tree are serialized. Once the record's location is known, only
+  // its bucket page is written: root splits of different indexes no longer meet on the header page.
+  if (header_record_.GetPageId() != INVALID_PAGE_ID &&
+      HeaderPage::UpdateRecordAt(buffer_pool_manager_, header_record_, index_name_, root_page_id_)) {
+    return;
+  }
+  HeaderPage *header_page = static_cast<HeaderPage *>(FetchPage(HEADER_PAGE_ID));
   if (insert_record != 0) {
-    // create a new record<index_name + root_page_id> in header_page
-    header_page->InsertRecord(index_name_, root_page_id_);
+    // create a new record<index_name + root_page_id> in header_page; the tree may have been emptied and regrown
+    header_page->WLatch();
+    if (!header_page->InsertRecord(buffer_pool_manager_, index_name_, root_page_id_, &header_record_)) {
+      header_page->UpdateRecord(buffer_pool_manager_, index_name_, root_page_id_, &header_record_);
+    }
+    header_page->WUnlatch();
   } else {
     // update root_page_id in header_page
-    header_page->UpdateRecord(index_name_, root_page_id_);
+    header_page->RLatch();
+    header_page->UpdateRecord(buffer_pool_manager_, index_name_, root_page_id_, &header_record_);
+    header_page->RUnlatch();
+  }
+  buffer_pool_manager_->UnpinPage(HEADER_PAGE_ID, insert_record != 0);
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+Page *BPLUSTREE_TYPE::FetchPage(page_id_t page_id) {
+  Page *page = buffer_pool_manager_->FetchPage(page_id);
+  if (page == nullptr) {
+    throw Exception(ExceptionType::OUT_OF_MEMORY, "Cannot fetch B+ tree page");
   }
-  buffer_pool_manager_->UnpinPage(HEADER_PAGE_ID, true);
+  return page;
 }
 
 /*
@@ -400,5 +1305,6 @@ template class BPlusTree<GenericKey<8>, RID, GenericComparator<8>>;
 template class BPlusTree<GenericKey<16>, RID, GenericComparator<16>>;
 template class BPlusTree<GenericKey<32>, RID, GenericComparator<32>>;
 template class BPlusTree<GenericKey<64>, RID, GenericComparator<64>>;
+template class BPlusTree<GenericKey<8>, RID, IntegerComparator<8>>;
 
 }  // namespace bustub
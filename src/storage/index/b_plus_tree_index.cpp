@@ -11,15 +11,34 @@
 
 #include "storage/index/b_plus_tree_index.h"
 
+#include <algorithm>
+
+#include "storage/index/index_entry_sorter.h"
+
 namespace bustub {
 /*
  * Constructor
  */
 INDEX_TEMPLATE_ARGUMENTS
-BPLUSTREE_INDEX_TYPE::BPlusTreeIndex(std::unique_ptr<IndexMetadata> &&metadata, BufferPoolManager *buffer_pool_manager)
+BPLUSTREE_INDEX_TYPE::BPlusTreeIndex(std::unique_ptr<IndexMetadata> &&metadata, BufferPoolManager *buffer_pool_manager,
+                                     bool unique_keys)
     : Index(std::move(metadata)),
+      buffer_pool_manager_(buffer_pool_manager),
+      unique_keys_(unique_keys),
       comparator_(GetMetadata()->GetKeySchema()),
-      container_(GetMetadata()->GetName(), buffer_pool_manager, comparator_) {}
+      container_(GetMetadata()->GetName(), buffer_pool_manager, comparator_, LEAF_PAGE_SIZE, INTERNAL_PAGE_SIZE,
+                 unique_keys) {
+  if (GetMetadata()->GetIncludeAttrs().empty()) {
+    return;
+  }
+  // the entry of a key with several RIDs would have to hold the included columns of all of them
+  if (!unique_keys_) {
+    throw Exception(ExceptionType::NOT_IMPLEMENTED, "Index " + GetName() + ": included columns need unique keys");
+  }
+  if (GetEntrySchema()->GetLength() > sizeof(KeyType)) {
+    throw Exception(ExceptionType::OUT_OF_RANGE, "Index " + GetName() + ": included columns do not fit in the key");
+  }
+}
 
 INDEX_TEMPLATE_ARGUMENTS
 void BPLUSTREE_INDEX_TYPE::InsertEntry(const Tuple &key, RID rid, Transaction *transaction) {
@@ -36,7 +55,7 @@ void BPLUSTREE_INDEX_TYPE::DeleteEntry(const Tuple &key, RID rid, Transaction *t
   KeyType index_key;
   index_key.SetFromKey(key);
 
-  container_.Remove(index_key, transaction);
+  container_.Remove(index_key, rid, transaction);
 }
 
 INDEX_TEMPLATE_ARGUMENTS
@@ -48,6 +67,65 @@ void BPLUSTREE_INDEX_TYPE::ScanKey(const Tuple &key, std::vector<RID> *result, T
   container_.GetValue(index_key, result, transaction);
 }
 
+INDEX_TEMPLATE_ARGUMENTS
+void BPLUSTREE_INDEX_TYPE::BuildFromTable(TableHeap *table_heap, const Schema &table_schema,
+                                          Transaction *transaction) {
+  // with unique keys, keep the first tuple of each key, like inserting the tuples one by one would
+  IndexEntrySorter<KeyType, ValueType, KeyComparator> sorter(buffer_pool_manager_, comparator_, unique_keys_);
+  KeyType index_key;
+  for (auto tuple = table_heap->Begin(transaction); tuple != table_heap->End(); ++tuple) {
+    index_key.SetFromKey(EntryFromTuple(*tuple, table_schema));
+    sorter.Add(index_key, tuple->GetRid());
+  }
+  sorter.Finish();
+
+  auto entry = sorter.Begin();
+  bool loaded =
+      unique_keys_ ? container_.BulkLoad(entry, sorter.End(), sorter.GetSize()) : BulkLoadGrouped(&entry, sorter.End());
+  if (!loaded) {
+    // the tree already has entries, so they have to go in one at a time
+    for (; entry != sorter.End(); ++entry) {
+      container_.Insert(entry->first, entry->second, transaction);
+    }
+  }
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+template <typename Iterator>
+bool BPLUSTREE_INDEX_TYPE::BulkLoadGrouped(Iterator *begin, Iterator end) {
+  if (!container_.IsEmpty()) {
+    return false;
+  }
+  // The number of distinct keys is only known once they have been grouped, so the grouped entries go through a second
+  // sorter; they already come in order, which makes its runs cheap to merge.
+  IndexEntrySorter<KeyType, ValueType, KeyComparator> grouped(buffer_pool_manager_, comparator_, true);
+  std::vector<RID> rids;
+  KeyType key;
+  auto add_group = [&]() {
+    if (rids.size() == 1) {
+      grouped.Add(key, rids[0]);
+      return;
+    }
+    std::sort(rids.begin(), rids.end(), [](const RID &lhs, const RID &rhs) { return lhs.Get() < rhs.Get(); });
+    rids.erase(std::unique(rids.begin(), rids.end()), rids.end());
+    grouped.Add(key, rids.size() == 1 ? rids[0] : PostingList::Create(buffer_pool_manager_, rids));
+  };
+  for (; *begin != end; ++*begin) {
+    const auto &entry = **begin;
+    if (!rids.empty() && comparator_(entry.first, key) != 0) {
+      add_group();
+      rids.clear();
+    }
+    key = entry.first;
+    rids.push_back(entry.second);
+  }
+  if (!rids.empty()) {
+    add_group();
+  }
+  grouped.Finish();
+  return container_.BulkLoad(grouped.Begin(), grouped.End(), grouped.GetSize());
+}
+
 INDEX_TEMPLATE_ARGUMENTS
 INDEXITERATOR_TYPE BPLUSTREE_INDEX_TYPE::GetBeginIterator() { return container_.Begin(); }
 
@@ -57,10 +135,64 @@ INDEXITERATOR_TYPE BPLUSTREE_INDEX_TYPE::GetBeginIterator(const KeyType &key) {
 INDEX_TEMPLATE_ARGUMENTS
 INDEXITERATOR_TYPE BPLUSTREE_INDEX_TYPE::GetEndIterator() { return container_.End(); }
 
+INDEX_TEMPLATE_ARGUMENTS
+std::unique_ptr<IndexRangeCursor> BPLUSTREE_INDEX_TYPE::ScanRange(const KeyRange<Tuple> &range,
+                                                                  Transaction *transaction) {
+  KeyRange<KeyType> key_range;
+  if (range.lower_.has_value()) {
+    key_range.lower_.emplace();
+    key_range.lower_->SetFromKey(*range.lower_);
+  }
+  key_range.lower_inclusive_ = range.lower_inclusive_;
+  if (range.upper_.has_value()) {
+    key_range.upper_.emplace();
+    key_range.upper_->SetFromKey(*range.upper_);
+  }
+  key_range.upper_inclusive_ = range.upper_inclusive_;
+  key_range.reverse_ = range.reverse_;
+  return std::make_unique<RangeCursor>(container_.Scan(key_range), GetEntrySchema());
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+INDEXRANGESCAN_TYPE BPLUSTREE_INDEX_TYPE::GetRangeScan(const KeyRange<KeyType> &range) {
+  return container_.Scan(range);
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+bool BPLUSTREE_INDEX_TYPE::RangeCursor::NextBatch(std::vector<RID> *rids) {
+  rids->clear();
+  if (!scan_.NextBatch(&entries_)) {
+    return false;
+  }
+  for (const auto &entry : entries_) {
+    rids->push_back(entry.second);
+  }
+  return true;
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+bool BPLUSTREE_INDEX_TYPE::RangeCursor::NextEntryBatch(std::vector<RID> *rids, std::vector<Tuple> *entries) {
+  if (!NextBatch(rids)) {
+    entries->clear();
+    return false;
+  }
+  entries->clear();
+  entries->reserve(entries_.size());
+  std::vector<Value> values(entry_schema_->GetColumnCount());
+  for (const auto &entry : entries_) {
+    for (uint32_t i = 0; i < values.size(); i++) {
+      values[i] = entry.first.ToValue(entry_schema_, i);
+    }
+    entries->emplace_back(values, entry_schema_);
+  }
+  return true;
+}
+
 template class BPlusTreeIndex<GenericKey<4>, RID, GenericComparator<4>>;
 template class BPlusTreeIndex<GenericKey<8>, RID, GenericComparator<8>>;
 template class BPlusTreeIndex<GenericKey<16>, RID, GenericComparator<16>>;
 template class BPlusTreeIndex<GenericKey<32>, RID, GenericComparator<32>>;
 template class BPlusTreeIndex<GenericKey<64>, RID, GenericComparator<64>>;
+template class BPlusTreeIndex<GenericKey<8>, RID, IntegerComparator<8>>;
 
 }  // namespace bustub
@@ -0,0 +1,190 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// index_entry_sorter.cpp
+//
+// Identification: src/storage/index/index_entry_sorter.cpp
+//
+// Copyright (c) 2015-2021, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "storage/index/index_entry_sorter.h"
+
+#include <algorithm>
+
+#include "common/exception.h"
+#include "common/rid.h"
+#include "storage/index/generic_key.h"
+
+namespace bustub {
+
+INDEX_TEMPLATE_ARGUMENTS
+INDEX_ENTRY_SORTER_TYPE::IndexEntrySorter(BufferPoolManager *buffer_pool_manager, const KeyComparator &comparator,
+                                          bool unique_keys, size_t run_size, size_t fan_in)
+    : buffer_pool_manager_(buffer_pool_manager),
+      comparator_(comparator),
+      unique_keys_(unique_keys),
+      run_size_(std::max<size_t>(run_size, 1)),
+      fan_in_(std::max<size_t>(fan_in, 2)),
+      merger_(this, fan_in_, unique_keys) {}
+
+INDEX_TEMPLATE_ARGUMENTS
+INDEX_ENTRY_SORTER_TYPE::~IndexEntrySorter() {
+  for (auto &run : merger_.GetRuns()) {
+    DropRun(&run);
+  }
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+void INDEX_ENTRY_SORTER_TYPE::Add(const KeyType &key, const ValueType &value) {
+  BUSTUB_ASSERT(!finished_, "Add after Finish");
+  buffer_.emplace_back(key, value);
+  size_++;
+  if (buffer_.size() >= run_size_) {
+    SpillBuffer();
+  }
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+void INDEX_ENTRY_SORTER_TYPE::Finish() {
+  BUSTUB_ASSERT(!finished_, "Finish called twice");
+  finished_ = true;
+  if (merger_.GetRuns().empty()) {
+    SortBuffer();
+    size_ = buffer_.size();
+    return;
+  }
+
+  if (!buffer_.empty()) {
+    SpillBuffer();
+  }
+  buffer_.clear();
+  buffer_.shrink_to_fit();
+
+  merger_.MergeRunGroups(unique_keys_ ? 1 : fan_in_);
+  if (unique_keys_) {
+    size_ = merger_.GetRuns()[0].size_;
+  }
+  merger_.StartMerge();
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+bool INDEX_ENTRY_SORTER_TYPE::Next(MappingType *entry) {
+  BUSTUB_ASSERT(finished_, "Next before Finish");
+  if (merger_.GetRuns().empty()) {
+    if (buffer_next_ == buffer_.size()) {
+      return false;
+    }
+    *entry = buffer_[buffer_next_++];
+    return true;
+  }
+  const Run *run = merger_.MinRun();
+  if (run == nullptr) {
+    return false;
+  }
+  *entry = CurrentEntry(*run);
+  merger_.AdvanceMinRun();
+  return true;
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+void INDEX_ENTRY_SORTER_TYPE::SortBuffer() {
+  std::stable_sort(buffer_.begin(), buffer_.end(), [this](const MappingType &lhs, const MappingType &rhs) {
+    return comparator_(lhs.first, rhs.first) < 0;
+  });
+  if (unique_keys_) {
+    auto last = std::unique(buffer_.begin(), buffer_.end(), [this](const MappingType &lhs, const MappingType &rhs) {
+      return comparator_(lhs.first, rhs.first) == 0;
+    });
+    buffer_.erase(last, buffer_.end());
+  }
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+void INDEX_ENTRY_SORTER_TYPE::SpillBuffer() {
+  SortBuffer();
+  Run run;
+  for (const auto &entry : buffer_) {
+    AppendEntry(&run, entry);
+  }
+  SealRun(&run);
+  merger_.AddRun(std::move(run));
+  num_runs_++;
+  buffer_.clear();
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+void INDEX_ENTRY_SORTER_TYPE::AppendEntry(Run *run, const MappingType &entry) {
+  if (run->page_ == nullptr || PageCount(run->page_) == ENTRIES_PER_PAGE) {
+    if (run->page_ != nullptr) {
+      buffer_pool_manager_->UnpinPage(run->page_->GetPageId(), true);
+    }
+    page_id_t page_id;
+    run->page_ = buffer_pool_manager_->NewPage(&page_id);
+    if (run->page_ == nullptr) {
+      throw Exception(ExceptionType::OUT_OF_MEMORY, "Cannot allocate a page for a sorted run");
+    }
+    PageCount(run->page_) = 0;
+    run->page_ids_.push_back(page_id);
+  }
+  PageEntries(run->page_)[PageCount(run->page_)++] = entry;
+  run->size_++;
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+void INDEX_ENTRY_SORTER_TYPE::SealRun(Run *run) {
+  if (run->page_ != nullptr) {
+    buffer_pool_manager_->UnpinPage(run->page_->GetPageId(), true);
+    run->page_ = nullptr;
+  }
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+bool INDEX_ENTRY_SORTER_TYPE::FillRun(Run *run) {
+  if (run->page_ != nullptr) {
+    return true;
+  }
+  if (run->next_page_ == run->page_ids_.size()) {
+    return false;
+  }
+  run->page_ = buffer_pool_manager_->FetchPage(run->page_ids_[run->next_page_]);
+  if (run->page_ == nullptr) {
+    throw Exception(ExceptionType::OUT_OF_MEMORY, "Cannot fetch a page of a sorted run");
+  }
+  run->index_ = 0;
+  return true;
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+void INDEX_ENTRY_SORTER_TYPE::AdvanceRun(Run *run) {
+  if (++run->index_ < PageCount(run->page_)) {
+    return;
+  }
+  page_id_t page_id = run->page_->GetPageId();
+  buffer_pool_manager_->UnpinPage(page_id, false);
+  buffer_pool_manager_->DeletePage(page_id);
+  run->page_ = nullptr;
+  run->next_page_++;
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+void INDEX_ENTRY_SORTER_TYPE::DropRun(Run *run) {
+  if (run->page_ != nullptr) {
+    buffer_pool_manager_->UnpinPage(run->page_->GetPageId(), false);
+    run->page_ = nullptr;
+  }
+  for (; run->next_page_ < run->page_ids_.size(); run->next_page_++) {
+    buffer_pool_manager_->DeletePage(run->page_ids_[run->next_page_]);
+  }
+}
+
+template class IndexEntrySorter<GenericKey<4>, RID, GenericComparator<4>>;
+template class IndexEntrySorter<GenericKey<8>, RID, GenericComparator<8>>;
+template class IndexEntrySorter<GenericKey<16>, RID, GenericComparator<16>>;
+template class IndexEntrySorter<GenericKey<32>, RID, GenericComparator<32>>;
+template class IndexEntrySorter<GenericKey<64>, RID, GenericComparator<64>>;
+template class IndexEntrySorter<GenericKey<8>, RID, IntegerComparator<8>>;
+
+}  // namespace bustub
@@ -0,0 +1,130 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// index_factory.cpp
+//
+// Identification: src/storage/index/index_factory.cpp
+//
+// Copyright (c) 2015-2021, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "storage/index/index_factory.h"
+
+#include <string>
+#include <utility>
+
+#include "storage/index/adaptive_radix_tree_index.h"
+#include "storage/index/b_epsilon_tree_index.h"
+#include "storage/index/b_plus_tree_index.h"
+#include "storage/index/extendible_hash_table_index.h"
+#include "storage/index/generic_key.h"
+#include "storage/index/linear_probe_hash_table_index.h"
+#include "storage/index/varlen_b_plus_tree_index.h"
+
+namespace bustub {
+
+namespace {
+
+// whether the key is one BIGINT column, which IntegerComparator compares as a native integer
+bool IsBigIntKey(const IndexMetadata &metadata) {
+  const Schema &key_schema = *metadata.GetKeySchema();
+  return key_schema.GetColumnCount() == 1 && key_schema.GetColumn(0).GetType() == TypeId::BIGINT;
+}
+
+template <size_t N>
+std::unique_ptr<Index> CreateFixedSize(IndexType index_type, std::unique_ptr<IndexMetadata> &&metadata,
+                                       BufferPoolManager *buffer_pool_manager, bool unique_keys) {
+  using KeyType = GenericKey<N>;
+  using KeyComparator = GenericComparator<N>;
+  switch (index_type) {
+    case IndexType::ExtendibleHash:
+      return std::make_unique<ExtendibleHashTableIndex<KeyType, RID, KeyComparator>>(
+          std::move(metadata), buffer_pool_manager, HashFunction<KeyType>{});
+    case IndexType::LinearProbeHash:
+      return std::make_unique<LinearProbeHashTableIndex<KeyType, RID, KeyComparator>>(
+          std::move(metadata), buffer_pool_manager, IndexFactory::LINEAR_PROBE_NUM_BUCKETS, HashFunction<KeyType>{});
+    case IndexType::BPlusTree:
+      if constexpr (N == sizeof(int64_t)) {
+        if (IsBigIntKey(*metadata)) {
+          return std::make_unique<BPlusTreeIndex<KeyType, RID, IntegerComparator<N>>>(
+              std::move(metadata), buffer_pool_manager, unique_keys);
+        }
+      }
+      return std::make_unique<BPlusTreeIndex<KeyType, RID, KeyComparator>>(std::move(metadata), buffer_pool_manager,
+                                                                           unique_keys);
+    case IndexType::BEpsilonTree:
+      return std::make_unique<BEpsilonTreeIndex<KeyType, RID, KeyComparator>>(std::move(metadata),
+                                                                              buffer_pool_manager);
+    default:
+      UNREACHABLE("Not a fixed-size index type");
+  }
+}
+
+}  // namespace
+
+std::unique_ptr<Index> IndexFactory::Create(IndexType index_type, std::unique_ptr<IndexMetadata> &&metadata,
+                                            BufferPoolManager *buffer_pool_manager, bool unique_keys) {
+  // included columns follow the key in a B+ tree's leaf entries; no other type has entries they could go in
+  if (index_type != IndexType::BPlusTree && !metadata->GetIncludeAttrs().empty()) {
+    throw Exception(ExceptionType::NOT_IMPLEMENTED,
+                    "Index " + metadata->GetName() + ": only B+ tree indexes can include columns");
+  }
+  if (index_type == IndexType::AdaptiveRadixTree) {
+    return std::make_unique<AdaptiveRadixTreeIndex>(std::move(metadata));
+  }
+  if (index_type == IndexType::BPlusTree && !metadata->GetKeySchema()->IsInlined()) {
+    // the variable-length B+ tree keeps one RID per key and has no room for included columns
+    if (!unique_keys || !metadata->GetIncludeAttrs().empty()) {
+      throw Exception(ExceptionType::NOT_IMPLEMENTED,
+                      "Index " + metadata->GetName() + ": a B+ tree on a VARCHAR key must be unique, without included "
+                      "columns");
+    }
+    return std::make_unique<VarlenBPlusTreeIndex>(std::move(metadata), buffer_pool_manager);
+  }
+  switch (KeySize(index_type, *metadata)) {
+    case 4:
+      return CreateFixedSize<4>(index_type, std::move(metadata), buffer_pool_manager, unique_keys);
+    case 8:
+      return CreateFixedSize<8>(index_type, std::move(metadata), buffer_pool_manager, unique_keys);
+    case 16:
+      return CreateFixedSize<16>(index_type, std::move(metadata), buffer_pool_manager, unique_keys);
+    case 32:
+      return CreateFixedSize<32>(index_type, std::move(metadata), buffer_pool_manager, unique_keys);
+    default:
+      return CreateFixedSize<64>(index_type, std::move(metadata), buffer_pool_manager, unique_keys);
+  }
+}
+
+size_t IndexFactory::KeySize(IndexType index_type, const IndexMetadata &metadata) {
+  switch (index_type) {
+    case IndexType::AdaptiveRadixTree:
+      return metadata.GetKeySchema()->GetLength();
+    case IndexType::BPlusTree:
+      if (!metadata.GetKeySchema()->IsInlined()) {
+        return metadata.GetKeySchema()->GetLength();
+      }
+      // a leaf entry holds the included columns after the key; Create() rejects them for every other type
+      return FixedKeySize(*metadata.GetEntrySchema());
+    default:
+      return FixedKeySize(*metadata.GetKeySchema());
+  }
+}
+
+size_t IndexFactory::FixedKeySize(const Schema &schema) {
+  // a VARCHAR column's inline slot only points at its data, which GenericKey would copy past its end
+  if (!schema.IsInlined()) {
+    throw Exception(ExceptionType::OUT_OF_RANGE, "Variable-length key does not fit in a fixed-size index");
+  }
+  size_t length = schema.GetLength();
+  for (size_t key_size = 4; key_size <= MAX_KEY_SIZE; key_size *= 2) {
+    if (length <= key_size) {
+      return key_size;
+    }
+  }
+  throw Exception(ExceptionType::OUT_OF_RANGE,
+                  "Key of " + std::to_string(length) + " bytes does not fit in a fixed-size index");
+}
+
+}  // namespace bustub
@@ -2,29 +2,123 @@
  * index_iterator.cpp
  */
 #include <cassert>
+#include <utility>
 
+#include "common/exception.h"
 #include "storage/index/index_iterator.h"
 
 namespace bustub {
 
-/*
- * NOTE: you can change the destructor/constructor method here
- * set your own input parameters
- */
 INDEX_TEMPLATE_ARGUMENTS
 INDEXITERATOR_TYPE::IndexIterator() = default;
 
 INDEX_TEMPLATE_ARGUMENTS
-INDEXITERATOR_TYPE::~IndexIterator() = default;
+INDEXITERATOR_TYPE::IndexIterator(BufferPoolManager *buffer_pool_manager, Page *page, int index)
+    : buffer_pool_manager_(buffer_pool_manager),
+      page_(page),
+      leaf_(reinterpret_cast<LeafPage *>(page->GetData())),
+      index_(index) {
+  LoadEntry();
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+INDEXITERATOR_TYPE::IndexIterator(IndexIterator &&other) noexcept
+    : buffer_pool_manager_(other.buffer_pool_manager_),
+      page_(other.page_),
+      leaf_(other.leaf_),
+      index_(other.index_),
+      entry_(other.entry_),
+      postings_(std::move(other.postings_)),
+      posting_index_(other.posting_index_) {
+  other.page_ = nullptr;
+  other.leaf_ = nullptr;
+  other.index_ = 0;
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+INDEXITERATOR_TYPE &INDEXITERATOR_TYPE::operator=(IndexIterator &&other) noexcept {
+  if (this != &other) {
+    Release();
+    buffer_pool_manager_ = other.buffer_pool_manager_;
+    page_ = other.page_;
+    leaf_ = other.leaf_;
+    index_ = other.index_;
+    entry_ = other.entry_;
+    postings_ = std::move(other.postings_);
+    posting_index_ = other.posting_index_;
+    other.page_ = nullptr;
+    other.leaf_ = nullptr;
+    other.index_ = 0;
+  }
+  return *this;
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+INDEXITERATOR_TYPE::~IndexIterator() { Release(); }
+
+INDEX_TEMPLATE_ARGUMENTS
+bool INDEXITERATOR_TYPE::IsEnd() { return page_ == nullptr; }
 
 INDEX_TEMPLATE_ARGUMENTS
-bool INDEXITERATOR_TYPE::IsEnd() { throw std::runtime_error("unimplemented"); }
+const MappingType &INDEXITERATOR_TYPE::operator*() { return entry_; }
 
 INDEX_TEMPLATE_ARGUMENTS
-const MappingType &INDEXITERATOR_TYPE::operator*() { throw std::runtime_error("unimplemented"); }
+INDEXITERATOR_TYPE &INDEXITERATOR_TYPE::operator++() {
+  if (!postings_.empty() && ++posting_index_ < postings_.size()) {
+    entry_.second = postings_[posting_index_];
+    return *this;
+  }
+  index_++;
+  LoadEntry();
+  return *this;
+}
 
 INDEX_TEMPLATE_ARGUMENTS
-INDEXITERATOR_TYPE &INDEXITERATOR_TYPE::operator++() { throw std::runtime_error("unimplemented"); }
+void INDEXITERATOR_TYPE::LoadEntry() {
+  postings_.clear();
+  while (page_ != nullptr) {
+    // Writers move entries around within the leaf, so it is only read under its latch.
+    page_->RLatch();
+    if (index_ < leaf_->GetSize()) {
+      entry_ = leaf_->GetItem(index_);
+      if (PostingList::IsReference(entry_.second)) {
+        // the list may only be read under the leaf's latch as well
+        try {
+          PostingList::Read(buffer_pool_manager_, entry_.second, &postings_);
+        } catch (const Exception &e) {
+          postings_.clear();
+          page_->RUnlatch();
+          throw;
+        }
+        posting_index_ = 0;
+        entry_.second = postings_[0];
+      }
+      page_->RUnlatch();
+      return;
+    }
+    // Never hold two leaf latches at once: a merge latches leaves right to left.
+    page_id_t next_page_id = leaf_->GetNextPageId();
+    page_->RUnlatch();
+    Release();
+    index_ = 0;
+    if (next_page_id != INVALID_PAGE_ID) {
+      page_ = buffer_pool_manager_->FetchPage(next_page_id);
+      if (page_ == nullptr) {
+        throw Exception(ExceptionType::OUT_OF_MEMORY, "Cannot fetch the next leaf of an index iterator");
+      }
+      leaf_ = reinterpret_cast<LeafPage *>(page_->GetData());
+    }
+  }
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+void INDEXITERATOR_TYPE::Release() {
+  if (page_ != nullptr) {
+    buffer_pool_manager_->UnpinPage(page_->GetPageId(), false);
+    page_ = nullptr;
+    leaf_ = nullptr;
+  }
+}
 
 template class IndexIterator<GenericKey<4>, RID, GenericComparator<4>>;
 
@@ -36,4 +130,6 @@ template class IndexIterator<GenericKey<32>, RID, GenericComparator<32>>;
 
 template class IndexIterator<GenericKey<64>, RID, GenericComparator<64>>;
 
+template class IndexIterator<GenericKey<8>, RID, IntegerComparator<8>>;
+
 }  // namespace bustub
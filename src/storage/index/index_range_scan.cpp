@@ -0,0 +1,240 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// index_range_scan.cpp
+//
+// Identification: src/storage/index/index_range_scan.cpp
+//
+// Copyright (c) 2015-2021, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "storage/index/index_range_scan.h"
+
+#include <algorithm>
+#include <utility>
+
+#include "common/exception.h"
+#include "common/rid.h"
+#include "storage/index/b_plus_tree.h"
+
+namespace bustub {
+
+INDEX_TEMPLATE_ARGUMENTS
+INDEXRANGESCAN_TYPE::IndexRangeScan(Tree *tree, BufferPoolManager *buffer_pool_manager, const KeyComparator &comparator,
+                                    KeyRange<KeyType> range)
+    : tree_(tree), buffer_pool_manager_(buffer_pool_manager), comparator_(comparator), range_(std::move(range)) {}
+
+INDEX_TEMPLATE_ARGUMENTS
+INDEXRANGESCAN_TYPE::IndexRangeScan(IndexRangeScan &&other) noexcept
+    : tree_(other.tree_),
+      buffer_pool_manager_(other.buffer_pool_manager_),
+      comparator_(other.comparator_),
+      range_(std::move(other.range_)),
+      started_(other.started_),
+      done_(other.done_),
+      next_page_(other.next_page_),
+      next_bound_(other.next_bound_),
+      has_next_bound_(other.has_next_bound_),
+      next_version_(other.next_version_),
+      next_fence_(std::move(other.next_fence_)) {
+  other.next_page_ = nullptr;
+  other.done_ = true;
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+INDEXRANGESCAN_TYPE::~IndexRangeScan() {
+  if (next_page_ != nullptr) {
+    buffer_pool_manager_->UnpinPage(next_page_->GetPageId(), false);
+  }
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+bool INDEXRANGESCAN_TYPE::NextBatch(std::vector<MappingType> *batch) {
+  batch->clear();
+  // a leaf may hold no matching entries, e.g. the first one when the range starts at its end
+  while (batch->empty() && !done_) {
+    if (range_.reverse_) {
+      ScanReverse(batch);
+    } else {
+      ScanForward(batch);
+    }
+  }
+  return !batch->empty();
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+void INDEXRANGESCAN_TYPE::ScanForward(std::vector<MappingType> *batch) {
+  Page *page = nullptr;
+  if (started_) {
+    page = next_page_;
+    next_page_ = nullptr;
+    page->RLatch();
+    if (reinterpret_cast<BPlusTreePage *>(page->GetData())->ReadVersion() != next_version_) {
+      // entries may have moved into the leaf on the left, which was already read, so look up the keys after it
+      page->RUnlatch();
+      buffer_pool_manager_->UnpinPage(page->GetPageId(), false);
+      page = nullptr;
+    }
+  }
+  if (page == nullptr) {
+    const KeyType *key = has_next_bound_ ? &next_bound_ : range_.lower_.has_value() ? &*range_.lower_ : nullptr;
+    page = key != nullptr ? tree_->FindLeafPageLatched(*key, false, false)
+                          : tree_->FindLeafPageLatched(KeyType{}, true, false);
+    started_ = true;
+    if (page == nullptr) {
+      done_ = true;
+      return;
+    }
+  }
+
+  auto *leaf = reinterpret_cast<LeafPage *>(page->GetData());
+  int begin = 0;
+  if (range_.lower_.has_value()) {
+    begin = range_.lower_inclusive_ ? leaf->KeyIndex(*range_.lower_, comparator_)
+                                    : leaf->UpperKeyIndex(*range_.lower_, comparator_);
+  }
+  if (has_next_bound_) {
+    begin = std::max(begin, leaf->UpperKeyIndex(next_bound_, comparator_));
+  }
+  int end = leaf->GetSize();
+  if (range_.upper_.has_value()) {
+    int upper_end = range_.upper_inclusive_ ? leaf->UpperKeyIndex(*range_.upper_, comparator_)
+                                            : leaf->KeyIndex(*range_.upper_, comparator_);
+    if (upper_end < end) {
+      end = upper_end;
+      done_ = true;
+    }
+  }
+  if (begin < end) {
+    leaf->CopyRangeTo(begin, end, false, batch);
+    ExpandPostingLists(batch, false);
+  }
+  if (leaf->GetSize() > 0) {
+    next_bound_ = leaf->KeyAt(leaf->GetSize() - 1);
+    has_next_bound_ = true;
+  }
+
+  // Pin the next leaf before handing out this batch, and note its version while this leaf is still latched: nothing
+  // can move entries between the two leaves before then. Never latch the next leaf here, though: a merge latches
+  // leaves right to left.
+  page_id_t next_page_id = leaf->GetNextPageId();
+  if (!done_ && next_page_id != INVALID_PAGE_ID) {
+    next_page_ = buffer_pool_manager_->FetchPage(next_page_id);
+    if (next_page_ == nullptr) {
+      page->RUnlatch();
+      buffer_pool_manager_->UnpinPage(page->GetPageId(), false);
+      throw Exception(ExceptionType::OUT_OF_MEMORY, "Cannot fetch the next leaf of a range scan");
+    }
+    next_version_ = reinterpret_cast<BPlusTreePage *>(next_page_->GetData())->ReadVersion();
+  } else {
+    done_ = true;
+  }
+  page->RUnlatch();
+  buffer_pool_manager_->UnpinPage(page->GetPageId(), false);
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+void INDEXRANGESCAN_TYPE::ScanReverse(std::vector<MappingType> *batch) {
+  Page *page;
+  std::optional<KeyType> fence;
+  const KeyType *bound;
+  bool bound_inclusive;
+  if (!started_) {
+    started_ = true;
+    bound = range_.upper_.has_value() ? &*range_.upper_ : nullptr;
+    bound_inclusive = range_.upper_inclusive_;
+    page = tree_->FindLeafPageReverse(bound, bound_inclusive, &fence);
+  } else {
+    bound = &next_bound_;
+    bound_inclusive = false;
+    page = next_page_;
+    next_page_ = nullptr;
+    page->RLatch();
+    if (reinterpret_cast<BPlusTreePage *>(page->GetData())->ReadVersion() == next_version_) {
+      fence = std::move(next_fence_);
+    } else {
+      // the leaf changed since it was prefetched, so its entries below the bound may live elsewhere by now
+      page->RUnlatch();
+      buffer_pool_manager_->UnpinPage(page->GetPageId(), false);
+      page = tree_->FindLeafPageReverse(bound, false, &fence);
+    }
+  }
+  if (page == nullptr) {
+    done_ = true;
+    return;
+  }
+
+  auto *leaf = reinterpret_cast<LeafPage *>(page->GetData());
+  int end = leaf->GetSize();
+  if (bound != nullptr) {
+    end = bound_inclusive ? leaf->UpperKeyIndex(*bound, comparator_) : leaf->KeyIndex(*bound, comparator_);
+  }
+  int begin = 0;
+  if (range_.lower_.has_value()) {
+    begin = range_.lower_inclusive_ ? leaf->KeyIndex(*range_.lower_, comparator_)
+                                    : leaf->UpperKeyIndex(*range_.lower_, comparator_);
+    done_ = begin > 0;
+  }
+  if (begin < end) {
+    leaf->CopyRangeTo(begin, end, true, batch);
+    ExpandPostingLists(batch, true);
+  }
+  page->RUnlatch();
+  buffer_pool_manager_->UnpinPage(page->GetPageId(), false);
+
+  // every key in the leaves to the left is below the fence, so stop once the fence is at or below the lower bound
+  if (!fence.has_value() || (range_.lower_.has_value() && comparator_(*fence, *range_.lower_) <= 0)) {
+    done_ = true;
+  }
+  if (!done_) {
+    next_bound_ = *fence;
+    PrefetchReverse();
+  }
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+void INDEXRANGESCAN_TYPE::PrefetchReverse() {
+  next_page_ = tree_->FindLeafPageReverse(&next_bound_, false, &next_fence_);
+  if (next_page_ == nullptr) {
+    done_ = true;
+    return;
+  }
+  next_version_ = reinterpret_cast<BPlusTreePage *>(next_page_->GetData())->ReadVersion();
+  next_page_->RUnlatch();
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+void INDEXRANGESCAN_TYPE::ExpandPostingLists(std::vector<MappingType> *batch, bool reverse) {
+  auto is_reference = [](const MappingType &entry) { return PostingList::IsReference(entry.second); };
+  if (tree_->unique_keys_ || std::none_of(batch->begin(), batch->end(), is_reference)) {
+    return;
+  }
+  std::vector<MappingType> entries;
+  entries.swap(*batch);
+  std::vector<RID> rids;
+  for (const auto &entry : entries) {
+    if (!is_reference(entry)) {
+      batch->push_back(entry);
+      continue;
+    }
+    rids.clear();
+    PostingList::Read(buffer_pool_manager_, entry.second, &rids);
+    if (reverse) {
+      std::reverse(rids.begin(), rids.end());
+    }
+    for (const auto &rid : rids) {
+      batch->emplace_back(entry.first, rid);
+    }
+  }
+}
+
+template class IndexRangeScan<GenericKey<4>, RID, GenericComparator<4>>;
+template class IndexRangeScan<GenericKey<8>, RID, GenericComparator<8>>;
+template class IndexRangeScan<GenericKey<16>, RID, GenericComparator<16>>;
+template class IndexRangeScan<GenericKey<32>, RID, GenericComparator<32>>;
+template class IndexRangeScan<GenericKey<64>, RID, GenericComparator<64>>;
+template class IndexRangeScan<GenericKey<8>, RID, IntegerComparator<8>>;
+
+}  // namespace bustub
@@ -0,0 +1,96 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// key_encoder.cpp
+//
+// Identification: src/storage/index/key_encoder.cpp
+//
+// Copyright (c) 2015-2021, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "storage/index/key_encoder.h"
+
+#include <cstring>
+
+#include "common/exception.h"
+
+namespace bustub {
+
+namespace {
+
+/** Appends the low "bytes" bytes of value, most significant first. */
+void AppendBigEndian(uint64_t value, size_t bytes, std::string *out) {
+  for (size_t i = bytes; i > 0; i--) {
+    out->push_back(static_cast<char>((value >> ((i - 1) * 8)) & 0xFF));
+  }
+}
+
+template <typename T>
+void AppendSigned(T value, std::string *out) {
+  constexpr size_t bytes = sizeof(T);
+  constexpr uint64_t sign_bit = 1ULL << (bytes * 8 - 1);
+  AppendBigEndian(static_cast<uint64_t>(static_cast<int64_t>(value)) ^ sign_bit, bytes, out);
+}
+
+}  // namespace
+
+std::string KeyEncoder::Encode(const Tuple &key) const {
+  std::string out;
+  for (uint32_t i = 0; i < key_schema_->GetColumnCount(); i++) {
+    AppendValue(key.GetValue(key_schema_, i), &out);
+  }
+  return out;
+}
+
+void KeyEncoder::AppendValue(const Value &value, std::string *out) {
+  if (value.IsNull()) {
+    out->push_back('\0');
+    return;
+  }
+  out->push_back('\1');
+  switch (value.GetTypeId()) {
+    case TypeId::BOOLEAN:
+    case TypeId::TINYINT:
+      AppendSigned(value.GetAs<int8_t>(), out);
+      break;
+    case TypeId::SMALLINT:
+      AppendSigned(value.GetAs<int16_t>(), out);
+      break;
+    case TypeId::INTEGER:
+      AppendSigned(value.GetAs<int32_t>(), out);
+      break;
+    case TypeId::BIGINT:
+      AppendSigned(value.GetAs<int64_t>(), out);
+      break;
+    case TypeId::DECIMAL: {
+      auto decimal = value.GetAs<double>();
+      uint64_t bits;
+      memcpy(&bits, &decimal, sizeof(bits));
+      bits = (bits >> 63) != 0 ? ~bits : bits | (1ULL << 63);
+      AppendBigEndian(bits, sizeof(bits), out);
+      break;
+    }
+    case TypeId::TIMESTAMP:
+      AppendBigEndian(value.GetAs<uint64_t>(), sizeof(uint64_t), out);
+      break;
+    case TypeId::VARCHAR: {
+      // the stored length counts the trailing '\0'
+      const char *data = value.GetData();
+      uint32_t length = value.GetLength() - 1;
+      for (uint32_t i = 0; i < length; i++) {
+        out->push_back(data[i]);
+        if (data[i] == '\0') {
+          out->push_back('\xFF');
+        }
+      }
+      out->append(2, '\0');
+      break;
+    }
+    default:
+      throw Exception(ExceptionType::UNKNOWN_TYPE, "cannot encode an index key of this type");
+  }
+}
+
+}  // namespace bustub
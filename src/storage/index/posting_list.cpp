@@ -0,0 +1,205 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// posting_list.cpp
+//
+// Identification: src/storage/index/posting_list.cpp
+//
+// Copyright (c) 2015-2021, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "storage/index/posting_list.h"
+
+#include <algorithm>
+#include <cstring>
+
+#include "common/exception.h"
+
+namespace bustub {
+
+namespace {
+
+BPlusTreePostingPage *AsPosting(Page *page) { return reinterpret_cast<BPlusTreePostingPage *>(page->GetData()); }
+
+bool RidLess(const RID &lhs, const RID &rhs) { return lhs.Get() < rhs.Get(); }
+
+}  // namespace
+
+RID PostingList::Create(BufferPoolManager *buffer_pool_manager, const std::vector<RID> &rids) {
+  page_id_t head_page_id;
+  Page *page = NewPage(buffer_pool_manager, &head_page_id);
+  AsPosting(page)->Init();
+  AsPosting(page)->SetListSize(static_cast<uint32_t>(rids.size()));
+  size_t written = AsPosting(page)->Encode(rids.data(), rids.data() + rids.size());
+  while (written < rids.size()) {
+    page_id_t next_page_id;
+    Page *next_page = NewPage(buffer_pool_manager, &next_page_id);
+    AsPosting(next_page)->Init();
+    written += AsPosting(next_page)->Encode(rids.data() + written, rids.data() + rids.size());
+    AsPosting(page)->SetNextPageId(next_page_id);
+    buffer_pool_manager->UnpinPage(page->GetPageId(), true);
+    page = next_page;
+  }
+  buffer_pool_manager->UnpinPage(page->GetPageId(), true);
+  return MakeReference(head_page_id);
+}
+
+bool PostingList::Insert(BufferPoolManager *buffer_pool_manager, const RID &reference, const RID &rid) {
+  Page *head = FetchPage(buffer_pool_manager, reference.GetPageId());
+  // the RID belongs on the first page whose last RID is not smaller, or at the end of the last page
+  Page *page = head;
+  while (AsPosting(page)->GetLast().Get() < rid.Get() && AsPosting(page)->GetNextPageId() != INVALID_PAGE_ID) {
+    Page *next_page = FetchPage(buffer_pool_manager, AsPosting(page)->GetNextPageId());
+    if (page != head) {
+      buffer_pool_manager->UnpinPage(page->GetPageId(), false);
+    }
+    page = next_page;
+  }
+  auto *posting = AsPosting(page);
+
+  std::vector<RID> rids;
+  rids.reserve(posting->GetSize() + 1);
+  posting->Decode(&rids);
+  auto position = std::lower_bound(rids.begin(), rids.end(), rid, RidLess);
+  bool inserted = position == rids.end() || !(*position == rid);
+  if (inserted) {
+    bool append = position == rids.end() && posting->GetNextPageId() == INVALID_PAGE_ID;
+    rids.insert(position, rid);
+    size_t written = posting->Encode(rids.data(), rids.data() + rids.size());
+    if (written < rids.size()) {
+      // Appends keep the page full and start a new one; anywhere else, split in half so that the next inserts fit.
+      if (!append) {
+        written = rids.size() / 2;
+        posting->Encode(rids.data(), rids.data() + written);
+      }
+      page_id_t new_page_id;
+      Page *new_page = NewPage(buffer_pool_manager, &new_page_id);
+      AsPosting(new_page)->Init();
+      // at most half a page plus one RID, which always fits
+      AsPosting(new_page)->Encode(rids.data() + written, rids.data() + rids.size());
+      AsPosting(new_page)->SetNextPageId(posting->GetNextPageId());
+      posting->SetNextPageId(new_page_id);
+      buffer_pool_manager->UnpinPage(new_page_id, true);
+    }
+    AsPosting(head)->SetListSize(AsPosting(head)->GetListSize() + 1);
+  }
+
+  if (page != head) {
+    buffer_pool_manager->UnpinPage(page->GetPageId(), inserted);
+  }
+  buffer_pool_manager->UnpinPage(head->GetPageId(), inserted);
+  return inserted;
+}
+
+bool PostingList::Remove(BufferPoolManager *buffer_pool_manager, const RID &reference, const RID &rid,
+                         std::optional<RID> *only_rid) {
+  Page *head = FetchPage(buffer_pool_manager, reference.GetPageId());
+  // keep the previous page pinned as well, to unlink the page if it ends up empty
+  Page *previous = nullptr;
+  Page *page = head;
+  while (AsPosting(page)->GetLast().Get() < rid.Get() && AsPosting(page)->GetNextPageId() != INVALID_PAGE_ID) {
+    Page *next_page = FetchPage(buffer_pool_manager, AsPosting(page)->GetNextPageId());
+    if (previous != nullptr && previous != head) {
+      buffer_pool_manager->UnpinPage(previous->GetPageId(), false);
+    }
+    previous = page;
+    page = next_page;
+  }
+  auto unpin_path = [&](bool is_dirty) {
+    if (previous != nullptr && previous != head) {
+      buffer_pool_manager->UnpinPage(previous->GetPageId(), is_dirty);
+    }
+    if (page != head) {
+      buffer_pool_manager->UnpinPage(page->GetPageId(), is_dirty);
+    }
+  };
+  auto *posting = AsPosting(page);
+
+  std::vector<RID> rids;
+  posting->Decode(&rids);
+  auto position = std::lower_bound(rids.begin(), rids.end(), rid, RidLess);
+  if (position == rids.end() || !(*position == rid)) {
+    unpin_path(false);
+    buffer_pool_manager->UnpinPage(head->GetPageId(), false);
+    return false;
+  }
+  rids.erase(position);
+
+  uint32_t list_size = AsPosting(head)->GetListSize() - 1;
+  if (list_size == 1) {
+    // fold the list back into the leaf
+    unpin_path(false);
+    buffer_pool_manager->UnpinPage(head->GetPageId(), false);
+    std::vector<RID> remaining;
+    Read(buffer_pool_manager, reference, &remaining);
+    Free(buffer_pool_manager, reference);
+    *only_rid = remaining[0] == rid ? remaining[1] : remaining[0];
+    return true;
+  }
+
+  if (!rids.empty()) {
+    // dropping a RID never makes the encoding longer
+    posting->Encode(rids.data(), rids.data() + rids.size());
+    unpin_path(true);
+  } else if (page == head) {
+    // the first page must stay put, so it takes over the contents of the second one
+    page_id_t next_page_id = posting->GetNextPageId();
+    Page *next_page = FetchPage(buffer_pool_manager, next_page_id);
+    std::memcpy(head->GetData(), next_page->GetData(), PAGE_SIZE);
+    buffer_pool_manager->UnpinPage(next_page_id, false);
+    buffer_pool_manager->DeletePage(next_page_id);
+  } else {
+    AsPosting(previous)->SetNextPageId(posting->GetNextPageId());
+    if (previous != head) {
+      buffer_pool_manager->UnpinPage(previous->GetPageId(), true);
+    }
+    page_id_t page_id = page->GetPageId();
+    buffer_pool_manager->UnpinPage(page_id, false);
+    buffer_pool_manager->DeletePage(page_id);
+  }
+  AsPosting(head)->SetListSize(list_size);
+  buffer_pool_manager->UnpinPage(head->GetPageId(), true);
+  return true;
+}
+
+void PostingList::Read(BufferPoolManager *buffer_pool_manager, const RID &reference, std::vector<RID> *rids) {
+  page_id_t page_id = reference.GetPageId();
+  while (page_id != INVALID_PAGE_ID) {
+    Page *page = FetchPage(buffer_pool_manager, page_id);
+    AsPosting(page)->Decode(rids);
+    page_id_t next_page_id = AsPosting(page)->GetNextPageId();
+    buffer_pool_manager->UnpinPage(page_id, false);
+    page_id = next_page_id;
+  }
+}
+
+void PostingList::Free(BufferPoolManager *buffer_pool_manager, const RID &reference) {
+  page_id_t page_id = reference.GetPageId();
+  while (page_id != INVALID_PAGE_ID) {
+    Page *page = FetchPage(buffer_pool_manager, page_id);
+    page_id_t next_page_id = AsPosting(page)->GetNextPageId();
+    buffer_pool_manager->UnpinPage(page_id, false);
+    buffer_pool_manager->DeletePage(page_id);
+    page_id = next_page_id;
+  }
+}
+
+Page *PostingList::FetchPage(BufferPoolManager *buffer_pool_manager, page_id_t page_id) {
+  Page *page = buffer_pool_manager->FetchPage(page_id);
+  if (page == nullptr) {
+    throw Exception(ExceptionType::OUT_OF_MEMORY, "Cannot fetch posting list page");
+  }
+  return page;
+}
+
+Page *PostingList::NewPage(BufferPoolManager *buffer_pool_manager, page_id_t *page_id) {
+  Page *page = buffer_pool_manager->NewPage(page_id);
+  if (page == nullptr) {
+    throw Exception(ExceptionType::OUT_OF_MEMORY, "Cannot allocate posting list page");
+  }
+  return page;
+}
+
+}  // namespace bustub
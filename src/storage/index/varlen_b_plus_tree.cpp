@@ -0,0 +1,383 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// varlen_b_plus_tree.cpp
+//
+// Identification: src/storage/index/varlen_b_plus_tree.cpp
+//
+// Copyright (c) 2015-2021, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "storage/index/varlen_b_plus_tree.h"
+
+#include <algorithm>
+
+#include "common/exception.h"
+#include "storage/page/header_page.h"
+
+namespace bustub {
+
+namespace {
+
+/** @return the shortest key that is > left and <= right, for left < right */
+std::string ShortestSeparator(const std::string &left, const std::string &right) {
+  size_t common = 0;
+  while (common < left.size() && common < right.size() && left[common] == right[common]) {
+    common++;
+  }
+  return right.substr(0, common + 1);
+}
+
+/** @return the index in [1, size - 1] that splits the entries' key bytes closest to evenly */
+template <typename Entries>
+size_t SplitPoint(const Entries &entries) {
+  size_t total = 0;
+  for (const auto &entry : entries) {
+    total += entry.first.size();
+  }
+  size_t bytes = 0;
+  size_t mid = 0;
+  while (mid < entries.size() && bytes * 2 < total) {
+    bytes += entries[mid++].first.size();
+  }
+  return std::clamp<size_t>(mid, 1, entries.size() - 1);
+}
+
+}  // namespace
+
+VarlenBPlusTree::VarlenBPlusTree(std::string name, BufferPoolManager *buffer_pool_manager)
+    : index_name_(std::move(name)), root_page_id_(INVALID_PAGE_ID), buffer_pool_manager_(buffer_pool_manager) {}
+
+bool VarlenBPlusTree::IsEmpty() const { return root_page_id_ == INVALID_PAGE_ID; }
+
+/*****************************************************************************
+ * SEARCH
+ *****************************************************************************/
+bool VarlenBPlusTree::GetValue(std::string_view key, std::vector<RID> *result) {
+  latch_.RLock();
+  bool found = false;
+  if (root_page_id_ != INVALID_PAGE_ID) {
+    Page *page = FindLeafPage(key, nullptr);
+    auto *leaf = reinterpret_cast<LeafPage *>(page->GetData());
+    int index = leaf->LowerBound(key);
+    if (index < leaf->GetSize() && leaf->KeyAt(index) == key) {
+      result->push_back(leaf->ValueAt(index));
+      found = true;
+    }
+    buffer_pool_manager_->UnpinPage(page->GetPageId(), false);
+  }
+  latch_.RUnlock();
+  return found;
+}
+
+void VarlenBPlusTree::Scan(std::string_view begin_key,
+                           const std::function<bool(std::string_view key, const RID &value)> &callback) {
+  latch_.RLock();
+  if (root_page_id_ != INVALID_PAGE_ID) {
+    Page *page = FindLeafPage(begin_key, nullptr);
+    int index = reinterpret_cast<LeafPage *>(page->GetData())->LowerBound(begin_key);
+    bool more = true;
+    while (more) {
+      auto *leaf = reinterpret_cast<LeafPage *>(page->GetData());
+      for (; more && index < leaf->GetSize(); index++) {
+        more = callback(leaf->KeyAt(index), leaf->ValueAt(index));
+      }
+      page_id_t next_page_id = leaf->GetNextPageId();
+      buffer_pool_manager_->UnpinPage(page->GetPageId(), false);
+      if (!more || next_page_id == INVALID_PAGE_ID) {
+        break;
+      }
+      page = buffer_pool_manager_->FetchPage(next_page_id);
+      index = 0;
+    }
+  }
+  latch_.RUnlock();
+}
+
+int VarlenBPlusTree::GetHeight() {
+  latch_.RLock();
+  int height = 0;
+  page_id_t page_id = root_page_id_;
+  while (page_id != INVALID_PAGE_ID) {
+    height++;
+    Page *page = buffer_pool_manager_->FetchPage(page_id);
+    auto *node = reinterpret_cast<BPlusTreePage *>(page->GetData());
+    page_id = node->IsLeafPage() ? INVALID_PAGE_ID : reinterpret_cast<InternalPage *>(node)->ValueAt(0);
+    buffer_pool_manager_->UnpinPage(page->GetPageId(), false);
+  }
+  latch_.RUnlock();
+  return height;
+}
+
+Page *VarlenBPlusTree::FindLeafPage(std::string_view key, std::vector<PathEntry> *path) {
+  Page *page = buffer_pool_manager_->FetchPage(root_page_id_);
+  auto *node = reinterpret_cast<BPlusTreePage *>(page->GetData());
+  while (!node->IsLeafPage()) {
+    auto *internal = reinterpret_cast<InternalPage *>(node);
+    int child_index = internal->UpperBound(key, 1) - 1;
+    Page *child_page = buffer_pool_manager_->FetchPage(internal->ValueAt(child_index));
+    if (path != nullptr) {
+      path->push_back({page, child_index});
+    } else {
+      buffer_pool_manager_->UnpinPage(page->GetPageId(), false);
+    }
+    page = child_page;
+    node = reinterpret_cast<BPlusTreePage *>(page->GetData());
+  }
+  return page;
+}
+
+/*****************************************************************************
+ * INSERTION
+ *****************************************************************************/
+bool VarlenBPlusTree::Insert(std::string_view key, const RID &value) {
+  if (key.size() > LeafPage::MAX_KEY_SIZE) {
+    throw Exception(ExceptionType::OUT_OF_RANGE, "index key is too long");
+  }
+  latch_.WLock();
+  bool inserted = InsertLocked(key, value);
+  latch_.WUnlock();
+  return inserted;
+}
+
+bool VarlenBPlusTree::InsertLocked(std::string_view key, const RID &value) {
+  if (root_page_id_ == INVALID_PAGE_ID) {
+    Page *page = buffer_pool_manager_->NewPage(&root_page_id_);
+    if (page == nullptr) {
+      throw Exception(ExceptionType::OUT_OF_MEMORY, "out of memory");
+    }
+    reinterpret_cast<LeafPage *>(page->GetData())->Init(root_page_id_, IndexPageType::LEAF_PAGE);
+    UpdateRootPageId(1);
+    buffer_pool_manager_->UnpinPage(root_page_id_, true);
+  }
+
+  std::vector<PathEntry> path;
+  Page *page = FindLeafPage(key, &path);
+  auto *leaf = reinterpret_cast<LeafPage *>(page->GetData());
+  int index = leaf->LowerBound(key);
+  if (index < leaf->GetSize() && leaf->KeyAt(index) == key) {
+    buffer_pool_manager_->UnpinPage(page->GetPageId(), false);
+    UnpinPath(path, false);
+    return false;
+  }
+
+  if (!leaf->Insert(index, key, value)) {
+    auto [separator, right_page] = SplitLeaf(page);
+    auto *target = key < separator ? leaf : reinterpret_cast<LeafPage *>(right_page->GetData());
+    [[maybe_unused]] bool inserted = target->Insert(target->LowerBound(key), key, value);
+    BUSTUB_ASSERT(inserted, "a freshly split leaf must have room for one more key");
+    InsertIntoParent(path, path.size(), page, separator, right_page);
+  }
+  buffer_pool_manager_->UnpinPage(page->GetPageId(), true);
+  UnpinPath(path, true);
+  return true;
+}
+
+std::pair<std::string, Page *> VarlenBPlusTree::SplitLeaf(Page *page) {
+  auto *leaf = reinterpret_cast<LeafPage *>(page->GetData());
+  auto entries = leaf->GetEntries();
+  size_t mid = SplitPoint(entries);
+  std::string separator = ShortestSeparator(entries[mid - 1].first, entries[mid].first);
+
+  page_id_t right_page_id;
+  Page *right_page = buffer_pool_manager_->NewPage(&right_page_id);
+  if (right_page == nullptr) {
+    throw Exception(ExceptionType::OUT_OF_MEMORY, "out of memory");
+  }
+  auto *right = reinterpret_cast<LeafPage *>(right_page->GetData());
+  right->Init(right_page_id, IndexPageType::LEAF_PAGE);
+  right->Rebuild(separator, leaf->GetUpperFence(), LeafPage::Entries(entries.begin() + mid, entries.end()));
+  right->SetNextPageId(leaf->GetNextPageId());
+  leaf->Rebuild(leaf->GetLowerFence(), separator, LeafPage::Entries(entries.begin(), entries.begin() + mid));
+  leaf->SetNextPageId(right_page_id);
+  return {separator, right_page};
+}
+
+void VarlenBPlusTree::InsertIntoParent(const std::vector<PathEntry> &path, size_t level, Page *left,
+                                       const std::string &separator, Page *right) {
+  if (level == 0) {
+    // left was the root
+    page_id_t root_page_id;
+    Page *root_page = buffer_pool_manager_->NewPage(&root_page_id);
+    if (root_page == nullptr) {
+      throw Exception(ExceptionType::OUT_OF_MEMORY, "out of memory");
+    }
+    auto *root = reinterpret_cast<InternalPage *>(root_page->GetData());
+    root->Init(root_page_id, IndexPageType::INTERNAL_PAGE);
+    root->Rebuild("", std::nullopt, {{"", left->GetPageId()}, {separator, right->GetPageId()}});
+    root_page_id_ = root_page_id;
+    UpdateRootPageId();
+    buffer_pool_manager_->UnpinPage(root_page_id, true);
+    buffer_pool_manager_->UnpinPage(right->GetPageId(), true);
+    return;
+  }
+
+  Page *parent_page = path[level - 1].page_;
+  auto *parent = reinterpret_cast<InternalPage *>(parent_page->GetData());
+  int index = path[level - 1].child_index_ + 1;
+  if (parent->Insert(index, separator, right->GetPageId())) {
+    buffer_pool_manager_->UnpinPage(right->GetPageId(), true);
+    return;
+  }
+  buffer_pool_manager_->UnpinPage(right->GetPageId(), true);
+
+  // Split the parent with the new separator already in place. The middle key moves up; it becomes the unused
+  // first key of the new right page, so it is not stored there.
+  auto entries = parent->GetEntries();
+  entries.emplace(entries.begin() + index, separator, right->GetPageId());
+  size_t mid = SplitPoint(entries);
+  std::string push_up = std::move(entries[mid].first);
+  entries[mid].first.clear();
+
+  page_id_t sibling_page_id;
+  Page *sibling_page = buffer_pool_manager_->NewPage(&sibling_page_id);
+  if (sibling_page == nullptr) {
+    throw Exception(ExceptionType::OUT_OF_MEMORY, "out of memory");
+  }
+  auto *sibling = reinterpret_cast<InternalPage *>(sibling_page->GetData());
+  sibling->Init(sibling_page_id, IndexPageType::INTERNAL_PAGE);
+  sibling->Rebuild(push_up, parent->GetUpperFence(), InternalPage::Entries(entries.begin() + mid, entries.end()));
+  parent->Rebuild(parent->GetLowerFence(), push_up, InternalPage::Entries(entries.begin(), entries.begin() + mid));
+  InsertIntoParent(path, level - 1, parent_page, push_up, sibling_page);
+}
+
+/*****************************************************************************
+ * REMOVE
+ *****************************************************************************/
+void VarlenBPlusTree::Remove(std::string_view key) {
+  latch_.WLock();
+  if (root_page_id_ == INVALID_PAGE_ID) {
+    latch_.WUnlock();
+    return;
+  }
+  std::vector<PathEntry> path;
+  Page *page = FindLeafPage(key, &path);
+  auto *leaf = reinterpret_cast<LeafPage *>(page->GetData());
+  int index = leaf->LowerBound(key);
+  bool found = index < leaf->GetSize() && leaf->KeyAt(index) == key;
+  std::vector<page_id_t> deleted;
+  if (found) {
+    leaf->Remove(index);
+    HandleUnderflow(path, path.size(), page, &deleted);
+  }
+  buffer_pool_manager_->UnpinPage(page->GetPageId(), found);
+  UnpinPath(path, found);
+  for (auto page_id : deleted) {
+    buffer_pool_manager_->DeletePage(page_id);
+  }
+  latch_.WUnlock();
+}
+
+void VarlenBPlusTree::HandleUnderflow(const std::vector<PathEntry> &path, size_t level, Page *page,
+                                      std::vector<page_id_t> *deleted) {
+  auto *node = reinterpret_cast<BPlusTreePage *>(page->GetData());
+  if (level == 0) {
+    // the root shrinks only once it is an empty leaf or an internal page with a single child
+    if (node->IsLeafPage() && node->GetSize() == 0) {
+      root_page_id_ = INVALID_PAGE_ID;
+    } else if (!node->IsLeafPage() && node->GetSize() == 1) {
+      root_page_id_ = reinterpret_cast<InternalPage *>(node)->ValueAt(0);
+    } else {
+      return;
+    }
+    UpdateRootPageId();
+    deleted->push_back(page->GetPageId());
+    return;
+  }
+  bool underflow = node->IsLeafPage() ? reinterpret_cast<LeafPage *>(node)->GetUsedBytes() < PAGE_SIZE / 4
+                                      : reinterpret_cast<InternalPage *>(node)->GetUsedBytes() < PAGE_SIZE / 4;
+  if (!underflow) {
+    return;
+  }
+
+  // merge the right one of the node and a sibling into the left one
+  Page *parent_page = path[level - 1].page_;
+  auto *parent = reinterpret_cast<InternalPage *>(parent_page->GetData());
+  int child_index = path[level - 1].child_index_;
+  int right_index = child_index + 1 < parent->GetSize() ? child_index + 1 : child_index;
+  if (right_index == 0) {
+    return;
+  }
+  Page *sibling_page = buffer_pool_manager_->FetchPage(parent->ValueAt(right_index == child_index ? right_index - 1
+                                                                                                  : right_index));
+  Page *left_page = right_index == child_index ? sibling_page : page;
+  Page *right_page = right_index == child_index ? page : sibling_page;
+
+  bool merged = false;
+  if (node->IsLeafPage()) {
+    auto *left = reinterpret_cast<LeafPage *>(left_page->GetData());
+    auto *right = reinterpret_cast<LeafPage *>(right_page->GetData());
+    auto entries = left->GetEntries();
+    auto right_entries = right->GetEntries();
+    entries.insert(entries.end(), right_entries.begin(), right_entries.end());
+    std::string lower = left->GetLowerFence();
+    auto upper = right->GetUpperFence();
+    if (LeafPage::BytesNeeded(lower, upper, entries) <= PAGE_SIZE) {
+      left->Rebuild(lower, upper, entries);
+      left->SetNextPageId(right->GetNextPageId());
+      merged = true;
+    }
+  } else {
+    // the separator comes down as the key of the right page's first child
+    auto *left = reinterpret_cast<InternalPage *>(left_page->GetData());
+    auto *right = reinterpret_cast<InternalPage *>(right_page->GetData());
+    auto entries = left->GetEntries();
+    auto right_entries = right->GetEntries();
+    right_entries[0].first = parent->KeyAt(right_index);
+    entries.insert(entries.end(), right_entries.begin(), right_entries.end());
+    std::string lower = left->GetLowerFence();
+    auto upper = right->GetUpperFence();
+    if (InternalPage::BytesNeeded(lower, upper, entries) <= PAGE_SIZE) {
+      left->Rebuild(lower, upper, entries);
+      merged = true;
+    }
+  }
+  buffer_pool_manager_->UnpinPage(sibling_page->GetPageId(), merged);
+  if (!merged) {
+    return;
+  }
+  deleted->push_back(right_page->GetPageId());
+  parent->Remove(right_index);
+  HandleUnderflow(path, level - 1, parent_page, deleted);
+}
+
+/*****************************************************************************
+ * UTILITIES
+ *****************************************************************************/
+void VarlenBPlusTree::UnpinPath(const std::vector<PathEntry> &path, bool is_dirty) {
+  for (const auto &entry : path) {
+    buffer_pool_manager_->UnpinPage(entry.page_->GetPageId(), is_dirty);
+  }
+}
+
+/*
+ * Update/Insert root page id in header page(where page_id = 0, header_page is
+ * defined under include/page/header_page.h)
+ * Call this method everytime root page id is changed.
+ * @parameter: insert_record      defualt value is false. When set to true,
+ * insert a record<index_name, root_page_id> into header page instead of
+ * updating it.
+ */
+void VarlenBPlusTree::UpdateRootPageId(int insert_record) {
+  if (header_record_.GetPageId() != INVALID_PAGE_ID &&
+      HeaderPage::UpdateRecordAt(buffer_pool_manager_, header_record_, index_name_, root_page_id_)) {
+    return;
+  }
+  auto *header_page = static_cast<HeaderPage *>(buffer_pool_manager_->FetchPage(HEADER_PAGE_ID));
+  if (insert_record != 0) {
+    header_page->WLatch();
+    if (!header_page->InsertRecord(buffer_pool_manager_, index_name_, root_page_id_, &header_record_)) {
+      header_page->UpdateRecord(buffer_pool_manager_, index_name_, root_page_id_, &header_record_);
+    }
+    header_page->WUnlatch();
+  } else {
+    header_page->RLatch();
+    header_page->UpdateRecord(buffer_pool_manager_, index_name_, root_page_id_, &header_record_);
+    header_page->RUnlatch();
+  }
+  buffer_pool_manager_->UnpinPage(HEADER_PAGE_ID, insert_record != 0);
+}
+
+}  // namespace bustub
@@ -0,0 +1,37 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// varlen_b_plus_tree_index.cpp
+//
+// Identification: src/storage/index/varlen_b_plus_tree_index.cpp
+//
+// Copyright (c) 2015-2021, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "storage/index/varlen_b_plus_tree_index.h"
+
+namespace bustub {
+/*
+ * Constructor
+ */
+VarlenBPlusTreeIndex::VarlenBPlusTreeIndex(std::unique_ptr<IndexMetadata> &&metadata,
+                                           BufferPoolManager *buffer_pool_manager)
+    : Index(std::move(metadata)),
+      encoder_(GetMetadata()->GetKeySchema()),
+      container_(GetMetadata()->GetName(), buffer_pool_manager) {}
+
+void VarlenBPlusTreeIndex::InsertEntry(const Tuple &key, RID rid, Transaction *transaction) {
+  container_.Insert(encoder_.Encode(key), rid);
+}
+
+void VarlenBPlusTreeIndex::DeleteEntry(const Tuple &key, RID rid, Transaction *transaction) {
+  container_.Remove(encoder_.Encode(key));
+}
+
+void VarlenBPlusTreeIndex::ScanKey(const Tuple &key, std::vector<RID> *result, Transaction *transaction) {
+  container_.GetValue(encoder_.Encode(key), result);
+}
+
+}  // namespace bustub
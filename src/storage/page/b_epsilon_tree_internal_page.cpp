@@ -0,0 +1,136 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// b_epsilon_tree_internal_page.cpp
+//
+// Identification: src/storage/page/b_epsilon_tree_internal_page.cpp
+//
+// Copyright (c) 2015-2021, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "storage/page/b_epsilon_tree_internal_page.h"
+
+#include <algorithm>
+
+#include "common/rid.h"
+#include "storage/index/generic_key.h"
+
+namespace bustub {
+
+INDEX_TEMPLATE_ARGUMENTS
+void B_EPSILON_TREE_INTERNAL_PAGE_TYPE::Init(page_id_t page_id, int max_size, int max_messages) {
+  SetPageType(IndexPageType::INTERNAL_PAGE);
+  SetSize(0);
+  SetPageId(page_id);
+  SetParentPageId(INVALID_PAGE_ID);
+  SetMaxSize(max_size);
+  num_messages_ = 0;
+  max_messages_ = max_messages;
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+int B_EPSILON_TREE_INTERNAL_PAGE_TYPE::ChildIndex(const KeyType &key, const ValueType &value,
+                                                  const KeyComparator &comparator) const {
+  // the last child whose pivot is not greater than the entry
+  auto *pivot = std::upper_bound(children_ + 1, children_ + GetSize(), MappingType(key, value),
+                                 [&comparator](const MappingType &entry, const auto &child) {
+                                   return CompareEntries(entry.first, entry.second, child.first.first,
+                                                         child.first.second, comparator) < 0;
+                                 });
+  return static_cast<int>(pivot - children_) - 1;
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+std::pair<int, int> B_EPSILON_TREE_INTERNAL_PAGE_TYPE::ChildRange(const KeyType &key,
+                                                                 const KeyComparator &comparator) const {
+  // from the last child whose pivot key is smaller than key to the last one whose pivot key is not greater
+  auto *first = std::lower_bound(
+      children_ + 1, children_ + GetSize(), key,
+      [&comparator](const auto &child, const KeyType &k) { return comparator(child.first.first, k) < 0; });
+  auto *last = std::upper_bound(
+      first, children_ + GetSize(), key,
+      [&comparator](const KeyType &k, const auto &child) { return comparator(k, child.first.first) < 0; });
+  return {static_cast<int>(first - children_) - 1, static_cast<int>(last - children_) - 1};
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+void B_EPSILON_TREE_INTERNAL_PAGE_TYPE::PopulateNewRoot(page_id_t left, const MappingType &pivot, page_id_t right) {
+  children_[0].second = left;
+  children_[1] = {pivot, right};
+  SetSize(2);
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+void B_EPSILON_TREE_INTERNAL_PAGE_TYPE::InsertChildAfter(int index, const MappingType &pivot, page_id_t child) {
+  std::move_backward(children_ + index + 1, children_ + GetSize(), children_ + GetSize() + 1);
+  children_[index + 1] = {pivot, child};
+  IncreaseSize(1);
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+int B_EPSILON_TREE_INTERNAL_PAGE_TYPE::MessageIndex(const MappingType &entry, const KeyComparator &comparator) const {
+  return std::lower_bound(messages_, messages_ + num_messages_, entry,
+                          [&comparator](const Message &message, const MappingType &e) {
+                            return CompareEntries(message.key_, message.value_, e.first, e.second, comparator) < 0;
+                          }) -
+         messages_;
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+int B_EPSILON_TREE_INTERNAL_PAGE_TYPE::MessageKeyIndex(const KeyType &key, const KeyComparator &comparator) const {
+  return std::lower_bound(
+             messages_, messages_ + num_messages_, key,
+             [&comparator](const Message &message, const KeyType &k) { return comparator(message.key_, k) < 0; }) -
+         messages_;
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+std::pair<int, int> B_EPSILON_TREE_INTERNAL_PAGE_TYPE::MessageRange(int child_index,
+                                                                   const KeyComparator &comparator) const {
+  int begin = child_index == 0 ? 0 : MessageIndex(PivotAt(child_index), comparator);
+  int end = child_index + 1 == GetSize() ? num_messages_ : MessageIndex(PivotAt(child_index + 1), comparator);
+  return {begin, end};
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+void B_EPSILON_TREE_INTERNAL_PAGE_TYPE::AddMessage(const Message &message, const KeyComparator &comparator) {
+  int index = MessageIndex(MappingType(message.key_, message.value_), comparator);
+  if (index < num_messages_ && CompareEntries(messages_[index].key_, messages_[index].value_, message.key_,
+                                              message.value_, comparator) == 0) {
+    messages_[index] = message;
+    return;
+  }
+  std::move_backward(messages_ + index, messages_ + num_messages_, messages_ + num_messages_ + 1);
+  messages_[index] = message;
+  num_messages_++;
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+void B_EPSILON_TREE_INTERNAL_PAGE_TYPE::RemoveMessages(int begin, int count) {
+  std::move(messages_ + begin + count, messages_ + num_messages_, messages_ + begin);
+  num_messages_ -= count;
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+void B_EPSILON_TREE_INTERNAL_PAGE_TYPE::MoveHalfTo(BEpsilonTreeInternalPage *recipient,
+                                                   const KeyComparator &comparator) {
+  int keep = GetSize() / 2;
+  std::copy(children_ + keep, children_ + GetSize(), recipient->children_);
+  recipient->SetSize(GetSize() - keep);
+  SetSize(keep);
+
+  int split = MessageIndex(recipient->PivotAt(0), comparator);
+  std::copy(messages_ + split, messages_ + num_messages_, recipient->messages_);
+  recipient->num_messages_ = num_messages_ - split;
+  num_messages_ = split;
+}
+
+template class BEpsilonTreeInternalPage<GenericKey<4>, RID, GenericComparator<4>>;
+template class BEpsilonTreeInternalPage<GenericKey<8>, RID, GenericComparator<8>>;
+template class BEpsilonTreeInternalPage<GenericKey<16>, RID, GenericComparator<16>>;
+template class BEpsilonTreeInternalPage<GenericKey<32>, RID, GenericComparator<32>>;
+template class BEpsilonTreeInternalPage<GenericKey<64>, RID, GenericComparator<64>>;
+
+}  // namespace bustub
@@ -0,0 +1,82 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// b_epsilon_tree_leaf_page.cpp
+//
+// Identification: src/storage/page/b_epsilon_tree_leaf_page.cpp
+//
+// Copyright (c) 2015-2021, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "storage/page/b_epsilon_tree_leaf_page.h"
+
+#include <algorithm>
+
+#include "common/rid.h"
+#include "storage/index/generic_key.h"
+
+namespace bustub {
+
+INDEX_TEMPLATE_ARGUMENTS
+void B_EPSILON_TREE_LEAF_PAGE_TYPE::Init(page_id_t page_id, int max_size) {
+  SetPageType(IndexPageType::LEAF_PAGE);
+  SetSize(0);
+  SetPageId(page_id);
+  SetParentPageId(INVALID_PAGE_ID);
+  SetNextPageId(INVALID_PAGE_ID);
+  SetMaxSize(max_size);
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+int B_EPSILON_TREE_LEAF_PAGE_TYPE::KeyIndex(const KeyType &key, const KeyComparator &comparator) const {
+  return std::lower_bound(array_, array_ + GetSize(), key,
+                          [&comparator](const MappingType &entry, const KeyType &k) {
+                            return comparator(entry.first, k) < 0;
+                          }) -
+         array_;
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+int B_EPSILON_TREE_LEAF_PAGE_TYPE::EntryIndex(const KeyType &key, const ValueType &value,
+                                              const KeyComparator &comparator) const {
+  return std::lower_bound(array_, array_ + GetSize(), MappingType(key, value),
+                          [&comparator](const MappingType &lhs, const MappingType &rhs) {
+                            return CompareEntries(lhs.first, lhs.second, rhs.first, rhs.second, comparator) < 0;
+                          }) -
+         array_;
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+void B_EPSILON_TREE_LEAF_PAGE_TYPE::Apply(const Message &message, const KeyComparator &comparator) {
+  int index = EntryIndex(message.key_, message.value_, comparator);
+  bool found = index < GetSize() &&
+               CompareEntries(array_[index].first, array_[index].second, message.key_, message.value_, comparator) == 0;
+  if (message.op_ == BEpsilonOp::INSERT && !found) {
+    std::move_backward(array_ + index, array_ + GetSize(), array_ + GetSize() + 1);
+    array_[index] = MappingType(message.key_, message.value_);
+    IncreaseSize(1);
+  } else if (message.op_ == BEpsilonOp::DELETE && found) {
+    std::move(array_ + index + 1, array_ + GetSize(), array_ + index);
+    IncreaseSize(-1);
+  }
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+void B_EPSILON_TREE_LEAF_PAGE_TYPE::MoveHalfTo(BEpsilonTreeLeafPage *recipient) {
+  int keep = GetSize() / 2;
+  std::copy(array_ + keep, array_ + GetSize(), recipient->array_);
+  recipient->SetSize(GetSize() - keep);
+  SetSize(keep);
+  recipient->SetNextPageId(GetNextPageId());
+  SetNextPageId(recipient->GetPageId());
+}
+
+template class BEpsilonTreeLeafPage<GenericKey<4>, RID, GenericComparator<4>>;
+template class BEpsilonTreeLeafPage<GenericKey<8>, RID, GenericComparator<8>>;
+template class BEpsilonTreeLeafPage<GenericKey<16>, RID, GenericComparator<16>>;
+template class BEpsilonTreeLeafPage<GenericKey<32>, RID, GenericComparator<32>>;
+template class BEpsilonTreeLeafPage<GenericKey<64>, RID, GenericComparator<64>>;
+
+}  // namespace bustub
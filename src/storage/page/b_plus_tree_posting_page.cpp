@@ -0,0 +1,89 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// b_plus_tree_posting_page.cpp
+//
+// Identification: src/storage/page/b_plus_tree_posting_page.cpp
+//
+// Copyright (c) 2015-2021, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "storage/page/b_plus_tree_posting_page.h"
+
+#include <algorithm>
+
+namespace bustub {
+
+namespace {
+
+// longest LEB128 encoding of a 64-bit value
+constexpr size_t MAX_VARINT_SIZE = 10;
+
+size_t PutVarint(uint64_t value, uint8_t *out) {
+  size_t size = 0;
+  while (value >= 0x80) {
+    out[size++] = static_cast<uint8_t>(value) | 0x80;
+    value >>= 7;
+  }
+  out[size++] = static_cast<uint8_t>(value);
+  return size;
+}
+
+const uint8_t *GetVarint(const uint8_t *in, uint64_t *value) {
+  uint64_t result = 0;
+  for (int shift = 0;; shift += 7) {
+    uint8_t byte = *in++;
+    result |= static_cast<uint64_t>(byte & 0x7f) << shift;
+    if ((byte & 0x80) == 0) {
+      break;
+    }
+  }
+  *value = result;
+  return in;
+}
+
+}  // namespace
+
+void BPlusTreePostingPage::Init() {
+  next_page_id_ = INVALID_PAGE_ID;
+  size_ = 0;
+  num_bytes_ = 0;
+  list_size_ = 0;
+  last_ = 0;
+}
+
+void BPlusTreePostingPage::Decode(std::vector<RID> *rids) const {
+  const uint8_t *in = data_;
+  uint64_t value = 0;
+  for (int i = 0; i < size_; i++) {
+    uint64_t delta;
+    in = GetVarint(in, &delta);
+    value += delta;
+    rids->emplace_back(static_cast<int64_t>(value));
+  }
+}
+
+size_t BPlusTreePostingPage::Encode(const RID *begin, const RID *end) {
+  uint8_t buffer[MAX_VARINT_SIZE];
+  uint64_t previous = 0;
+  size_t num_bytes = 0;
+  size_t count = 0;
+  for (const RID *rid = begin; rid != end; ++rid, ++count) {
+    auto value = static_cast<uint64_t>(rid->Get());
+    size_t size = PutVarint(value - previous, buffer);
+    if (num_bytes + size > CAPACITY) {
+      break;
+    }
+    std::copy(buffer, buffer + size, data_ + num_bytes);
+    num_bytes += size;
+    previous = value;
+  }
+  size_ = static_cast<int32_t>(count);
+  num_bytes_ = static_cast<uint32_t>(num_bytes);
+  last_ = static_cast<int64_t>(previous);
+  return count;
+}
+
+}  // namespace bustub
@@ -0,0 +1,232 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// b_plus_tree_varlen_page.cpp
+//
+// Identification: src/storage/page/b_plus_tree_varlen_page.cpp
+//
+// Copyright (c) 2015-2021, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "storage/page/b_plus_tree_varlen_page.h"
+
+#include <algorithm>
+#include <cstring>
+
+#include "common/rid.h"
+#include "storage/page/b_plus_tree_key_search.h"
+
+namespace bustub {
+
+namespace {
+
+size_t CommonPrefixLength(std::string_view a, std::string_view b) {
+  size_t length = std::min(a.size(), b.size());
+  size_t i = 0;
+  while (i < length && a[i] == b[i]) {
+    i++;
+  }
+  return i;
+}
+
+size_t PrefixLengthFor(std::string_view lower_fence, const std::optional<std::string> &upper_fence) {
+  return upper_fence.has_value() ? CommonPrefixLength(lower_fence, *upper_fence) : 0;
+}
+
+}  // namespace
+
+template <typename ValueType>
+void BPlusTreeVarlenPage<ValueType>::Init(page_id_t page_id, IndexPageType page_type) {
+  SetPageType(page_type);
+  SetPageId(page_id);
+  SetParentPageId(INVALID_PAGE_ID);
+  SetMaxSize(0);
+  SetNextPageId(INVALID_PAGE_ID);
+  Rebuild("", std::nullopt, {});
+}
+
+template <typename ValueType>
+std::string BPlusTreeVarlenPage<ValueType>::KeyAt(int index) const {
+  std::string key(HeapAt(lower_fence_offset_, prefix_length_));
+  key.append(SuffixAt(index));
+  return key;
+}
+
+template <typename ValueType>
+typename BPlusTreeVarlenPage<ValueType>::Entries BPlusTreeVarlenPage<ValueType>::GetEntries() const {
+  Entries entries;
+  entries.reserve(GetSize());
+  for (int i = 0; i < GetSize(); i++) {
+    entries.emplace_back(KeyAt(i), ValueAt(i));
+  }
+  return entries;
+}
+
+template <typename ValueType>
+std::string BPlusTreeVarlenPage<ValueType>::GetLowerFence() const {
+  return std::string(HeapAt(lower_fence_offset_, lower_fence_length_));
+}
+
+template <typename ValueType>
+std::optional<std::string> BPlusTreeVarlenPage<ValueType>::GetUpperFence() const {
+  if (has_upper_fence_ == 0) {
+    return std::nullopt;
+  }
+  return std::string(HeapAt(upper_fence_offset_, upper_fence_length_));
+}
+
+template <typename ValueType>
+int BPlusTreeVarlenPage<ValueType>::LowerBound(std::string_view key, int begin) const {
+  return PartitionPoint<false>(key, begin);
+}
+
+template <typename ValueType>
+int BPlusTreeVarlenPage<ValueType>::UpperBound(std::string_view key, int begin) const {
+  return PartitionPoint<true>(key, begin);
+}
+
+template <typename ValueType>
+template <bool OrEqual>
+int BPlusTreeVarlenPage<ValueType>::PartitionPoint(std::string_view key, int begin) const {
+  // The prefix is compared once; after that only the suffixes are.
+  int cmp = ComparePrefix(key);
+  if (cmp < 0) {
+    return begin;
+  }
+  if (cmp > 0) {
+    return std::max(begin, GetSize());
+  }
+  std::string_view rest = key.substr(prefix_length_);
+  return BranchFreePartitionPoint(slots_, begin, GetSize(), [&](const Slot &slot) {
+    int order = HeapAt(slot.offset_, slot.length_).compare(rest);
+    return OrEqual ? order <= 0 : order < 0;
+  });
+}
+
+template <typename ValueType>
+bool BPlusTreeVarlenPage<ValueType>::Insert(int index, std::string_view key, const ValueType &value) {
+  std::string_view suffix = key.substr(std::min<size_t>(prefix_length_, key.size()));
+  size_t needed = sizeof(Slot) + suffix.size();
+  if (ContiguousFreeSpace() < needed) {
+    if (ContiguousFreeSpace() + garbage_ < needed) {
+      return false;
+    }
+    Compact();
+  }
+  uint16_t offset = AllocateInHeap(suffix);
+  std::memmove(slots_ + index + 1, slots_ + index, (GetSize() - index) * sizeof(Slot));
+  slots_[index].offset_ = offset;
+  slots_[index].length_ = static_cast<uint16_t>(suffix.size());
+  slots_[index].value_ = value;
+  IncreaseSize(1);
+  return true;
+}
+
+template <typename ValueType>
+void BPlusTreeVarlenPage<ValueType>::Remove(int index) {
+  garbage_ += slots_[index].length_;
+  std::memmove(slots_ + index, slots_ + index + 1, (GetSize() - index - 1) * sizeof(Slot));
+  IncreaseSize(-1);
+}
+
+template <typename ValueType>
+void BPlusTreeVarlenPage<ValueType>::Rebuild(std::string_view lower_fence,
+                                             const std::optional<std::string> &upper_fence, const Entries &entries) {
+  // the fences may point into this page's own heap
+  std::string lower(lower_fence);
+  std::optional<std::string> upper(upper_fence);
+
+  SetSize(0);
+  heap_begin_ = PAGE_SIZE;
+  garbage_ = 0;
+  lower_fence_offset_ = AllocateInHeap(lower);
+  lower_fence_length_ = static_cast<uint16_t>(lower.size());
+  has_upper_fence_ = static_cast<uint16_t>(upper.has_value());
+  upper_fence_offset_ = upper.has_value() ? AllocateInHeap(*upper) : heap_begin_;
+  upper_fence_length_ = upper.has_value() ? static_cast<uint16_t>(upper->size()) : 0;
+  prefix_length_ = static_cast<uint16_t>(PrefixLengthFor(lower, upper));
+
+  for (size_t i = 0; i < entries.size(); i++) {
+    const auto &key = entries[i].first;
+    std::string_view suffix = std::string_view(key).substr(std::min<size_t>(prefix_length_, key.size()));
+    slots_[i].offset_ = AllocateInHeap(suffix);
+    slots_[i].length_ = static_cast<uint16_t>(suffix.size());
+    slots_[i].value_ = entries[i].second;
+  }
+  SetSize(static_cast<int>(entries.size()));
+}
+
+template <typename ValueType>
+size_t BPlusTreeVarlenPage<ValueType>::GetUsedBytes() const {
+  return sizeof(BPlusTreeVarlenPage) + GetSize() * sizeof(Slot) + (PAGE_SIZE - heap_begin_ - garbage_);
+}
+
+template <typename ValueType>
+size_t BPlusTreeVarlenPage<ValueType>::BytesNeeded(std::string_view lower_fence,
+                                                   const std::optional<std::string> &upper_fence,
+                                                   const Entries &entries) {
+  size_t prefix_length = PrefixLengthFor(lower_fence, upper_fence);
+  size_t bytes = sizeof(BPlusTreeVarlenPage) + lower_fence.size() + (upper_fence.has_value() ? upper_fence->size() : 0);
+  for (const auto &entry : entries) {
+    bytes += sizeof(Slot) + entry.first.size() - std::min(prefix_length, entry.first.size());
+  }
+  return bytes;
+}
+
+template <typename ValueType>
+std::string_view BPlusTreeVarlenPage<ValueType>::SuffixAt(int index) const {
+  return HeapAt(slots_[index].offset_, slots_[index].length_);
+}
+
+template <typename ValueType>
+std::string_view BPlusTreeVarlenPage<ValueType>::HeapAt(uint16_t offset, uint16_t length) const {
+  return std::string_view(reinterpret_cast<const char *>(this) + offset, length);
+}
+
+template <typename ValueType>
+uint16_t BPlusTreeVarlenPage<ValueType>::AllocateInHeap(std::string_view bytes) {
+  heap_begin_ -= bytes.size();
+  std::memcpy(reinterpret_cast<char *>(this) + heap_begin_, bytes.data(), bytes.size());
+  return heap_begin_;
+}
+
+template <typename ValueType>
+void BPlusTreeVarlenPage<ValueType>::Compact() {
+  std::string lower = GetLowerFence();
+  std::optional<std::string> upper = GetUpperFence();
+  std::vector<std::string> suffixes;
+  suffixes.reserve(GetSize());
+  for (int i = 0; i < GetSize(); i++) {
+    suffixes.emplace_back(SuffixAt(i));
+  }
+
+  heap_begin_ = PAGE_SIZE;
+  garbage_ = 0;
+  lower_fence_offset_ = AllocateInHeap(lower);
+  if (upper.has_value()) {
+    upper_fence_offset_ = AllocateInHeap(*upper);
+  }
+  for (int i = 0; i < GetSize(); i++) {
+    slots_[i].offset_ = AllocateInHeap(suffixes[i]);
+  }
+}
+
+template <typename ValueType>
+size_t BPlusTreeVarlenPage<ValueType>::ContiguousFreeSpace() const {
+  size_t slots_end = reinterpret_cast<const char *>(slots_ + GetSize()) - reinterpret_cast<const char *>(this);
+  return heap_begin_ - slots_end;
+}
+
+template <typename ValueType>
+int BPlusTreeVarlenPage<ValueType>::ComparePrefix(std::string_view key) const {
+  std::string_view prefix = HeapAt(lower_fence_offset_, prefix_length_);
+  int order = key.substr(0, prefix.size()).compare(prefix);
+  return (order > 0) - (order < 0);
+}
+
+template class BPlusTreeVarlenPage<RID>;
+template class BPlusTreeVarlenPage<page_id_t>;
+
+}  // namespace bustub
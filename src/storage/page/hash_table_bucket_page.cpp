@@ -34,23 +34,34 @@ bool HASH_TABLE_BUCKET_TYPE::GetValue(KeyType key, KeyComparator cmp, std::vecto
 
 template <typename KeyType, typename ValueType, typename KeyComparator>
 bool HASH_TABLE_BUCKET_TYPE::Insert(KeyType key, ValueType value, KeyComparator cmp) {
-  
   int insert_idx = -1;
-  
-  for(size_t i = 0; i < BUCKET_ARRAY_SIZE; i++){
-    if (!IsReadable(i))
-    {
-      if(insert_idx == -1) {insert_idx = i;}
+
+  for (size_t i = 0; i < BUCKET_ARRAY_SIZE; i++) {
+    // Slots are handed out in order, so nothing past the first never-occupied slot can hold a duplicate.
+    if (!IsOccupied(i)) {
+      if (insert_idx == -1) {
+        insert_idx = i;
+      }
       break;
     }
 
-    if (cmp(key,array_[i].first) == 0 && value == array_[i].second)
-    {
+    if (!IsReadable(i)) {
+      if (insert_idx == -1) {
+        insert_idx = i;
+      }
+      continue;
+    }
+
+    if (cmp(key, array_[i].first) == 0 && value == array_[i].second) {
       return false;
     }
   }
 
-  array_[insert_idx] = MappingType(key,value);
+  if (insert_idx == -1) {
+    return false;
+  }
+
+  array_[insert_idx] = MappingType(key, value);
   SetReadable(insert_idx);
   SetOccupied(insert_idx);
   return true;
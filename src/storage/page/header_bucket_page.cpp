@@ -0,0 +1,63 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// header_bucket_page.cpp
+//
+// Identification: src/storage/page/header_bucket_page.cpp
+//
+// Copyright (c) 2015-2021, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "storage/page/header_bucket_page.h"
+
+#include <cassert>
+#include <cstring>
+
+namespace bustub {
+
+void HeaderBucketPage::Init() {
+  next_page_id_ = INVALID_PAGE_ID;
+  record_count_ = 0;
+  memset(records_, 0, sizeof(records_));
+}
+
+int HeaderBucketPage::FindRecord(const std::string &name) const {
+  // free slots may sit between used ones, so every slot is looked at until all records have been seen
+  int seen = 0;
+  for (int slot = 0; slot < CAPACITY && seen < record_count_; slot++) {
+    if (records_[slot].name_[0] == '\0') {
+      continue;
+    }
+    if (strcmp(records_[slot].name_, name.c_str()) == 0) {
+      return slot;
+    }
+    seen++;
+  }
+  return -1;
+}
+
+bool HeaderBucketPage::IsRecordAt(int slot, const std::string &name) const {
+  return slot >= 0 && slot < CAPACITY && strcmp(records_[slot].name_, name.c_str()) == 0;
+}
+
+int HeaderBucketPage::InsertRecord(const std::string &name, page_id_t root_id) {
+  assert(name.length() < NAME_SIZE && !name.empty());
+  assert(!IsFull());
+  int slot = 0;
+  while (records_[slot].name_[0] != '\0') {
+    slot++;
+  }
+  memcpy(records_[slot].name_, name.c_str(), name.length() + 1);
+  records_[slot].root_id_ = root_id;
+  record_count_++;
+  return slot;
+}
+
+void HeaderBucketPage::DeleteRecord(int slot) {
+  memset(&records_[slot], 0, sizeof(Record));
+  record_count_--;
+}
+
+}  // namespace bustub
@@ -12,76 +12,135 @@
 #include <cassert>
 #include <iostream>
 
+#include "common/exception.h"
 #include "storage/page/header_page.h"
 
 namespace bustub {
 
+namespace {
+
+HeaderBucketPage *AsBucket(Page *page) { return reinterpret_cast<HeaderBucketPage *>(page->GetData()); }
+
+}  // namespace
+
 /**
  * Record related
  */
-bool HeaderPage::InsertRecord(const std::string &name, const page_id_t root_id) {
-  assert(name.length() < 32);
+bool HeaderPage::InsertRecord(BufferPoolManager *bpm, const std::string &name, const page_id_t root_id,
+                              RID *location) {
+  assert(name.length() < HeaderBucketPage::NAME_SIZE);
   assert(root_id > INVALID_PAGE_ID);
 
-  int record_num = GetRecordCount();
-  int offset = 4 + record_num * 36;
   // check for duplicate name
-  if (FindRecord(name) != -1) {
+  RID found;
+  if (FindRecord(bpm, name, &found)) {
     return false;
   }
-  // copy record content
-  memcpy(GetData() + offset, name.c_str(), (name.length() + 1));
-  memcpy((GetData() + offset + 32), &root_id, 4);
 
-  SetRecordCount(record_num + 1);
+  page_id_t *bucket_page_id = &BucketPageIds()[BucketIndex(name)];
+  Page *page;
+  if (*bucket_page_id == HEADER_PAGE_ID) {
+    page = NewPage(bpm, bucket_page_id);
+    AsBucket(page)->Init();
+    page->WLatch();
+  } else {
+    // the first page with a free slot, or a new one at the end of the chain
+    page = FetchPage(bpm, *bucket_page_id);
+    page->WLatch();
+    while (AsBucket(page)->IsFull()) {
+      page_id_t next_page_id = AsBucket(page)->GetNextPageId();
+      Page *next_page;
+      if (next_page_id == INVALID_PAGE_ID) {
+        next_page = NewPage(bpm, &next_page_id);
+        AsBucket(next_page)->Init();
+        AsBucket(page)->SetNextPageId(next_page_id);
+      } else {
+        next_page = FetchPage(bpm, next_page_id);
+      }
+      next_page->WLatch();
+      page->WUnlatch();
+      bpm->UnpinPage(page->GetPageId(), true);
+      page = next_page;
+    }
+  }
+  int slot = AsBucket(page)->InsertRecord(name, root_id);
+  page->WUnlatch();
+  if (location != nullptr) {
+    *location = RID(page->GetPageId(), slot);
+  }
+  bpm->UnpinPage(page->GetPageId(), true);
+
+  SetRecordCount(GetRecordCount() + 1);
   return true;
 }
 
-bool HeaderPage::DeleteRecord(const std::string &name) {
-  int record_num = GetRecordCount();
-  assert(record_num > 0);
+bool HeaderPage::DeleteRecord(BufferPoolManager *bpm, const std::string &name) {
+  assert(GetRecordCount() > 0);
 
-  int index = FindRecord(name);
+  RID location;
   // record does not exsit
-  if (index == -1) {
+  if (!FindRecord(bpm, name, &location)) {
     return false;
   }
-  int offset = index * 36 + 4;
-  memmove(GetData() + offset, GetData() + offset + 36, (record_num - index - 1) * 36);
+  Page *page = FetchPage(bpm, location.GetPageId());
+  page->WLatch();
+  AsBucket(page)->DeleteRecord(static_cast<int>(location.GetSlotNum()));
+  page->WUnlatch();
+  bpm->UnpinPage(location.GetPageId(), true);
 
-  SetRecordCount(record_num - 1);
+  SetRecordCount(GetRecordCount() - 1);
   return true;
 }
 
-bool HeaderPage::UpdateRecord(const std::string &name, const page_id_t root_id) {
-  assert(name.length() < 32);
+bool HeaderPage::UpdateRecord(BufferPoolManager *bpm, const std::string &name, const page_id_t root_id,
+                              RID *location) {
+  assert(name.length() < HeaderBucketPage::NAME_SIZE);
 
-  int index = FindRecord(name);
+  RID found;
   // record does not exsit
-  if (index == -1) {
+  if (!FindRecord(bpm, name, &found)) {
     return false;
   }
-  int offset = index * 36 + 4;
   // update record content, only root_id
-  memcpy((GetData() + offset + 32), &root_id, 4);
-
+  UpdateRecordAt(bpm, found, name, root_id);
+  if (location != nullptr) {
+    *location = found;
+  }
   return true;
 }
 
-bool HeaderPage::GetRootId(const std::string &name, page_id_t *root_id) {
-  assert(name.length() < 32);
+bool HeaderPage::GetRootId(BufferPoolManager *bpm, const std::string &name, page_id_t *root_id) {
+  assert(name.length() < HeaderBucketPage::NAME_SIZE);
 
-  int index = FindRecord(name);
+  RID location;
   // record does not exsit
-  if (index == -1) {
+  if (!FindRecord(bpm, name, &location)) {
     return false;
   }
-  int offset = (index + 1) * 36;
-  *root_id = *reinterpret_cast<page_id_t *>(GetData() + offset);
+  Page *page = FetchPage(bpm, location.GetPageId());
+  page->RLatch();
+  *root_id = AsBucket(page)->GetRootId(static_cast<int>(location.GetSlotNum()));
+  page->RUnlatch();
+  bpm->UnpinPage(location.GetPageId(), false);
 
   return true;
 }
 
+bool HeaderPage::UpdateRecordAt(BufferPoolManager *bpm, const RID &location, const std::string &name,
+                                page_id_t root_id) {
+  Page *page = FetchPage(bpm, location.GetPageId());
+  page->WLatch();
+  // the record may have been deleted, and its slot reused, since the location was handed out
+  auto slot = static_cast<int>(location.GetSlotNum());
+  bool found = AsBucket(page)->IsRecordAt(slot, name);
+  if (found) {
+    AsBucket(page)->SetRootId(slot, root_id);
+  }
+  page->WUnlatch();
+  bpm->UnpinPage(location.GetPageId(), found);
+  return found;
+}
+
 /**
  * helper functions
  */
@@ -90,15 +149,49 @@ int HeaderPage::GetRecordCount() { return *reinterpret_cast<int *>(GetData()); }
 
 void HeaderPage::SetRecordCount(int record_count) { memcpy(GetData(), &record_count, 4); }
 
-int HeaderPage::FindRecord(const std::string &name) {
-  int record_num = GetRecordCount();
-
-  for (int i = 0; i < record_num; i++) {
-    char *raw_name = reinterpret_cast<char *>(GetData() + (4 + i * 36));
-    if (strcmp(raw_name, name.c_str()) == 0) {
-      return i;
+bool HeaderPage::FindRecord(BufferPoolManager *bpm, const std::string &name, RID *location) {
+  page_id_t page_id = BucketPageIds()[BucketIndex(name)];
+  if (page_id == HEADER_PAGE_ID) {
+    return false;
+  }
+  while (page_id != INVALID_PAGE_ID) {
+    Page *page = FetchPage(bpm, page_id);
+    page->RLatch();
+    int slot = AsBucket(page)->FindRecord(name);
+    page_id_t next_page_id = AsBucket(page)->GetNextPageId();
+    page->RUnlatch();
+    bpm->UnpinPage(page_id, false);
+    if (slot != -1) {
+      *location = RID(page_id, slot);
+      return true;
     }
+    page_id = next_page_id;
+  }
+  return false;
+}
+
+size_t HeaderPage::BucketIndex(const std::string &name) {
+  // FNV-1a: the bucket of a name is part of the on-disk format, so it must not depend on the standard library
+  uint32_t hash = 2166136261U;
+  for (char c : name) {
+    hash = (hash ^ static_cast<uint8_t>(c)) * 16777619U;
+  }
+  return hash % NUM_BUCKETS;
+}
+
+Page *HeaderPage::FetchPage(BufferPoolManager *bpm, page_id_t page_id) {
+  Page *page = bpm->FetchPage(page_id);
+  if (page == nullptr) {
+    throw Exception(ExceptionType::OUT_OF_MEMORY, "Cannot fetch header bucket page");
+  }
+  return page;
+}
+
+Page *HeaderPage::NewPage(BufferPoolManager *bpm, page_id_t *page_id) {
+  Page *page = bpm->NewPage(page_id);
+  if (page == nullptr) {
+    throw Exception(ExceptionType::OUT_OF_MEMORY, "Cannot allocate header bucket page");
   }
-  return -1;
+  return page;
 }
 }  // namespace bustub
@@ -0,0 +1,81 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// spill_file.cpp
+//
+// Identification: src/storage/table/spill_file.cpp
+//
+// Copyright (c) 2015-2021, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "storage/table/spill_file.h"
+
+#include <algorithm>
+#include <cstring>
+
+#include "common/exception.h"
+
+namespace bustub {
+
+SpillFile::SpillFile(BufferPoolManager *buffer_pool_manager) : buffer_pool_manager_(buffer_pool_manager) {
+  buffer_.Init(INVALID_PAGE_ID, PAGE_SIZE);
+}
+
+SpillFile::~SpillFile() {
+  for (page_id_t page_id : page_ids_) {
+    buffer_pool_manager_->DeletePage(page_id);
+  }
+}
+
+void SpillFile::Append(const Tuple &tuple) {
+  TmpTuple tmp_tuple(INVALID_PAGE_ID, 0);
+  if (!buffer_.Insert(tuple, &tmp_tuple)) {
+    if (buffer_.IsEmpty()) {
+      throw Exception(ExceptionType::OUT_OF_RANGE, "Tuple does not fit in a page");
+    }
+    Flush();
+    buffer_.Insert(tuple, &tmp_tuple);
+  }
+  num_tuples_++;
+}
+
+void SpillFile::Rewind() {
+  if (!buffer_.IsEmpty()) {
+    Flush();
+  }
+  next_page_ = 0;
+}
+
+bool SpillFile::ReadPage(std::vector<Tuple> *tuples) {
+  if (next_page_ == page_ids_.size()) {
+    return false;
+  }
+  page_id_t page_id = page_ids_[next_page_++];
+  auto *page = reinterpret_cast<TmpTuplePage *>(buffer_pool_manager_->FetchPage(page_id));
+  if (page == nullptr) {
+    throw Exception(ExceptionType::OUT_OF_MEMORY, "Cannot fetch spilled page");
+  }
+  size_t begin = tuples->size();
+  page->GetTuples(tuples);
+  buffer_pool_manager_->UnpinPage(page_id, false);
+  // a page stores its tuples from its end backwards
+  std::reverse(tuples->begin() + begin, tuples->end());
+  return true;
+}
+
+void SpillFile::Flush() {
+  page_id_t page_id;
+  Page *page = buffer_pool_manager_->NewPage(&page_id);
+  if (page == nullptr) {
+    throw Exception(ExceptionType::OUT_OF_MEMORY, "Cannot allocate a page to spill to");
+  }
+  memcpy(page->GetData(), buffer_.GetData(), PAGE_SIZE);
+  memcpy(page->GetData(), &page_id, sizeof(page_id_t));
+  buffer_pool_manager_->UnpinPage(page_id, true);
+  page_ids_.push_back(page_id);
+  buffer_.Init(INVALID_PAGE_ID, PAGE_SIZE);
+}
+
+}  // namespace bustub
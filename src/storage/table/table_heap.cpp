@@ -22,7 +22,17 @@ TableHeap::TableHeap(BufferPoolManager *buffer_pool_manager, LockManager *lock_m
     : buffer_pool_manager_(buffer_pool_manager),
       lock_manager_(lock_manager),
       log_manager_(log_manager),
-      first_page_id_(first_page_id) {}
+      first_page_id_(first_page_id) {
+  for (auto page_id = first_page_id_; page_id != INVALID_PAGE_ID;) {
+    auto page = static_cast<TablePage *>(buffer_pool_manager_->FetchPage(page_id));
+    BUSTUB_ASSERT(page != nullptr, "Couldn't fetch a page of the table heap.");
+    page_ids_.push_back(page_id);
+    page->RLatch();
+    page_id = page->GetNextPageId();
+    page->RUnlatch();
+    buffer_pool_manager_->UnpinPage(page_ids_.back(), false);
+  }
+}
 
 TableHeap::TableHeap(BufferPoolManager *buffer_pool_manager, LockManager *lock_manager, LogManager *log_manager,
                      Transaction *txn)
@@ -34,6 +44,7 @@ TableHeap::TableHeap(BufferPoolManager *buffer_pool_manager, LockManager *lock_m
   first_page->Init(first_page_id_, PAGE_SIZE, INVALID_LSN, log_manager_, txn);
   first_page->WUnlatch();
   buffer_pool_manager_->UnpinPage(first_page_id_, true);
+  page_ids_.push_back(first_page_id_);
 }
 
 bool TableHeap::InsertTuple(const Tuple &tuple, RID *rid, Transaction *txn) {
@@ -76,6 +87,11 @@ bool TableHeap::InsertTuple(const Tuple &tuple, RID *rid, Transaction *txn) {
       new_page->WLatch();
       cur_page->SetNextPageId(next_page_id);
       new_page->Init(next_page_id, PAGE_SIZE, cur_page->GetTablePageId(), log_manager_, txn);
+      // Only the last page grows the table, and it is still latched, so the directory keeps the order of the links.
+      {
+        std::scoped_lock lock(page_ids_latch_);
+        page_ids_.push_back(next_page_id);
+      }
       cur_page->WUnlatch();
       buffer_pool_manager_->UnpinPage(cur_page->GetTablePageId(), true);
       cur_page = new_page;
@@ -169,6 +185,42 @@ bool TableHeap::GetTuple(const RID &rid, Tuple *tuple, Transaction *txn) {
   return res;
 }
 
+page_id_t TableHeap::GetPageTuples(page_id_t page_id, std::vector<Tuple> *tuples, Transaction *txn,
+                                   const std::function<bool(const Tuple &)> &filter) {
+  auto page = static_cast<TablePage *>(buffer_pool_manager_->FetchPage(page_id));
+  // Skipping the page here would silently cut short whoever is scanning it.
+  if (page == nullptr) {
+    throw Exception(ExceptionType::OUT_OF_MEMORY, "Cannot fetch table page");
+  }
+  // Copy every live tuple out under a single latch.
+  page->RLatch();
+  RID rid;
+  Tuple in_place;
+  for (bool found = page->GetFirstTupleRid(&rid); found; found = page->GetNextTupleRid(rid, &rid)) {
+    if (filter != nullptr && page->PeekTuple(rid, &in_place) && !filter(in_place)) {
+      continue;
+    }
+    tuples->emplace_back();
+    if (!page->GetTuple(rid, &tuples->back(), txn, lock_manager_)) {
+      tuples->pop_back();
+    }
+  }
+  page_id_t next_page_id = page->GetNextPageId();
+  page->RUnlatch();
+  buffer_pool_manager_->UnpinPage(page_id, false);
+  return next_page_id;
+}
+
+size_t TableHeap::GetNumPages() {
+  std::scoped_lock lock(page_ids_latch_);
+  return page_ids_.size();
+}
+
+void TableHeap::GetPageIds(size_t begin, size_t end, std::vector<page_id_t> *page_ids) {
+  std::scoped_lock lock(page_ids_latch_);
+  page_ids->assign(page_ids_.begin() + begin, page_ids_.begin() + end);
+}
+
 TableIterator TableHeap::Begin(Transaction *txn) {
   // Start an iterator from the first page.
   // TODO(Wuwen): Hacky fix for now. Removing empty pages is a better way to handle this.
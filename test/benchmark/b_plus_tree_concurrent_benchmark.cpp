@@ -0,0 +1,112 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// b_plus_tree_concurrent_benchmark.cpp
+//
+// Identification: test/benchmark/b_plus_tree_concurrent_benchmark.cpp
+//
+// Copyright (c) 2015-2021, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include <algorithm>
+#include <cstdio>
+#include <random>
+#include <thread>  // NOLINT
+#include <vector>
+
+#include "benchmark_util.h"  // NOLINT
+#include "buffer/buffer_pool_manager_instance.h"
+#include "gtest/gtest.h"
+#include "storage/index/b_plus_tree.h"
+#include "test_util.h"  // NOLINT
+
+namespace bustub {
+
+namespace {
+
+using Tree = BPlusTree<GenericKey<8>, RID, GenericComparator<8>>;
+
+// runs fn(tree, key) over keys, split across num_threads threads as the concurrent tests split them
+template <typename Fn>
+void RunSplit(Tree *tree, const std::vector<int64_t> &keys, int num_threads, Fn fn) {
+  std::vector<std::thread> threads;
+  for (int thread_itr = 0; thread_itr < num_threads; thread_itr++) {
+    threads.emplace_back([&, thread_itr] {
+      GenericKey<8> index_key;
+      for (auto key : keys) {
+        if (key % num_threads == thread_itr) {
+          index_key.SetFromInteger(key);
+          fn(tree, index_key, key);
+        }
+      }
+    });
+  }
+  for (auto &thread : threads) {
+    thread.join();
+  }
+}
+
+void Insert(Tree *tree, const GenericKey<8> &index_key, int64_t key) {
+  Transaction transaction(0);
+  tree->Insert(index_key, RID(0, static_cast<uint32_t>(key)), &transaction);
+}
+
+void Lookup(Tree *tree, const GenericKey<8> &index_key, int64_t key) {
+  std::vector<RID> rids;
+  tree->GetValue(index_key, &rids);
+  EXPECT_EQ(rids.size(), 1) << key;
+}
+
+void Remove(Tree *tree, const GenericKey<8> &index_key, int64_t key) {
+  Transaction transaction(0);
+  tree->Remove(index_key, &transaction);
+}
+
+}  // namespace
+
+// NOLINTNEXTLINE
+TEST(BPlusTreeConcurrentBenchmark, Throughput) {
+  // The insert, lookup, delete and mixed scenarios of b_plus_tree_concurrent_test, at increasing thread counts.
+  auto key_schema = ParseCreateStatement("a bigint");
+  GenericComparator<8> comparator(key_schema.get());
+  const int64_t num_keys = 1 << 13;
+  std::vector<int64_t> keys;
+  for (int64_t key = 1; key <= num_keys; key++) {
+    keys.push_back(key);
+  }
+  std::shuffle(keys.begin(), keys.end(), std::mt19937(15445));
+  std::vector<int64_t> half(keys.begin(), keys.begin() + num_keys / 2);
+
+  auto mops = [&](auto &&fn) { return static_cast<double>(num_keys) / ElapsedNanos(fn) * 1000; };
+
+  printf("Mops/s over %ld keys\n", static_cast<long>(num_keys));  // NOLINT
+  printf("%8s %10s %10s %10s %10s\n", "threads", "insert", "lookup", "mixed", "delete");
+  for (int num_threads : {1, 2, 4, 8, 16, 32}) {
+    DiskManager disk_manager("test.db");
+    BufferPoolManagerInstance bpm(256, &disk_manager);
+    Tree tree("foo_pk", &bpm, comparator);
+    page_id_t page_id;
+    bpm.NewPage(&page_id);
+
+    double insert = mops([&] { RunSplit(&tree, keys, num_threads, Insert); });
+    double lookup = mops([&] { RunSplit(&tree, keys, num_threads, Lookup); });
+    // deletes of the first half race inserts of it back
+    double mixed = mops([&] {
+      std::thread remover([&] { RunSplit(&tree, half, num_threads, Remove); });
+      RunSplit(&tree, half, num_threads, Insert);
+      remover.join();
+    });
+    double remove_all = mops([&] { RunSplit(&tree, keys, num_threads, Remove); });
+    EXPECT_TRUE(tree.IsEmpty());
+    printf("%8d %10.3f %10.3f %10.3f %10.3f\n", num_threads, insert, lookup, mixed, remove_all);
+
+    bpm.UnpinPage(HEADER_PAGE_ID, true);
+    disk_manager.ShutDown();
+    remove("test.db");
+    remove("test.log");
+  }
+}
+
+}  // namespace bustub
@@ -0,0 +1,85 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// b_plus_tree_key_search_benchmark.cpp
+//
+// Identification: test/benchmark/b_plus_tree_key_search_benchmark.cpp
+//
+// Copyright (c) 2015-2021, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include <cstdio>
+#include <random>
+#include <utility>
+#include <vector>
+
+#include "benchmark_util.h"  // NOLINT
+#include "gtest/gtest.h"
+#include "storage/page/b_plus_tree_key_search.h"
+#include "storage/page/b_plus_tree_leaf_page.h"
+#include "test_util.h"  // NOLINT
+
+namespace bustub {
+
+namespace {
+
+using LeafMapping = std::pair<GenericKey<8>, RID>;
+
+}  // namespace
+
+// NOLINTNEXTLINE
+TEST(BPlusTreeKeySearchBenchmark, FillLevels) {
+  auto key_schema = ParseCreateStatement("a bigint");
+  GenericComparator<8> generic_comparator(key_schema.get());
+  IntegerComparator<8> integer_comparator;
+  std::mt19937_64 rng(15445);
+  const int max_leaf_size = (PAGE_SIZE - LEAF_PAGE_HEADER_SIZE) / sizeof(LeafMapping);
+
+  printf("ns/search over a leaf page of GenericKey<8>\n");
+  printf("%5s %10s %10s %10s %10s %10s %10s\n", "size", "linear", "branching", "branchfree", "int-branch", "int-bfree",
+         "int-simd");
+  for (int n : {8, 32, 64, 128, max_leaf_size}) {
+    // every third key, so that about two thirds of the probes miss
+    std::vector<LeafMapping> entries(n);
+    for (int i = 0; i < n; i++) {
+      entries[i].first.SetFromInteger(i * 3);
+    }
+    std::vector<GenericKey<8>> probes(4096);
+    for (auto &probe : probes) {
+      probe.SetFromInteger(static_cast<int64_t>(rng() % (n * 3 + 2)) - 1);
+    }
+    const LeafMapping *array = entries.data();
+
+    auto nanos_per_search = [&](auto &&search) {
+      int sink = 0;
+      double nanos = NanosPerOp(probes.size() * 8, [&](uint64_t i) { sink += search(probes[i % probes.size()]); });
+      KeepAlive(sink);
+      return nanos;
+    };
+    auto generic_less = [&](const GenericKey<8> &key) {
+      return [&](const LeafMapping &entry) { return generic_comparator(entry.first, key) < 0; };
+    };
+    auto integer_less = [&](const GenericKey<8> &key) {
+      return [&](const LeafMapping &entry) { return integer_comparator(entry.first, key) < 0; };
+    };
+    double linear = nanos_per_search(
+        [&](const GenericKey<8> &key) { return LinearPartitionPoint(array, 0, n, generic_less(key)); });
+    double branching = nanos_per_search(
+        [&](const GenericKey<8> &key) { return BranchingPartitionPoint(array, 0, n, generic_less(key)); });
+    double branch_free = nanos_per_search(
+        [&](const GenericKey<8> &key) { return BranchFreePartitionPoint(array, 0, n, generic_less(key)); });
+    double int_branching = nanos_per_search(
+        [&](const GenericKey<8> &key) { return BranchingPartitionPoint(array, 0, n, integer_less(key)); });
+    double int_branch_free = nanos_per_search(
+        [&](const GenericKey<8> &key) { return BranchFreePartitionPoint(array, 0, n, integer_less(key)); });
+    double int_simd = nanos_per_search([&](const GenericKey<8> &key) {
+      return IntegerPartitionPoint(array, 0, n, IntegerComparator<8>::ToInteger(key), false);
+    });
+    printf("%5d %10.2f %10.2f %10.2f %10.2f %10.2f %10.2f\n", n, linear, branching, branch_free, int_branching,
+           int_branch_free, int_simd);
+  }
+}
+
+}  // namespace bustub
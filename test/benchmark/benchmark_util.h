@@ -0,0 +1,46 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// benchmark_util.h
+//
+// Identification: test/benchmark/benchmark_util.h
+//
+// Copyright (c) 2015-2021, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <chrono>  // NOLINT
+#include <cstdint>
+
+namespace bustub {
+
+/** @return the wall-clock time fn takes, in nanoseconds */
+template <typename Fn>
+double ElapsedNanos(Fn &&fn) {
+  auto start = std::chrono::steady_clock::now();
+  fn();
+  std::chrono::duration<double, std::nano> elapsed = std::chrono::steady_clock::now() - start;
+  return elapsed.count();
+}
+
+/** @return the average time fn takes per call over num_ops calls fn(0) ... fn(num_ops - 1), in nanoseconds */
+template <typename Fn>
+double NanosPerOp(uint64_t num_ops, Fn &&fn) {
+  return ElapsedNanos([&] {
+           for (uint64_t i = 0; i < num_ops; i++) {
+             fn(i);
+           }
+         }) /
+         static_cast<double>(num_ops);
+}
+
+/** Keeps the compiler from optimizing away the computation of value. */
+template <typename T>
+void KeepAlive(const T &value) {
+  asm volatile("" : : "g"(&value) : "memory");  // NOLINT
+}
+
+}  // namespace bustub
@@ -0,0 +1,72 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// hash_function_benchmark.cpp
+//
+// Identification: test/benchmark/hash_function_benchmark.cpp
+//
+// Copyright (c) 2015-2021, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include <cstdio>
+#include <cstring>
+#include <random>
+#include <vector>
+
+#include "benchmark_util.h"  // NOLINT
+#include "common/util/hash_util.h"
+#include "container/hash/hash_function.h"
+#include "gtest/gtest.h"
+#include "storage/index/generic_key.h"
+
+namespace bustub {
+
+namespace {
+
+// The per-byte loop HashUtil::HashBytes used before it was switched to wyhash, as the baseline.
+template <size_t KeySize>
+hash_t LegacyHashKey(const GenericKey<KeySize> &key) {
+  hash_t hash = KeySize;
+  for (size_t i = 0; i < KeySize; ++i) {
+    hash = ((hash << 5) ^ (hash >> 27)) ^ key.data_[i];
+  }
+  return hash;
+}
+
+template <size_t KeySize>
+void RunHashBenchmark(const std::vector<GenericKey<KeySize>> &keys, const char *name) {
+  HashFunction<GenericKey<KeySize>> hash_function;
+  const size_t rounds = 16;
+  hash_t sink = 0;
+  const uint64_t num_ops = keys.size() * rounds;
+  double wyhash = NanosPerOp(num_ops, [&](uint64_t i) { sink ^= hash_function.GetHash(keys[i % keys.size()]); });
+  double legacy = NanosPerOp(num_ops, [&](uint64_t i) { sink ^= LegacyHashKey(keys[i % keys.size()]); });
+  KeepAlive(sink);
+  printf("%-16s %10.2f %10.2f\n", name, wyhash, legacy);
+}
+
+}  // namespace
+
+// NOLINTNEXTLINE
+TEST(HashFunctionBenchmark, Throughput) {
+  const size_t num_keys = 1 << 14;
+  std::mt19937_64 rng(15445);
+  std::vector<GenericKey<8>> keys8(num_keys);
+  std::vector<GenericKey<64>> keys64(num_keys);
+  for (size_t i = 0; i < num_keys; i++) {
+    keys8[i].SetFromInteger(static_cast<int64_t>(rng()));
+    for (size_t j = 0; j < 64; j += 8) {
+      uint64_t word = rng();
+      memcpy(keys64[i].data_ + j, &word, sizeof(word));
+    }
+  }
+
+  printf("ns/key over %zu random keys\n", num_keys);
+  printf("%-16s %10s %10s\n", "key", "wyhash", "legacy");
+  RunHashBenchmark(keys8, "GenericKey<8>");
+  RunHashBenchmark(keys64, "GenericKey<64>");
+}
+
+}  // namespace bustub
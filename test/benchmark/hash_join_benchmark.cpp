@@ -0,0 +1,112 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// hash_join_benchmark.cpp
+//
+// Identification: test/benchmark/hash_join_benchmark.cpp
+//
+// Copyright (c) 2015-2021, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include <cstdio>
+#include <map>
+#include <string>
+#include <utility>
+
+#include "../execution/executor_test_util.h"  // NOLINT
+#include "benchmark_util.h"                   // NOLINT
+#include "catalog/table_generator.h"
+#include "execution/executor_factory.h"
+#include "execution/plans/hash_join_plan.h"
+#include "execution/plans/seq_scan_plan.h"
+#include "execution/tuple_batch.h"
+#include "gtest/gtest.h"
+
+namespace bustub {
+
+using HashJoinBenchmark = ExecutorTest;
+
+// SELECT build.colA, probe.col1 FROM build JOIN probe ON build.colA = probe.col2, where build is shaped like test_1
+// and probe like test_2, with their join keys drawn from ever more skewed distributions
+TEST_F(HashJoinBenchmark, Zipf) {
+  using Dist = TableGenerator::Dist;
+  // enough build rows for the hash table to be partitioned
+  const uint32_t build_size = 20000;
+  const uint32_t probe_size = 4000;
+  const uint64_t max_key = 19999;
+  TableGenerator generator{GetExecutorContext()};
+  printf("%8s %10s %10s %12s\n", "keys", "build ms", "probe ms", "rows");
+  for (auto [dist, name] : {std::pair{Dist::Zipf_50, "zipf .50"}, std::pair{Dist::Zipf_75, "zipf .75"},
+                            std::pair{Dist::Zipf_99, "zipf .99"}}) {
+    // the metas hold the names as C strings, which must outlive the tables' generation
+    std::string build_name = std::string("build_") + name;
+    std::string probe_name = std::string("probe_") + name;
+    TableGenerator::TableInsertMeta build_meta{build_name.c_str(),
+                                               build_size,
+                                               {{"colA", TypeId::INTEGER, false, dist, 0, max_key},
+                                                {"colB", TypeId::INTEGER, false, Dist::Uniform, 0, 9},
+                                                {"colC", TypeId::INTEGER, false, Dist::Uniform, 0, 9999},
+                                                {"colD", TypeId::INTEGER, false, Dist::Uniform, 0, 99999}}};
+    TableGenerator::TableInsertMeta probe_meta{probe_name.c_str(),
+                                               probe_size,
+                                               {{"col1", TypeId::SMALLINT, false, Dist::Serial, 0, 0},
+                                                {"col2", TypeId::INTEGER, true, dist, 0, max_key},
+                                                {"col3", TypeId::BIGINT, false, Dist::Uniform, 0, 1024},
+                                                {"col4", TypeId::INTEGER, true, Dist::Uniform, 0, 2048}}};
+    TableInfo *build_table = generator.GenerateTable(&build_meta);
+    TableInfo *probe_table = generator.GenerateTable(&probe_meta);
+
+    auto *build_col_a = MakeColumnValueExpression(build_table->schema_, 0, "colA");
+    auto *build_schema = MakeOutputSchema({{"colA", build_col_a}});
+    auto *probe_col1 = MakeColumnValueExpression(probe_table->schema_, 0, "col1");
+    auto *probe_col2 = MakeColumnValueExpression(probe_table->schema_, 0, "col2");
+    auto *probe_schema = MakeOutputSchema({{"col1", probe_col1}, {"col2", probe_col2}});
+    SeqScanPlanNode build_plan{build_schema, nullptr, build_table->oid_};
+    SeqScanPlanNode probe_plan{probe_schema, nullptr, probe_table->oid_};
+    auto *left_col_a = MakeColumnValueExpression(*build_schema, 0, "colA");
+    auto *right_col1 = MakeColumnValueExpression(*probe_schema, 1, "col1");
+    auto *right_col2 = MakeColumnValueExpression(*probe_schema, 1, "col2");
+    auto *out_schema = MakeOutputSchema({{"colA", left_col_a}, {"col1", right_col1}});
+    HashJoinPlanNode join_plan{out_schema, {&build_plan, &probe_plan}, left_col_a, right_col2};
+
+    // the expected number of matches of every key
+    std::map<int32_t, uint64_t> build_counts;
+    for (auto it = build_table->table_->Begin(GetTxn()); it != build_table->table_->End(); ++it) {
+      build_counts[it->GetValue(&build_table->schema_, 0).GetAs<int32_t>()]++;
+    }
+    std::map<int32_t, uint64_t> expected;
+    for (auto it = probe_table->table_->Begin(GetTxn()); it != probe_table->table_->End(); ++it) {
+      auto key = it->GetValue(&probe_table->schema_, 1).GetAs<int32_t>();
+      if (build_counts.count(key) == 1) {
+        expected[key] += build_counts[key];
+      }
+    }
+
+    auto executor = ExecutorFactory::CreateExecutor(GetExecutorContext(), &join_plan);
+    std::map<int32_t, uint64_t> matches;
+    uint64_t num_rows = 0;
+    double build_nanos = ElapsedNanos([&] { executor->Init(); });
+    double probe_nanos = ElapsedNanos([&] {
+      TupleBatch batch;
+      while (executor->NextBatch(&batch)) {
+        num_rows += batch.GetNumSelected();
+        // checking every row would dwarf the join itself, so only the first of each batch is
+        matches[batch.GetValue(0, batch.GetSelection()[0]).GetAs<int32_t>()]++;
+      }
+    });
+    uint64_t expected_rows = 0;
+    for (const auto &[key, count] : expected) {
+      expected_rows += count;
+    }
+    ASSERT_EQ(num_rows, expected_rows);
+    for (const auto &[key, count] : matches) {
+      ASSERT_EQ(expected.count(key), 1) << key;
+    }
+    printf("%8s %10.2f %10.2f %12lu\n", name, build_nanos / 1e6, probe_nanos / 1e6,
+           static_cast<unsigned long>(num_rows));  // NOLINT
+  }
+}
+
+}  // namespace bustub
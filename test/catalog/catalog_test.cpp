@@ -19,6 +19,10 @@
 #include "catalog/table_generator.h"
 #include "execution/executor_context.h"
 #include "gtest/gtest.h"
+#include "storage/index/adaptive_radix_tree_index.h"
+#include "storage/index/b_epsilon_tree_index.h"
+#include "storage/index/linear_probe_hash_table_index.h"
+#include "storage/index/varlen_b_plus_tree_index.h"
 #include "type/value_factory.h"
 
 namespace bustub {
@@ -688,4 +692,162 @@ TEST(CatalogTest, DISABLED_IndexInteraction3) {
   remove("catalog_test.log");
 }
 
+// Every index type can be created through the catalog, with the smallest key type that fits
+TEST(CatalogTest, CreateIndexByType) {
+  auto disk_manager = std::make_unique<DiskManager>("catalog_test.db");
+  auto bpm = std::make_unique<BufferPoolManagerInstance>(64, disk_manager.get());
+  page_id_t header_page_id;
+  bpm->NewPage(&header_page_id);
+  auto catalog = std::make_unique<Catalog>(bpm.get(), nullptr, nullptr);
+  auto txn = std::make_unique<Transaction>(0);
+
+  const std::string table_name{"foobar"};
+  std::vector<Column> columns{{"A", TypeId::INTEGER}, {"B", TypeId::BIGINT}, {"C", TypeId::INTEGER}};
+  Schema table_schema{columns};
+  auto *table_info = catalog->CreateTable(txn.get(), table_name, table_schema);
+  const int num_tuples = 200;
+  for (int i = 0; i < num_tuples; i++) {
+    Tuple tuple{std::vector<Value>{ValueFactory::GetIntegerValue(i % 100), ValueFactory::GetBigIntValue(i % 100),
+                                   ValueFactory::GetIntegerValue(i)},
+                &table_schema};
+    RID rid;
+    ASSERT_TRUE(table_info->table_->InsertTuple(tuple, &rid, txn.get()));
+  }
+
+  // a 12 byte key goes in a GenericKey<16>; every type but the unique B+ tree keeps both tuples of a key
+  const std::vector<uint32_t> key_attrs{0, 1};
+  auto *extendible = catalog->CreateIndex(txn.get(), "extendible", table_name, table_schema, key_attrs,
+                                          IndexType::ExtendibleHash);
+  EXPECT_NE(nullptr, (dynamic_cast<ExtendibleHashTableIndex<GenericKey<16>, RID, GenericComparator<16>> *>(
+                         extendible->index_.get())));
+  auto *linear_probe = catalog->CreateIndex(txn.get(), "linear_probe", table_name, table_schema, key_attrs,
+                                            IndexType::LinearProbeHash);
+  EXPECT_NE(nullptr, (dynamic_cast<LinearProbeHashTableIndex<GenericKey<16>, RID, GenericComparator<16>> *>(
+                         linear_probe->index_.get())));
+  auto *b_plus_tree =
+      catalog->CreateIndex(txn.get(), "b_plus_tree", table_name, table_schema, key_attrs, IndexType::BPlusTree);
+  EXPECT_NE(nullptr, (dynamic_cast<BPlusTreeIndex<GenericKey<16>, RID, GenericComparator<16>> *>(
+                         b_plus_tree->index_.get())));
+  EXPECT_TRUE(b_plus_tree->index_->SupportsRangeScan());
+  auto *secondary = catalog->CreateIndex(txn.get(), "secondary", table_name, table_schema, key_attrs,
+                                         IndexType::BPlusTree, false);
+  auto *b_epsilon_tree =
+      catalog->CreateIndex(txn.get(), "b_epsilon_tree", table_name, table_schema, key_attrs, IndexType::BEpsilonTree);
+  EXPECT_NE(nullptr, (dynamic_cast<BEpsilonTreeIndex<GenericKey<16>, RID, GenericComparator<16>> *>(
+                         b_epsilon_tree->index_.get())));
+  auto *radix_tree = catalog->CreateIndex(txn.get(), "radix_tree", table_name, table_schema, key_attrs,
+                                          IndexType::AdaptiveRadixTree);
+  EXPECT_NE(nullptr, dynamic_cast<AdaptiveRadixTreeIndex *>(radix_tree->index_.get()));
+
+  EXPECT_EQ(16, extendible->key_size_);
+  EXPECT_EQ(12, radix_tree->key_size_);
+  EXPECT_EQ(6, catalog->GetTableIndexes(table_name).size());
+  EXPECT_EQ(Catalog::NULL_INDEX_INFO, catalog->CreateIndex(txn.get(), "extendible", table_name, table_schema,
+                                                           key_attrs, IndexType::BPlusTree));
+
+  for (auto *index_info : {extendible, linear_probe, b_plus_tree, secondary, b_epsilon_tree, radix_tree}) {
+    for (int key = 0; key < 100; key += 7) {
+      Tuple index_key{std::vector<Value>{ValueFactory::GetIntegerValue(key), ValueFactory::GetBigIntValue(key)},
+                      &index_info->key_schema_};
+      std::vector<RID> results;
+      index_info->index_->ScanKey(index_key, &results, txn.get());
+      EXPECT_EQ(index_info == b_plus_tree ? 1 : 2, results.size()) << index_info->name_ << " key " << key;
+    }
+  }
+
+  // a single INTEGER column fits in a GenericKey<4>, and included columns count towards a B+ tree's key size
+  auto *small = catalog->CreateIndex(txn.get(), "small", table_name, table_schema, {2}, IndexType::ExtendibleHash);
+  EXPECT_EQ(4, small->key_size_);
+  auto *covering =
+      catalog->CreateIndex(txn.get(), "covering", table_name, table_schema, {2}, IndexType::BPlusTree, true, {0, 1});
+  EXPECT_EQ(16, covering->key_size_);
+  EXPECT_TRUE(covering->index_->SupportsIndexOnlyScan());
+  // only the included columns are listed as such
+  std::string description = covering->index_->GetMetadata()->ToString();
+  size_t include_pos = description.find(" INCLUDE (Column[A,");
+  ASSERT_NE(std::string::npos, include_pos);
+  EXPECT_NE(std::string::npos, description.find("Column[B,", include_pos));
+  EXPECT_EQ(std::string::npos, description.find("Column[C,", include_pos));
+  for (auto index_type : {IndexType::ExtendibleHash, IndexType::LinearProbeHash, IndexType::BEpsilonTree,
+                          IndexType::AdaptiveRadixTree}) {
+    EXPECT_THROW(catalog->CreateIndex(txn.get(), "included", table_name, table_schema, {2}, index_type, true, {0}),
+                 Exception);
+  }
+
+  // a B+ tree on a single BIGINT column compares its keys as integers
+  auto *bigint = catalog->CreateIndex(txn.get(), "bigint", table_name, table_schema, {1}, IndexType::BPlusTree);
+  EXPECT_EQ(8, bigint->key_size_);
+  EXPECT_NE(nullptr, (dynamic_cast<BPlusTreeIndex<GenericKey<8>, RID, IntegerComparator<8>> *>(bigint->index_.get())));
+  EXPECT_TRUE(bigint->index_->SupportsRangeScan());
+  for (int key = 0; key < 100; key += 7) {
+    Tuple index_key{std::vector<Value>{ValueFactory::GetBigIntValue(key)}, &bigint->key_schema_};
+    std::vector<RID> results;
+    bigint->index_->ScanKey(index_key, &results, txn.get());
+    EXPECT_EQ(1, results.size()) << "key " << key;
+  }
+
+  bpm->UnpinPage(HEADER_PAGE_ID, true);
+  remove("catalog_test.db");
+  remove("catalog_test.log");
+}
+
+// Fixed-size indexes reject VARCHAR keys, whose length is not bounded; B+ trees and the radix tree store them as
+// variable-length bytes
+TEST(CatalogTest, CreateIndexVarcharKey) {
+  auto disk_manager = std::make_unique<DiskManager>("catalog_test.db");
+  auto bpm = std::make_unique<BufferPoolManagerInstance>(64, disk_manager.get());
+  page_id_t header_page_id;
+  bpm->NewPage(&header_page_id);
+  auto catalog = std::make_unique<Catalog>(bpm.get(), nullptr, nullptr);
+  auto txn = std::make_unique<Transaction>(0);
+
+  const std::string table_name{"foobar"};
+  std::vector<Column> columns{{"A", TypeId::INTEGER}, {"B", TypeId::VARCHAR, 64}};
+  Schema table_schema{columns};
+  auto *table_info = catalog->CreateTable(txn.get(), table_name, table_schema);
+  const int num_tuples = 100;
+  for (int i = 0; i < num_tuples; i++) {
+    // long enough that a copy of the whole key tuple would overflow any GenericKey
+    std::string name = std::string(40, 'x') + std::to_string(i);
+    Tuple tuple{std::vector<Value>{ValueFactory::GetIntegerValue(i), ValueFactory::GetVarcharValue(name)},
+                &table_schema};
+    RID rid;
+    ASSERT_TRUE(table_info->table_->InsertTuple(tuple, &rid, txn.get()));
+  }
+
+  for (auto index_type : {IndexType::ExtendibleHash, IndexType::LinearProbeHash, IndexType::BEpsilonTree}) {
+    EXPECT_THROW(catalog->CreateIndex(txn.get(), "name", table_name, table_schema, {1}, index_type), Exception);
+  }
+  // included columns are part of a B+ tree's fixed-size entry too
+  EXPECT_THROW(catalog->CreateIndex(txn.get(), "covering", table_name, table_schema, {0}, IndexType::BPlusTree, true,
+                                    {1}),
+               Exception);
+  // the variable-length B+ tree holds one RID per key, and no included columns
+  EXPECT_THROW(catalog->CreateIndex(txn.get(), "secondary", table_name, table_schema, {1}, IndexType::BPlusTree, false),
+               Exception);
+  EXPECT_THROW(catalog->CreateIndex(txn.get(), "covering", table_name, table_schema, {1}, IndexType::BPlusTree, true,
+                                    {0}),
+               Exception);
+  EXPECT_TRUE(catalog->GetTableIndexes(table_name).empty());
+
+  auto *b_plus_tree =
+      catalog->CreateIndex(txn.get(), "b_plus_tree", table_name, table_schema, {1}, IndexType::BPlusTree);
+  EXPECT_NE(nullptr, dynamic_cast<VarlenBPlusTreeIndex *>(b_plus_tree->index_.get()));
+  auto *radix_tree =
+      catalog->CreateIndex(txn.get(), "name", table_name, table_schema, {1}, IndexType::AdaptiveRadixTree);
+  for (auto *index_info : {b_plus_tree, radix_tree}) {
+    for (int i = 0; i < num_tuples; i += 7) {
+      Tuple index_key{std::vector<Value>{ValueFactory::GetVarcharValue(std::string(40, 'x') + std::to_string(i))},
+                      &index_info->key_schema_};
+      std::vector<RID> results;
+      index_info->index_->ScanKey(index_key, &results, txn.get());
+      EXPECT_EQ(1, results.size()) << index_info->name_ << " key " << i;
+    }
+  }
+
+  bpm->UnpinPage(HEADER_PAGE_ID, true);
+  remove("catalog_test.db");
+  remove("catalog_test.log");
+}
+
 }  // namespace bustub
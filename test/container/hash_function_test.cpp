@@ -0,0 +1,102 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// hash_function_test.cpp
+//
+// Identification: test/container/hash_function_test.cpp
+//
+// Copyright (c) 2015-2021, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include <vector>
+
+#include "common/util/hash_util.h"
+#include "container/hash/hash_function.h"
+#include "gtest/gtest.h"
+#include "storage/index/generic_key.h"
+
+namespace bustub {
+
+namespace {
+
+/**
+ * Chi-squared statistic of the low `bits` bits of each hash, i.e. the directory index an extendible hash table
+ * with global depth `bits` would compute. For a uniform hash this is close to the number of buckets.
+ */
+double LowBitsChiSquared(const std::vector<uint64_t> &hashes, uint32_t bits) {
+  const uint32_t num_buckets = 1U << bits;
+  std::vector<uint64_t> counts(num_buckets, 0);
+  for (auto h : hashes) {
+    counts[h & (num_buckets - 1)]++;
+  }
+  const double expected = static_cast<double>(hashes.size()) / num_buckets;
+  double chi = 0;
+  for (auto c : counts) {
+    chi += (c - expected) * (c - expected) / expected;
+  }
+  return chi;
+}
+
+}  // namespace
+
+// NOLINTNEXTLINE
+TEST(HashFunctionTest, FixedWidthPathsTest) {
+  HashFunction<GenericKey<8>> hash8;
+  HashFunction<GenericKey<16>> hash16;
+  HashFunction<int> hash_int;
+
+  GenericKey<8> key8;
+  GenericKey<16> key16;
+  for (int64_t i = -100; i < 100; i++) {
+    key8.SetFromInteger(i);
+    key16.SetFromInteger(i);
+    // The specialized paths must agree with the general ones.
+    EXPECT_EQ(hash8.GetHash(key8), HashUtil::HashInt(static_cast<uint64_t>(i)));
+    EXPECT_EQ(hash16.GetHash(key16), HashUtil::HashBytes(key16.data_, 16));
+    EXPECT_EQ(hash_int.GetHash(static_cast<int>(i)), HashUtil::HashInt(static_cast<uint64_t>(static_cast<int>(i))));
+    // And be deterministic.
+    EXPECT_EQ(hash8.GetHash(key8), hash8.GetHash(key8));
+  }
+
+  // Every length takes a different code path through HashBytes; make sure a one-bit change is always seen.
+  char buf[128] = {0};
+  for (size_t len = 1; len < sizeof(buf); len++) {
+    hash_t before = HashUtil::HashBytes(buf, len);
+    buf[len - 1] ^= 1;
+    EXPECT_NE(before, HashUtil::HashBytes(buf, len)) << "len=" << len;
+    buf[len - 1] ^= 1;
+  }
+
+  EXPECT_NE(HashUtil::CombineHashes(1, 2), HashUtil::CombineHashes(2, 1));
+}
+
+// NOLINTNEXTLINE
+TEST(HashFunctionTest, BucketDistributionTest) {
+  // Dense sequential keys are the common case for surrogate keys and the worst case for weak low bits.
+  const size_t num_keys = 1 << 16;
+  HashFunction<GenericKey<8>> hash8;
+  HashFunction<GenericKey<32>> hash32;
+  std::vector<uint64_t> new8;
+  std::vector<uint64_t> new32;
+  GenericKey<8> key8;
+  GenericKey<32> key32;
+  for (size_t i = 0; i < num_keys; i++) {
+    key8.SetFromInteger(static_cast<int64_t>(i));
+    key32.SetFromInteger(static_cast<int64_t>(i));
+    new8.push_back(hash8.GetHash(key8));
+    new32.push_back(hash32.GetHash(key32));
+  }
+
+  for (uint32_t bits : {4U, 8U, 9U, 12U}) {
+    const double buckets = 1U << bits;
+    double chi_new8 = LowBitsChiSquared(new8, bits);
+    double chi_new32 = LowBitsChiSquared(new32, bits);
+    // A uniform hash has E[chi2] == buckets with a standard deviation of sqrt(2 * buckets); allow a wide margin.
+    EXPECT_LT(chi_new8, buckets * 1.5 + 100);
+    EXPECT_LT(chi_new32, buckets * 1.5 + 100);
+  }
+}
+
+}  // namespace bustub
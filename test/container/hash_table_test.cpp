@@ -10,21 +10,24 @@
 //
 //===----------------------------------------------------------------------===//
 
+#include <algorithm>
+#include <random>
 #include <thread>  // NOLINT
 #include <vector>
 
 #include "buffer/buffer_pool_manager_instance.h"
 #include "common/logger.h"
+#include "common/util/hash_util.h"
+#include "container/hash/counting_bloom_filter.h"
 #include "container/hash/extendible_hash_table.h"
+#include "container/hash/linear_probe_hash_table.h"
 #include "gtest/gtest.h"
 #include "murmur3/MurmurHash3.h"
 
 namespace bustub {
 
 // NOLINTNEXTLINE
-
-// NOLINTNEXTLINE
-TEST(HashTableTest, DISABLED_SampleTest) {
+TEST(HashTableTest, SampleTest) {
   auto *disk_manager = new DiskManager("test.db");
   auto *bpm = new BufferPoolManagerInstance(50, disk_manager);
   ExtendibleHashTable<int, int, IntComparator> ht("blah", bpm, IntComparator(), HashFunction<int>());
@@ -117,4 +120,262 @@ TEST(HashTableTest, DISABLED_SampleTest) {
   delete bpm;
 }
 
+// NOLINTNEXTLINE
+TEST(HashTableTest, SplitMergeTest) {
+  auto *disk_manager = new DiskManager("test.db");
+  auto *bpm = new BufferPoolManagerInstance(50, disk_manager);
+  ExtendibleHashTable<int, int, IntComparator> ht("blah", bpm, IntComparator(), HashFunction<int>());
+
+  // enough keys to split the single initial bucket several times
+  const int num_keys = 5000;
+  for (int i = 0; i < num_keys; i++) {
+    EXPECT_TRUE(ht.Insert(nullptr, i, i));
+  }
+  EXPECT_GT(ht.GetGlobalDepth(), 0);
+  ht.VerifyIntegrity();
+
+  for (int i = 0; i < num_keys; i++) {
+    std::vector<int> res;
+    EXPECT_TRUE(ht.GetValue(nullptr, i, &res));
+    ASSERT_EQ(1, res.size());
+    EXPECT_EQ(i, res[0]);
+    // duplicates are still rejected once the bucket is full
+    EXPECT_FALSE(ht.Insert(nullptr, i, i));
+  }
+
+  for (int i = 0; i < num_keys; i++) {
+    EXPECT_TRUE(ht.Remove(nullptr, i, i));
+  }
+  ht.VerifyIntegrity();
+  EXPECT_EQ(0, ht.GetGlobalDepth());
+
+  disk_manager->ShutDown();
+  remove("test.db");
+  delete disk_manager;
+  delete bpm;
+}
+
+// NOLINTNEXTLINE
+TEST(HashTableTest, MembershipFilterTest) {
+  const size_t capacity = 10000;
+  CountingBloomFilter filter(capacity);
+  std::mt19937_64 rng(15445);
+  std::vector<uint64_t> present;
+  for (size_t i = 0; i < capacity; i++) {
+    present.push_back(HashUtil::HashInt(rng()));
+    filter.Insert(present.back());
+  }
+  EXPECT_EQ(capacity, filter.GetSize());
+
+  // no false negatives
+  for (auto hash : present) {
+    EXPECT_TRUE(filter.MayContain(hash));
+  }
+
+  // a low false positive rate at full capacity
+  size_t false_positives = 0;
+  const size_t num_probes = 100000;
+  for (size_t i = 0; i < num_probes; i++) {
+    false_positives += filter.MayContain(HashUtil::HashInt(rng())) ? 1 : 0;
+  }
+  EXPECT_LT(false_positives, num_probes / 20);
+
+  // removing everything brings the filter back to empty, and inserting twice needs two removes
+  filter.Insert(present[0]);
+  for (auto hash : present) {
+    filter.Remove(hash);
+  }
+  EXPECT_TRUE(filter.MayContain(present[0]));
+  filter.Remove(present[0]);
+  EXPECT_EQ(0, filter.GetSize());
+  for (auto hash : present) {
+    EXPECT_FALSE(filter.MayContain(hash));
+  }
+}
+
+// NOLINTNEXTLINE
+TEST(HashTableTest, FilterLookupTest) {
+  auto *disk_manager = new DiskManager("test.db");
+  auto *bpm = new BufferPoolManagerInstance(50, disk_manager);
+  ExtendibleHashTable<int, int, IntComparator> ht("blah", bpm, IntComparator(), HashFunction<int>(), true);
+
+  // grows the filter past its initial capacity a few times
+  const int num_keys = 3000;
+  for (int i = 0; i < num_keys; i += 2) {
+    EXPECT_TRUE(ht.Insert(nullptr, i, i));
+  }
+  for (int i = 0; i < num_keys; i++) {
+    std::vector<int> res;
+    EXPECT_EQ(i % 2 == 0, ht.GetValue(nullptr, i, &res));
+  }
+
+  // removed keys are answered negatively again, and a rebuild keeps what is left
+  for (int i = 0; i < num_keys; i += 4) {
+    EXPECT_TRUE(ht.Remove(nullptr, i, i));
+  }
+  ht.RebuildFilter();
+  for (int i = 0; i < num_keys; i++) {
+    std::vector<int> res;
+    EXPECT_EQ(i % 4 == 2, ht.GetValue(nullptr, i, &res)) << i;
+  }
+  ht.VerifyIntegrity();
+
+  disk_manager->ShutDown();
+  remove("test.db");
+  delete disk_manager;
+  delete bpm;
+}
+
+namespace {
+
+/** A buffer pool that counts the pages fetched from it. */
+class CountingBufferPoolManager : public BufferPoolManagerInstance {
+ public:
+  using BufferPoolManagerInstance::BufferPoolManagerInstance;
+
+  size_t num_fetches_{0};
+
+ protected:
+  Page *FetchPgImp(page_id_t page_id) override {
+    num_fetches_++;
+    return BufferPoolManagerInstance::FetchPgImp(page_id);
+  }
+};
+
+}  // namespace
+
+// NOLINTNEXTLINE
+TEST(HashTableTest, FilterSkipsBufferPoolTest) {
+  auto *disk_manager = new DiskManager("test.db");
+  const int num_keys = 2000;
+  // the pages fetched by lookups of the keys present and of as many absent ones, with and without the filter
+  auto count_fetches = [&](bool use_membership_filter, size_t *present_fetches, size_t *absent_fetches) {
+    CountingBufferPoolManager bpm(50, disk_manager);
+    ExtendibleHashTable<int, int, IntComparator> ht("blah", &bpm, IntComparator(), HashFunction<int>(),
+                                                    use_membership_filter);
+    for (int i = 0; i < num_keys; i++) {
+      EXPECT_TRUE(ht.Insert(nullptr, i, i));
+    }
+    std::vector<int> res;
+    bpm.num_fetches_ = 0;
+    for (int i = 0; i < num_keys; i++) {
+      res.clear();
+      EXPECT_TRUE(ht.GetValue(nullptr, i, &res));
+    }
+    *present_fetches = bpm.num_fetches_;
+    bpm.num_fetches_ = 0;
+    for (int i = num_keys; i < 2 * num_keys; i++) {
+      res.clear();
+      EXPECT_FALSE(ht.GetValue(nullptr, i, &res));
+    }
+    *absent_fetches = bpm.num_fetches_;
+  };
+
+  // without the filter, every lookup reads the directory and a bucket
+  size_t present_fetches;
+  size_t absent_fetches;
+  count_fetches(false, &present_fetches, &absent_fetches);
+  EXPECT_EQ(present_fetches, 2 * num_keys);
+  EXPECT_EQ(absent_fetches, 2 * num_keys);
+
+  // with it, only the few absent keys the filter takes for present ones reach the buffer pool
+  count_fetches(true, &present_fetches, &absent_fetches);
+  EXPECT_EQ(present_fetches, 2 * num_keys);
+  EXPECT_LT(absent_fetches, 2 * num_keys / 10);
+
+  disk_manager->ShutDown();
+  remove("test.db");
+  delete disk_manager;
+}
+
+// NOLINTNEXTLINE
+TEST(HashTableTest, LinearProbeTest) {
+  auto *disk_manager = new DiskManager("test.db");
+  auto *bpm = new BufferPoolManagerInstance(50, disk_manager);
+  LinearProbeHashTable<int, int, IntComparator> ht("blah", bpm, IntComparator(), 10, HashFunction<int>());
+  size_t initial_size = ht.GetSize();
+
+  // two values per key, and far more pairs than the table starts out with, so that it has to grow
+  const int num_keys = 2000;
+  for (int i = 0; i < num_keys; i++) {
+    EXPECT_TRUE(ht.Insert(nullptr, i, i));
+    EXPECT_TRUE(ht.Insert(nullptr, i, -i - 1));
+    EXPECT_FALSE(ht.Insert(nullptr, i, i));
+  }
+  EXPECT_GE(ht.GetSize(), 2 * num_keys);
+  for (int i = 0; i < num_keys; i++) {
+    std::vector<int> res;
+    ASSERT_TRUE(ht.GetValue(nullptr, i, &res));
+    std::sort(res.begin(), res.end());
+    EXPECT_EQ(res, (std::vector<int>{-i - 1, i}));
+  }
+
+  // removed pairs are gone, and the other value of the key is still found past the tombstone
+  for (int i = 0; i < num_keys; i += 2) {
+    EXPECT_TRUE(ht.Remove(nullptr, i, i));
+    EXPECT_FALSE(ht.Remove(nullptr, i, i));
+  }
+  for (int i = 0; i < num_keys; i++) {
+    std::vector<int> res;
+    ASSERT_TRUE(ht.GetValue(nullptr, i, &res));
+    EXPECT_EQ(res.size(), i % 2 == 0 ? 1 : 2);
+  }
+
+  // churn only leaves tombstones behind, which are dropped instead of growing the table
+  size_t size = ht.GetSize();
+  for (int round = 0; round < 20; round++) {
+    for (int i = 0; i < num_keys; i += 2) {
+      EXPECT_TRUE(ht.Insert(nullptr, i, i));
+      EXPECT_TRUE(ht.Remove(nullptr, i, i));
+    }
+  }
+  EXPECT_LE(ht.GetSize(), 2 * size);
+  EXPECT_GT(ht.GetSize(), initial_size);
+
+  disk_manager->ShutDown();
+  remove("test.db");
+  delete disk_manager;
+  delete bpm;
+}
+
+// NOLINTNEXTLINE
+TEST(HashTableTest, LinearProbeConcurrentDuplicateTest) {
+  auto *disk_manager = new DiskManager("test.db");
+  auto *bpm = new BufferPoolManagerInstance(50, disk_manager);
+  LinearProbeHashTable<int, int, IntComparator> ht("blah", bpm, IntComparator(), 10, HashFunction<int>());
+
+  // every thread inserts the same pairs in the same order, so they keep racing for the same buckets
+  const int num_threads = 8;
+  const int num_keys = 2000;
+  std::vector<std::vector<int>> num_inserted(num_threads, std::vector<int>(num_keys));
+  std::vector<std::thread> threads;
+  for (int t = 0; t < num_threads; t++) {
+    threads.emplace_back([&ht, &num_inserted, t] {
+      for (int i = 0; i < num_keys; i++) {
+        num_inserted[t][i] += ht.Insert(nullptr, i, i) ? 1 : 0;
+      }
+    });
+  }
+  for (auto &thread : threads) {
+    thread.join();
+  }
+
+  // each pair went in exactly once
+  for (int i = 0; i < num_keys; i++) {
+    int total = 0;
+    for (int t = 0; t < num_threads; t++) {
+      total += num_inserted[t][i];
+    }
+    EXPECT_EQ(1, total) << "key " << i;
+    std::vector<int> res;
+    ASSERT_TRUE(ht.GetValue(nullptr, i, &res));
+    EXPECT_EQ(res, std::vector<int>{i});
+  }
+
+  disk_manager->ShutDown();
+  remove("test.db");
+  delete disk_manager;
+  delete bpm;
+}
+
 }  // namespace bustub
@@ -10,8 +10,11 @@
 //
 //===----------------------------------------------------------------------===//
 
+#include <array>
+#include <map>
 #include <memory>
 #include <numeric>
+#include <random>
 #include <string>
 #include <unordered_set>
 #include <utility>
@@ -21,19 +24,30 @@
 #include "concurrency/transaction_manager.h"
 #include "execution/execution_engine.h"
 #include "execution/executor_context.h"
+#include "catalog/table_generator.h"
 #include "execution/executors/aggregation_executor.h"
+#include "execution/executors/hash_join_executor.h"
 #include "execution/executors/insert_executor.h"
+#include "execution/executors/merge_join_executor.h"
 #include "execution/executors/nested_loop_join_executor.h"
+#include "execution/executors/sort_executor.h"
 #include "execution/expressions/aggregate_value_expression.h"
 #include "execution/expressions/column_value_expression.h"
 #include "execution/expressions/comparison_expression.h"
 #include "execution/expressions/constant_value_expression.h"
+#include "execution/join_filter.h"
+#include "execution/sort_key_encoder.h"
 #include "execution/plans/delete_plan.h"
 #include "execution/plans/distinct_plan.h"
 #include "execution/plans/hash_join_plan.h"
+#include "execution/plans/index_scan_plan.h"
 #include "execution/plans/limit_plan.h"
+#include "execution/plans/merge_join_plan.h"
 #include "execution/plans/seq_scan_plan.h"
+#include "execution/plans/sort_plan.h"
+#include "execution/plans/topn_plan.h"
 #include "execution/plans/update_plan.h"
+#include "execution/tuple_batch.h"
 #include "executor_test_util.h"  // NOLINT
 #include "gtest/gtest.h"
 #include "storage/table/tuple.h"
@@ -87,7 +101,7 @@ using ComparatorType = GenericComparator<8>;
 using HashFunctionType = HashFunction<KeyType>;
 
 // SELECT col_a, col_b FROM test_1 WHERE col_a < 500
-TEST_F(ExecutorTest, DISABLED_SimpleSeqScanTest) {
+TEST_F(ExecutorTest, SimpleSeqScanTest) {
   // Construct query plan
   TableInfo *table_info = GetExecutorContext()->GetCatalog()->GetTable("test_1");
   const Schema &schema = table_info->schema_;
@@ -110,6 +124,120 @@ TEST_F(ExecutorTest, DISABLED_SimpleSeqScanTest) {
   }
 }
 
+// SELECT col_a, col_b FROM test_1 WHERE col_a = 500, through an index on col_a
+TEST_F(ExecutorTest, SimpleIndexScanTest) {
+  // Construct query plan
+  TableInfo *table_info = GetExecutorContext()->GetCatalog()->GetTable("test_1");
+  const Schema &schema = table_info->schema_;
+  auto key_schema = ParseCreateStatement("a integer");
+  ComparatorType comparator{key_schema.get()};
+  auto *index_info = GetExecutorContext()->GetCatalog()->CreateIndex<KeyType, ValueType, ComparatorType>(
+      GetTxn(), "index1", "test_1", schema, *key_schema, {0}, 8, HashFunctionType{});
+  auto *col_a = MakeColumnValueExpression(schema, 0, "colA");
+  auto *col_b = MakeColumnValueExpression(schema, 0, "colB");
+  auto *const500 = MakeConstantValueExpression(ValueFactory::GetIntegerValue(500));
+  auto *predicate = MakeComparisonExpression(col_a, const500, ComparisonType::Equal);
+  auto *out_schema = MakeOutputSchema({{"colA", col_a}, {"colB", col_b}});
+  IndexScanPlanNode plan{out_schema, predicate, index_info->index_oid_};
+
+  // Execute
+  std::vector<Tuple> result_set{};
+  GetExecutionEngine()->Execute(&plan, &result_set, GetTxn(), GetExecutorContext());
+
+  // Verify
+  ASSERT_EQ(result_set.size(), 1);
+  ASSERT_EQ(result_set[0].GetValue(out_schema, out_schema->GetColIdx("colA")).GetAs<int32_t>(), 500);
+  ASSERT_TRUE(result_set[0].GetValue(out_schema, out_schema->GetColIdx("colB")).GetAs<int32_t>() < 10);
+}
+
+// SELECT colA FROM test_1 WHERE colA <op> c, through an index on colA, for constants that no colA equals
+TEST_F(ExecutorTest, IndexScanInexactBoundTest) {
+  TableInfo *table_info = GetExecutorContext()->GetCatalog()->GetTable("test_1");
+  const Schema &schema = table_info->schema_;
+  auto *index_info =
+      GetExecutorContext()->GetCatalog()->CreateIndex(GetTxn(), "index1", "test_1", schema, {0}, IndexType::BPlusTree);
+  auto *col_a = MakeColumnValueExpression(schema, 0, "colA");
+  auto *out_schema = MakeOutputSchema({{"colA", col_a}});
+
+  struct Case {
+    ComparisonType comp_type_;
+    Value constant_;
+    size_t expected_;
+  };
+  const int32_t size = TEST1_SIZE;
+  for (const auto &[comp_type, constant, expected] : std::vector<Case>{
+           {ComparisonType::LessThan, ValueFactory::GetDecimalValue(3.5), 4},
+           {ComparisonType::GreaterThan, ValueFactory::GetDecimalValue(-2.5), size},
+           {ComparisonType::GreaterThanOrEqual, ValueFactory::GetDecimalValue(size - 1.5), 1},
+           {ComparisonType::Equal, ValueFactory::GetDecimalValue(3.5), 0},
+           {ComparisonType::LessThanOrEqual, ValueFactory::GetDecimalValue(3.0), 4},
+           {ComparisonType::LessThan, ValueFactory::GetBigIntValue(int64_t{1} << 40), size},
+           {ComparisonType::GreaterThan, ValueFactory::GetBigIntValue(-(int64_t{1} << 40)), size}}) {
+    auto *predicate = MakeComparisonExpression(col_a, MakeConstantValueExpression(constant), comp_type);
+    IndexScanPlanNode plan{out_schema, predicate, index_info->index_oid_};
+    std::vector<Tuple> result_set{};
+    GetExecutionEngine()->Execute(&plan, &result_set, GetTxn(), GetExecutorContext());
+    ASSERT_EQ(result_set.size(), expected) << constant.ToString();
+  }
+}
+
+// SELECT colA, colB FROM test_1 WHERE colA >= 990, from an index on colA that includes colB
+TEST_F(ExecutorTest, CoveringIndexScanTest) {
+  TableInfo *table_info = GetExecutorContext()->GetCatalog()->GetTable("test_1");
+  const Schema &schema = table_info->schema_;
+  auto key_schema = ParseCreateStatement("a integer");
+  auto *index_info = GetExecutorContext()->GetCatalog()->CreateIndex<KeyType, ValueType, ComparatorType>(
+      GetTxn(), "index1", "test_1", schema, *key_schema, {0}, 8, HashFunctionType{}, {1});
+  ASSERT_TRUE(index_info->index_->SupportsIndexOnlyScan());
+  auto *col_a = MakeColumnValueExpression(schema, 0, "colA");
+  auto *col_b = MakeColumnValueExpression(schema, 0, "colB");
+  auto *col_c = MakeColumnValueExpression(schema, 0, "colC");
+  auto *const990 = MakeConstantValueExpression(ValueFactory::GetIntegerValue(990));
+  auto *predicate = MakeComparisonExpression(col_a, const990, ComparisonType::GreaterThanOrEqual);
+  auto *covered_schema = MakeOutputSchema({{"colA", col_a}, {"colB", col_b}});
+  auto *uncovered_schema = MakeOutputSchema({{"colA", col_a}, {"colC", col_c}});
+  IndexScanPlanNode covered_plan{covered_schema, predicate, index_info->index_oid_};
+  IndexScanPlanNode uncovered_plan{uncovered_schema, predicate, index_info->index_oid_};
+
+  // the expected colB and colC of each colA
+  std::vector<int32_t> col_b_vals(TEST1_SIZE);
+  std::vector<int32_t> col_c_vals(TEST1_SIZE);
+  RID deleted_rid;
+  for (auto tuple = table_info->table_->Begin(GetTxn()); tuple != table_info->table_->End(); ++tuple) {
+    auto a = tuple->GetValue(&schema, 0).GetAs<int32_t>();
+    col_b_vals[a] = tuple->GetValue(&schema, 1).GetAs<int32_t>();
+    col_c_vals[a] = tuple->GetValue(&schema, 2).GetAs<int32_t>();
+    if (a == 995) {
+      deleted_rid = tuple->GetRid();
+    }
+  }
+
+  std::vector<Tuple> result_set{};
+  GetExecutionEngine()->Execute(&covered_plan, &result_set, GetTxn(), GetExecutorContext());
+  ASSERT_EQ(result_set.size(), 10);
+  for (size_t i = 0; i < result_set.size(); i++) {
+    auto a = result_set[i].GetValue(covered_schema, 0).GetAs<int32_t>();
+    ASSERT_EQ(a, 990 + static_cast<int32_t>(i));
+    ASSERT_EQ(result_set[i].GetValue(covered_schema, 1).GetAs<int32_t>(), col_b_vals[a]);
+  }
+  result_set.clear();
+  GetExecutionEngine()->Execute(&uncovered_plan, &result_set, GetTxn(), GetExecutorContext());
+  ASSERT_EQ(result_set.size(), 10);
+  for (auto &tuple : result_set) {
+    auto a = tuple.GetValue(uncovered_schema, 0).GetAs<int32_t>();
+    ASSERT_EQ(tuple.GetValue(uncovered_schema, 1).GetAs<int32_t>(), col_c_vals[a]);
+  }
+
+  // Delete a tuple behind the index's back: only the scan that reads the table notices.
+  ASSERT_TRUE(table_info->table_->MarkDelete(deleted_rid, GetTxn()));
+  result_set.clear();
+  GetExecutionEngine()->Execute(&covered_plan, &result_set, GetTxn(), GetExecutorContext());
+  ASSERT_EQ(result_set.size(), 10);
+  result_set.clear();
+  GetExecutionEngine()->Execute(&uncovered_plan, &result_set, GetTxn(), GetExecutorContext());
+  ASSERT_EQ(result_set.size(), 9);
+}
+
 // INSERT INTO empty_table2 VALUES (100, 10), (101, 11), (102, 12)
 TEST_F(ExecutorTest, DISABLED_SimpleRawInsertTest) {
   // Create Values to insert
@@ -374,7 +502,7 @@ TEST_F(ExecutorTest, DISABLED_SimpleDeleteTest) {
 }
 
 // SELECT test_1.col_a, test_1.col_b, test_2.col1, test_2.col3 FROM test_1 JOIN test_2 ON test_1.col_a = test_2.col1;
-TEST_F(ExecutorTest, DISABLED_SimpleNestedLoopJoinTest) {
+TEST_F(ExecutorTest, SimpleNestedLoopJoinTest) {
   const Schema *out_schema1;
   std::unique_ptr<AbstractPlanNode> scan_plan1;
   {
@@ -417,8 +545,65 @@ TEST_F(ExecutorTest, DISABLED_SimpleNestedLoopJoinTest) {
   ASSERT_EQ(result_set.size(), 100);
 }
 
+// SELECT t1.colA, t2.colA FROM test_1 t1 JOIN test_1 t2 ON t1.colD > t2.colD, where t1.colA < 100 and t2.colA < 300,
+// with blocks of various sizes
+TEST_F(ExecutorTest, BlockNestedLoopJoinTest) {
+  TableInfo *table_info = GetExecutorContext()->GetCatalog()->GetTable("test_1");
+  const Schema &schema = table_info->schema_;
+  auto *scan_schema = MakeOutputSchema({{"colA", MakeColumnValueExpression(schema, 0, "colA")},
+                                        {"colB", MakeColumnValueExpression(schema, 0, "colB")},
+                                        {"colD", MakeColumnValueExpression(schema, 0, "colD")}});
+  auto *col_a = MakeColumnValueExpression(*scan_schema, 0, "colA");
+  auto *const100 = MakeConstantValueExpression(ValueFactory::GetIntegerValue(100));
+  auto *const300 = MakeConstantValueExpression(ValueFactory::GetIntegerValue(300));
+  SeqScanPlanNode left_plan{scan_schema, MakeComparisonExpression(col_a, const100, ComparisonType::LessThan),
+                            table_info->oid_};
+  SeqScanPlanNode right_plan{scan_schema, MakeComparisonExpression(col_a, const300, ComparisonType::LessThan),
+                             table_info->oid_};
+  auto *left_col_a = MakeColumnValueExpression(*scan_schema, 0, "colA");
+  auto *right_col_a = MakeColumnValueExpression(*scan_schema, 1, "colA");
+  auto *predicate = MakeComparisonExpression(MakeColumnValueExpression(*scan_schema, 0, "colD"),
+                                             MakeColumnValueExpression(*scan_schema, 1, "colD"),
+                                             ComparisonType::GreaterThan);
+  auto *out_schema = MakeOutputSchema({{"left_colA", left_col_a}, {"right_colA", right_col_a}});
+
+  // the rows of either side, to join by brute force
+  std::vector<Tuple> result_set{};
+  GetExecutionEngine()->Execute(&right_plan, &result_set, GetTxn(), GetExecutorContext());
+  ASSERT_EQ(result_set.size(), 300);
+  std::vector<std::pair<int32_t, int32_t>> expected;
+  for (const auto &left : result_set) {
+    for (const auto &right : result_set) {
+      int32_t left_col_a_val = left.GetValue(scan_schema, 0).GetAs<int32_t>();
+      if (left_col_a_val < 100 &&
+          left.GetValue(scan_schema, 2).GetAs<int32_t>() > right.GetValue(scan_schema, 2).GetAs<int32_t>()) {
+        expected.emplace_back(left_col_a_val, right.GetValue(scan_schema, 0).GetAs<int32_t>());
+      }
+    }
+  }
+  std::sort(expected.begin(), expected.end());
+
+  // a tuple per block scans the right side once per left tuple, and a block holding the whole left side only once
+  for (size_t block_size : {1, 7, 100, 4096}) {
+    NestedLoopJoinPlanNode join_plan{out_schema, {&left_plan, &right_plan}, predicate, block_size};
+    auto executor = ExecutorFactory::CreateExecutor(GetExecutorContext(), &join_plan);
+    executor->Init();
+    std::vector<std::pair<int32_t, int32_t>> pairs;
+    TupleBatch batch;
+    while (executor->NextBatch(&batch)) {
+      for (uint32_t row : batch.GetSelection()) {
+        pairs.emplace_back(batch.GetValue(0, row).GetAs<int32_t>(), batch.GetValue(1, row).GetAs<int32_t>());
+      }
+    }
+    std::sort(pairs.begin(), pairs.end());
+    ASSERT_EQ(pairs, expected) << block_size;
+    ASSERT_EQ(dynamic_cast<NestedLoopJoinExecutor *>(executor.get())->GetNumRightScans(),
+              (100 + block_size - 1) / block_size);
+  }
+}
+
 // SELECT test_4.colA, test_4.colB, test_6.colA, test_6.colB FROM test_4 JOIN test_6 ON test_4.colA = test_6.colA;
-TEST_F(ExecutorTest, DISABLED_SimpleHashJoinTest) {
+TEST_F(ExecutorTest, SimpleHashJoinTest) {
   // Construct sequential scan of table test_4
   const Schema *out_schema1{};
   std::unique_ptr<AbstractPlanNode> scan_plan1{};
@@ -487,7 +672,7 @@ TEST_F(ExecutorTest, DISABLED_SimpleHashJoinTest) {
 }
 
 // SELECT COUNT(col_a), SUM(col_a), min(col_a), max(col_a) from test_1;
-TEST_F(ExecutorTest, DISABLED_SimpleAggregationTest) {
+TEST_F(ExecutorTest, SimpleAggregationTest) {
   const Schema *scan_schema;
   std::unique_ptr<AbstractPlanNode> scan_plan;
   {
@@ -537,7 +722,7 @@ TEST_F(ExecutorTest, DISABLED_SimpleAggregationTest) {
 }
 
 // SELECT count(col_a), col_b, sum(col_c) FROM test_1 Group By col_b HAVING count(col_a) > 100
-TEST_F(ExecutorTest, DISABLED_SimpleGroupByAggregation) {
+TEST_F(ExecutorTest, SimpleGroupByAggregation) {
   const Schema *scan_schema;
   std::unique_ptr<AbstractPlanNode> scan_plan;
   {
@@ -589,6 +774,651 @@ TEST_F(ExecutorTest, DISABLED_SimpleGroupByAggregation) {
   }
 }
 
+// SELECT col_a, col_b FROM test_1 WHERE col_a < 600, a batch at a time
+TEST_F(ExecutorTest, BatchSeqScanTest) {
+  TableInfo *table_info = GetExecutorContext()->GetCatalog()->GetTable("test_1");
+  const Schema &schema = table_info->schema_;
+  auto *col_a = MakeColumnValueExpression(schema, 0, "colA");
+  auto *col_b = MakeColumnValueExpression(schema, 0, "colB");
+  auto *const600 = MakeConstantValueExpression(ValueFactory::GetIntegerValue(600));
+  auto *predicate = MakeComparisonExpression(col_a, const600, ComparisonType::LessThan);
+  auto *out_schema = MakeOutputSchema({{"colA", col_a}, {"colB", col_b}});
+  SeqScanPlanNode plan{out_schema, predicate, table_info->oid_};
+
+  auto executor = ExecutorFactory::CreateExecutor(GetExecutorContext(), &plan);
+  executor->Init();
+  TupleBatch batch{64};
+  std::vector<int32_t> col_as;
+  while (executor->NextBatch(&batch)) {
+    ASSERT_LE(batch.GetNumRows(), 64);
+    ASSERT_GT(batch.GetNumSelected(), 0);
+    for (uint32_t row : batch.GetSelection()) {
+      col_as.push_back(batch.GetValue(0, row).GetAs<int32_t>());
+      ASSERT_LT(batch.GetValue(1, row).GetAs<int32_t>(), 10);
+    }
+  }
+  std::vector<int32_t> expected(600);
+  std::iota(expected.begin(), expected.end(), 0);
+  ASSERT_EQ(col_as, expected);
+
+  // the same rows one at a time, after a re-initialization
+  executor->Init();
+  Tuple tuple;
+  RID rid;
+  col_as.clear();
+  while (executor->Next(&tuple, &rid)) {
+    col_as.push_back(tuple.GetValue(out_schema, 0).GetAs<int32_t>());
+  }
+  ASSERT_EQ(col_as, expected);
+}
+
+// SELECT t1.colA, t2.colA, t2.colB FROM test_1 t1 JOIN test_1 t2 ON t1.colA = t2.colA WHERE t2.colA < 600, a batch at
+// a time, with output batches smaller than the probe batches
+TEST_F(ExecutorTest, BatchHashJoinTest) {
+  TableInfo *table_info = GetExecutorContext()->GetCatalog()->GetTable("test_1");
+  const Schema &schema = table_info->schema_;
+  auto *col_a = MakeColumnValueExpression(schema, 0, "colA");
+  auto *col_b = MakeColumnValueExpression(schema, 0, "colB");
+  auto *scan_schema = MakeOutputSchema({{"colA", col_a}, {"colB", col_b}});
+  auto *const600 = MakeConstantValueExpression(ValueFactory::GetIntegerValue(600));
+  SeqScanPlanNode left_plan{scan_schema, nullptr, table_info->oid_};
+  SeqScanPlanNode right_plan{scan_schema, MakeComparisonExpression(col_a, const600, ComparisonType::LessThan),
+                             table_info->oid_};
+
+  auto *left_col_a = MakeColumnValueExpression(*scan_schema, 0, "colA");
+  auto *right_col_a = MakeColumnValueExpression(*scan_schema, 1, "colA");
+  auto *right_col_b = MakeColumnValueExpression(*scan_schema, 1, "colB");
+  auto *out_schema =
+      MakeOutputSchema({{"left_colA", left_col_a}, {"right_colA", right_col_a}, {"right_colB", right_col_b}});
+  HashJoinPlanNode join_plan{out_schema, {&left_plan, &right_plan}, left_col_a, right_col_a};
+
+  auto executor = ExecutorFactory::CreateExecutor(GetExecutorContext(), &join_plan);
+  executor->Init();
+  TupleBatch batch{100};
+  std::unordered_set<int32_t> col_as;
+  while (executor->NextBatch(&batch)) {
+    ASSERT_LE(batch.GetNumRows(), 100);
+    for (uint32_t row : batch.GetSelection()) {
+      auto left_col_a_val = batch.GetValue(0, row).GetAs<int32_t>();
+      ASSERT_EQ(left_col_a_val, batch.GetValue(1, row).GetAs<int32_t>());
+      ASSERT_LT(left_col_a_val, 600);
+      ASSERT_LT(batch.GetValue(2, row).GetAs<int32_t>(), 10);
+      ASSERT_EQ(col_as.count(left_col_a_val), 0);
+      col_as.insert(left_col_a_val);
+    }
+  }
+  ASSERT_EQ(col_as.size(), 600);
+}
+
+// NOLINTNEXTLINE
+TEST(JoinHashTableTest, PartitionedBuildTest) {
+  Schema schema{{Column{"colA", TypeId::INTEGER}}};
+  TupleBatch batch;
+  batch.Reset(&schema);
+  JoinHashTable table;
+  table.columns_.resize(1);
+  // enough rows for several partitions, each key on eight of them
+  const int32_t num_keys = 5000;
+  const uint32_t num_rows = 8 * num_keys;
+  for (uint32_t i = 0; i < num_rows; i++) {
+    batch.AppendRow({ValueFactory::GetIntegerValue(i % num_keys)}, RID{});
+    table.Append(batch, i, batch.GetValue(0, i), HashUtil::HashValue(&batch.GetValue(0, i)));
+  }
+  table.Build();
+  ASSERT_GT(table.GetNumPartitions(), 1);
+
+  for (int32_t key = -10; key < num_keys + 10; key++) {
+    Value value = ValueFactory::GetIntegerValue(key);
+    std::vector<uint32_t> rows;
+    for (uint32_t row = table.Find(value, HashUtil::HashValue(&value)); row != JoinHashTable::NO_ROW;
+         row = table.next_rows_[row]) {
+      rows.push_back(row);
+    }
+    if (key < 0 || key >= num_keys) {
+      ASSERT_TRUE(rows.empty()) << key;
+      continue;
+    }
+    // the rows of a key are chained in the order they were appended
+    ASSERT_EQ(rows.size(), 8) << key;
+    for (uint32_t i = 0; i < rows.size(); i++) {
+      ASSERT_EQ(rows[i], key + i * num_keys);
+      ASSERT_EQ(table.columns_[0][rows[i]].GetAs<int32_t>(), key);
+    }
+  }
+}
+
+// SELECT t1.colA, t2.colA FROM test_1 t1 JOIN test_1 t2 ON t1.colX = t2.colX, for colX = colA and the far more
+// skewed colB, under a memory budget of a tenth of the build side
+TEST_F(ExecutorTest, SpillingHashJoinTest) {
+  TableInfo *table_info = GetExecutorContext()->GetCatalog()->GetTable("test_1");
+  const Schema &schema = table_info->schema_;
+  auto *scan_schema = MakeOutputSchema({{"colA", MakeColumnValueExpression(schema, 0, "colA")},
+                                        {"colB", MakeColumnValueExpression(schema, 0, "colB")},
+                                        {"colC", MakeColumnValueExpression(schema, 0, "colC")},
+                                        {"colD", MakeColumnValueExpression(schema, 0, "colD")}});
+  SeqScanPlanNode left_plan{scan_schema, nullptr, table_info->oid_};
+  SeqScanPlanNode right_plan{scan_schema, nullptr, table_info->oid_};
+  auto *left_col_a = MakeColumnValueExpression(*scan_schema, 0, "colA");
+  auto *right_col_a = MakeColumnValueExpression(*scan_schema, 1, "colA");
+  auto *out_schema = MakeOutputSchema({{"left_colA", left_col_a}, {"right_colA", right_col_a}});
+  // the estimated size of a build row, as the join counts it
+  const size_t memory_budget = TEST1_SIZE * (5 * sizeof(Value) + sizeof(hash_t) + sizeof(uint32_t)) / 10;
+
+  for (uint32_t key_idx : {0, 1}) {
+    const char *key_name = key_idx == 0 ? "colA" : "colB";
+    auto *left_key = MakeColumnValueExpression(*scan_schema, 0, key_name);
+    auto *right_key = MakeColumnValueExpression(*scan_schema, 1, key_name);
+    auto run = [&](size_t budget, size_t *num_spilled_partitions) {
+      HashJoinPlanNode join_plan{out_schema, {&left_plan, &right_plan}, left_key, right_key, budget};
+      auto executor = ExecutorFactory::CreateExecutor(GetExecutorContext(), &join_plan);
+      executor->Init();
+      std::vector<std::pair<int32_t, int32_t>> pairs;
+      TupleBatch batch;
+      while (executor->NextBatch(&batch)) {
+        for (uint32_t row : batch.GetSelection()) {
+          pairs.emplace_back(batch.GetValue(0, row).GetAs<int32_t>(), batch.GetValue(1, row).GetAs<int32_t>());
+        }
+      }
+      *num_spilled_partitions = dynamic_cast<HashJoinExecutor *>(executor.get())->GetNumSpilledPartitions();
+      std::sort(pairs.begin(), pairs.end());
+      return pairs;
+    };
+
+    size_t num_spilled_partitions;
+    auto expected = run(HashJoinPlanNode::NO_MEMORY_BUDGET, &num_spilled_partitions);
+    ASSERT_EQ(num_spilled_partitions, 0);
+    if (key_idx == 0) {
+      ASSERT_EQ(expected.size(), TEST1_SIZE);
+    } else {
+      // ten values of colB, each on about a hundred rows and so about a budget's worth of them
+      ASSERT_GT(expected.size(), 50 * TEST1_SIZE);
+    }
+    auto spilled = run(memory_budget, &num_spilled_partitions);
+    ASSERT_GT(num_spilled_partitions, 0);
+    ASSERT_EQ(spilled, expected) << key_name;
+  }
+}
+
+// NOLINTNEXTLINE
+TEST(JoinFilterTest, BasicTest) {
+  // every tenth integer in [100, 10000)
+  std::vector<Value> keys;
+  std::vector<hash_t> hashes;
+  for (int32_t key = 100; key < 10000; key += 10) {
+    keys.push_back(ValueFactory::GetIntegerValue(key));
+    hashes.push_back(HashUtil::HashValue(&keys.back()));
+  }
+  JoinFilter filter{keys, hashes};
+  for (const auto &key : keys) {
+    ASSERT_TRUE(filter.MayContain(key));
+  }
+  // a key of another integer type still matches
+  ASSERT_TRUE(filter.MayContain(ValueFactory::GetBigIntValue(5000)));
+  ASSERT_FALSE(filter.MayContain(ValueFactory::GetIntegerValue(99)));
+  ASSERT_FALSE(filter.MayContain(ValueFactory::GetIntegerValue(9991)));
+  ASSERT_FALSE(filter.MayContain(ValueFactory::GetNullValueByType(TypeId::INTEGER)));
+  uint32_t num_false_positives = 0;
+  for (int32_t key = 101; key < 10000; key += 10) {
+    num_false_positives += filter.MayContain(ValueFactory::GetIntegerValue(key)) ? 1 : 0;
+  }
+  ASSERT_LT(num_false_positives, keys.size() / 20);
+
+  // keys with no range to speak of are left to the Bloom filter
+  std::vector<Value> names{ValueFactory::GetVarcharValue(std::string("alice")),
+                           ValueFactory::GetVarcharValue(std::string("bob"))};
+  std::vector<hash_t> name_hashes{HashUtil::HashValue(&names[0]), HashUtil::HashValue(&names[1])};
+  JoinFilter name_filter{names, name_hashes};
+  ASSERT_TRUE(name_filter.MayContain(ValueFactory::GetVarcharValue(std::string("bob"))));
+
+  // nothing matches an empty build side
+  JoinFilter empty_filter{{}, {}};
+  ASSERT_FALSE(empty_filter.MayContain(ValueFactory::GetIntegerValue(0)));
+}
+
+// SELECT t1.colA, t2.colA FROM test_1 t1 JOIN test_1 t2 ON t1.colA = t2.colA WHERE t1.colA < 100
+TEST_F(ExecutorTest, JoinFilterPushDownTest) {
+  TableInfo *table_info = GetExecutorContext()->GetCatalog()->GetTable("test_1");
+  const Schema &schema = table_info->schema_;
+  auto *col_a = MakeColumnValueExpression(schema, 0, "colA");
+  auto *col_b = MakeColumnValueExpression(schema, 0, "colB");
+  auto *scan_schema = MakeOutputSchema({{"colB", col_b}, {"colA", col_a}});
+  auto *const100 = MakeConstantValueExpression(ValueFactory::GetIntegerValue(100));
+
+  // a filter pushed into a scan drops the tuples it rules out, and only those
+  std::vector<Value> keys;
+  std::vector<hash_t> hashes;
+  for (int32_t key = 0; key < 100; key++) {
+    keys.push_back(ValueFactory::GetIntegerValue(key));
+    hashes.push_back(HashUtil::HashValue(&keys.back()));
+  }
+  JoinFilter filter{keys, hashes};
+  SeqScanPlanNode scan_plan{scan_schema, nullptr, table_info->oid_};
+  auto scan = ExecutorFactory::CreateExecutor(GetExecutorContext(), &scan_plan);
+  scan->Init();
+  ASSERT_TRUE(scan->PushDownJoinFilter(&filter, 1));
+  std::vector<int32_t> col_as;
+  TupleBatch batch;
+  while (scan->NextBatch(&batch)) {
+    for (uint32_t row : batch.GetSelection()) {
+      col_as.push_back(batch.GetValue(1, row).GetAs<int32_t>());
+    }
+  }
+  std::sort(col_as.begin(), col_as.end());
+  ASSERT_EQ(col_as.size(), 100);
+  ASSERT_EQ(col_as.front(), 0);
+  ASSERT_EQ(col_as.back(), 99);
+  // and Init drops the filter
+  scan->Init();
+  uint32_t num_selected = 0;
+  while (scan->NextBatch(&batch)) {
+    num_selected += batch.GetNumSelected();
+  }
+  ASSERT_EQ(num_selected, TEST1_SIZE);
+
+  // the join pushes its own filter into the probe side, scanned on one thread or several
+  SeqScanPlanNode left_plan{scan_schema, MakeComparisonExpression(col_a, const100, ComparisonType::LessThan),
+                            table_info->oid_};
+  auto *left_col_a = MakeColumnValueExpression(*scan_schema, 0, "colA");
+  auto *right_col_a = MakeColumnValueExpression(*scan_schema, 1, "colA");
+  auto *out_schema = MakeOutputSchema({{"left_colA", left_col_a}, {"right_colA", right_col_a}});
+  for (uint32_t num_threads : {1, 4}) {
+    SeqScanPlanNode right_plan{scan_schema, nullptr, table_info->oid_, num_threads};
+    HashJoinPlanNode join_plan{out_schema, {&left_plan, &right_plan}, left_col_a, right_col_a};
+    std::vector<Tuple> result_set{};
+    GetExecutionEngine()->Execute(&join_plan, &result_set, GetTxn(), GetExecutorContext());
+    col_as.clear();
+    for (const auto &tuple : result_set) {
+      ASSERT_EQ(tuple.GetValue(out_schema, 0).GetAs<int32_t>(), tuple.GetValue(out_schema, 1).GetAs<int32_t>());
+      col_as.push_back(tuple.GetValue(out_schema, 0).GetAs<int32_t>());
+    }
+    std::sort(col_as.begin(), col_as.end());
+    std::vector<int32_t> expected(100);
+    std::iota(expected.begin(), expected.end(), 0);
+    ASSERT_EQ(col_as, expected) << num_threads << " threads";
+  }
+}
+
+namespace {
+
+// SELECT k, s, COUNT(v), SUM(v), MIN(v), MAX(v) FROM t GROUP BY k, s, where s is a SMALLINT
+struct GroupByTestPlan {
+  ColumnValueExpression key_{0, 0, TypeId::INTEGER};
+  ColumnValueExpression small_key_{0, 1, TypeId::SMALLINT};
+  ColumnValueExpression input_{0, 2, TypeId::INTEGER};
+  AggregationPlanNode plan_{nullptr,
+                            nullptr,
+                            nullptr,
+                            {&key_, &small_key_},
+                            {&input_, &input_, &input_, &input_},
+                            {AggregationType::CountAggregate, AggregationType::SumAggregate,
+                             AggregationType::MinAggregate, AggregationType::MaxAggregate}};
+};
+
+// a batch of the columns of t, in the layout the aggregation evaluates them into
+void MakeGroupByBatch(std::mt19937 *rng, uint32_t num_rows, int32_t num_keys, bool with_nulls,
+                      std::vector<std::vector<Value>> *group_by_columns,
+                      std::vector<std::vector<Value>> *aggregate_columns) {
+  group_by_columns->assign(2, {});
+  aggregate_columns->assign(4, {});
+  for (uint32_t row = 0; row < num_rows; row++) {
+    auto key = static_cast<int32_t>((*rng)() % num_keys);
+    auto small_key = static_cast<int16_t>((*rng)() % (with_nulls ? 4 : 3));
+    (*group_by_columns)[0].push_back(ValueFactory::GetIntegerValue(key));
+    // the nulls of a key column make a group of their own, and those of an input make its aggregates null
+    (*group_by_columns)[1].push_back(small_key == 3 ? ValueFactory::GetNullValueByType(TypeId::SMALLINT)
+                                                    : ValueFactory::GetSmallIntValue(small_key));
+    Value input = with_nulls && key % 50 == 7 && (*rng)() % 10 == 0 ? ValueFactory::GetNullValueByType(TypeId::INTEGER)
+                                                       : ValueFactory::GetIntegerValue((*rng)() % 2001 - 1000);
+    for (auto &column : *aggregate_columns) {
+      column.push_back(input);
+    }
+  }
+}
+
+// every group of the table, as its key (a null small key as -1) and its aggregates (a null one as INT32_MIN)
+std::map<std::pair<int32_t, int32_t>, std::vector<int32_t>> ReadGroups(const FlatAggregationTable &table) {
+  std::map<std::pair<int32_t, int32_t>, std::vector<int32_t>> groups;
+  std::vector<Value> group_bys;
+  std::vector<Value> aggregates;
+  for (uint32_t partition = 0; partition < table.GetNumPartitions(); partition++) {
+    for (uint32_t group = 0; group < table.GetNumGroups(partition); group++) {
+      table.GetGroup(partition, group, &group_bys, &aggregates);
+      std::pair<int32_t, int32_t> key{group_bys[0].GetAs<int32_t>(),
+                                      group_bys[1].IsNull() ? -1 : group_bys[1].GetAs<int16_t>()};
+      EXPECT_EQ(groups.count(key), 0);
+      for (const auto &aggregate : aggregates) {
+        groups[key].push_back(aggregate.IsNull() ? BUSTUB_INT32_NULL : aggregate.GetAs<int32_t>());
+      }
+    }
+  }
+  return groups;
+}
+
+}  // namespace
+
+// NOLINTNEXTLINE
+TEST(FlatAggregationTableTest, GroupByTest) {
+  GroupByTestPlan test_plan;
+  ASSERT_TRUE(FlatAggregationTable::CanAggregate(&test_plan.plan_));
+  FlatAggregationTable table{&test_plan.plan_, 0};
+  FlatAggregationTable partitioned[2] = {{&test_plan.plan_, FlatAggregationTable::PARALLEL_PARTITION_BITS},
+                                         {&test_plan.plan_, FlatAggregationTable::PARALLEL_PARTITION_BITS}};
+
+  // the aggregates of every group, computed on the side
+  std::map<std::pair<int32_t, int32_t>, std::vector<int32_t>> expected;
+  std::mt19937 rng(15445);
+  std::vector<std::vector<Value>> group_by_columns;
+  std::vector<std::vector<Value>> aggregate_columns;
+  for (int batch = 0; batch < 20; batch++) {
+    MakeGroupByBatch(&rng, 1000, 1000, true, &group_by_columns, &aggregate_columns);
+    // every other row
+    std::vector<uint32_t> rows;
+    for (uint32_t row = batch % 2; row < 1000; row += 2) {
+      rows.push_back(row);
+      const Value &small_key = group_by_columns[1][row];
+      std::pair<int32_t, int32_t> key{group_by_columns[0][row].GetAs<int32_t>(),
+                                      small_key.IsNull() ? -1 : small_key.GetAs<int16_t>()};
+      auto [it, inserted] = expected.try_emplace(key, std::vector<int32_t>{0, 0, BUSTUB_INT32_MAX, BUSTUB_INT32_MIN});
+      auto &aggregates = it->second;
+      aggregates[0]++;
+      const Value &input = aggregate_columns[0][row];
+      if (input.IsNull() || aggregates[1] == BUSTUB_INT32_NULL) {
+        aggregates[1] = aggregates[2] = aggregates[3] = BUSTUB_INT32_NULL;
+        continue;
+      }
+      aggregates[1] += input.GetAs<int32_t>();
+      aggregates[2] = std::min(aggregates[2], input.GetAs<int32_t>());
+      aggregates[3] = std::max(aggregates[3], input.GetAs<int32_t>());
+    }
+    table.InsertBatch(group_by_columns, aggregate_columns, rows);
+    partitioned[batch % 2].InsertBatch(group_by_columns, aggregate_columns, rows);
+  }
+  ASSERT_GT(expected.size(), 2000);
+  ASSERT_EQ(ReadGroups(table), expected);
+
+  // two partitioned tables merge into the groups of one
+  for (uint32_t partition = 0; partition < partitioned[0].GetNumPartitions(); partition++) {
+    partitioned[0].MergePartition(partition, partitioned[1]);
+  }
+  ASSERT_EQ(ReadGroups(partitioned[0]), expected);
+
+  table.Clear();
+  ASSERT_EQ(table.GetNumGroups(0), 0);
+  ASSERT_TRUE(ReadGroups(table).empty());
+}
+
+// SELECT t1.colA, t2.colA FROM test_1 t1 JOIN test_1 t2 ON t1.key <op> t2.key [AND t1.colD < t2.colD], merging children
+// ordered by an index scan or a sort
+TEST_F(ExecutorTest, MergeJoinTest) {
+  TableInfo *table_info = GetExecutorContext()->GetCatalog()->GetTable("test_1");
+  const Schema &schema = table_info->schema_;
+  auto *scan_schema = MakeOutputSchema({{"colA", MakeColumnValueExpression(schema, 0, "colA")},
+                                        {"colB", MakeColumnValueExpression(schema, 0, "colB")},
+                                        {"colD", MakeColumnValueExpression(schema, 0, "colD")}});
+  auto *left_col_a = MakeColumnValueExpression(*scan_schema, 0, "colA");
+  auto *right_col_a = MakeColumnValueExpression(*scan_schema, 1, "colA");
+  auto *left_col_b = MakeColumnValueExpression(*scan_schema, 0, "colB");
+  auto *right_col_b = MakeColumnValueExpression(*scan_schema, 1, "colB");
+  auto *left_col_d = MakeColumnValueExpression(*scan_schema, 0, "colD");
+  auto *right_col_d = MakeColumnValueExpression(*scan_schema, 1, "colD");
+  auto *out_schema = MakeOutputSchema({{"left_colA", left_col_a}, {"right_colA", right_col_a}});
+  auto *col_a = MakeColumnValueExpression(*scan_schema, 0, "colA");
+  auto *col_b = MakeColumnValueExpression(*scan_schema, 0, "colB");
+
+  // the colA pairs of a join, in the order it produces them, and the largest window it held
+  auto run = [&](const MergeJoinPlanNode &plan, size_t *max_window_size) {
+    auto executor = ExecutorFactory::CreateExecutor(GetExecutorContext(), &plan);
+    executor->Init();
+    std::vector<std::pair<int32_t, int32_t>> pairs;
+    TupleBatch batch;
+    while (executor->NextBatch(&batch)) {
+      for (uint32_t row : batch.GetSelection()) {
+        pairs.emplace_back(batch.GetValue(0, row).GetAs<int32_t>(), batch.GetValue(1, row).GetAs<int32_t>());
+      }
+    }
+    *max_window_size = dynamic_cast<MergeJoinExecutor *>(executor.get())->GetMaxWindowSize();
+    return pairs;
+  };
+  size_t max_window_size;
+
+  // on colA, between a B+ tree index scan and a sort of a scan that produces colA in order anyway
+  auto *index_info =
+      GetExecutorContext()->GetCatalog()->CreateIndex(GetTxn(), "index1", "test_1", schema, {0}, IndexType::BPlusTree);
+  IndexScanPlanNode index_plan{scan_schema, nullptr, index_info->index_oid_};
+  SeqScanPlanNode scan_plan{scan_schema, nullptr, table_info->oid_};
+  SortPlanNode sort_a_plan{scan_schema, &scan_plan, {{OrderByType::Asc, col_a}}};
+  MergeJoinPlanNode a_plan{out_schema, {&index_plan, &sort_a_plan}, left_col_a, right_col_a};
+  auto pairs = run(a_plan, &max_window_size);
+  ASSERT_EQ(pairs.size(), TEST1_SIZE);
+  for (uint32_t i = 0; i < pairs.size(); i++) {
+    ASSERT_EQ(pairs[i], std::make_pair(static_cast<int32_t>(i), static_cast<int32_t>(i)));
+  }
+  // the children are walked in step, one row of each at a time
+  ASSERT_EQ(max_window_size, 1);
+
+  // the rows of a subset of test_1 and their sort on colB, for joins whose output brute force can check
+  auto *const200 = MakeConstantValueExpression(ValueFactory::GetIntegerValue(200));
+  SeqScanPlanNode subset_plan{scan_schema, MakeComparisonExpression(col_a, const200, ComparisonType::LessThan),
+                              table_info->oid_};
+  SortPlanNode sort_b_plan{scan_schema, &subset_plan, {{OrderByType::Asc, col_b}}};
+  std::vector<Tuple> result_set{};
+  GetExecutionEngine()->Execute(&subset_plan, &result_set, GetTxn(), GetExecutorContext());
+  std::vector<std::array<int32_t, 3>> rows;
+  for (const auto &tuple : result_set) {
+    rows.push_back({tuple.GetValue(scan_schema, 0).GetAs<int32_t>(), tuple.GetValue(scan_schema, 1).GetAs<int32_t>(),
+                    tuple.GetValue(scan_schema, 2).GetAs<int32_t>()});
+  }
+  ASSERT_EQ(rows.size(), 200);
+
+  auto *predicate = MakeComparisonExpression(left_col_d, right_col_d, ComparisonType::LessThan);
+  for (auto comparison : {ComparisonType::Equal, ComparisonType::LessThan, ComparisonType::LessThanOrEqual,
+                          ComparisonType::GreaterThan, ComparisonType::GreaterThanOrEqual}) {
+    for (bool with_predicate : {false, true}) {
+      MergeJoinPlanNode b_plan{out_schema, {&sort_b_plan, &sort_b_plan}, left_col_b, right_col_b, comparison,
+                               with_predicate ? predicate : nullptr};
+      auto joins = [&](const std::array<int32_t, 3> &left, const std::array<int32_t, 3> &right) {
+        bool keys_join = (comparison == ComparisonType::Equal && left[1] == right[1]) ||
+                         (comparison == ComparisonType::LessThan && left[1] < right[1]) ||
+                         (comparison == ComparisonType::LessThanOrEqual && left[1] <= right[1]) ||
+                         (comparison == ComparisonType::GreaterThan && left[1] > right[1]) ||
+                         (comparison == ComparisonType::GreaterThanOrEqual && left[1] >= right[1]);
+        return keys_join && (!with_predicate || left[2] < right[2]);
+      };
+      std::vector<std::pair<int32_t, int32_t>> expected;
+      std::map<int32_t, int32_t> col_bs;
+      for (const auto &left : rows) {
+        col_bs[left[0]] = left[1];
+        for (const auto &right : rows) {
+          if (joins(left, right)) {
+            expected.emplace_back(left[0], right[0]);
+          }
+        }
+      }
+      auto b_pairs = run(b_plan, &max_window_size);
+      // the output follows the order of the left child
+      for (uint32_t i = 1; i < b_pairs.size(); i++) {
+        ASSERT_LE(col_bs[b_pairs[i - 1].first], col_bs[b_pairs[i].first]);
+      }
+      std::sort(b_pairs.begin(), b_pairs.end());
+      std::sort(expected.begin(), expected.end());
+      ASSERT_EQ(b_pairs, expected);
+      if (comparison == ComparisonType::Equal) {
+        // one run of duplicates at a time, of which colB has ten
+        ASSERT_LT(max_window_size, rows.size() / 5);
+      }
+    }
+  }
+
+  // a child out of order on its key cannot be merged
+  MergeJoinPlanNode unordered_plan{out_schema, {&sort_b_plan, &subset_plan}, left_col_b, right_col_b};
+  EXPECT_THROW(run(unordered_plan, &max_window_size), Exception);
+}
+
+// NOLINTNEXTLINE
+TEST(SortKeyEncoderTest, OrderTest) {
+  Schema schema{{Column{"colA", TypeId::INTEGER}, Column{"colB", TypeId::VARCHAR, 16}}};
+  ColumnValueExpression col_a{0, 0, TypeId::INTEGER};
+  ColumnValueExpression col_b{0, 1, TypeId::VARCHAR};
+  TupleBatch batch;
+  batch.Reset(&schema);
+  // integers of either sign and strings that prefix each other, with nulls among both
+  std::vector<Value> ints{ValueFactory::GetIntegerValue(-7), ValueFactory::GetIntegerValue(0),
+                          ValueFactory::GetIntegerValue(3), ValueFactory::GetNullValueByType(TypeId::INTEGER)};
+  std::vector<Value> strings{ValueFactory::GetVarcharValue(""), ValueFactory::GetVarcharValue("ab"),
+                             ValueFactory::GetVarcharValue("abc"), ValueFactory::GetVarcharValue("b"),
+                             ValueFactory::GetNullValueByType(TypeId::VARCHAR)};
+  for (const auto &int_value : ints) {
+    for (const auto &string_value : strings) {
+      batch.AppendRow({int_value, string_value}, RID{});
+    }
+  }
+
+  for (auto a_type : {OrderByType::Asc, OrderByType::Desc}) {
+    for (auto b_type : {OrderByType::Asc, OrderByType::Desc}) {
+      std::vector<OrderBy> order_bys{{a_type, &col_a}, {b_type, &col_b}};
+      SortKeyEncoder encoder{order_bys};
+      std::vector<std::string> keys;
+      encoder.EncodeBatch(batch, &keys);
+      ASSERT_EQ(keys.size(), batch.GetNumRows());
+
+      // -1, 0 or 1 as row a comes before, ties with or comes after row b on a key: NULL is the smallest value
+      auto compare = [&](uint32_t col_idx, OrderByType type, uint32_t a, uint32_t b) {
+        const Value &value_a = batch.GetValue(col_idx, a);
+        const Value &value_b = batch.GetValue(col_idx, b);
+        int cmp;
+        if (value_a.IsNull() || value_b.IsNull()) {
+          cmp = static_cast<int>(!value_a.IsNull()) - static_cast<int>(!value_b.IsNull());
+        } else if (value_a.CompareEquals(value_b) == CmpBool::CmpTrue) {
+          cmp = 0;
+        } else {
+          cmp = value_a.CompareLessThan(value_b) == CmpBool::CmpTrue ? -1 : 1;
+        }
+        return type == OrderByType::Asc ? cmp : -cmp;
+      };
+      for (uint32_t a = 0; a < batch.GetNumRows(); a++) {
+        for (uint32_t b = 0; b < batch.GetNumRows(); b++) {
+          int expected = compare(0, a_type, a, b);
+          if (expected == 0) {
+            expected = compare(1, b_type, a, b);
+          }
+          int cmp = keys[a].compare(keys[b]);
+          ASSERT_EQ((cmp > 0) - (cmp < 0), expected) << a << " " << b;
+        }
+      }
+    }
+  }
+}
+
+// SELECT colA, colB, colC, colD FROM test_1 ORDER BY colB DESC, and ORDER BY colB, colD DESC, in memory and spilling
+TEST_F(ExecutorTest, SortTest) {
+  TableInfo *table_info = GetExecutorContext()->GetCatalog()->GetTable("test_1");
+  const Schema &schema = table_info->schema_;
+  auto *scan_schema = MakeOutputSchema({{"colA", MakeColumnValueExpression(schema, 0, "colA")},
+                                        {"colB", MakeColumnValueExpression(schema, 0, "colB")},
+                                        {"colC", MakeColumnValueExpression(schema, 0, "colC")},
+                                        {"colD", MakeColumnValueExpression(schema, 0, "colD")}});
+  SeqScanPlanNode scan_plan{scan_schema, nullptr, table_info->oid_};
+  auto *col_b = MakeColumnValueExpression(*scan_schema, 0, "colB");
+  auto *col_d = MakeColumnValueExpression(*scan_schema, 0, "colD");
+
+  // the rows of the scan, in the order it produces them
+  std::vector<std::vector<int32_t>> scan_rows;
+  std::vector<Tuple> result_set{};
+  GetExecutionEngine()->Execute(&scan_plan, &result_set, GetTxn(), GetExecutorContext());
+  for (const auto &tuple : result_set) {
+    scan_rows.emplace_back();
+    for (uint32_t col_idx = 0; col_idx < 4; col_idx++) {
+      scan_rows.back().push_back(tuple.GetValue(scan_schema, col_idx).GetAs<int32_t>());
+    }
+  }
+  ASSERT_EQ(scan_rows.size(), TEST1_SIZE);
+
+  auto run = [&](std::vector<OrderBy> order_bys, size_t budget, size_t *num_spilled_runs) {
+    SortPlanNode sort_plan{scan_schema, &scan_plan, std::move(order_bys), budget};
+    auto executor = ExecutorFactory::CreateExecutor(GetExecutorContext(), &sort_plan);
+    executor->Init();
+    std::vector<std::vector<int32_t>> rows;
+    TupleBatch batch;
+    while (executor->NextBatch(&batch)) {
+      for (uint32_t row : batch.GetSelection()) {
+        rows.emplace_back();
+        for (uint32_t col_idx = 0; col_idx < 4; col_idx++) {
+          rows.back().push_back(batch.GetValue(col_idx, row).GetAs<int32_t>());
+        }
+      }
+    }
+    *num_spilled_runs = dynamic_cast<SortExecutor *>(executor.get())->GetNumSpilledRuns();
+    return rows;
+  };
+
+  // the sort is stable, so rows with equal keys stay in the order of the scan
+  auto expected_b = scan_rows;
+  std::stable_sort(expected_b.begin(), expected_b.end(), [](const auto &a, const auto &b) { return a[1] > b[1]; });
+  auto expected_bd = scan_rows;
+  std::stable_sort(expected_bd.begin(), expected_bd.end(),
+                   [](const auto &a, const auto &b) { return a[1] < b[1] || (a[1] == b[1] && a[3] > b[3]); });
+
+  // two pages of budget merge two runs at a time, so the runs of about two hundred rows each take several passes
+  for (size_t budget : {SortPlanNode::NO_MEMORY_BUDGET, static_cast<size_t>(2 * PAGE_SIZE)}) {
+    size_t num_spilled_runs;
+    ASSERT_EQ(run({{OrderByType::Desc, col_b}}, budget, &num_spilled_runs), expected_b);
+    ASSERT_EQ(run({{OrderByType::Asc, col_b}, {OrderByType::Desc, col_d}}, budget, &num_spilled_runs), expected_bd);
+    if (budget == SortPlanNode::NO_MEMORY_BUDGET) {
+      ASSERT_EQ(num_spilled_runs, 0);
+    } else {
+      ASSERT_GT(num_spilled_runs, 4);
+    }
+  }
+
+  // a sort of nothing
+  auto *const0 = MakeConstantValueExpression(ValueFactory::GetIntegerValue(0));
+  SeqScanPlanNode empty_scan_plan{scan_schema, MakeComparisonExpression(col_b, const0, ComparisonType::LessThan),
+                                  table_info->oid_};
+  SortPlanNode empty_sort_plan{scan_schema, &empty_scan_plan, {{OrderByType::Asc, col_b}}};
+  result_set.clear();
+  GetExecutionEngine()->Execute(&empty_sort_plan, &result_set, GetTxn(), GetExecutorContext());
+  ASSERT_TRUE(result_set.empty());
+}
+
+// SELECT colA, colB, colD FROM test_1 ORDER BY colB, colD DESC LIMIT n
+TEST_F(ExecutorTest, TopNTest) {
+  TableInfo *table_info = GetExecutorContext()->GetCatalog()->GetTable("test_1");
+  const Schema &schema = table_info->schema_;
+  auto *scan_schema = MakeOutputSchema({{"colA", MakeColumnValueExpression(schema, 0, "colA")},
+                                        {"colB", MakeColumnValueExpression(schema, 0, "colB")},
+                                        {"colD", MakeColumnValueExpression(schema, 0, "colD")}});
+  SeqScanPlanNode scan_plan{scan_schema, nullptr, table_info->oid_};
+  auto *col_b = MakeColumnValueExpression(*scan_schema, 0, "colB");
+  auto *col_d = MakeColumnValueExpression(*scan_schema, 0, "colD");
+
+  // colA identifies a row
+  auto col_as = [&](const AbstractPlanNode *plan) {
+    std::vector<Tuple> result_set{};
+    GetExecutionEngine()->Execute(plan, &result_set, GetTxn(), GetExecutorContext());
+    std::vector<int32_t> col_as;
+    for (const auto &tuple : result_set) {
+      col_as.push_back(tuple.GetValue(scan_schema, 0).GetAs<int32_t>());
+    }
+    return col_as;
+  };
+  SortPlanNode sort_plan{scan_schema, &scan_plan, {{OrderByType::Asc, col_b}, {OrderByType::Desc, col_d}}};
+  auto sorted = col_as(&sort_plan);
+  ASSERT_EQ(sorted.size(), TEST1_SIZE);
+
+  // a handful of rows, a batch's worth and more, all of them, and none
+  for (size_t n : {1, 10, 150, 1100, 999, 1000, 2000, 0}) {
+    TopNPlanNode topn_plan{scan_schema, &scan_plan, {{OrderByType::Asc, col_b}, {OrderByType::Desc, col_d}}, n};
+    std::vector<int32_t> expected(sorted.begin(), sorted.begin() + std::min<size_t>(n, sorted.size()));
+    ASSERT_EQ(col_as(&topn_plan), expected) << n;
+  }
+
+  // ties on colB alone are broken by the order of the scan
+  TopNPlanNode ties_plan{scan_schema, &scan_plan, {{OrderByType::Desc, col_b}}, 50};
+  SortPlanNode ties_sort_plan{scan_schema, &scan_plan, {{OrderByType::Desc, col_b}}};
+  auto ties_sorted = col_as(&ties_sort_plan);
+  ASSERT_EQ(col_as(&ties_plan), std::vector<int32_t>(ties_sorted.begin(), ties_sorted.begin() + 50));
+}
+
 // SELECT colA, colB FROM test_3 LIMIT 10
 TEST_F(ExecutorTest, DISABLED_SimpleLimitTest) {
   auto *table_info = GetExecutorContext()->GetCatalog()->GetTable("test_3");
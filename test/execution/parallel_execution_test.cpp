@@ -0,0 +1,211 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// parallel_execution_test.cpp
+//
+// Identification: test/execution/parallel_execution_test.cpp
+//
+// Copyright (c) 2015-2021, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include <algorithm>
+#include <map>
+#include <memory>
+#include <numeric>
+#include <vector>
+
+#include "execution/execution_engine.h"
+#include "execution/executor_context.h"
+#include "execution/executors/seq_scan_executor.h"
+#include "execution/plans/aggregation_plan.h"
+#include "execution/plans/hash_join_plan.h"
+#include "execution/plans/seq_scan_plan.h"
+#include "executor_test_util.h"  // NOLINT
+#include "gtest/gtest.h"
+#include "type/value_factory.h"
+
+namespace bustub {
+
+namespace {
+
+// enough workers to contend for the morsels of test_1, whose pages each make a morsel of their own
+constexpr uint32_t NUM_WORKERS = 4;
+constexpr uint32_t MORSEL_SIZE = 1;
+
+}  // namespace
+
+// SELECT colA, colB FROM test_1 WHERE colA < 600
+TEST_F(ExecutorTest, ParallelSeqScanTest) {
+  TableInfo *table_info = GetExecutorContext()->GetCatalog()->GetTable("test_1");
+  const Schema &schema = table_info->schema_;
+  auto *col_a = MakeColumnValueExpression(schema, 0, "colA");
+  auto *col_b = MakeColumnValueExpression(schema, 0, "colB");
+  auto *const600 = MakeConstantValueExpression(ValueFactory::GetIntegerValue(600));
+  auto *predicate = MakeComparisonExpression(col_a, const600, ComparisonType::LessThan);
+  auto *out_schema = MakeOutputSchema({{"colA", col_a}, {"colB", col_b}});
+  SeqScanPlanNode plan{out_schema, predicate, table_info->oid_};
+
+  std::vector<Tuple> result_set{};
+  GetExecutionEngine()->ExecuteParallel(&plan, &result_set, GetTxn(), GetExecutorContext(), NUM_WORKERS, MORSEL_SIZE);
+
+  std::vector<int32_t> col_as;
+  for (const auto &tuple : result_set) {
+    col_as.push_back(tuple.GetValue(out_schema, 0).GetAs<int32_t>());
+    ASSERT_LT(tuple.GetValue(out_schema, 1).GetAs<int32_t>(), 10);
+  }
+  std::sort(col_as.begin(), col_as.end());
+  std::vector<int32_t> expected(600);
+  std::iota(expected.begin(), expected.end(), 0);
+  ASSERT_EQ(col_as, expected);
+}
+
+// SELECT colA, colB FROM test_1 WHERE colA < 600, on scan threads of its own
+TEST_F(ExecutorTest, ThreadedSeqScanTest) {
+  TableInfo *table_info = GetExecutorContext()->GetCatalog()->GetTable("test_1");
+  const Schema &schema = table_info->schema_;
+  auto *col_a = MakeColumnValueExpression(schema, 0, "colA");
+  auto *col_b = MakeColumnValueExpression(schema, 0, "colB");
+  auto *const600 = MakeConstantValueExpression(ValueFactory::GetIntegerValue(600));
+  auto *predicate = MakeComparisonExpression(col_a, const600, ComparisonType::LessThan);
+  auto *out_schema = MakeOutputSchema({{"colA", col_a}, {"colB", col_b}});
+  SeqScanPlanNode plan{out_schema, predicate, table_info->oid_, NUM_WORKERS};
+
+  std::vector<Tuple> result_set{};
+  GetExecutionEngine()->Execute(&plan, &result_set, GetTxn(), GetExecutorContext());
+  std::vector<int32_t> col_as;
+  for (const auto &tuple : result_set) {
+    col_as.push_back(tuple.GetValue(out_schema, 0).GetAs<int32_t>());
+    ASSERT_LT(tuple.GetValue(out_schema, 1).GetAs<int32_t>(), 10);
+  }
+  std::sort(col_as.begin(), col_as.end());
+  std::vector<int32_t> expected(600);
+  std::iota(expected.begin(), expected.end(), 0);
+  ASSERT_EQ(col_as, expected);
+
+  // small batches keep the threads waiting on the queue, where stopping them early must find them
+  SeqScanExecutor executor{GetExecutorContext(), &plan};
+  TupleBatch batch{8};
+  for (int run = 0; run < 2; run++) {
+    executor.Init();
+    ASSERT_TRUE(executor.NextBatch(&batch));
+    ASSERT_LE(batch.GetNumRows(), 8);
+  }
+  executor.Init();
+  uint32_t num_selected = 0;
+  while (executor.NextBatch(&batch)) {
+    num_selected += batch.GetNumSelected();
+  }
+  ASSERT_EQ(num_selected, 600);
+  ASSERT_FALSE(executor.NextBatch(&batch));
+}
+
+// SELECT colB, COUNT(colA), SUM(colC), MIN(colD), MAX(colD) FROM test_1 GROUP BY colB
+TEST_F(ExecutorTest, ParallelGroupByAggregationTest) {
+  TableInfo *table_info = GetExecutorContext()->GetCatalog()->GetTable("test_1");
+  const Schema &schema = table_info->schema_;
+  auto *scan_schema = MakeOutputSchema({{"colA", MakeColumnValueExpression(schema, 0, "colA")},
+                                        {"colB", MakeColumnValueExpression(schema, 0, "colB")},
+                                        {"colC", MakeColumnValueExpression(schema, 0, "colC")},
+                                        {"colD", MakeColumnValueExpression(schema, 0, "colD")}});
+  SeqScanPlanNode scan_plan{scan_schema, nullptr, table_info->oid_};
+
+  const AbstractExpression *col_a = MakeColumnValueExpression(*scan_schema, 0, "colA");
+  const AbstractExpression *col_b = MakeColumnValueExpression(*scan_schema, 0, "colB");
+  const AbstractExpression *col_c = MakeColumnValueExpression(*scan_schema, 0, "colC");
+  const AbstractExpression *col_d = MakeColumnValueExpression(*scan_schema, 0, "colD");
+  auto *agg_schema = MakeOutputSchema({{"colB", MakeAggregateValueExpression(true, 0)},
+                                       {"countA", MakeAggregateValueExpression(false, 0)},
+                                       {"sumC", MakeAggregateValueExpression(false, 1)},
+                                       {"minD", MakeAggregateValueExpression(false, 2)},
+                                       {"maxD", MakeAggregateValueExpression(false, 3)}});
+  AggregationPlanNode agg_plan{agg_schema,
+                               &scan_plan,
+                               nullptr,
+                               {col_b},
+                               {col_a, col_c, col_d, col_d},
+                               {AggregationType::CountAggregate, AggregationType::SumAggregate,
+                                AggregationType::MinAggregate, AggregationType::MaxAggregate}};
+
+  // the aggregates of each group, serially and in parallel
+  auto run = [&](bool parallel) {
+    std::vector<Tuple> result_set{};
+    if (parallel) {
+      GetExecutionEngine()->ExecuteParallel(&agg_plan, &result_set, GetTxn(), GetExecutorContext(), NUM_WORKERS,
+                                            MORSEL_SIZE);
+    } else {
+      GetExecutionEngine()->Execute(&agg_plan, &result_set, GetTxn(), GetExecutorContext());
+    }
+    std::map<int32_t, std::vector<int32_t>> groups;
+    for (const auto &tuple : result_set) {
+      auto col_b_val = tuple.GetValue(agg_schema, 0).GetAs<int32_t>();
+      EXPECT_EQ(groups.count(col_b_val), 0);
+      for (uint32_t i = 1; i < agg_schema->GetColumnCount(); i++) {
+        groups[col_b_val].push_back(tuple.GetValue(agg_schema, i).GetAs<int32_t>());
+      }
+    }
+    return groups;
+  };
+  auto expected = run(false);
+  ASSERT_EQ(expected.size(), 10);
+  ASSERT_EQ(run(true), expected);
+}
+
+// SELECT COUNT(t1.colA) FROM test_1 t1 JOIN test_1 t2 ON t1.colA = t2.colA WHERE t2.colA < 600
+TEST_F(ExecutorTest, ParallelHashJoinAggregationTest) {
+  TableInfo *table_info = GetExecutorContext()->GetCatalog()->GetTable("test_1");
+  const Schema &schema = table_info->schema_;
+  auto *col_a = MakeColumnValueExpression(schema, 0, "colA");
+  auto *scan_schema = MakeOutputSchema({{"colA", col_a}});
+  auto *const600 = MakeConstantValueExpression(ValueFactory::GetIntegerValue(600));
+  SeqScanPlanNode left_plan{scan_schema, nullptr, table_info->oid_};
+  SeqScanPlanNode right_plan{scan_schema, MakeComparisonExpression(col_a, const600, ComparisonType::LessThan),
+                             table_info->oid_};
+
+  auto *left_col_a = MakeColumnValueExpression(*scan_schema, 0, "colA");
+  auto *right_col_a = MakeColumnValueExpression(*scan_schema, 1, "colA");
+  auto *join_schema = MakeOutputSchema({{"left_colA", left_col_a}, {"right_colA", right_col_a}});
+  HashJoinPlanNode join_plan{join_schema, {&left_plan, &right_plan}, left_col_a, right_col_a};
+
+  // the join on its own
+  std::vector<Tuple> result_set{};
+  GetExecutionEngine()->ExecuteParallel(&join_plan, &result_set, GetTxn(), GetExecutorContext(), NUM_WORKERS,
+                                        MORSEL_SIZE);
+  ASSERT_EQ(result_set.size(), 600);
+  for (const auto &tuple : result_set) {
+    ASSERT_EQ(tuple.GetValue(join_schema, 0).GetAs<int32_t>(), tuple.GetValue(join_schema, 1).GetAs<int32_t>());
+  }
+
+  // and under an aggregation, which only one worker outputs
+  const AbstractExpression *join_col_a = MakeColumnValueExpression(*join_schema, 0, "left_colA");
+  auto *agg_schema = MakeOutputSchema({{"countA", MakeAggregateValueExpression(false, 0)}});
+  AggregationPlanNode agg_plan{agg_schema, &join_plan, nullptr, {}, {join_col_a}, {AggregationType::CountAggregate}};
+  result_set.clear();
+  GetExecutionEngine()->ExecuteParallel(&agg_plan, &result_set, GetTxn(), GetExecutorContext(), NUM_WORKERS,
+                                        MORSEL_SIZE);
+  ASSERT_EQ(result_set.size(), 1);
+  ASSERT_EQ(result_set[0].GetValue(agg_schema, 0).GetAs<int32_t>(), 600);
+}
+
+// SELECT SUM(colA) FROM big, whose sum overflows an INTEGER
+TEST_F(ExecutorTest, ParallelFailureTest) {
+  using Dist = TableGenerator::Dist;
+  TableGenerator generator{GetExecutorContext()};
+  TableGenerator::TableInsertMeta meta{
+      "big", 1000, {{"colA", TypeId::INTEGER, false, Dist::Uniform, 1000000000, 2000000000}}};
+  TableInfo *table_info = generator.GenerateTable(&meta);
+  auto *col_a = MakeColumnValueExpression(table_info->schema_, 0, "colA");
+  auto *scan_schema = MakeOutputSchema({{"colA", col_a}});
+  SeqScanPlanNode scan_plan{scan_schema, nullptr, table_info->oid_};
+  auto *agg_schema = MakeOutputSchema({{"sumA", MakeAggregateValueExpression(false, 0)}});
+  AggregationPlanNode agg_plan{agg_schema, &scan_plan, nullptr, {}, {col_a}, {AggregationType::SumAggregate}};
+
+  // the worker that outputs the sum fails, and the query with it
+  std::vector<Tuple> result_set{};
+  EXPECT_FALSE(GetExecutionEngine()->ExecuteParallel(&agg_plan, &result_set, GetTxn(), GetExecutorContext(),
+                                                     NUM_WORKERS, MORSEL_SIZE));
+  EXPECT_TRUE(result_set.empty());
+}
+
+}  // namespace bustub
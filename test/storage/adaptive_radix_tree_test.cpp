@@ -0,0 +1,193 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// adaptive_radix_tree_test.cpp
+//
+// Identification: test/storage/adaptive_radix_tree_test.cpp
+//
+// Copyright (c) 2015-2021, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include <cstdio>
+#include <map>
+#include <random>
+#include <set>
+#include <string>
+#include <vector>
+
+#include "buffer/buffer_pool_manager_instance.h"
+#include "catalog/catalog.h"
+#include "gtest/gtest.h"
+#include "storage/index/adaptive_radix_tree.h"
+#include "storage/index/adaptive_radix_tree_index.h"
+#include "test_util.h"  // NOLINT
+#include "type/value_factory.h"
+
+namespace bustub {
+
+namespace {
+
+using Entries = std::map<std::string, std::set<int64_t>>;
+
+void CheckTree(AdaptiveRadixTree *tree, const Entries &entries, const std::vector<std::string> &keys) {
+  size_t size = 0;
+  std::vector<RID> rids;
+  for (const auto &key : keys) {
+    rids.clear();
+    auto it = entries.find(key);
+    bool present = it != entries.end() && !it->second.empty();
+    ASSERT_EQ(tree->GetValue(key, &rids), present);
+    std::vector<int64_t> values;
+    for (const auto &rid : rids) {
+      values.push_back(rid.Get());
+    }
+    std::vector<int64_t> expected;
+    if (present) {
+      expected.assign(it->second.begin(), it->second.end());
+      size += expected.size();
+    }
+    ASSERT_EQ(values, expected);
+  }
+  EXPECT_EQ(tree->GetSize(), size);
+}
+
+}  // namespace
+
+// NOLINTNEXTLINE
+TEST(AdaptiveRadixTreeTest, RandomKeysTest) {
+  // VARCHAR encodings of strings over a small alphabet share long prefixes and differ in length, and none is a
+  // prefix of another
+  std::mt19937_64 rng(15445);
+  std::vector<std::string> keys;
+  std::set<std::string> seen;
+  while (keys.size() < 2000) {
+    std::string value(1 + rng() % 12, 'a');
+    for (auto &c : value) {
+      c = static_cast<char>('a' + rng() % 3);
+    }
+    std::string key;
+    KeyEncoder::AppendValue(ValueFactory::GetVarcharValue(value), &key);
+    if (seen.insert(key).second) {
+      keys.push_back(key);
+    }
+  }
+
+  AdaptiveRadixTree tree;
+  Entries entries;
+  for (int i = 0; i < 20000; i++) {
+    const auto &key = keys[rng() % keys.size()];
+    int64_t value = static_cast<int64_t>(rng() % 4);
+    if (rng() % 3 == 0) {
+      EXPECT_EQ(tree.Remove(key, RID(value)), entries[key].erase(value) == 1);
+    } else {
+      EXPECT_EQ(tree.Insert(key, RID(value)), entries[key].insert(value).second);
+    }
+  }
+  CheckTree(&tree, entries, keys);
+
+  for (const auto &[key, values] : entries) {
+    for (auto value : values) {
+      EXPECT_TRUE(tree.Remove(key, RID(value)));
+    }
+  }
+  entries.clear();
+  CheckTree(&tree, entries, keys);
+}
+
+// NOLINTNEXTLINE
+TEST(AdaptiveRadixTreeTest, NodeResizeTest) {
+  // keys of three bytes that differ in the middle one, so that one node goes through every size and back
+  std::vector<std::string> keys;
+  for (int byte = 0; byte < 256; byte++) {
+    keys.push_back(std::string{'x', static_cast<char>(byte), 'y'});
+  }
+  AdaptiveRadixTree tree;
+  Entries entries;
+  for (int round = 0; round < 2; round++) {
+    for (int i = 0; i < 256; i++) {
+      const auto &key = keys[(i * 37) % 256];
+      ASSERT_TRUE(tree.Insert(key, RID(i)));
+      entries[key].insert(i);
+      if (i < 60 || i % 16 == 0) {
+        CheckTree(&tree, entries, keys);
+      }
+    }
+    CheckTree(&tree, entries, keys);
+    for (int i = 0; i < 256; i++) {
+      const auto &key = keys[(i * 101) % 256];
+      ASSERT_TRUE(tree.Remove(key, RID(*entries[key].begin())));
+      entries[key].clear();
+      if (i > 196 || i % 16 == 0) {
+        CheckTree(&tree, entries, keys);
+      }
+    }
+  }
+
+  // a key that splits the prefix of an inner node, and one that removes it again
+  tree.Insert(keys[1], RID(1));
+  tree.Insert(keys[2], RID(2));
+  tree.Insert(std::string{'z', 'z'}, RID(3));
+  std::vector<RID> rids;
+  EXPECT_TRUE(tree.GetValue(keys[2], &rids));
+  tree.Remove(std::string{'z', 'z'}, RID(3));
+  tree.Remove(keys[1], RID(1));
+  rids.clear();
+  EXPECT_TRUE(tree.GetValue(keys[2], &rids));
+  EXPECT_EQ(rids, std::vector<RID>{RID(2)});
+  EXPECT_EQ(tree.GetSize(), 1);
+}
+
+// NOLINTNEXTLINE
+TEST(AdaptiveRadixTreeTest, BuildFromTableTest) {
+  auto disk_manager = std::make_unique<DiskManager>("test.db");
+  auto bpm = std::make_unique<BufferPoolManagerInstance>(64, disk_manager.get());
+  page_id_t page_id;
+  bpm->NewPage(&page_id);
+  auto catalog = std::make_unique<Catalog>(bpm.get(), nullptr, nullptr);
+  Transaction txn(0);
+
+  auto schema = ParseCreateStatement("a varchar(16),b integer");
+  auto *table_info = catalog->CreateTable(&txn, "t", *schema);
+  const int num_tuples = 1000;
+  std::map<std::pair<std::string, int32_t>, std::set<int64_t>> expected;
+  for (int i = 0; i < num_tuples; i++) {
+    // each (a, b) pair appears several times
+    std::string a = "key" + std::to_string(i % 50);
+    int32_t b = i % 3;
+    Tuple tuple({ValueFactory::GetVarcharValue(a), ValueFactory::GetIntegerValue(b)}, schema.get());
+    RID rid;
+    ASSERT_TRUE(table_info->table_->InsertTuple(tuple, &rid, &txn));
+    expected[{a, b}].insert(rid.Get());
+  }
+
+  auto metadata = std::make_unique<IndexMetadata>("t_ab", "t", schema.get(), std::vector<uint32_t>{0, 1});
+  AdaptiveRadixTreeIndex index(std::move(metadata));
+  // building twice, as after a restart, does not duplicate entries
+  index.BuildFromTable(table_info->table_.get(), *schema, &txn);
+  index.BuildFromTable(table_info->table_.get(), *schema, &txn);
+
+  std::vector<RID> result;
+  for (const auto &[key, rids] : expected) {
+    result.clear();
+    Tuple index_key({ValueFactory::GetVarcharValue(key.first), ValueFactory::GetIntegerValue(key.second)},
+                    index.GetKeySchema());
+    index.ScanKey(index_key, &result, &txn);
+    std::vector<int64_t> values;
+    for (const auto &rid : result) {
+      values.push_back(rid.Get());
+    }
+    ASSERT_EQ(values, std::vector<int64_t>(rids.begin(), rids.end()));
+  }
+  result.clear();
+  Tuple missing({ValueFactory::GetVarcharValue("key"), ValueFactory::GetIntegerValue(0)}, index.GetKeySchema());
+  index.ScanKey(missing, &result, &txn);
+  EXPECT_TRUE(result.empty());
+
+  bpm->UnpinPage(HEADER_PAGE_ID, true);
+  remove("test.db");
+  remove("test.log");
+}
+
+}  // namespace bustub
@@ -0,0 +1,223 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// b_epsilon_tree_test.cpp
+//
+// Identification: test/storage/b_epsilon_tree_test.cpp
+//
+// Copyright (c) 2015-2021, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include <algorithm>
+#include <cstdio>
+#include <map>
+#include <random>
+#include <set>
+#include <thread>  // NOLINT
+#include <vector>
+
+#include "buffer/buffer_pool_manager_instance.h"
+#include "gtest/gtest.h"
+#include "storage/index/b_epsilon_tree.h"
+#include "storage/index/b_epsilon_tree_index.h"
+#include "test_util.h"  // NOLINT
+#include "type/value_factory.h"
+
+namespace bustub {
+
+namespace {
+
+using Tree = BEpsilonTree<GenericKey<8>, RID, GenericComparator<8>>;
+
+GenericKey<8> MakeKey(int64_t key) {
+  GenericKey<8> index_key;
+  index_key.SetFromInteger(key);
+  return index_key;
+}
+
+// the RIDs of every key below max_key must match "entries"
+void CheckTree(Tree *tree, const std::map<int64_t, std::set<int64_t>> &entries, int64_t max_key) {
+  std::vector<RID> rids;
+  for (int64_t key = 0; key < max_key; key++) {
+    rids.clear();
+    auto it = entries.find(key);
+    bool present = it != entries.end() && !it->second.empty();
+    ASSERT_EQ(tree->GetValue(MakeKey(key), &rids), present) << "key " << key;
+    std::vector<int64_t> values;
+    for (const auto &rid : rids) {
+      values.push_back(rid.Get());
+    }
+    std::vector<int64_t> expected;
+    if (present) {
+      expected.assign(it->second.begin(), it->second.end());
+    }
+    ASSERT_EQ(values, expected) << "key " << key;
+  }
+}
+
+}  // namespace
+
+// NOLINTNEXTLINE
+TEST(BEpsilonTreeTest, InsertRemoveTest) {
+  auto key_schema = ParseCreateStatement("a bigint");
+  GenericComparator<8> comparator(key_schema.get());
+  DiskManager *disk_manager = new DiskManager("test.db");
+  BufferPoolManager *bpm = new BufferPoolManagerInstance(50, disk_manager);
+  page_id_t page_id;
+  bpm->NewPage(&page_id);
+  // small pages, so that the tree is several levels deep and flushes and splits all the time
+  Tree tree("foo_pk", bpm, comparator, 8, 4, 8);
+
+  std::vector<RID> rids;
+  EXPECT_FALSE(tree.GetValue(MakeKey(1), &rids));
+  tree.Remove(MakeKey(1), RID(0, 1));
+  EXPECT_TRUE(tree.IsEmpty());
+
+  // random inserts and removes over a small key range, so that keys get several RIDs and removes often hit
+  const int64_t num_keys = 300;
+  std::mt19937_64 rng(15445);
+  std::map<int64_t, std::set<int64_t>> entries;
+  for (int i = 0; i < 6000; i++) {
+    int64_t key = static_cast<int64_t>(rng() % num_keys);
+    int64_t value = key * 10 + static_cast<int64_t>(rng() % 4);
+    if (rng() % 3 == 0) {
+      tree.Remove(MakeKey(key), RID(value));
+      entries[key].erase(value);
+    } else {
+      tree.Insert(MakeKey(key), RID(value));
+      entries[key].insert(value);
+    }
+    if (i % 1000 == 999) {
+      CheckTree(&tree, entries, num_keys);
+    }
+  }
+  EXPECT_GT(tree.GetNumPages(), 10);
+
+  // removing everything leaves no values behind, in the buffers or the leaves
+  for (auto &[key, values] : entries) {
+    for (auto value : values) {
+      tree.Remove(MakeKey(key), RID(value));
+    }
+    values.clear();
+  }
+  CheckTree(&tree, entries, num_keys);
+
+  // reinserting after a remove brings the value back
+  tree.Insert(MakeKey(7), RID(70));
+  tree.Remove(MakeKey(7), RID(70));
+  tree.Insert(MakeKey(7), RID(70));
+  entries[7].insert(70);
+  CheckTree(&tree, entries, num_keys);
+
+  bpm->UnpinPage(HEADER_PAGE_ID, true);
+  delete bpm;
+  delete disk_manager;
+  remove("test.db");
+  remove("test.log");
+}
+
+// NOLINTNEXTLINE
+TEST(BEpsilonTreeTest, SequentialInsertTest) {
+  auto key_schema = ParseCreateStatement("a bigint");
+  GenericComparator<8> comparator(key_schema.get());
+  DiskManager *disk_manager = new DiskManager("test.db");
+  BufferPoolManager *bpm = new BufferPoolManagerInstance(50, disk_manager);
+  page_id_t page_id;
+  bpm->NewPage(&page_id);
+  Tree tree("foo_pk", bpm, comparator);
+
+  // with full-size pages, ascending keys leave most messages in the buffers
+  const int64_t num_keys = 20000;
+  std::map<int64_t, std::set<int64_t>> entries;
+  for (int64_t key = 0; key < num_keys; key++) {
+    tree.Insert(MakeKey(key), RID(key));
+    entries[key].insert(key);
+  }
+  for (int64_t key = 0; key < num_keys; key += 3) {
+    tree.Remove(MakeKey(key), RID(key));
+    entries[key].clear();
+  }
+  CheckTree(&tree, entries, num_keys);
+
+  bpm->UnpinPage(HEADER_PAGE_ID, true);
+  delete bpm;
+  delete disk_manager;
+  remove("test.db");
+  remove("test.log");
+}
+
+// NOLINTNEXTLINE
+TEST(BEpsilonTreeTest, ConcurrentInsertTest) {
+  auto key_schema = ParseCreateStatement("a bigint");
+  GenericComparator<8> comparator(key_schema.get());
+  DiskManager *disk_manager = new DiskManager("test.db");
+  BufferPoolManager *bpm = new BufferPoolManagerInstance(50, disk_manager);
+  page_id_t page_id;
+  bpm->NewPage(&page_id);
+  Tree tree("foo_pk", bpm, comparator, 8, 4, 8);
+
+  // each thread owns the keys equal to its id modulo the number of threads, and reads its own writes back
+  const int num_threads = 4;
+  const int64_t num_keys = 2000;
+  std::vector<std::thread> threads;
+  for (int thread = 0; thread < num_threads; thread++) {
+    threads.emplace_back([&, thread] {
+      std::vector<RID> rids;
+      for (int64_t key = thread; key < num_keys; key += num_threads) {
+        tree.Insert(MakeKey(key), RID(key));
+        rids.clear();
+        EXPECT_TRUE(tree.GetValue(MakeKey(key), &rids));
+      }
+      for (int64_t key = thread; key < num_keys; key += num_threads) {
+        if (key % 2 == 0) {
+          tree.Remove(MakeKey(key), RID(key));
+        }
+      }
+    });
+  }
+  for (auto &thread : threads) {
+    thread.join();
+  }
+
+  std::map<int64_t, std::set<int64_t>> entries;
+  for (int64_t key = 1; key < num_keys; key += 2) {
+    entries[key].insert(key);
+  }
+  CheckTree(&tree, entries, num_keys);
+
+  bpm->UnpinPage(HEADER_PAGE_ID, true);
+  delete bpm;
+  delete disk_manager;
+  remove("test.db");
+  remove("test.log");
+}
+
+// NOLINTNEXTLINE
+TEST(BEpsilonTreeTest, IndexTest) {
+  auto key_schema = ParseCreateStatement("a bigint");
+  DiskManager *disk_manager = new DiskManager("test.db");
+  BufferPoolManager *bpm = new BufferPoolManagerInstance(50, disk_manager);
+  page_id_t page_id;
+  bpm->NewPage(&page_id);
+  auto metadata = std::make_unique<IndexMetadata>("foo_idx", "foo", key_schema.get(), std::vector<uint32_t>{0});
+  BEpsilonTreeIndex<GenericKey<8>, RID, GenericComparator<8>> index(std::move(metadata), bpm);
+
+  std::vector<Value> values{ValueFactory::GetBigIntValue(42)};
+  Tuple key(values, key_schema.get());
+  index.InsertEntry(key, RID(1, 1), nullptr);
+  index.InsertEntry(key, RID(1, 2), nullptr);
+  index.DeleteEntry(key, RID(1, 1), nullptr);
+  std::vector<RID> rids;
+  index.ScanKey(key, &rids, nullptr);
+  EXPECT_EQ(rids, std::vector<RID>{RID(1, 2)});
+
+  bpm->UnpinPage(HEADER_PAGE_ID, true);
+  delete bpm;
+  delete disk_manager;
+  remove("test.db");
+  remove("test.log");
+}
+
+}  // namespace bustub
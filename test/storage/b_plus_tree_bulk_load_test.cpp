@@ -0,0 +1,347 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// b_plus_tree_bulk_load_test.cpp
+//
+// Identification: test/storage/b_plus_tree_bulk_load_test.cpp
+//
+// Copyright (c) 2015-2021, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include <algorithm>
+#include <cstdio>
+#include <map>
+#include <random>
+#include <utility>
+#include <vector>
+
+#include "buffer/buffer_pool_manager_instance.h"
+#include "catalog/catalog.h"
+#include "gtest/gtest.h"
+#include "storage/index/b_plus_tree.h"
+#include "storage/index/b_plus_tree_index.h"
+#include "storage/index/index_entry_sorter.h"
+#include "test_util.h"  // NOLINT
+#include "type/value_factory.h"
+
+namespace bustub {
+
+namespace {
+
+using Tree = BPlusTree<GenericKey<8>, RID, GenericComparator<8>>;
+using Sorter = IndexEntrySorter<GenericKey<8>, RID, GenericComparator<8>>;
+
+std::vector<std::pair<GenericKey<8>, RID>> MakeEntries(const std::vector<int64_t> &keys) {
+  std::vector<std::pair<GenericKey<8>, RID>> entries;
+  GenericKey<8> index_key;
+  for (auto key : keys) {
+    index_key.SetFromInteger(key);
+    entries.emplace_back(index_key, RID(static_cast<int32_t>(key >> 32), static_cast<uint32_t>(key)));
+  }
+  return entries;
+}
+
+// the keys in the tree, in iteration order
+std::vector<int64_t> TreeKeys(Tree *tree) {
+  std::vector<int64_t> keys;
+  for (auto it = tree->Begin(); !it.IsEnd(); ++it) {
+    keys.push_back((*it).second.GetSlotNum());
+  }
+  return keys;
+}
+
+bool AllPagesUnpinned(BufferPoolManager *bpm, size_t pool_size) {
+  std::vector<page_id_t> page_ids;
+  bool ok = true;
+  for (size_t i = 0; i < pool_size && ok; i++) {
+    page_id_t page_id;
+    ok = bpm->NewPage(&page_id) != nullptr;
+    if (ok) {
+      page_ids.push_back(page_id);
+    }
+  }
+  for (auto page_id : page_ids) {
+    bpm->UnpinPage(page_id, false);
+    bpm->DeletePage(page_id);
+  }
+  return ok;
+}
+
+}  // namespace
+
+// NOLINTNEXTLINE
+TEST(BPlusTreeBulkLoadTest, BulkLoadTest) {
+  auto key_schema = ParseCreateStatement("a bigint");
+  GenericComparator<8> comparator(key_schema.get());
+
+  const int leaf_page_size = (PAGE_SIZE - LEAF_PAGE_HEADER_SIZE) / sizeof(std::pair<GenericKey<8>, RID>);
+  const int internal_page_size = (PAGE_SIZE - INTERNAL_PAGE_HEADER_SIZE) / sizeof(std::pair<GenericKey<8>, page_id_t>);
+  const std::vector<std::pair<int, int>> node_sizes = {{3, 3}, {4, 4}, {5, 4}, {leaf_page_size, internal_page_size}};
+  for (auto [leaf_max_size, internal_max_size] : node_sizes) {
+    for (double fill_factor : {0.5, 0.7, 1.0}) {
+      for (int64_t n : {0, 1, 2, 3, 7, 100, 1000}) {
+        DiskManager *disk_manager = new DiskManager("test.db");
+        BufferPoolManager *bpm = new BufferPoolManagerInstance(50, disk_manager);
+        page_id_t page_id;
+        bpm->NewPage(&page_id);
+        Tree tree("foo_pk", bpm, comparator, leaf_max_size, internal_max_size);
+        SCOPED_TRACE(testing::Message() << "leaf " << leaf_max_size << " internal " << internal_max_size << " fill "
+                                        << fill_factor << " n " << n);
+
+        // even keys only, so that odd ones can be inserted afterwards
+        std::vector<int64_t> keys;
+        for (int64_t i = 0; i < n; i++) {
+          keys.push_back(2 * i);
+        }
+        auto entries = MakeEntries(keys);
+        EXPECT_TRUE(tree.BulkLoad(entries.begin(), entries.end(), entries.size(), fill_factor));
+        EXPECT_EQ(tree.IsEmpty(), n == 0);
+        EXPECT_EQ(TreeKeys(&tree), keys);
+        std::vector<RID> result;
+        for (const auto &entry : entries) {
+          result.clear();
+          EXPECT_TRUE(tree.GetValue(entry.first, &result));
+          EXPECT_EQ(result[0], entry.second);
+        }
+
+        // the loaded tree keeps working as a regular one
+        GenericKey<8> index_key;
+        for (int64_t i = 0; i < n; i++) {
+          index_key.SetFromInteger(2 * i + 1);
+          EXPECT_TRUE(tree.Insert(index_key, RID(0, 2 * i + 1)));
+        }
+        for (int64_t i = 0; i < 2 * n; i += 3) {
+          index_key.SetFromInteger(i);
+          tree.Remove(index_key);
+        }
+        std::vector<int64_t> expected;
+        for (int64_t i = 0; i < 2 * n; i++) {
+          if (i % 3 != 0) {
+            expected.push_back(i);
+          }
+        }
+        EXPECT_EQ(TreeKeys(&tree), expected);
+        EXPECT_TRUE(AllPagesUnpinned(bpm, 49));
+
+        // a tree that is not empty refuses to be loaded
+        if (!expected.empty()) {
+          EXPECT_FALSE(tree.BulkLoad(entries.begin(), entries.end(), entries.size()));
+        }
+
+        bpm->UnpinPage(HEADER_PAGE_ID, true);
+        delete bpm;
+        delete disk_manager;
+        remove("test.db");
+        remove("test.log");
+      }
+    }
+  }
+}
+
+// NOLINTNEXTLINE
+TEST(BPlusTreeBulkLoadTest, BadInputTest) {
+  auto key_schema = ParseCreateStatement("a bigint");
+  GenericComparator<8> comparator(key_schema.get());
+  DiskManager *disk_manager = new DiskManager("test.db");
+  BufferPoolManager *bpm = new BufferPoolManagerInstance(50, disk_manager);
+  page_id_t page_id;
+  bpm->NewPage(&page_id);
+  Tree tree("foo_pk", bpm, comparator, 4, 4);
+
+  auto unsorted = MakeEntries({1, 2, 3, 5, 4, 6});
+  EXPECT_THROW(tree.BulkLoad(unsorted.begin(), unsorted.end(), unsorted.size()), Exception);
+  auto duplicates = MakeEntries({1, 2, 2, 3});
+  EXPECT_THROW(tree.BulkLoad(duplicates.begin(), duplicates.end(), duplicates.size()), Exception);
+  auto sorted = MakeEntries({1, 2, 3, 4, 5, 6, 7, 8, 9});
+  EXPECT_THROW(tree.BulkLoad(sorted.begin(), sorted.end(), sorted.size() - 1), Exception);
+  EXPECT_THROW(tree.BulkLoad(sorted.begin(), sorted.end(), sorted.size() + 1), Exception);
+  EXPECT_TRUE(tree.IsEmpty());
+  EXPECT_TRUE(AllPagesUnpinned(bpm, 49));
+
+  EXPECT_TRUE(tree.BulkLoad(sorted.begin(), sorted.end(), sorted.size()));
+  EXPECT_EQ(TreeKeys(&tree), std::vector<int64_t>({1, 2, 3, 4, 5, 6, 7, 8, 9}));
+
+  bpm->UnpinPage(HEADER_PAGE_ID, true);
+  delete bpm;
+  delete disk_manager;
+  remove("test.db");
+  remove("test.log");
+}
+
+// NOLINTNEXTLINE
+TEST(BPlusTreeBulkLoadTest, ExternalSortTest) {
+  auto key_schema = ParseCreateStatement("a bigint");
+  GenericComparator<8> comparator(key_schema.get());
+  const size_t pool_size = 20;
+  DiskManager *disk_manager = new DiskManager("test.db");
+  BufferPoolManager *bpm = new BufferPoolManagerInstance(pool_size, disk_manager);
+
+  std::mt19937_64 rng(15445);
+  for (bool unique_keys : {false, true}) {
+    for (size_t num_entries : {0, 50, 20000}) {
+      SCOPED_TRACE(testing::Message() << "unique " << unique_keys << " entries " << num_entries);
+      // keys repeat, and the slot number records the order the entries were added in
+      std::vector<std::pair<int64_t, uint32_t>> added;
+      for (size_t i = 0; i < num_entries; i++) {
+        added.emplace_back(static_cast<int64_t>(rng() % 5000) - 2500, static_cast<uint32_t>(i));
+      }
+      std::vector<std::pair<int64_t, uint32_t>> expected = added;
+      std::stable_sort(expected.begin(), expected.end(),
+                       [](const auto &lhs, const auto &rhs) { return lhs.first < rhs.first; });
+      if (unique_keys) {
+        auto last = std::unique(expected.begin(), expected.end(),
+                                [](const auto &lhs, const auto &rhs) { return lhs.first == rhs.first; });
+        expected.erase(last, expected.end());
+      }
+
+      std::vector<std::pair<int64_t, uint32_t>> sorted;
+      {
+        // small runs and a small fan-in force several merge passes
+        Sorter sorter(bpm, comparator, unique_keys, 300, 3);
+        GenericKey<8> index_key;
+        for (const auto &[key, slot] : added) {
+          index_key.SetFromInteger(key);
+          sorter.Add(index_key, RID(0, slot));
+        }
+        sorter.Finish();
+        EXPECT_EQ(sorter.GetSize(), expected.size());
+        EXPECT_EQ(sorter.GetNumRuns(), (num_entries + 299) / 300 > 1 ? (num_entries + 299) / 300 : 0);
+        for (auto it = sorter.Begin(); it != sorter.End(); ++it) {
+          sorted.emplace_back(it->first.ToString(), it->second.GetSlotNum());
+        }
+      }
+      EXPECT_EQ(sorted, expected);
+      EXPECT_TRUE(AllPagesUnpinned(bpm, pool_size));
+    }
+  }
+
+  // a sorter dropped halfway through releases its pages
+  {
+    Sorter sorter(bpm, comparator, false, 100, 4);
+    GenericKey<8> index_key;
+    for (int i = 0; i < 5000; i++) {
+      index_key.SetFromInteger(5000 - i);
+      sorter.Add(index_key, RID(0, i));
+    }
+    sorter.Finish();
+    std::pair<GenericKey<8>, RID> entry;
+    for (int i = 0; i < 10; i++) {
+      EXPECT_TRUE(sorter.Next(&entry));
+    }
+  }
+  EXPECT_TRUE(AllPagesUnpinned(bpm, pool_size));
+
+  delete bpm;
+  delete disk_manager;
+  remove("test.db");
+  remove("test.log");
+}
+
+// NOLINTNEXTLINE
+TEST(BPlusTreeBulkLoadTest, BuildFromTableTest) {
+  auto disk_manager = std::make_unique<DiskManager>("test.db");
+  auto bpm = std::make_unique<BufferPoolManagerInstance>(64, disk_manager.get());
+  page_id_t page_id;
+  bpm->NewPage(&page_id);
+  auto catalog = std::make_unique<Catalog>(bpm.get(), nullptr, nullptr);
+  Transaction txn(0);
+
+  auto schema = ParseCreateStatement("a bigint,b integer");
+  auto *table_info = catalog->CreateTable(&txn, "t", *schema);
+  const int num_tuples = 3000;
+  std::map<int64_t, RID> first_rid;
+  for (int i = 0; i < num_tuples; i++) {
+    // every key appears twice
+    int64_t key = (i * 7919) % (num_tuples / 2);
+    Tuple tuple({ValueFactory::GetBigIntValue(key), ValueFactory::GetIntegerValue(i)}, schema.get());
+    RID rid;
+    ASSERT_TRUE(table_info->table_->InsertTuple(tuple, &rid, &txn));
+    first_rid.emplace(key, rid);
+  }
+
+  auto metadata = std::make_unique<IndexMetadata>("t_a", "t", schema.get(), std::vector<uint32_t>{0});
+  BPlusTreeIndex<GenericKey<8>, RID, GenericComparator<8>> index(std::move(metadata), bpm.get());
+  index.BuildFromTable(table_info->table_.get(), *schema, &txn);
+
+  std::vector<RID> result;
+  for (const auto &[key, rid] : first_rid) {
+    result.clear();
+    Tuple index_key({ValueFactory::GetBigIntValue(key)}, index.GetKeySchema());
+    index.ScanKey(index_key, &result, &txn);
+    ASSERT_EQ(result.size(), 1);
+    EXPECT_EQ(result[0], rid);
+  }
+  size_t count = 0;
+  for (auto it = index.GetBeginIterator(); !it.IsEnd(); ++it) {
+    count++;
+  }
+  EXPECT_EQ(count, first_rid.size());
+
+  bpm->UnpinPage(HEADER_PAGE_ID, true);
+  remove("test.db");
+  remove("test.log");
+}
+
+// NOLINTNEXTLINE
+TEST(BPlusTreeBulkLoadTest, BuildComparisonTest) {
+  auto key_schema = ParseCreateStatement("a bigint");
+  GenericComparator<8> comparator(key_schema.get());
+  const int64_t num_keys = 100000;
+  std::vector<int64_t> keys(num_keys);
+  for (int64_t i = 0; i < num_keys; i++) {
+    keys[i] = i;
+  }
+  std::shuffle(keys.begin(), keys.end(), std::mt19937_64(15445));
+
+  auto next_page_id = [](BufferPoolManager *bpm) {
+    page_id_t page_id;
+    bpm->NewPage(&page_id);
+    bpm->UnpinPage(page_id, false);
+    return page_id;
+  };
+
+  DiskManager *disk_manager = new DiskManager("test.db");
+  BufferPoolManager *bpm = new BufferPoolManagerInstance(256, disk_manager);
+  page_id_t page_id;
+  bpm->NewPage(&page_id);
+  GenericKey<8> index_key;
+
+  Tree inserted("inserted", bpm, comparator);
+  page_id_t first_page = next_page_id(bpm);
+  for (auto key : keys) {
+    index_key.SetFromInteger(key);
+    inserted.Insert(index_key, RID(0, key));
+  }
+  page_id_t inserted_pages = next_page_id(bpm) - first_page - 1;
+
+  // the sort finishes before the loaded tree's pages are counted, so its run pages are not counted with them
+  std::vector<std::pair<GenericKey<8>, RID>> sorted;
+  {
+    Sorter sorter(bpm, comparator, true, 10000);
+    for (auto key : keys) {
+      index_key.SetFromInteger(key);
+      sorter.Add(index_key, RID(0, key));
+    }
+    sorter.Finish();
+    sorted.assign(sorter.Begin(), sorter.End());
+  }
+
+  Tree loaded("loaded", bpm, comparator);
+  first_page = next_page_id(bpm);
+  EXPECT_TRUE(loaded.BulkLoad(sorted.begin(), sorted.end(), sorted.size()));
+  page_id_t loaded_pages = next_page_id(bpm) - first_page - 1;
+
+  EXPECT_EQ(TreeKeys(&loaded), TreeKeys(&inserted));
+  // random inserts leave pages about 70% full on average, bulk loaded ones are full
+  EXPECT_LT(loaded_pages * 5, inserted_pages * 4);
+
+  bpm->UnpinPage(HEADER_PAGE_ID, true);
+  delete bpm;
+  delete disk_manager;
+  remove("test.db");
+  remove("test.log");
+}
+
+}  // namespace bustub
@@ -0,0 +1,344 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// b_plus_tree_duplicate_key_test.cpp
+//
+// Identification: test/storage/b_plus_tree_duplicate_key_test.cpp
+//
+// Copyright (c) 2015-2021, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include <algorithm>
+#include <cstdio>
+#include <map>
+#include <numeric>
+#include <random>
+#include <set>
+#include <thread>  // NOLINT
+#include <utility>
+#include <vector>
+
+#include "buffer/buffer_pool_manager_instance.h"
+#include "catalog/catalog.h"
+#include "gtest/gtest.h"
+#include "storage/index/b_plus_tree.h"
+#include "storage/index/b_plus_tree_index.h"
+#include "test_util.h"  // NOLINT
+#include "type/value_factory.h"
+
+namespace bustub {
+
+namespace {
+
+using Tree = BPlusTree<GenericKey<8>, RID, GenericComparator<8>>;
+// key -> RID::Get() of each of its RIDs
+using Expected = std::map<int64_t, std::set<int64_t>>;
+
+GenericKey<8> MakeKey(int64_t key) {
+  GenericKey<8> index_key;
+  index_key.SetFromInteger(key);
+  return index_key;
+}
+
+std::vector<int64_t> Values(Tree *tree, int64_t key) {
+  std::vector<RID> rids;
+  tree->GetValue(MakeKey(key), &rids);
+  std::vector<int64_t> values;
+  for (const auto &rid : rids) {
+    values.push_back(rid.Get());
+  }
+  return values;
+}
+
+void CheckTree(Tree *tree, const Expected &expected, int64_t num_keys) {
+  for (int64_t key = 0; key < num_keys; key++) {
+    auto it = expected.find(key);
+    std::vector<int64_t> values;
+    if (it != expected.end()) {
+      values.assign(it->second.begin(), it->second.end());
+    }
+    ASSERT_EQ(Values(tree, key), values) << "key " << key;
+  }
+}
+
+page_id_t NextPageId(BufferPoolManager *bpm) {
+  page_id_t page_id;
+  bpm->NewPage(&page_id);
+  bpm->UnpinPage(page_id, false);
+  bpm->DeletePage(page_id);
+  return page_id;
+}
+
+bool AllPagesUnpinned(BufferPoolManager *bpm, size_t pool_size) {
+  std::vector<page_id_t> page_ids;
+  bool ok = true;
+  for (size_t i = 0; i < pool_size && ok; i++) {
+    page_id_t page_id;
+    ok = bpm->NewPage(&page_id) != nullptr;
+    if (ok) {
+      page_ids.push_back(page_id);
+    }
+  }
+  for (auto page_id : page_ids) {
+    bpm->UnpinPage(page_id, false);
+    bpm->DeletePage(page_id);
+  }
+  return ok;
+}
+
+}  // namespace
+
+// NOLINTNEXTLINE
+TEST(BPlusTreeDuplicateKeyTest, InsertRemoveTest) {
+  auto key_schema = ParseCreateStatement("a bigint");
+  GenericComparator<8> comparator(key_schema.get());
+  DiskManager *disk_manager = new DiskManager("test.db");
+  const size_t pool_size = 64;
+  BufferPoolManager *bpm = new BufferPoolManagerInstance(pool_size, disk_manager);
+  page_id_t page_id;
+  bpm->NewPage(&page_id);
+  // full-size pages
+  const int leaf_max_size = (PAGE_SIZE - LEAF_PAGE_HEADER_SIZE) / sizeof(std::pair<GenericKey<8>, RID>);
+  const int internal_max_size = (PAGE_SIZE - INTERNAL_PAGE_HEADER_SIZE) / sizeof(std::pair<GenericKey<8>, page_id_t>);
+  Tree tree("foo_pk", bpm, comparator, leaf_max_size, internal_max_size, false);
+
+  // a low-cardinality column: 40000 rows over 8 keys, inserted out of order
+  const int64_t num_keys = 8;
+  const int num_rows = 40000;
+  std::vector<int> rows(num_rows);
+  std::iota(rows.begin(), rows.end(), 0);
+  std::shuffle(rows.begin(), rows.end(), std::mt19937_64(15445));
+  Expected expected;
+  page_id_t first_page = NextPageId(bpm);
+  for (int row : rows) {
+    RID rid(row / 100, row % 100);
+    EXPECT_TRUE(tree.Insert(MakeKey(row % num_keys), rid));
+    expected[row % num_keys].insert(rid.Get());
+  }
+  page_id_t num_pages = NextPageId(bpm) - first_page - 1;
+  CheckTree(&tree, expected, num_keys);
+
+  // most deltas fit in a byte, so the RIDs take a handful of pages per key; as leaf entries they would need at least
+  // 40000 / 252 = 159 leaves
+  EXPECT_LT(num_pages, 50);
+
+  // a (key, RID) pair goes in only once
+  EXPECT_FALSE(tree.Insert(MakeKey(3), RID(0, 3)));
+  EXPECT_FALSE(tree.Insert(MakeKey(3), RID(1, 7)));
+  EXPECT_TRUE(tree.Insert(MakeKey(num_keys), RID(0, 0)));
+  EXPECT_FALSE(tree.Insert(MakeKey(num_keys), RID(0, 0)));
+  EXPECT_TRUE(tree.Insert(MakeKey(num_keys), RID(0, 1)));
+  expected[num_keys] = {RID(0, 0).Get(), RID(0, 1).Get()};
+  CheckTree(&tree, expected, num_keys + 1);
+
+  // removing a RID the key does not have changes nothing
+  tree.Remove(MakeKey(3), RID(0, 4));
+  tree.Remove(MakeKey(3), RID(999, 3));
+  CheckTree(&tree, expected, num_keys + 1);
+
+  // take out half of each list, in random order
+  for (int row : rows) {
+    if (row % 3 != 0) {
+      RID rid(row / 100, row % 100);
+      tree.Remove(MakeKey(row % num_keys), rid);
+      expected[row % num_keys].erase(rid.Get());
+    }
+  }
+  CheckTree(&tree, expected, num_keys + 1);
+
+  // a list down to one RID goes back into the leaf, and removing that RID removes the key
+  for (int64_t key = 0; key <= num_keys; key++) {
+    auto &values = expected[key];
+    while (values.size() > 1) {
+      tree.Remove(MakeKey(key), RID(*values.rbegin()));
+      values.erase(*values.rbegin());
+    }
+  }
+  CheckTree(&tree, expected, num_keys + 1);
+  for (int64_t key = 0; key <= num_keys; key += 2) {
+    tree.Remove(MakeKey(key), RID(*expected[key].begin()));
+    expected.erase(key);
+  }
+  CheckTree(&tree, expected, num_keys + 1);
+
+  // removing a key drops all of its RIDs
+  for (int i = 0; i < 1000; i++) {
+    tree.Insert(MakeKey(1), RID(i + 1, 0));
+    expected[1].insert(RID(i + 1, 0).Get());
+  }
+  CheckTree(&tree, expected, num_keys + 1);
+  tree.Remove(MakeKey(1));
+  expected.erase(1);
+  CheckTree(&tree, expected, num_keys + 1);
+  EXPECT_TRUE(AllPagesUnpinned(bpm, pool_size - 1));
+
+  bpm->UnpinPage(HEADER_PAGE_ID, true);
+  delete bpm;
+  delete disk_manager;
+  remove("test.db");
+  remove("test.log");
+}
+
+// NOLINTNEXTLINE
+TEST(BPlusTreeDuplicateKeyTest, ScanTest) {
+  auto key_schema = ParseCreateStatement("a bigint");
+  GenericComparator<8> comparator(key_schema.get());
+  DiskManager *disk_manager = new DiskManager("test.db");
+  BufferPoolManager *bpm = new BufferPoolManagerInstance(50, disk_manager);
+  page_id_t page_id;
+  bpm->NewPage(&page_id);
+  Tree tree("foo_pk", bpm, comparator, 4, 4, false);
+
+  // key k has k RIDs, so some keys stay inline and the others get posting lists
+  std::vector<std::pair<int64_t, int64_t>> entries;
+  std::mt19937_64 rng(15445);
+  for (int64_t key = 1; key <= 40; key++) {
+    std::vector<int64_t> values;
+    for (int64_t i = 0; i < key * 20; i++) {
+      values.push_back(RID(static_cast<page_id_t>(rng() % 50), static_cast<uint32_t>(rng() % 1000)).Get());
+    }
+    std::sort(values.begin(), values.end());
+    values.erase(std::unique(values.begin(), values.end()), values.end());
+    std::shuffle(values.begin(), values.end(), rng);
+    for (auto value : values) {
+      tree.Insert(MakeKey(key), RID(value));
+      entries.emplace_back(key, value);
+    }
+  }
+  std::sort(entries.begin(), entries.end());
+
+  std::vector<std::pair<int64_t, int64_t>> iterated;
+  for (auto it = tree.Begin(); !it.IsEnd(); ++it) {
+    iterated.emplace_back((*it).first.ToString(), (*it).second.Get());
+  }
+  EXPECT_EQ(iterated, entries);
+
+  for (bool reverse : {false, true}) {
+    KeyRange<GenericKey<8>> range;
+    range.lower_ = MakeKey(5);
+    range.upper_ = MakeKey(30);
+    range.upper_inclusive_ = false;
+    range.reverse_ = reverse;
+    std::vector<std::pair<int64_t, int64_t>> scanned;
+    std::vector<std::pair<GenericKey<8>, RID>> batch;
+    auto scan = tree.Scan(range);
+    while (scan.NextBatch(&batch)) {
+      for (const auto &entry : batch) {
+        scanned.emplace_back(entry.first.ToString(), entry.second.Get());
+      }
+    }
+    std::vector<std::pair<int64_t, int64_t>> in_range;
+    std::copy_if(entries.begin(), entries.end(), std::back_inserter(in_range),
+                 [](const auto &entry) { return entry.first >= 5 && entry.first < 30; });
+    if (reverse) {
+      std::reverse(in_range.begin(), in_range.end());
+    }
+    EXPECT_EQ(scanned, in_range) << "reverse " << reverse;
+  }
+
+  bpm->UnpinPage(HEADER_PAGE_ID, true);
+  delete bpm;
+  delete disk_manager;
+  remove("test.db");
+  remove("test.log");
+}
+
+// NOLINTNEXTLINE
+TEST(BPlusTreeDuplicateKeyTest, ConcurrentTest) {
+  auto key_schema = ParseCreateStatement("a bigint");
+  GenericComparator<8> comparator(key_schema.get());
+  DiskManager *disk_manager = new DiskManager("test.db");
+  BufferPoolManager *bpm = new BufferPoolManagerInstance(64, disk_manager);
+  page_id_t page_id;
+  bpm->NewPage(&page_id);
+  Tree tree("foo_pk", bpm, comparator, 4, 4, false);
+
+  // every thread inserts its own RIDs under the same few keys, then removes every other one of them
+  const int num_threads = 4;
+  const int num_rows = 4000;
+  const int64_t num_keys = 5;
+  std::vector<std::thread> threads;
+  for (int thread = 0; thread < num_threads; thread++) {
+    threads.emplace_back([&, thread] {
+      for (int row = 0; row < num_rows; row++) {
+        tree.Insert(MakeKey(row % num_keys), RID(thread, row));
+      }
+      for (int row = 0; row < num_rows; row += 2) {
+        tree.Remove(MakeKey(row % num_keys), RID(thread, row));
+      }
+    });
+  }
+  for (auto &thread : threads) {
+    thread.join();
+  }
+
+  Expected expected;
+  for (int thread = 0; thread < num_threads; thread++) {
+    for (int row = 1; row < num_rows; row += 2) {
+      expected[row % num_keys].insert(RID(thread, row).Get());
+    }
+  }
+  CheckTree(&tree, expected, num_keys);
+
+  bpm->UnpinPage(HEADER_PAGE_ID, true);
+  delete bpm;
+  delete disk_manager;
+  remove("test.db");
+  remove("test.log");
+}
+
+// NOLINTNEXTLINE
+TEST(BPlusTreeDuplicateKeyTest, IndexTest) {
+  auto disk_manager = std::make_unique<DiskManager>("test.db");
+  auto bpm = std::make_unique<BufferPoolManagerInstance>(64, disk_manager.get());
+  page_id_t page_id;
+  bpm->NewPage(&page_id);
+  auto catalog = std::make_unique<Catalog>(bpm.get(), nullptr, nullptr);
+  Transaction txn(0);
+
+  // a status-like column with five values
+  auto schema = ParseCreateStatement("a bigint,b integer");
+  auto *table_info = catalog->CreateTable(&txn, "t", *schema);
+  const int num_tuples = 3000;
+  std::map<int64_t, std::vector<RID>> rids;
+  for (int i = 0; i < num_tuples; i++) {
+    int64_t key = (i * 7919) % 5;
+    Tuple tuple({ValueFactory::GetBigIntValue(key), ValueFactory::GetIntegerValue(i)}, schema.get());
+    RID rid;
+    ASSERT_TRUE(table_info->table_->InsertTuple(tuple, &rid, &txn));
+    rids[key].push_back(rid);
+  }
+  auto sorted = [](std::vector<RID> values) {
+    std::sort(values.begin(), values.end(), [](const RID &lhs, const RID &rhs) { return lhs.Get() < rhs.Get(); });
+    return values;
+  };
+
+  auto metadata = std::make_unique<IndexMetadata>("t_a", "t", schema.get(), std::vector<uint32_t>{0});
+  BPlusTreeIndex<GenericKey<8>, RID, GenericComparator<8>> index(std::move(metadata), bpm.get(), false);
+  index.BuildFromTable(table_info->table_.get(), *schema, &txn);
+
+  std::vector<RID> result;
+  for (const auto &[key, key_rids] : rids) {
+    result.clear();
+    Tuple index_key({ValueFactory::GetBigIntValue(key)}, index.GetKeySchema());
+    index.ScanKey(index_key, &result, &txn);
+    EXPECT_EQ(result, sorted(key_rids));
+  }
+
+  // entries are deleted one RID at a time
+  Tuple index_key({ValueFactory::GetBigIntValue(2)}, index.GetKeySchema());
+  index.DeleteEntry(index_key, rids[2][0], &txn);
+  index.DeleteEntry(index_key, rids[2][1], &txn);
+  rids[2].erase(rids[2].begin(), rids[2].begin() + 2);
+  result.clear();
+  index.ScanKey(index_key, &result, &txn);
+  EXPECT_EQ(result, sorted(rids[2]));
+
+  bpm->UnpinPage(HEADER_PAGE_ID, true);
+  remove("test.db");
+  remove("test.log");
+}
+
+}  // namespace bustub
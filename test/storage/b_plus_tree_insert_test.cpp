@@ -12,6 +12,8 @@
 
 #include <algorithm>
 #include <cstdio>
+#include <set>
+#include <vector>
 
 #include "buffer/buffer_pool_manager_instance.h"
 #include "gtest/gtest.h"
@@ -20,7 +22,7 @@
 
 namespace bustub {
 
-TEST(BPlusTreeTests, DISABLED_InsertTest1) {
+TEST(BPlusTreeTests, InsertTest1) {
   // create KeyComparator and index schema
   auto key_schema = ParseCreateStatement("a bigint");
   GenericComparator<8> comparator(key_schema.get());
@@ -78,7 +80,7 @@ TEST(BPlusTreeTests, DISABLED_InsertTest1) {
   remove("test.log");
 }
 
-TEST(BPlusTreeTests, DISABLED_InsertTest2) {
+TEST(BPlusTreeTests, InsertTest2) {
   // create KeyComparator and index schema
   auto key_schema = ParseCreateStatement("a bigint");
   GenericComparator<8> comparator(key_schema.get());
@@ -145,4 +147,126 @@ TEST(BPlusTreeTests, DISABLED_InsertTest2) {
   remove("test.db");
   remove("test.log");
 }
+// Operations that cannot fetch a page throw, and leave no latch or pin behind them.
+TEST(BPlusTreeTests, OutOfFramesTest) {
+  auto key_schema = ParseCreateStatement("a bigint");
+  GenericComparator<8> comparator(key_schema.get());
+  const size_t pool_size = 50;
+  DiskManager *disk_manager = new DiskManager("test.db");
+  BufferPoolManager *bpm = new BufferPoolManagerInstance(pool_size, disk_manager);
+  BPlusTree<GenericKey<8>, RID, GenericComparator<8>> tree("foo_pk", bpm, comparator, 3, 3);
+  page_id_t page_id;
+  bpm->NewPage(&page_id);
+
+  GenericKey<8> index_key;
+  std::set<int64_t> expected;
+  for (int64_t key = 0; key < 200; key += 2) {
+    index_key.SetFromInteger(key);
+    ASSERT_TRUE(tree.Insert(index_key, RID(0, key)));
+    expected.insert(key);
+  }
+
+  // pin all the frames but num_free, so that the tree has only those to work with
+  std::vector<page_id_t> pinned;
+  auto leave_free = [&](size_t num_free) {
+    while (bpm->NewPage(&page_id) != nullptr) {
+      pinned.push_back(page_id);
+    }
+    for (size_t i = 0; i < num_free; i++) {
+      bpm->UnpinPage(pinned.back(), false);
+      bpm->DeletePage(pinned.back());
+      pinned.pop_back();
+    }
+  };
+  auto free_all = [&] {
+    for (auto pinned_page_id : pinned) {
+      bpm->UnpinPage(pinned_page_id, false);
+      bpm->DeletePage(pinned_page_id);
+    }
+    pinned.clear();
+  };
+
+  // Not even the path down to a leaf fits.
+  std::vector<RID> rids;
+  for (size_t num_free : {0, 1}) {
+    leave_free(num_free);
+    index_key.SetFromInteger(100);
+    EXPECT_THROW(tree.GetValue(index_key, &rids), Exception);
+    EXPECT_THROW(tree.Remove(index_key), Exception);
+    index_key.SetFromInteger(101);
+    EXPECT_THROW(tree.Insert(index_key, RID(0, 101)), Exception);
+    EXPECT_THROW(tree.Begin(), Exception);
+    free_all();
+  }
+
+  // The path fits, but a split or merge needs more. An insert that fails to split leaves its key in the leaf; a
+  // remove that fails to merge leaves its leaf underfull.
+  leave_free(2);
+  int num_failed = 0;
+  for (int64_t key = 1; key < 100; key += 2) {
+    index_key.SetFromInteger(key);
+    try {
+      tree.Insert(index_key, RID(0, key));
+    } catch (const Exception &e) {
+      num_failed++;
+    }
+    expected.insert(key);
+  }
+  for (int64_t key = 100; key < 200; key += 2) {
+    index_key.SetFromInteger(key);
+    try {
+      tree.Remove(index_key);
+    } catch (const Exception &e) {
+      num_failed++;
+    }
+    expected.erase(key);
+  }
+  EXPECT_GT(num_failed, 0);
+  free_all();
+  {
+    // An iterator that cannot fetch its next leaf throws. The other one keeps the first leaf pinned, so leaving it
+    // frees no frame.
+    auto holder = tree.Begin();
+    auto iterator = tree.Begin();
+    leave_free(0);
+    EXPECT_THROW(
+        {
+          while (!iterator.IsEnd()) {
+            ++iterator;
+          }
+        },
+        Exception);
+    free_all();
+  }
+
+  // Every frame but the header page's is free again, and every latch was released.
+  leave_free(0);
+  EXPECT_EQ(pinned.size(), pool_size - 1);
+  free_all();
+  for (int64_t key = 1; key < 100; key += 2) {
+    index_key.SetFromInteger(key);
+    tree.Insert(index_key, RID(0, key));
+  }
+  for (int64_t key = 100; key < 200; key += 2) {
+    index_key.SetFromInteger(key);
+    tree.Remove(index_key);
+  }
+  for (int64_t key = 0; key < 200; key++) {
+    rids.clear();
+    index_key.SetFromInteger(key);
+    EXPECT_EQ(tree.GetValue(index_key, &rids), expected.count(key) == 1) << key;
+  }
+  auto expected_key = expected.begin();
+  for (auto iterator = tree.Begin(); iterator != tree.End(); ++iterator, ++expected_key) {
+    ASSERT_NE(expected_key, expected.end());
+    EXPECT_EQ((*iterator).second.GetSlotNum(), *expected_key);
+  }
+  EXPECT_EQ(expected_key, expected.end());
+
+  bpm->UnpinPage(HEADER_PAGE_ID, true);
+  delete disk_manager;
+  delete bpm;
+  remove("test.db");
+  remove("test.log");
+}
 }  // namespace bustub
@@ -0,0 +1,153 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// b_plus_tree_key_search_test.cpp
+//
+// Identification: test/storage/b_plus_tree_key_search_test.cpp
+//
+// Copyright (c) 2015-2021, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include <algorithm>
+#include <cstdio>
+#include <random>
+#include <set>
+#include <vector>
+
+#include "buffer/buffer_pool_manager_instance.h"
+#include "gtest/gtest.h"
+#include "storage/index/b_plus_tree.h"
+#include "storage/page/b_plus_tree_key_search.h"
+#include "test_util.h"  // NOLINT
+
+namespace bustub {
+
+namespace {
+
+using LeafMapping = std::pair<GenericKey<8>, RID>;
+using InternalMapping = std::pair<GenericKey<8>, page_id_t>;
+
+template <typename Entry>
+std::vector<Entry> MakeEntries(const std::vector<int64_t> &keys) {
+  std::vector<Entry> entries(keys.size());
+  for (size_t i = 0; i < keys.size(); i++) {
+    entries[i].first.SetFromInteger(keys[i]);
+  }
+  return entries;
+}
+
+std::vector<int64_t> SortedKeys(size_t n, std::mt19937_64 *rng) {
+  std::set<int64_t> keys;
+  while (keys.size() < n) {
+    keys.insert(static_cast<int64_t>((*rng)() % 20000) - 10000);
+  }
+  return {keys.begin(), keys.end()};
+}
+
+template <typename Entry>
+void CheckAllStrategies(const std::vector<int64_t> &keys, const GenericComparator<8> &generic_comparator) {
+  auto entries = MakeEntries<Entry>(keys);
+  const IntegerComparator<8> integer_comparator;
+  const int n = static_cast<int>(entries.size());
+
+  std::vector<int64_t> probes = {INT64_MIN + 1, -10001, 10001, INT64_MAX};
+  for (auto key : keys) {
+    probes.push_back(key);
+    probes.push_back(key + 1);
+  }
+  for (auto probe : probes) {
+    GenericKey<8> key;
+    key.SetFromInteger(probe);
+    // begin at 1 as the internal pages do, unless there is nothing to skip
+    for (int begin : {0, std::min(1, n)}) {
+      const int lower = std::lower_bound(keys.begin() + begin, keys.end(), probe) - keys.begin();
+      const int upper = std::upper_bound(keys.begin() + begin, keys.end(), probe) - keys.begin();
+      auto less = [&](const Entry &entry) { return generic_comparator(entry.first, key) < 0; };
+      auto less_equal = [&](const Entry &entry) { return generic_comparator(entry.first, key) <= 0; };
+
+      EXPECT_EQ(BranchingPartitionPoint(entries.data(), begin, n, less), lower);
+      EXPECT_EQ(LinearPartitionPoint(entries.data(), begin, n, less), lower);
+      EXPECT_EQ(BranchFreePartitionPoint(entries.data(), begin, n, less), lower);
+      EXPECT_EQ(BranchFreePartitionPoint(entries.data(), begin, n, less_equal), upper);
+      EXPECT_EQ(IntegerPartitionPoint(entries.data(), begin, n, probe, false), lower);
+      EXPECT_EQ(IntegerPartitionPoint(entries.data(), begin, n, probe, true), upper);
+
+      using GenericSearch = KeySearch<GenericKey<8>, typename Entry::second_type, GenericComparator<8>>;
+      using IntegerSearch = KeySearch<GenericKey<8>, typename Entry::second_type, IntegerComparator<8>>;
+      EXPECT_EQ(GenericSearch::LowerBound(entries.data(), begin, n, key, generic_comparator), lower);
+      EXPECT_EQ(GenericSearch::UpperBound(entries.data(), begin, n, key, generic_comparator), upper);
+      EXPECT_EQ(IntegerSearch::LowerBound(entries.data(), begin, n, key, integer_comparator), lower);
+      EXPECT_EQ(IntegerSearch::UpperBound(entries.data(), begin, n, key, integer_comparator), upper);
+    }
+  }
+}
+
+}  // namespace
+
+// NOLINTNEXTLINE
+TEST(BPlusTreeKeySearchTest, StrategiesAgreeTest) {
+  auto key_schema = ParseCreateStatement("a bigint");
+  GenericComparator<8> comparator(key_schema.get());
+  std::mt19937_64 rng(15445);
+  for (size_t n = 0; n <= 70; n++) {
+    auto keys = SortedKeys(n, &rng);
+    CheckAllStrategies<LeafMapping>(keys, comparator);
+    CheckAllStrategies<InternalMapping>(keys, comparator);
+  }
+  for (size_t n : {127, 128, 129, 253, 340}) {
+    auto keys = SortedKeys(n, &rng);
+    CheckAllStrategies<LeafMapping>(keys, comparator);
+    CheckAllStrategies<InternalMapping>(keys, comparator);
+  }
+}
+
+// NOLINTNEXTLINE
+TEST(BPlusTreeKeySearchTest, IntegerComparatorTreeTest) {
+  // A tree over IntegerComparator keys takes the SIMD search on every page, including negative keys.
+  DiskManager *disk_manager = new DiskManager("test.db");
+  BufferPoolManager *bpm = new BufferPoolManagerInstance(50, disk_manager);
+  IntegerComparator<8> comparator;
+  BPlusTree<GenericKey<8>, RID, IntegerComparator<8>> tree("foo_pk", bpm, comparator, 20, 20);
+  page_id_t page_id;
+  auto header_page = bpm->NewPage(&page_id);
+  (void)header_page;
+
+  std::vector<int64_t> keys;
+  for (int64_t key = -500; key < 500; key++) {
+    keys.push_back(key * 3);
+  }
+  std::shuffle(keys.begin(), keys.end(), std::mt19937(15445));
+  GenericKey<8> index_key;
+  for (auto key : keys) {
+    index_key.SetFromInteger(key);
+    EXPECT_TRUE(tree.Insert(index_key, RID(0, static_cast<uint32_t>(key + 1500))));
+  }
+
+  std::vector<RID> result;
+  for (int64_t key = -1500; key < 1500; key++) {
+    index_key.SetFromInteger(key);
+    result.clear();
+    bool found = tree.GetValue(index_key, &result);
+    EXPECT_EQ(found, key % 3 == 0) << key;
+    if (found) {
+      EXPECT_EQ(result[0].GetSlotNum(), key + 1500);
+    }
+  }
+
+  int64_t current_key = -1500;
+  for (auto iterator = tree.Begin(); iterator != tree.End(); ++iterator) {
+    EXPECT_EQ((*iterator).first.ToString(), current_key);
+    current_key += 3;
+  }
+  EXPECT_EQ(current_key, 1500);
+
+  bpm->UnpinPage(HEADER_PAGE_ID, true);
+  delete disk_manager;
+  delete bpm;
+  remove("test.db");
+  remove("test.log");
+}
+
+}  // namespace bustub
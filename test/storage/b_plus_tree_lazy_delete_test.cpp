@@ -0,0 +1,255 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// b_plus_tree_lazy_delete_test.cpp
+//
+// Identification: test/storage/b_plus_tree_lazy_delete_test.cpp
+//
+// Copyright (c) 2015-2021, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include <algorithm>
+#include <chrono>  // NOLINT
+#include <cstdio>
+#include <random>
+#include <set>
+#include <thread>  // NOLINT
+#include <vector>
+
+#include "buffer/buffer_pool_manager_instance.h"
+#include "gtest/gtest.h"
+#include "storage/index/b_plus_tree.h"
+#include "test_util.h"  // NOLINT
+
+namespace bustub {
+
+namespace {
+
+using Tree = BPlusTree<GenericKey<8>, RID, GenericComparator<8>>;
+using LeafPage = BPlusTreeLeafPage<GenericKey<8>, RID, GenericComparator<8>>;
+
+GenericKey<8> MakeKey(int64_t key) {
+  GenericKey<8> index_key;
+  index_key.SetFromInteger(key);
+  return index_key;
+}
+
+// the keys of every leaf, left to right
+std::vector<std::vector<int64_t>> LeafKeys(Tree *tree, BufferPoolManager *bpm) {
+  std::vector<std::vector<int64_t>> leaves;
+  Page *page = tree->FindLeafPage(GenericKey<8>{}, true);
+  while (page != nullptr) {
+    auto *leaf = reinterpret_cast<LeafPage *>(page->GetData());
+    leaves.emplace_back();
+    for (int i = 0; i < leaf->GetSize(); i++) {
+      leaves.back().push_back(leaf->KeyAt(i).ToString());
+    }
+    page_id_t next_page_id = leaf->GetNextPageId();
+    page->RUnlatch();
+    bpm->UnpinPage(page->GetPageId(), false);
+    page = nullptr;
+    if (next_page_id != INVALID_PAGE_ID) {
+      page = bpm->FetchPage(next_page_id);
+      page->RLatch();
+    }
+  }
+  return leaves;
+}
+
+// the size of every leaf, left to right
+std::vector<int> LeafSizes(Tree *tree, BufferPoolManager *bpm) {
+  std::vector<int> sizes;
+  for (const auto &leaf : LeafKeys(tree, bpm)) {
+    sizes.push_back(static_cast<int>(leaf.size()));
+  }
+  return sizes;
+}
+
+void CheckTree(Tree *tree, const std::set<int64_t> &keys, int64_t max_key) {
+  std::vector<RID> rids;
+  for (int64_t key = 0; key < max_key; key++) {
+    rids.clear();
+    ASSERT_EQ(tree->GetValue(MakeKey(key), &rids), keys.count(key) == 1) << "key " << key;
+  }
+  std::vector<int64_t> scanned;
+  for (auto it = tree->Begin(); !it.IsEnd(); ++it) {
+    scanned.push_back((*it).first.ToString());
+  }
+  ASSERT_EQ(scanned, std::vector<int64_t>(keys.begin(), keys.end()));
+}
+
+}  // namespace
+
+// NOLINTNEXTLINE
+TEST(BPlusTreeLazyDeleteTest, MergeTest) {
+  auto key_schema = ParseCreateStatement("a bigint");
+  GenericComparator<8> comparator(key_schema.get());
+  DiskManager *disk_manager = new DiskManager("test.db");
+  BufferPoolManager *bpm = new BufferPoolManagerInstance(50, disk_manager);
+  page_id_t page_id;
+  bpm->NewPage(&page_id);
+  Tree tree("foo_pk", bpm, comparator, 4, 4);
+  tree.SetRemoveMode(RemoveMode::LAZY);
+
+  const int64_t num_keys = 2000;
+  std::vector<int64_t> order(num_keys);
+  for (int64_t key = 0; key < num_keys; key++) {
+    order[key] = key;
+  }
+  std::mt19937_64 rng(15445);
+  std::shuffle(order.begin(), order.end(), rng);
+  std::set<int64_t> keys;
+  for (auto key : order) {
+    tree.Insert(MakeKey(key), RID(0, key));
+    keys.insert(key);
+  }
+  size_t num_leaves = LeafSizes(&tree, bpm).size();
+
+  // lazy removes only shrink leaves, some all the way down to nothing
+  std::shuffle(order.begin(), order.end(), rng);
+  for (int64_t i = 0; i < num_keys * 9 / 10; i++) {
+    tree.Remove(MakeKey(order[i]));
+    keys.erase(order[i]);
+  }
+  auto sizes = LeafSizes(&tree, bpm);
+  EXPECT_EQ(sizes.size(), num_leaves);
+  EXPECT_GT(std::count(sizes.begin(), sizes.end(), 0), 0);
+  CheckTree(&tree, keys, num_keys);
+
+  // inserts into underfull leaves still work, and a leaf that filled up again is left alone
+  for (int64_t i = 0; i < 100; i++) {
+    tree.Insert(MakeKey(order[i]), RID(0, order[i]));
+    keys.insert(order[i]);
+  }
+  CheckTree(&tree, keys, num_keys);
+
+  EXPECT_GT(tree.MergeUnderfullPages(), 0);
+  sizes = LeafSizes(&tree, bpm);
+  EXPECT_LT(sizes.size(), num_leaves / 2);
+  for (size_t i = 0; i < sizes.size() && sizes.size() > 1; i++) {
+    EXPECT_GE(sizes[i], 2) << "leaf " << i;
+  }
+  CheckTree(&tree, keys, num_keys);
+  EXPECT_EQ(tree.MergeUnderfullPages(), 0);
+
+  // removing everything lazily leaves an empty root leaf until the merge
+  for (auto key : std::vector<int64_t>(keys.begin(), keys.end())) {
+    tree.Remove(MakeKey(key));
+  }
+  keys.clear();
+  CheckTree(&tree, keys, num_keys);
+  tree.MergeUnderfullPages();
+  EXPECT_TRUE(tree.IsEmpty());
+
+  bpm->UnpinPage(HEADER_PAGE_ID, true);
+  delete bpm;
+  delete disk_manager;
+  remove("test.db");
+  remove("test.log");
+}
+
+// NOLINTNEXTLINE
+TEST(BPlusTreeLazyDeleteTest, BackgroundMergeTest) {
+  auto key_schema = ParseCreateStatement("a bigint");
+  GenericComparator<8> comparator(key_schema.get());
+  DiskManager *disk_manager = new DiskManager("test.db");
+  BufferPoolManager *bpm = new BufferPoolManagerInstance(64, disk_manager);
+  page_id_t page_id;
+  bpm->NewPage(&page_id);
+  Tree tree("foo_pk", bpm, comparator, 4, 4);
+  tree.SetRemoveMode(RemoveMode::LAZY);
+  tree.StartMergeThread(std::chrono::milliseconds(1));
+
+  // each thread owns the keys equal to its id modulo the number of threads: it inserts them all, removes most, and
+  // puts some back, while the merge thread works behind it
+  const int num_threads = 4;
+  const int64_t num_keys = 4000;
+  std::vector<std::thread> threads;
+  for (int thread = 0; thread < num_threads; thread++) {
+    threads.emplace_back([&, thread] {
+      for (int64_t key = thread; key < num_keys; key += num_threads) {
+        tree.Insert(MakeKey(key), RID(0, key));
+      }
+      for (int64_t key = thread; key < num_keys; key += num_threads) {
+        if (key % 10 != 0) {
+          tree.Remove(MakeKey(key));
+        }
+      }
+      for (int64_t key = thread; key < num_keys; key += num_threads) {
+        if (key % 10 == 5) {
+          tree.Insert(MakeKey(key), RID(0, key));
+        }
+      }
+    });
+  }
+  for (auto &thread : threads) {
+    thread.join();
+  }
+  tree.StopMergeThread();
+
+  std::set<int64_t> keys;
+  for (int64_t key = 0; key < num_keys; key += 5) {
+    keys.insert(key);
+  }
+  CheckTree(&tree, keys, num_keys);
+  tree.MergeUnderfullPages();
+  CheckTree(&tree, keys, num_keys);
+  auto sizes = LeafSizes(&tree, bpm);
+  for (size_t i = 0; i < sizes.size(); i++) {
+    EXPECT_GE(sizes[i], 2) << "leaf " << i;
+  }
+
+  bpm->UnpinPage(HEADER_PAGE_ID, true);
+  delete bpm;
+  delete disk_manager;
+  remove("test.db");
+  remove("test.log");
+}
+
+// NOLINTNEXTLINE
+TEST(BPlusTreeLazyDeleteTest, SplitUnderfullLeafTest) {
+  auto key_schema = ParseCreateStatement("a bigint");
+  GenericComparator<8> comparator(key_schema.get());
+  DiskManager *disk_manager = new DiskManager("test.db");
+  BufferPoolManager *bpm = new BufferPoolManagerInstance(50, disk_manager);
+  page_id_t page_id;
+  bpm->NewPage(&page_id);
+  Tree tree("foo_pk", bpm, comparator, 4, 4);
+  tree.SetRemoveMode(RemoveMode::LAZY);
+
+  std::set<int64_t> keys;
+  for (int64_t key = 0; key < 100; key += 10) {
+    tree.Insert(MakeKey(key), RID(0, key));
+    keys.insert(key);
+  }
+  using Leaves = std::vector<std::vector<int64_t>>;
+  ASSERT_EQ(LeafKeys(&tree, bpm), (Leaves{{0, 10}, {20, 30}, {40, 50}, {60, 70}, {80, 90}}));
+
+  // the leaf is recorded as underfull with the key 50, which a split then moves into the new right sibling
+  tree.Remove(MakeKey(50));
+  keys.erase(50);
+  for (int64_t key : {41, 42, 43}) {
+    tree.Insert(MakeKey(key), RID(0, key));
+    keys.insert(key);
+  }
+  ASSERT_EQ(LeafKeys(&tree, bpm), (Leaves{{0, 10}, {20, 30}, {40, 41}, {42, 43}, {60, 70}, {80, 90}}));
+
+  // the leaf underflows again and must be found through the key removed now, not the one recorded before the split
+  tree.Remove(MakeKey(41));
+  keys.erase(41);
+  EXPECT_GT(tree.MergeUnderfullPages(), 0);
+  CheckTree(&tree, keys, 100);
+  for (const auto &leaf : LeafKeys(&tree, bpm)) {
+    EXPECT_GE(leaf.size(), 2);
+  }
+
+  bpm->UnpinPage(HEADER_PAGE_ID, true);
+  delete bpm;
+  delete disk_manager;
+  remove("test.db");
+  remove("test.log");
+}
+
+}  // namespace bustub
@@ -0,0 +1,228 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// b_plus_tree_range_scan_test.cpp
+//
+// Identification: test/storage/b_plus_tree_range_scan_test.cpp
+//
+// Copyright (c) 2015-2021, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include <algorithm>
+#include <atomic>
+#include <cstdio>
+#include <iterator>
+#include <random>
+#include <set>
+#include <thread>  // NOLINT
+#include <vector>
+
+#include "buffer/buffer_pool_manager_instance.h"
+#include "gtest/gtest.h"
+#include "storage/index/b_plus_tree.h"
+#include "test_util.h"  // NOLINT
+
+namespace bustub {
+
+namespace {
+
+using Tree = BPlusTree<GenericKey<8>, RID, GenericComparator<8>>;
+
+GenericKey<8> MakeKey(int64_t key) {
+  GenericKey<8> index_key;
+  index_key.SetFromInteger(key);
+  return index_key;
+}
+
+KeyRange<GenericKey<8>> MakeRange(std::optional<int64_t> lower, bool lower_inclusive, std::optional<int64_t> upper,
+                                  bool upper_inclusive, bool reverse) {
+  KeyRange<GenericKey<8>> range;
+  if (lower.has_value()) {
+    range.lower_ = MakeKey(*lower);
+  }
+  range.lower_inclusive_ = lower_inclusive;
+  if (upper.has_value()) {
+    range.upper_ = MakeKey(*upper);
+  }
+  range.upper_inclusive_ = upper_inclusive;
+  range.reverse_ = reverse;
+  return range;
+}
+
+// every key a scan returns, checking that each batch is non-empty and fits in a leaf
+std::vector<int64_t> ScanKeys(Tree *tree, const KeyRange<GenericKey<8>> &range, size_t max_batch_size,
+                              size_t *num_batches = nullptr) {
+  std::vector<int64_t> keys;
+  std::vector<std::pair<GenericKey<8>, RID>> batch;
+  auto scan = tree->Scan(range);
+  size_t batches = 0;
+  while (scan.NextBatch(&batch)) {
+    EXPECT_FALSE(batch.empty());
+    EXPECT_LE(batch.size(), max_batch_size);
+    for (const auto &entry : batch) {
+      keys.push_back(entry.second.GetSlotNum());
+    }
+    batches++;
+  }
+  EXPECT_TRUE(batch.empty());
+  if (num_batches != nullptr) {
+    *num_batches = batches;
+  }
+  return keys;
+}
+
+std::vector<int64_t> ExpectedKeys(const std::set<int64_t> &keys, std::optional<int64_t> lower, bool lower_inclusive,
+                                  std::optional<int64_t> upper, bool upper_inclusive, bool reverse) {
+  std::vector<int64_t> expected;
+  for (auto key : keys) {
+    bool above = !lower.has_value() || key > *lower || (lower_inclusive && key == *lower);
+    bool below = !upper.has_value() || key < *upper || (upper_inclusive && key == *upper);
+    if (above && below) {
+      expected.push_back(key);
+    }
+  }
+  if (reverse) {
+    std::reverse(expected.begin(), expected.end());
+  }
+  return expected;
+}
+
+}  // namespace
+
+// NOLINTNEXTLINE
+TEST(BPlusTreeRangeScanTest, RandomRangesTest) {
+  auto key_schema = ParseCreateStatement("a bigint");
+  GenericComparator<8> comparator(key_schema.get());
+
+  for (auto [leaf_max_size, internal_max_size] : std::vector<std::pair<int, int>>{{3, 3}, {5, 4}, {64, 64}}) {
+    DiskManager *disk_manager = new DiskManager("test.db");
+    BufferPoolManager *bpm = new BufferPoolManagerInstance(50, disk_manager);
+    page_id_t page_id;
+    bpm->NewPage(&page_id);
+    Tree tree("foo_pk", bpm, comparator, leaf_max_size, internal_max_size);
+
+    // an empty tree has nothing in any range
+    EXPECT_TRUE(ScanKeys(&tree, MakeRange(std::nullopt, true, std::nullopt, true, false), leaf_max_size).empty());
+    EXPECT_TRUE(ScanKeys(&tree, MakeRange(std::nullopt, true, std::nullopt, true, true), leaf_max_size).empty());
+
+    std::mt19937_64 rng(15445);
+    std::set<int64_t> keys;
+    for (int i = 0; i < 2000; i++) {
+      int64_t key = static_cast<int64_t>(rng() % 4000);
+      if (keys.insert(key).second) {
+        tree.Insert(MakeKey(key), RID(0, key));
+      }
+    }
+    // remove some, so that separators no longer match the keys in the leaves
+    for (int i = 0; i < 500; i++) {
+      int64_t key = static_cast<int64_t>(rng() % 4000);
+      keys.erase(key);
+      tree.Remove(MakeKey(key));
+    }
+
+    for (int i = 0; i < 300; i++) {
+      std::optional<int64_t> lower;
+      std::optional<int64_t> upper;
+      if (rng() % 4 != 0) {
+        lower = static_cast<int64_t>(rng() % 4200) - 100;
+      }
+      if (rng() % 4 != 0) {
+        upper = lower.value_or(0) + static_cast<int64_t>(rng() % 1000);
+      }
+      bool lower_inclusive = rng() % 2 == 0;
+      bool upper_inclusive = rng() % 2 == 0;
+      bool reverse = rng() % 2 == 0;
+      SCOPED_TRACE(testing::Message() << "lower " << lower.value_or(-1) << (lower_inclusive ? "]" : ")") << " upper "
+                                      << upper.value_or(-1) << (upper_inclusive ? "]" : ")") << " reverse "
+                                      << reverse << " leaf " << leaf_max_size);
+      EXPECT_EQ(ScanKeys(&tree, MakeRange(lower, lower_inclusive, upper, upper_inclusive, reverse), leaf_max_size),
+                ExpectedKeys(keys, lower, lower_inclusive, upper, upper_inclusive, reverse));
+    }
+
+    // a full scan copies each leaf in one batch
+    size_t num_batches;
+    auto all = ScanKeys(&tree, MakeRange(std::nullopt, true, std::nullopt, true, false), leaf_max_size, &num_batches);
+    EXPECT_EQ(all.size(), keys.size());
+    EXPECT_LE(num_batches, keys.size() / (leaf_max_size / 2) + 1);
+    auto all_reverse =
+        ScanKeys(&tree, MakeRange(std::nullopt, true, std::nullopt, true, true), leaf_max_size, &num_batches);
+    EXPECT_TRUE(std::equal(all.rbegin(), all.rend(), all_reverse.begin(), all_reverse.end()));
+
+    // abandoning a scan halfway releases the prefetched leaf
+    for (bool reverse : {false, true}) {
+      auto scan = tree.Scan(MakeRange(std::nullopt, true, std::nullopt, true, reverse));
+      std::vector<std::pair<GenericKey<8>, RID>> batch;
+      EXPECT_TRUE(scan.NextBatch(&batch));
+    }
+    std::vector<page_id_t> page_ids;
+    for (int i = 0; i < 49; i++) {
+      ASSERT_NE(bpm->NewPage(&page_id), nullptr);
+      page_ids.push_back(page_id);
+    }
+    for (auto id : page_ids) {
+      bpm->UnpinPage(id, false);
+    }
+
+    bpm->UnpinPage(HEADER_PAGE_ID, true);
+    delete bpm;
+    delete disk_manager;
+    remove("test.db");
+    remove("test.log");
+  }
+}
+
+// NOLINTNEXTLINE
+TEST(BPlusTreeRangeScanTest, ConcurrentScanTest) {
+  auto key_schema = ParseCreateStatement("a bigint");
+  GenericComparator<8> comparator(key_schema.get());
+  DiskManager *disk_manager = new DiskManager("test.db");
+  BufferPoolManager *bpm = new BufferPoolManagerInstance(64, disk_manager);
+  page_id_t page_id;
+  bpm->NewPage(&page_id);
+  Tree tree("foo_pk", bpm, comparator, 4, 4);
+
+  // even keys stay put, odd keys come and go while the scans run
+  const int64_t num_keys = 2000;
+  std::set<int64_t> stable;
+  for (int64_t key = 0; key < num_keys; key += 2) {
+    tree.Insert(MakeKey(key), RID(0, key));
+    stable.insert(key);
+  }
+  std::atomic<bool> stop{false};
+  std::thread writer([&] {
+    std::mt19937_64 rng(15445);
+    while (!stop) {
+      int64_t key = static_cast<int64_t>(rng() % (num_keys / 2)) * 2 + 1;
+      if (rng() % 2 == 0) {
+        tree.Insert(MakeKey(key), RID(0, key));
+      } else {
+        tree.Remove(MakeKey(key));
+      }
+    }
+  });
+
+  for (int round = 0; round < 20; round++) {
+    bool reverse = round % 2 == 1;
+    auto keys = ScanKeys(&tree, MakeRange(100, true, 1800, false, reverse), 4);
+    std::vector<int64_t> even;
+    std::copy_if(keys.begin(), keys.end(), std::back_inserter(even), [](int64_t key) { return key % 2 == 0; });
+    EXPECT_EQ(even, ExpectedKeys(stable, 100, true, 1800, false, reverse));
+    if (reverse) {
+      EXPECT_TRUE(std::is_sorted(keys.rbegin(), keys.rend()));
+    } else {
+      EXPECT_TRUE(std::is_sorted(keys.begin(), keys.end()));
+    }
+  }
+  stop = true;
+  writer.join();
+
+  bpm->UnpinPage(HEADER_PAGE_ID, true);
+  delete bpm;
+  delete disk_manager;
+  remove("test.db");
+  remove("test.log");
+}
+
+}  // namespace bustub
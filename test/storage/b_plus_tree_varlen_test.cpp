@@ -0,0 +1,236 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// b_plus_tree_varlen_test.cpp
+//
+// Identification: test/storage/b_plus_tree_varlen_test.cpp
+//
+// Copyright (c) 2015-2021, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include <algorithm>
+#include <cstdio>
+#include <map>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "buffer/buffer_pool_manager_instance.h"
+#include "gtest/gtest.h"
+#include "storage/index/b_plus_tree.h"
+#include "storage/index/key_encoder.h"
+#include "storage/index/varlen_b_plus_tree.h"
+#include "test_util.h"  // NOLINT
+#include "type/value_factory.h"
+
+namespace bustub {
+
+namespace {
+
+std::vector<std::pair<std::string, RID>> ScanAll(VarlenBPlusTree *tree, const std::string &begin_key = "") {
+  std::vector<std::pair<std::string, RID>> entries;
+  tree->Scan(begin_key, [&](std::string_view key, const RID &value) {
+    entries.emplace_back(std::string(key), value);
+    return true;
+  });
+  return entries;
+}
+
+template <typename Iterator>
+bool SameEntries(const std::vector<std::pair<std::string, RID>> &entries, Iterator begin, Iterator end) {
+  return std::equal(entries.begin(), entries.end(), begin, end, [](const auto &lhs, const auto &rhs) {
+    return lhs.first == rhs.first && lhs.second == rhs.second;
+  });
+}
+
+// a key made of a few shared components, so that pages have long common prefixes to truncate
+std::string RandomKey(std::mt19937_64 *rng) {
+  static const std::string components[] = {"", "a", "ab", std::string("\0", 1), "orders/2021/", "\xff\xff"};
+  std::string key;
+  size_t parts = 1 + (*rng)() % 4;
+  for (size_t i = 0; i < parts; i++) {
+    key += components[(*rng)() % 6];
+  }
+  size_t tail = (*rng)() % 24;
+  for (size_t i = 0; i < tail; i++) {
+    key.push_back(static_cast<char>((*rng)() % 4 == 0 ? 0 : (*rng)() % 256));
+  }
+  return key;
+}
+
+}  // namespace
+
+// NOLINTNEXTLINE
+TEST(BPlusTreeVarlenTest, KeyEncoderOrderTest) {
+  auto schema = ParseCreateStatement("a bigint,b varchar(16),c integer");
+  KeyEncoder encoder(schema.get());
+
+  std::vector<int64_t> as = {BUSTUB_INT64_MIN + 1, -300, -1, 0, 1, 255, 256, BUSTUB_INT64_MAX};
+  std::vector<std::string> bs = {"", std::string("\0", 1), std::string("\0\0", 2), "a", std::string("a\0", 2),
+                                 "ab", "a\xff", "b"};
+  std::vector<int32_t> cs = {-70000, -1, 0, 65536};
+  // the values are listed in order, so encoding them in nested loop order must give sorted, distinct strings
+  std::vector<std::string> encoded;
+  for (auto a : as) {
+    for (const auto &b : bs) {
+      for (auto c : cs) {
+        Tuple key({ValueFactory::GetBigIntValue(a), ValueFactory::GetVarcharValue(b), ValueFactory::GetIntegerValue(c)},
+                  schema.get());
+        encoded.push_back(encoder.Encode(key));
+      }
+    }
+  }
+  for (size_t i = 1; i < encoded.size(); i++) {
+    EXPECT_LT(encoded[i - 1], encoded[i]) << i;
+  }
+
+  // NULL sorts first
+  std::string null_key;
+  KeyEncoder::AppendValue(ValueFactory::GetNullValueByType(TypeId::BIGINT), &null_key);
+  std::string min_key;
+  KeyEncoder::AppendValue(ValueFactory::GetBigIntValue(BUSTUB_INT64_MIN + 1), &min_key);
+  EXPECT_LT(null_key, min_key);
+
+  // and decimals order like numbers
+  std::vector<double> decimals = {-1e300, -2.5, -0.0001, 0.0, 0.0001, 3.0, 1e300};
+  for (size_t i = 1; i < decimals.size(); i++) {
+    std::string lhs;
+    std::string rhs;
+    KeyEncoder::AppendValue(ValueFactory::GetDecimalValue(decimals[i - 1]), &lhs);
+    KeyEncoder::AppendValue(ValueFactory::GetDecimalValue(decimals[i]), &rhs);
+    EXPECT_LT(lhs, rhs) << decimals[i];
+  }
+}
+
+// NOLINTNEXTLINE
+TEST(BPlusTreeVarlenTest, RandomOpsTest) {
+  DiskManager *disk_manager = new DiskManager("test.db");
+  BufferPoolManager *bpm = new BufferPoolManagerInstance(64, disk_manager);
+  page_id_t page_id;
+  auto header_page = bpm->NewPage(&page_id);
+  (void)header_page;
+  VarlenBPlusTree tree("foo_pk", bpm);
+
+  std::mt19937_64 rng(15445);
+  std::map<std::string, RID> expected;
+  for (int round = 0; round < 3; round++) {
+    for (int i = 0; i < 6000; i++) {
+      std::string key = RandomKey(&rng);
+      RID rid(round, i);
+      bool inserted = expected.emplace(key, rid).second;
+      EXPECT_EQ(tree.Insert(key, rid), inserted);
+    }
+    EXPECT_GE(tree.GetHeight(), 2);
+
+    auto entries = ScanAll(&tree);
+    EXPECT_TRUE(SameEntries(entries, expected.begin(), expected.end()));
+
+    std::vector<RID> result;
+    for (int i = 0; i < 2000; i++) {
+      std::string key = RandomKey(&rng);
+      result.clear();
+      auto it = expected.find(key);
+      EXPECT_EQ(tree.GetValue(key, &result), it != expected.end());
+      if (it != expected.end()) {
+        EXPECT_EQ(result[0], it->second);
+      }
+    }
+
+    // remove most keys, in a random order
+    std::vector<std::string> keys;
+    for (const auto &entry : expected) {
+      keys.push_back(entry.first);
+    }
+    std::shuffle(keys.begin(), keys.end(), rng);
+    keys.resize(keys.size() * 9 / 10);
+    for (const auto &key : keys) {
+      tree.Remove(key);
+      expected.erase(key);
+    }
+    entries = ScanAll(&tree);
+    EXPECT_TRUE(SameEntries(entries, expected.begin(), expected.end()));
+
+    // scans can start anywhere
+    std::string from = RandomKey(&rng);
+    entries = ScanAll(&tree, from);
+    EXPECT_TRUE(SameEntries(entries, expected.lower_bound(from), expected.end()));
+  }
+
+  for (const auto &entry : expected) {
+    tree.Remove(entry.first);
+  }
+  EXPECT_TRUE(tree.IsEmpty());
+  EXPECT_EQ(tree.GetHeight(), 0);
+  EXPECT_TRUE(ScanAll(&tree).empty());
+
+  EXPECT_TRUE(tree.Insert(std::string(BPlusTreeVarlenPage<RID>::MAX_KEY_SIZE, 'x'), RID()));
+  EXPECT_THROW(tree.Insert(std::string(BPlusTreeVarlenPage<RID>::MAX_KEY_SIZE + 1, 'x'), RID()), Exception);
+
+  bpm->UnpinPage(HEADER_PAGE_ID, true);
+  delete disk_manager;
+  delete bpm;
+  remove("test.db");
+  remove("test.log");
+}
+
+// NOLINTNEXTLINE
+TEST(BPlusTreeVarlenTest, FanoutComparisonTest) {
+  // A composite (region, customer name) key: a GenericKey needs 64 bytes for it, most of them padding.
+  auto key_schema = ParseCreateStatement("a integer,b varchar(40)");
+  KeyEncoder encoder(key_schema.get());
+  const int num_keys = 20000;
+  std::vector<Tuple> keys;
+  for (int i = 0; i < num_keys; i++) {
+    std::string name = "customer#" + std::to_string(i * 7919 % num_keys);
+    keys.emplace_back(std::vector<Value>{ValueFactory::GetIntegerValue(i % 8), ValueFactory::GetVarcharValue(name)},
+                      key_schema.get());
+  }
+
+  auto count_pages = [](BufferPoolManager *bpm) {
+    page_id_t next_page_id;
+    bpm->NewPage(&next_page_id);
+    bpm->UnpinPage(next_page_id, false);
+    return next_page_id;
+  };
+
+  DiskManager *disk_manager = new DiskManager("test.db");
+  BufferPoolManager *bpm = new BufferPoolManagerInstance(128, disk_manager);
+  page_id_t page_id;
+  bpm->NewPage(&page_id);
+
+  VarlenBPlusTree varlen_tree("varlen", bpm);
+  page_id_t varlen_start = count_pages(bpm);
+  for (int i = 0; i < num_keys; i++) {
+    EXPECT_TRUE(varlen_tree.Insert(encoder.Encode(keys[i]), RID(0, i)));
+  }
+  page_id_t varlen_pages = count_pages(bpm) - varlen_start - 1;
+
+  GenericComparator<64> comparator(key_schema.get());
+  BPlusTree<GenericKey<64>, RID, GenericComparator<64>> fixed_tree("fixed", bpm, comparator);
+  page_id_t fixed_start = count_pages(bpm);
+  GenericKey<64> index_key;
+  for (int i = 0; i < num_keys; i++) {
+    index_key.SetFromKey(keys[i]);
+    EXPECT_TRUE(fixed_tree.Insert(index_key, RID(0, i)));
+  }
+  page_id_t fixed_pages = count_pages(bpm) - fixed_start - 1;
+
+  EXPECT_LT(varlen_pages * 2, fixed_pages);
+
+  std::vector<RID> result;
+  for (int i = 0; i < num_keys; i += 97) {
+    result.clear();
+    EXPECT_TRUE(varlen_tree.GetValue(encoder.Encode(keys[i]), &result));
+    EXPECT_EQ(result[0].GetSlotNum(), i);
+  }
+
+  bpm->UnpinPage(HEADER_PAGE_ID, true);
+  delete disk_manager;
+  delete bpm;
+  remove("test.db");
+  remove("test.log");
+}
+
+}  // namespace bustub
@@ -0,0 +1,127 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// header_page_test.cpp
+//
+// Identification: test/storage/header_page_test.cpp
+//
+// Copyright (c) 2015-2021, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include <cstdio>
+#include <string>
+
+#include "buffer/buffer_pool_manager_instance.h"
+#include "gtest/gtest.h"
+#include "storage/index/b_plus_tree.h"
+#include "storage/page/header_page.h"
+#include "test_util.h"  // NOLINT
+
+namespace bustub {
+
+namespace {
+
+std::string IndexName(int i) { return "index_" + std::to_string(i); }
+
+}  // namespace
+
+// NOLINTNEXTLINE
+TEST(HeaderPageTest, ManyRecordsTest) {
+  DiskManager *disk_manager = new DiskManager("test.db");
+  BufferPoolManager *bpm = new BufferPoolManagerInstance(16, disk_manager);
+  page_id_t page_id;
+  auto *header_page = static_cast<HeaderPage *>(bpm->NewPage(&page_id));
+  ASSERT_EQ(page_id, HEADER_PAGE_ID);
+
+  // more records than the buckets hold without overflow pages
+  const int num_records = HeaderPage::NUM_BUCKETS * HeaderBucketPage::CAPACITY * 3 / 2;
+  for (int i = 0; i < num_records; i++) {
+    ASSERT_TRUE(header_page->InsertRecord(bpm, IndexName(i), i + 1));
+  }
+  EXPECT_FALSE(header_page->InsertRecord(bpm, IndexName(0), 1));
+  EXPECT_EQ(header_page->GetRecordCount(), num_records);
+
+  for (int i = 0; i < num_records; i += 3) {
+    ASSERT_TRUE(header_page->UpdateRecord(bpm, IndexName(i), i + 2));
+  }
+  for (int i = 1; i < num_records; i += 3) {
+    ASSERT_TRUE(header_page->DeleteRecord(bpm, IndexName(i)));
+  }
+  EXPECT_FALSE(header_page->DeleteRecord(bpm, IndexName(1)));
+  EXPECT_EQ(header_page->GetRecordCount(), num_records - (num_records + 1) / 3);
+
+  for (int i = 0; i < num_records; i++) {
+    page_id_t root_id = INVALID_PAGE_ID;
+    bool found = header_page->GetRootId(bpm, IndexName(i), &root_id);
+    ASSERT_EQ(found, i % 3 != 1) << IndexName(i);
+    if (found) {
+      EXPECT_EQ(root_id, i % 3 == 0 ? i + 2 : i + 1);
+    }
+  }
+
+  // a deleted record's location is no longer valid, even once its slot is taken again
+  RID location;
+  ASSERT_TRUE(header_page->InsertRecord(bpm, "foo", 1, &location));
+  EXPECT_TRUE(HeaderPage::UpdateRecordAt(bpm, location, "foo", 2));
+  ASSERT_TRUE(header_page->DeleteRecord(bpm, "foo"));
+  EXPECT_FALSE(HeaderPage::UpdateRecordAt(bpm, location, "foo", 3));
+
+  bpm->UnpinPage(HEADER_PAGE_ID, true);
+  delete bpm;
+  delete disk_manager;
+  remove("test.db");
+  remove("test.log");
+}
+
+// NOLINTNEXTLINE
+TEST(HeaderPageTest, RootPageIdTest) {
+  auto key_schema = ParseCreateStatement("a bigint");
+  GenericComparator<8> comparator(key_schema.get());
+  DiskManager *disk_manager = new DiskManager("test.db");
+  BufferPoolManager *bpm = new BufferPoolManagerInstance(50, disk_manager);
+  page_id_t page_id;
+  auto *header_page = static_cast<HeaderPage *>(bpm->NewPage(&page_id));
+
+  // the trees' root changes interleave, so each one must keep writing its own record
+  BPlusTree<GenericKey<8>, RID, GenericComparator<8>> first("first", bpm, comparator, 3, 3);
+  BPlusTree<GenericKey<8>, RID, GenericComparator<8>> second("second", bpm, comparator, 3, 3);
+  auto check_roots = [&] {
+    page_id_t root_id;
+    ASSERT_TRUE(header_page->GetRootId(bpm, "first", &root_id));
+    EXPECT_EQ(root_id, first.GetRootPageId());
+    ASSERT_TRUE(header_page->GetRootId(bpm, "second", &root_id));
+    EXPECT_EQ(root_id, second.GetRootPageId());
+  };
+
+  GenericKey<8> index_key;
+  for (int64_t key = 0; key < 200; key++) {
+    index_key.SetFromInteger(key);
+    first.Insert(index_key, RID(0, key));
+    second.Insert(index_key, RID(0, key));
+  }
+  check_roots();
+  for (int64_t key = 0; key < 200; key++) {
+    index_key.SetFromInteger(key);
+    first.Remove(index_key);
+    if (key < 150) {
+      second.Remove(index_key);
+    }
+  }
+  EXPECT_TRUE(first.IsEmpty());
+  check_roots();
+  // an emptied tree that grows again reuses its record
+  index_key.SetFromInteger(1);
+  first.Insert(index_key, RID(0, 1));
+  check_roots();
+  EXPECT_EQ(header_page->GetRecordCount(), 2);
+
+  bpm->UnpinPage(HEADER_PAGE_ID, true);
+  delete bpm;
+  delete disk_manager;
+  remove("test.db");
+  remove("test.log");
+}
+
+}  // namespace bustub
@@ -10,16 +10,21 @@
 //
 //===----------------------------------------------------------------------===//
 
+#include <cstdio>
+#include <memory>
+#include <string>
 #include <vector>
 
+#include "buffer/buffer_pool_manager_instance.h"
 #include "gtest/gtest.h"
 #include "storage/page/tmp_tuple_page.h"
+#include "storage/table/spill_file.h"
 #include "type/value_factory.h"
 
 namespace bustub {
 
 // NOLINTNEXTLINE
-TEST(TmpTuplePageTest, DISABLED_BasicTest) {
+TEST(TmpTuplePageTest, BasicTest) {
   // There are many ways to do this assignment, and this is only one of them.
   // If you don't like the TmpTuplePage idea, please feel free to delete this test case entirely.
   // You will get full credit as long as you are correctly using a linear probe hash table.
@@ -46,6 +51,62 @@ TEST(TmpTuplePageTest, DISABLED_BasicTest) {
   ASSERT_EQ(*reinterpret_cast<uint32_t *>(data + sizeof(page_id_t) + sizeof(lsn_t)), PAGE_SIZE - 8);
   ASSERT_EQ(*reinterpret_cast<uint32_t *>(data + PAGE_SIZE - 8), 4);
   ASSERT_EQ(*reinterpret_cast<uint32_t *>(data + PAGE_SIZE - 4), 123);
+  ASSERT_EQ(tmp_tuple, TmpTuple(page_id, PAGE_SIZE - 8));
+
+  // fill the page up, and read everything back
+  int32_t num_tuples = 1;
+  while (page.Insert(Tuple({ValueFactory::GetIntegerValue(123 + num_tuples)}, &schema), &tmp_tuple)) {
+    num_tuples++;
+  }
+  ASSERT_EQ(num_tuples, (PAGE_SIZE - 12) / 8);
+  Tuple first;
+  page.Get(TmpTuple(page_id, PAGE_SIZE - 8), &first);
+  ASSERT_EQ(first.GetValue(&schema, 0).GetAs<int32_t>(), 123);
+  std::vector<Tuple> tuples;
+  page.GetTuples(&tuples);
+  ASSERT_EQ(tuples.size(), num_tuples);
+  for (int32_t i = 0; i < num_tuples; i++) {
+    ASSERT_EQ(tuples[i].GetValue(&schema, 0).GetAs<int32_t>(), 123 + num_tuples - 1 - i);
+  }
+}
+
+// NOLINTNEXTLINE
+TEST(TmpTuplePageTest, SpillFileTest) {
+  auto *disk_manager = new DiskManager("test.db");
+  auto *bpm = new BufferPoolManagerInstance(4, disk_manager);
+  Schema schema({Column("A", TypeId::INTEGER), Column("B", TypeId::VARCHAR, 32)});
+  {
+    // more pages than the buffer pool holds, and more files than it has frames
+    std::vector<std::unique_ptr<SpillFile>> files;
+    for (int file = 0; file < 8; file++) {
+      files.push_back(std::make_unique<SpillFile>(bpm));
+    }
+    const int32_t num_tuples = 2000;
+    for (int32_t i = 0; i < num_tuples; i++) {
+      files[i % files.size()]->Append(
+          Tuple({ValueFactory::GetIntegerValue(i), ValueFactory::GetVarcharValue(std::to_string(i))}, &schema));
+    }
+    for (int pass = 0; pass < 2; pass++) {
+      for (size_t file = 0; file < files.size(); file++) {
+        files[file]->Rewind();
+        ASSERT_EQ(files[file]->GetNumTuples(), num_tuples / files.size());
+        std::vector<Tuple> tuples;
+        while (files[file]->ReadPage(&tuples)) {
+        }
+        ASSERT_EQ(tuples.size(), num_tuples / files.size());
+        for (size_t i = 0; i < tuples.size(); i++) {
+          auto expected = static_cast<int32_t>(i * files.size() + file);
+          ASSERT_EQ(tuples[i].GetValue(&schema, 0).GetAs<int32_t>(), expected);
+          ASSERT_EQ(tuples[i].GetValue(&schema, 1).ToString(), std::to_string(expected));
+        }
+      }
+    }
+  }
+
+  delete bpm;
+  delete disk_manager;
+  remove("test.db");
+  remove("test.log");
 }
 
 }  // namespace bustub
@@ -71,4 +71,62 @@ TEST(TupleTest, DISABLED_TableHeapTest) {
   delete disk_manager;
 }
 
+// NOLINTNEXTLINE
+TEST(TupleTest, PageDirectoryTest) {
+  Column col1{"a", TypeId::VARCHAR, 20};
+  Column col2{"b", TypeId::BIGINT};
+  std::vector<Column> cols{col1, col2};
+  Schema schema{cols};
+  Tuple tuple = ConstructTuple(&schema);
+
+  auto *transaction = new Transaction(0);
+  auto *disk_manager = new DiskManager("test.db");
+  auto *buffer_pool_manager = new BufferPoolManagerInstance(50, disk_manager);
+  auto *lock_manager = new LockManager();
+  auto *log_manager = new LogManager(disk_manager);
+  auto *table = new TableHeap(buffer_pool_manager, lock_manager, log_manager, transaction);
+  EXPECT_EQ(table->GetNumPages(), 1);
+
+  std::vector<page_id_t> rid_page_ids;
+  for (int i = 0; i < 2000; ++i) {
+    RID rid;
+    ASSERT_TRUE(table->InsertTuple(tuple, &rid, transaction));
+    if (rid_page_ids.empty() || rid_page_ids.back() != rid.GetPageId()) {
+      rid_page_ids.push_back(rid.GetPageId());
+    }
+  }
+
+  // the directory lists the pages in the order they are linked in, which is the order they were filled in
+  std::vector<page_id_t> chain_page_ids;
+  std::vector<Tuple> tuples;
+  for (page_id_t page_id = table->GetFirstPageId(); page_id != INVALID_PAGE_ID;) {
+    chain_page_ids.push_back(page_id);
+    page_id = table->GetPageTuples(page_id, &tuples, transaction);
+  }
+  EXPECT_EQ(tuples.size(), 2000);
+  EXPECT_EQ(chain_page_ids, rid_page_ids);
+  ASSERT_GT(table->GetNumPages(), 2);
+  std::vector<page_id_t> page_ids;
+  table->GetPageIds(0, table->GetNumPages(), &page_ids);
+  EXPECT_EQ(page_ids, chain_page_ids);
+  table->GetPageIds(1, 2, &page_ids);
+  EXPECT_EQ(page_ids, std::vector<page_id_t>{chain_page_ids[1]});
+
+  // opening the table rebuilds the directory from the chain
+  auto *opened_table = new TableHeap(buffer_pool_manager, lock_manager, log_manager, table->GetFirstPageId());
+  opened_table->GetPageIds(0, opened_table->GetNumPages(), &page_ids);
+  EXPECT_EQ(page_ids, chain_page_ids);
+
+  disk_manager->ShutDown();
+  remove("test.db");
+  remove("test.log");
+  delete opened_table;
+  delete table;
+  delete log_manager;
+  delete lock_manager;
+  delete buffer_pool_manager;
+  delete disk_manager;
+  delete transaction;
+}
+
 }  // namespace bustub
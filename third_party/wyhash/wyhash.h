@@ -0,0 +1,129 @@
+// This source file was originally from:
+//   https://github.com/wangyi-fudan/wyhash
+//
+// We've changed it for use with BusTub:
+//   - Wrapped the functions in the wyhash namespace and dropped the C linkage,
+//     PRNG and "condom" configuration knobs; we always use the fast 64x64->128
+//     multiply path with the default secret.
+//   - Added Hash64(), a fixed-width entry point for a single 8-byte word, and
+//     Mix(), used for combining two existing hashes.
+
+//-----------------------------------------------------------------------------
+// wyhash was written by Wang Yi and is released into the public domain
+// (The Unlicense). The author hereby disclaims copyright to this source code.
+
+#ifndef _WYHASH_H_
+#define _WYHASH_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+namespace wyhash {
+
+#if defined(__GNUC__) || defined(__clang__)
+#define WYHASH_LIKELY(x) __builtin_expect(!!(x), 1)
+#define WYHASH_UNLIKELY(x) __builtin_expect(!!(x), 0)
+#else
+#define WYHASH_LIKELY(x) (x)
+#define WYHASH_UNLIKELY(x) (x)
+#endif
+
+// The default secret. Four odd 64-bit constants, each with 32 bits set.
+static constexpr uint64_t kSecret[4] = {0xa0761d6478bd642full, 0xe7037ed1a0b428dbull, 0x8ebc6af09c88c6e3ull,
+                                        0x589965cc75374cc3ull};
+
+//-----------------------------------------------------------------------------
+// 64x64 -> 128 bit multiply, returning the low and high halves in place.
+inline void Mum(uint64_t *a, uint64_t *b) {
+  __uint128_t r = *a;
+  r *= *b;
+  *a = static_cast<uint64_t>(r);
+  *b = static_cast<uint64_t>(r >> 64);
+}
+
+// Multiply and fold the halves back together.
+inline uint64_t Mix(uint64_t a, uint64_t b) {
+  Mum(&a, &b);
+  return a ^ b;
+}
+
+//-----------------------------------------------------------------------------
+// Unaligned little-endian reads. memcpy compiles down to a single mov.
+inline uint64_t Read8(const uint8_t *p) {
+  uint64_t v;
+  memcpy(&v, p, 8);
+  return v;
+}
+
+inline uint64_t Read4(const uint8_t *p) {
+  uint32_t v;
+  memcpy(&v, p, 4);
+  return v;
+}
+
+inline uint64_t Read3(const uint8_t *p, size_t k) {
+  return (static_cast<uint64_t>(p[0]) << 16) | (static_cast<uint64_t>(p[k >> 1]) << 8) | p[k - 1];
+}
+
+//-----------------------------------------------------------------------------
+// Hash an arbitrary byte string. Consumes 48 bytes per iteration on long
+// inputs with three independent multiply chains, so the loop pipelines well.
+inline uint64_t Hash(const void *key, size_t len, uint64_t seed = 0) {
+  const auto *p = static_cast<const uint8_t *>(key);
+  seed ^= Mix(seed ^ kSecret[0], kSecret[1]);
+  uint64_t a;
+  uint64_t b;
+  if (WYHASH_LIKELY(len <= 16)) {
+    if (WYHASH_LIKELY(len >= 4)) {
+      a = (Read4(p) << 32) | Read4(p + ((len >> 3) << 2));
+      b = (Read4(p + len - 4) << 32) | Read4(p + len - 4 - ((len >> 3) << 2));
+    } else if (WYHASH_LIKELY(len > 0)) {
+      a = Read3(p, len);
+      b = 0;
+    } else {
+      a = b = 0;
+    }
+  } else {
+    size_t i = len;
+    if (WYHASH_UNLIKELY(i > 48)) {
+      uint64_t see1 = seed;
+      uint64_t see2 = seed;
+      do {
+        seed = Mix(Read8(p) ^ kSecret[1], Read8(p + 8) ^ seed);
+        see1 = Mix(Read8(p + 16) ^ kSecret[2], Read8(p + 24) ^ see1);
+        see2 = Mix(Read8(p + 32) ^ kSecret[3], Read8(p + 40) ^ see2);
+        p += 48;
+        i -= 48;
+      } while (WYHASH_LIKELY(i > 48));
+      seed ^= see1 ^ see2;
+    }
+    while (WYHASH_UNLIKELY(i > 16)) {
+      seed = Mix(Read8(p) ^ kSecret[1], Read8(p + 8) ^ seed);
+      i -= 16;
+      p += 16;
+    }
+    a = Read8(p + i - 16);
+    b = Read8(p + i - 8);
+  }
+  a ^= kSecret[1];
+  b ^= seed;
+  Mum(&a, &b);
+  return Mix(a ^ kSecret[0] ^ len, b ^ kSecret[1]);
+}
+
+//-----------------------------------------------------------------------------
+// Hash a single 64-bit word. Two multiplies, no loads, no branches.
+inline uint64_t Hash64(uint64_t key, uint64_t seed = 0) {
+  uint64_t a = key ^ kSecret[0];
+  uint64_t b = seed ^ kSecret[1];
+  Mum(&a, &b);
+  return Mix(a ^ kSecret[0], b ^ kSecret[1]);
+}
+
+#undef WYHASH_LIKELY
+#undef WYHASH_UNLIKELY
+
+}  // namespace wyhash
+
+#endif  // _WYHASH_H_